@@ -0,0 +1,389 @@
+// Benchmark suite: parameterized workloads against the real CacheManager and
+// FileSystem, each case run with warmup and repeated measurements and
+// reported with a 95% confidence interval. Results are written as JSON and
+// can be compared against an earlier results file to gate regressions.
+//
+//   benchmark_suite [--filter TEXT] [--reps N] [--warmup N] [--seed N]
+//                   [--scale X] [--quick] [--out FILE]
+//                   [--baseline FILE] [--threshold PERCENT]
+//
+// Exit status is 0 on success, 1 on a usage or I/O error and 2 when a case
+// regressed against the baseline.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "harness.hpp"
+#include "cache/enhanced_cache.hpp"
+#include "common/logger.hpp"
+#include "fs/filesystem.hpp"
+
+using namespace mtfs::bench;
+using mtfs::cache::CacheManager;
+using mtfs::cache::CachePolicy;
+using mtfs::fs::FileSystem;
+using mtfs::fs::SharedBuffer;
+
+namespace {
+
+// Only every LATENCY_SAMPLE-th cache operation is timed, so the clock reads
+// do not dominate what they measure
+constexpr size_t LATENCY_SAMPLE = 16;
+
+const char* policyName(CachePolicy policy) {
+    switch (policy) {
+        case CachePolicy::LRU: return "LRU";
+        case CachePolicy::LFU: return "LFU";
+        case CachePolicy::FIFO: return "FIFO";
+        case CachePolicy::LIFO: return "LIFO";
+        case CachePolicy::ARC: return "ARC";
+    }
+    return "?";
+}
+
+std::string formatSkew(double skew) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2) << skew;
+    return out.str();
+}
+
+size_t scaled(const Options& options, size_t count) {
+    return std::max<size_t>(1, static_cast<size_t>(count * options.scale));
+}
+
+// Runs body(thread) on `threads` threads released together; the wall time
+// from release until the last one finishes
+double timedParallel(size_t threads, const std::function<void(size_t)>& body) {
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            body(t);
+        });
+    }
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// A FileSystem in a scratch directory, removed with its backups on destruction
+class ScratchFileSystem {
+public:
+    explicit ScratchFileSystem(const std::string& name)
+        : root(std::filesystem::temp_directory_path() / ("mtfs_bench_" + name)) {
+        clean();
+        std::filesystem::create_directories(root);
+        fs = FileSystem::create(root.string());
+    }
+
+    ~ScratchFileSystem() {
+        fs.reset();
+        clean();
+    }
+
+    FileSystem& operator*() { return *fs; }
+    FileSystem* operator->() { return fs.get(); }
+
+private:
+    void clean() {
+        std::error_code ignored;
+        std::filesystem::remove_all(root, ignored);
+        std::filesystem::remove_all(root.string() + "_backups", ignored);
+    }
+
+    std::filesystem::path root;
+    std::shared_ptr<FileSystem> fs;
+};
+
+// Files spread over DIRECTORIES directories, with contents drawn from `sizes`
+struct FileSet {
+    static constexpr size_t DIRECTORIES = 8;
+
+    std::vector<std::string> paths;
+    std::vector<std::string> contents;
+    size_t bytes{0};
+
+    FileSet(SizeDistribution sizes, size_t count, uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        for (size_t i = 0; i < count; ++i) {
+            paths.push_back("d" + std::to_string(i % DIRECTORIES) + "/f" + std::to_string(i) + ".dat");
+            std::string data(sizes.next(rng), '\0');
+            // Compressible but not trivially so, like typical file contents
+            for (size_t b = 0; b < data.size(); ++b) {
+                data[b] = static_cast<char>('a' + (rng() % 16));
+            }
+            bytes += data.size();
+            contents.push_back(std::move(data));
+        }
+    }
+
+    void createDirectories(FileSystem& fs) const {
+        for (size_t d = 0; d < DIRECTORIES; ++d) {
+            fs.createDirectory("d" + std::to_string(d));
+        }
+    }
+};
+
+size_t fileCount(const std::string& sizes) {
+    if (sizes == "small") return 512;
+    if (sizes == "mixed") return 128;
+    return 32;
+}
+
+// Zipf-distributed gets against CacheManager over a key space ten times its
+// capacity; a miss puts the key, as FileSystem does on a read miss
+void cacheWorkloads(Harness& harness) {
+    const Options& options = harness.options();
+    constexpr size_t KEYS = 100000;
+    constexpr size_t CAPACITY = 10000;
+    const size_t operations = scaled(options, 400000);
+
+    std::vector<std::string> keys;
+    keys.reserve(KEYS);
+    for (size_t i = 0; i < KEYS; ++i) {
+        keys.push_back("dir_" + std::to_string(i % 97) + "/file_" + std::to_string(i) + ".dat");
+    }
+    auto payload = std::make_shared<const std::string>(4096, 'x');
+
+    for (CachePolicy policy : {CachePolicy::LRU, CachePolicy::LFU, CachePolicy::FIFO, CachePolicy::ARC}) {
+        for (double skew : {0.8, 0.99, 1.2}) {
+            for (size_t threads : {1, 4}) {
+                Params params{{"policy", policyName(policy)}, {"skew", formatSkew(skew)},
+                              {"threads", std::to_string(threads)}};
+                harness.run("cache.zipf", params, [&](Repetition& rep) {
+                    CacheManager<std::string, SharedBuffer> cache(CAPACITY, policy);
+                    RunResult result;
+                    result.seconds = timedParallel(threads, [&](size_t t) {
+                        ZipfGenerator zipf(KEYS, skew, rep.seed + t);
+                        for (size_t i = t; i < operations; i += threads) {
+                            const std::string& key = keys[zipf.next()];
+                            bool sampled = i % LATENCY_SAMPLE == 0;
+                            auto start = sampled ? std::chrono::steady_clock::now()
+                                                 : std::chrono::steady_clock::time_point();
+                            try {
+                                cache.get(key);
+                            } catch (const std::runtime_error&) {
+                                cache.put(key, payload);
+                            }
+                            if (sampled) {
+                                rep.latency.record(std::chrono::steady_clock::now() - start);
+                            }
+                        }
+                    });
+                    result.operations = static_cast<double>(operations);
+                    result.counters["hit_rate"] = cache.getStatistics().hitRate;
+                    return result;
+                });
+            }
+        }
+    }
+}
+
+// createFile and writeFile of a fresh file set, spread over the threads
+void fileWriteWorkloads(Harness& harness) {
+    const Options& options = harness.options();
+    for (const char* sizeName : {"small", "mixed", "large"}) {
+        for (size_t threads : {1, 4}) {
+            Params params{{"sizes", sizeName}, {"threads", std::to_string(threads)}};
+            if (!harness.selected("fs.write", params)) {
+                continue;
+            }
+            size_t count = scaled(options, fileCount(sizeName));
+            harness.run("fs.write", params, [&](Repetition& rep) {
+                FileSet files(SizeDistribution(sizeName), count, rep.seed);
+                ScratchFileSystem fs("write");
+                files.createDirectories(*fs);
+                RunResult result;
+                result.seconds = timedParallel(threads, [&](size_t t) {
+                    for (size_t i = t; i < files.paths.size(); i += threads) {
+                        mtfs::common::LatencyTimer timer(rep.latency);
+                        fs->createFile(files.paths[i]);
+                        fs->writeFile(files.paths[i], files.contents[i]);
+                    }
+                });
+                result.operations = static_cast<double>(files.paths.size());
+                result.bytes = static_cast<double>(files.bytes);
+                return result;
+            });
+        }
+    }
+}
+
+// readFile with the cache emptied first (every file once, so every read
+// misses) or warm (Zipf-distributed reads that mostly hit)
+void fileReadWorkloads(Harness& harness) {
+    const Options& options = harness.options();
+    for (const char* sizeName : {"small", "mixed", "large"}) {
+        for (const char* state : {"cold", "hot"}) {
+            for (size_t threads : {1, 4}) {
+                Params params{{"sizes", sizeName}, {"cache", state}, {"threads", std::to_string(threads)}};
+                if (!harness.selected("fs.read", params)) {
+                    continue;
+                }
+                bool cold = std::string(state) == "cold";
+                FileSet files(SizeDistribution(sizeName), scaled(options, fileCount(sizeName)), options.seed);
+                ScratchFileSystem fs("read");
+                files.createDirectories(*fs);
+                for (size_t i = 0; i < files.paths.size(); ++i) {
+                    fs->createFile(files.paths[i]);
+                    fs->writeFile(files.paths[i], files.contents[i]);
+                }
+                size_t reads = cold ? files.paths.size() : files.paths.size() * 8;
+
+                harness.run("fs.read", params, [&](Repetition& rep) {
+                    std::vector<size_t> order(reads);
+                    if (cold) {
+                        fs->clearCache();
+                        std::iota(order.begin(), order.end(), 0);
+                        std::shuffle(order.begin(), order.end(), std::mt19937_64(rep.seed));
+                    } else {
+                        ZipfGenerator zipf(files.paths.size(), 0.99, rep.seed);
+                        for (size_t& index : order) {
+                            index = zipf.next();
+                        }
+                    }
+                    fs->resetStats();
+                    std::atomic<size_t> bytes{0};
+                    RunResult result;
+                    result.seconds = timedParallel(threads, [&](size_t t) {
+                        size_t read = 0;
+                        for (size_t i = t; i < order.size(); i += threads) {
+                            mtfs::common::LatencyTimer timer(rep.latency);
+                            read += fs->readFileShared(files.paths[order[i]])->size();
+                        }
+                        bytes += read;
+                    });
+                    result.operations = static_cast<double>(order.size());
+                    result.bytes = static_cast<double>(bytes.load());
+                    result.counters["hit_rate"] = fs->getStats().getCacheHitRate();
+                    return result;
+                });
+            }
+        }
+    }
+}
+
+void printResult(const CaseResult& result) {
+    double relative = result.throughput.mean > 0 ? result.throughput.ci95 / result.throughput.mean * 100.0 : 0.0;
+    std::cout << std::left << std::setw(48) << result.id << std::right << std::fixed << std::setprecision(0)
+              << std::setw(14) << result.throughput.mean << " ops/s +-" << std::setprecision(1) << std::setw(5)
+              << relative << "%";
+    if (result.bandwidth.mean > 0) {
+        std::cout << std::setw(10) << result.bandwidth.mean << " MiB/s";
+    } else {
+        std::cout << std::setw(16) << "";
+    }
+    std::cout << "  p50 " << std::setprecision(2) << std::setw(9) << result.latency.percentile(50) / 1000.0
+              << " us  p99 " << std::setw(9) << result.latency.percentile(99) / 1000.0 << " us" << std::endl;
+}
+
+void usage() {
+    std::cerr << "usage: benchmark_suite [--filter TEXT] [--reps N] [--warmup N] [--seed N] [--scale X]\n"
+                 "                       [--quick] [--out FILE] [--baseline FILE] [--threshold PERCENT]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    std::string outPath = "benchmark_results.json";
+    std::string baselinePath;
+    double threshold = 10.0;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument(arg + " needs a value");
+                }
+                return argv[++i];
+            };
+            if (arg == "--filter") {
+                options.filter = value();
+            } else if (arg == "--reps") {
+                options.repetitions = std::stoul(value());
+            } else if (arg == "--warmup") {
+                options.warmup = std::stoul(value());
+            } else if (arg == "--seed") {
+                options.seed = std::stoull(value());
+            } else if (arg == "--scale") {
+                options.scale = std::stod(value());
+            } else if (arg == "--quick") {
+                options.repetitions = 3;
+                options.scale = 0.25;
+            } else if (arg == "--out") {
+                outPath = value();
+            } else if (arg == "--baseline") {
+                baselinePath = value();
+            } else if (arg == "--threshold") {
+                threshold = std::stod(value());
+            } else {
+                usage();
+                return arg == "--help" ? 0 : 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        usage();
+        return 1;
+    }
+
+    Harness harness(options);
+    std::cout << "=== Benchmark Suite (" << options.warmup << " warmup + " << options.repetitions
+              << " repetitions, seed " << options.seed << ", scale " << options.scale << ") ===" << std::endl;
+    size_t printed = 0;
+    auto report = [&]() {
+        mtfs::common::flush_logs();
+        for (; printed < harness.results().size(); ++printed) {
+            printResult(harness.results()[printed]);
+        }
+    };
+    cacheWorkloads(harness);
+    report();
+    fileWriteWorkloads(harness);
+    report();
+    fileReadWorkloads(harness);
+    report();
+
+    try {
+        harness.writeJson(outPath);
+        std::cout << "Results written to " << outPath << std::endl;
+        if (baselinePath.empty()) {
+            return 0;
+        }
+        auto comparisons = harness.compare(baselinePath, threshold);
+        bool regressed = false;
+        std::cout << "\n=== Against " << baselinePath << " (threshold " << threshold << "%) ===" << std::endl;
+        for (const auto& comparison : comparisons) {
+            std::cout << std::left << std::setw(48) << comparison.id << std::right << std::fixed
+                      << std::setprecision(1) << std::setw(8) << std::showpos << comparison.changePercent
+                      << std::noshowpos << "%" << (comparison.regressed ? "  REGRESSION" : "") << std::endl;
+            regressed = regressed || comparison.regressed;
+        }
+        std::cout << comparisons.size() << " cases compared, " << (regressed ? "regressions found" : "no regressions")
+                  << std::endl;
+        return regressed ? 2 : 0;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,197 @@
+// Cache storage layout: heap bytes per entry and LRU operations/sec for the
+// node-based layout the list policies used (std::list of CacheEntry plus an
+// std::unordered_map from a second copy of the key to the list node) against
+// SlotArena (one slot array with index links and an open-addressing table).
+// Both run the same LRU logic without locks or statistics, so only the
+// layout differs. Values are shared buffers pointing at one payload, so the
+// byte counts are the per-entry overhead, keys included.
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cache/slot_arena.hpp"
+
+using mtfs::cache::SlotArena;
+using Value = std::shared_ptr<const std::string>;
+
+// Live heap bytes, counted by the global operators below
+static std::atomic<size_t> liveBytes{0};
+
+namespace {
+
+constexpr size_t HEADER = alignof(std::max_align_t);
+
+void* countedAlloc(size_t size) {
+    auto* block = static_cast<unsigned char*>(std::malloc(size + HEADER));
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    liveBytes += size;
+    return block + HEADER;
+}
+
+void countedFree(void* pointer) {
+    if (pointer) {
+        auto* block = static_cast<unsigned char*>(pointer) - HEADER;
+        liveBytes -= *reinterpret_cast<size_t*>(block);
+        std::free(block);
+    }
+}
+
+} // namespace
+
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void operator delete(void* pointer) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer) noexcept { countedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { countedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { countedFree(pointer); }
+
+// The layout as it was: the entry kept the key, its stats and two wall-clock
+// times in a list node, and the map held the key again
+class NodeLru {
+public:
+    explicit NodeLru(size_t capacity) : capacity(capacity) {}
+
+    bool get(const std::string& key, Value& value) {
+        auto it = lookup.find(key);
+        if (it == lookup.end()) {
+            return false;
+        }
+        it->second->accessCount++;
+        it->second->lastAccessed = std::chrono::system_clock::now();
+        entries.splice(entries.begin(), entries, it->second);
+        value = it->second->value;
+        return true;
+    }
+
+    void put(const std::string& key, const Value& value) {
+        if (lookup.size() >= capacity) {
+            lookup.erase(entries.back().key);
+            entries.pop_back();
+        }
+        entries.push_front({key, value, 0, 0, std::chrono::system_clock::now(), std::chrono::system_clock::now()});
+        lookup[key] = entries.begin();
+    }
+
+private:
+    struct Entry {
+        std::string key;
+        Value value;
+        size_t accessCount;
+        size_t weight;
+        std::chrono::system_clock::time_point lastAccessed;
+        std::chrono::system_clock::time_point createdAt;
+        bool isPinned{false};
+        bool prefetched{false};
+    };
+
+    size_t capacity;
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> lookup;
+};
+
+class ArenaLru {
+public:
+    explicit ArenaLru(size_t capacity) : capacity(capacity) {}
+
+    bool get(const std::string& key, Value& value) {
+        auto index = entries.find(key);
+        if (index == Arena::NIL) {
+            return false;
+        }
+        entries[index].accessCount++;
+        entries[index].lastAccessed = entries.now();
+        entries.moveToFront(index);
+        value = entries[index].value;
+        return true;
+    }
+
+    void put(const std::string& key, const Value& value) {
+        if (entries.size() >= capacity) {
+            entries.erase(entries.back());
+        }
+        entries.insert(key, value);
+    }
+
+private:
+    using Arena = SlotArena<std::string, Value>;
+    size_t capacity;
+    Arena entries;
+};
+
+struct Result {
+    double bytesPerEntry{0};
+    double opsPerSecond{0};
+};
+
+// Fills the cache, then runs 90% gets and 10% puts over twice as many keys
+// as fit, so the puts evict
+template<typename Cache>
+Result measure(size_t entries, const std::vector<std::string>& keys, const Value& payload, size_t operations) {
+    Result result;
+    size_t before = liveBytes.load();
+    auto cache = std::make_unique<Cache>(entries);
+    for (size_t i = 0; i < entries; ++i) {
+        cache->put(keys[i], payload);
+    }
+    result.bytesPerEntry = static_cast<double>(liveBytes.load() - before) / entries;
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> pick(0, keys.size() - 1);
+    size_t hits = 0;
+    Value value;
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < operations; ++i) {
+        const std::string& key = keys[pick(rng)];
+        if (i % 10 == 0) {
+            if (!cache->get(key, value)) {
+                cache->put(key, payload);
+            }
+        } else {
+            hits += cache->get(key, value) ? 1 : 0;
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    result.opsPerSecond = (operations + (hits == 0 ? 1 : 0)) / elapsed;  // Keep the gets observable
+    return result;
+}
+
+int main(int argc, char** argv) {
+    size_t operations = argc > 1 ? std::stoul(argv[1]) : 2000000;
+    size_t maxEntries = argc > 2 ? std::stoul(argv[2]) : 1000000;
+
+    auto payload = std::make_shared<const std::string>(4096, 'x');
+    std::cout << "=== Cache Layout Benchmark (std::string keys, shared 4 KiB values, LRU) ===" << std::endl;
+    std::cout << std::left << std::setw(10) << "entries"
+              << std::right << std::setw(14) << "node B/entry" << std::setw(15) << "arena B/entry"
+              << std::setw(14) << "node ops/s" << std::setw(15) << "arena ops/s" << std::setw(10) << "speedup"
+              << std::endl;
+    for (size_t entries = 1000; entries <= maxEntries; entries *= 10) {
+        std::vector<std::string> keys;
+        keys.reserve(entries * 2);
+        for (size_t i = 0; i < entries * 2; ++i) {
+            keys.push_back("/data/dir_" + std::to_string(i % 97) + "/file_" + std::to_string(i) + ".dat");
+        }
+        Result node = measure<NodeLru>(entries, keys, payload, operations);
+        Result arena = measure<ArenaLru>(entries, keys, payload, operations);
+        std::cout << std::left << std::setw(10) << entries
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << node.bytesPerEntry << std::setw(15) << arena.bytesPerEntry
+                  << std::setprecision(0) << std::setw(14) << node.opsPerSecond << std::setw(15)
+                  << arena.opsPerSecond << std::setw(9) << std::setprecision(2)
+                  << arena.opsPerSecond / node.opsPerSecond << "x" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+// Concurrent cache read scaling: reads/sec from 1 to 64 threads for a hot
+// working set that fits in the cache, comparing the original get path
+// (shared shard lock, then exclusive manager and policy locks on every read)
+// against ConcurrentCacheManager::get, which serves hits under shared locks
+// and buffers the recency updates.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cache/enhanced_cache.hpp"
+#include "threading/concurrent_cache.hpp"
+
+using mtfs::cache::CacheManager;
+using mtfs::cache::CachePolicy;
+using mtfs::threading::ConcurrentCacheManager;
+
+constexpr size_t SHARDS = 16;
+constexpr size_t KEYS = 4096;
+
+// The read path as it was: every hit reorders the policy under exclusive locks
+class ExclusiveReadCache {
+public:
+    ExclusiveReadCache(size_t capacity, CachePolicy policy) {
+        for (size_t i = 0; i < SHARDS; ++i) {
+            shards.push_back(std::make_unique<Shard>(capacity / SHARDS, policy));
+        }
+    }
+
+    void put(const std::string& key, const std::string& value) {
+        auto& shard = shardFor(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.cache.put(key, value);
+    }
+
+    std::string get(const std::string& key) {
+        auto& shard = shardFor(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        return shard.cache.get(key);
+    }
+
+private:
+    struct Shard {
+        Shard(size_t capacity, CachePolicy policy) : cache(capacity, policy) {}
+        CacheManager<std::string, std::string> cache;
+        std::shared_mutex mutex;
+    };
+
+    Shard& shardFor(const std::string& key) { return *shards[std::hash<std::string>()(key) % SHARDS]; }
+
+    std::vector<std::unique_ptr<Shard>> shards;
+};
+
+template<typename Cache>
+double measure(Cache& cache, const std::vector<std::string>& keys, size_t threads,
+               std::chrono::milliseconds duration) {
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> totalReads{0};
+
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < threads; ++t) {
+        readers.emplace_back([&, t]() {
+            std::mt19937 rng(static_cast<unsigned>(t + 1));
+            std::uniform_int_distribution<size_t> pick(0, keys.size() - 1);
+            size_t reads = 0;
+            size_t bytes = 0;
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            while (!stop.load(std::memory_order_relaxed)) {
+                bytes += cache.get(keys[pick(rng)]).size();
+                ++reads;
+            }
+            totalReads += reads + (bytes == 0 ? 1 : 0);  // Keep the reads observable
+        });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(duration);
+    stop.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return totalReads.load() / elapsed;
+}
+
+int main(int argc, char** argv) {
+    auto duration = std::chrono::milliseconds(argc > 1 ? std::stoul(argv[1]) : 300);
+    size_t maxThreads = argc > 2 ? std::stoul(argv[2]) : 64;
+
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < KEYS; ++i) {
+        keys.push_back("/data/hot/file_" + std::to_string(i) + ".dat");
+    }
+
+    std::cout << "=== Concurrent Cache Read Benchmark (" << KEYS << " hot keys, "
+              << std::thread::hardware_concurrency() << " hardware threads) ===" << std::endl;
+
+    for (auto policy : {CachePolicy::LRU, CachePolicy::LFU}) {
+        std::string policyName = policy == CachePolicy::LRU ? "LRU" : "LFU";
+        ExclusiveReadCache exclusive(KEYS * 2, policy);
+        ConcurrentCacheManager<std::string, std::string> buffered(KEYS * 2, policy, SHARDS);
+        for (const auto& key : keys) {
+            exclusive.put(key, std::string(64, 'x'));
+            buffered.put(key, std::string(64, 'x'));
+        }
+
+        std::cout << "\n" << policyName << " policy" << std::endl;
+        std::cout << std::left << std::setw(10) << "threads"
+                  << std::right << std::setw(18) << "exclusive reads/s"
+                  << std::setw(18) << "buffered reads/s" << std::setw(10) << "speedup" << std::endl;
+        for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+            double before = measure(exclusive, keys, threads, duration);
+            double after = measure(buffered, keys, threads, duration);
+            std::cout << std::left << std::setw(10) << threads
+                      << std::right << std::fixed << std::setprecision(0)
+                      << std::setw(18) << before << std::setw(18) << after
+                      << std::setw(9) << std::setprecision(2) << after / before << "x" << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,458 @@
+#include "harness.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace mtfs::bench {
+
+namespace {
+
+constexpr int FORMAT_VERSION = 1;
+
+// Two-sided 95% critical values of Student's t for 1-30 degrees of freedom
+constexpr double T_95[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                           2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                           2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+
+double tCritical(size_t degreesOfFreedom) {
+    constexpr size_t tabulated = sizeof(T_95) / sizeof(T_95[0]);
+    return degreesOfFreedom <= tabulated ? T_95[degreesOfFreedom - 1] : 1.960;
+}
+
+// splitmix64, so neighbouring seeds give unrelated streams
+uint64_t mixSeed(uint64_t value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+std::string quoted(const std::string& text) {
+    std::ostringstream out;
+    out << '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec;
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+std::string number(double value) {
+    if (!std::isfinite(value)) {
+        return "null";
+    }
+    std::ostringstream out;
+    out << std::setprecision(10) << value;
+    return out.str();
+}
+
+std::string compilerName() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_VER);
+#else
+    return "unknown";
+#endif
+}
+
+std::string platformName() {
+#if defined(_WIN32)
+    return "windows";
+#elif defined(__APPLE__)
+    return "macos";
+#elif defined(__linux__)
+    return "linux";
+#else
+    return "unknown";
+#endif
+}
+
+// Just enough JSON to read back a results file
+struct Json {
+    enum class Type { Null, Bool, Number, String, Array, Object } type{Type::Null};
+    double value{0};
+    std::string text;
+    std::vector<Json> items;
+    std::vector<std::pair<std::string, Json>> fields;
+
+    const Json* field(const std::string& name) const {
+        for (const auto& [key, item] : fields) {
+            if (key == name) {
+                return &item;
+            }
+        }
+        return nullptr;
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& input) : input(input) {}
+
+    Json parse() {
+        Json root = parseValue();
+        skipSpace();
+        if (position != input.size()) {
+            fail("trailing characters");
+        }
+        return root;
+    }
+
+private:
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("Malformed JSON at offset " + std::to_string(position) + ": " + what);
+    }
+
+    void skipSpace() {
+        while (position < input.size() && std::isspace(static_cast<unsigned char>(input[position]))) {
+            ++position;
+        }
+    }
+
+    void expect(char c) {
+        skipSpace();
+        if (position >= input.size() || input[position] != c) {
+            fail(std::string("expected '") + c + "'");
+        }
+        ++position;
+    }
+
+    bool consume(const char* literal) {
+        size_t length = std::char_traits<char>::length(literal);
+        if (input.compare(position, length, literal) == 0) {
+            position += length;
+            return true;
+        }
+        return false;
+    }
+
+    Json parseValue() {
+        skipSpace();
+        if (position >= input.size()) {
+            fail("unexpected end");
+        }
+        Json result;
+        char c = input[position];
+        if (c == '{') {
+            result.type = Json::Type::Object;
+            ++position;
+            skipSpace();
+            if (position < input.size() && input[position] == '}') {
+                ++position;
+                return result;
+            }
+            do {
+                skipSpace();
+                std::string key = parseString();
+                expect(':');
+                result.fields.emplace_back(std::move(key), parseValue());
+                skipSpace();
+            } while (position < input.size() && input[position] == ',' && ++position);
+            expect('}');
+        } else if (c == '[') {
+            result.type = Json::Type::Array;
+            ++position;
+            skipSpace();
+            if (position < input.size() && input[position] == ']') {
+                ++position;
+                return result;
+            }
+            do {
+                result.items.push_back(parseValue());
+                skipSpace();
+            } while (position < input.size() && input[position] == ',' && ++position);
+            expect(']');
+        } else if (c == '"') {
+            result.type = Json::Type::String;
+            result.text = parseString();
+        } else if (consume("true")) {
+            result.type = Json::Type::Bool;
+            result.value = 1;
+        } else if (consume("false")) {
+            result.type = Json::Type::Bool;
+        } else if (consume("null")) {
+            result.type = Json::Type::Null;
+        } else {
+            size_t used = 0;
+            try {
+                result.value = std::stod(input.substr(position, 32), &used);
+            } catch (const std::exception&) {
+                fail("expected a value");
+            }
+            result.type = Json::Type::Number;
+            position += used;
+        }
+        return result;
+    }
+
+    std::string parseString() {
+        if (position >= input.size() || input[position] != '"') {
+            fail("expected a string");
+        }
+        ++position;
+        std::string text;
+        while (position < input.size() && input[position] != '"') {
+            char c = input[position++];
+            if (c == '\\' && position < input.size()) {
+                char escaped = input[position++];
+                switch (escaped) {
+                    case 'n': text += '\n'; break;
+                    case 't': text += '\t'; break;
+                    case 'u':
+                        // Only produced for control characters, which ids never hold
+                        text += static_cast<char>(std::stoi(input.substr(position, 4), nullptr, 16));
+                        position += 4;
+                        break;
+                    default: text += escaped;
+                }
+            } else {
+                text += c;
+            }
+        }
+        if (position >= input.size()) {
+            fail("unterminated string");
+        }
+        ++position;
+        return text;
+    }
+
+    const std::string& input;
+    size_t position{0};
+};
+
+} // namespace
+
+ZipfGenerator::ZipfGenerator(size_t n, double skew, uint64_t seed) : cdf(std::max<size_t>(n, 1)), rng(seed) {
+    double sum = 0;
+    for (size_t rank = 0; rank < cdf.size(); ++rank) {
+        sum += 1.0 / std::pow(static_cast<double>(rank + 1), skew);
+        cdf[rank] = sum;
+    }
+    for (double& value : cdf) {
+        value /= sum;
+    }
+}
+
+size_t ZipfGenerator::next() {
+    auto it = std::lower_bound(cdf.begin(), cdf.end(), unit(rng));
+    return std::min(static_cast<size_t>(it - cdf.begin()), cdf.size() - 1);
+}
+
+SizeDistribution::SizeDistribution(const std::string& name) : distribution(name) {
+    if (name != "small" && name != "mixed" && name != "large") {
+        throw std::invalid_argument("Unknown size distribution: " + name);
+    }
+}
+
+size_t SizeDistribution::next(std::mt19937_64& rng) {
+    if (distribution == "small") {
+        return std::uniform_int_distribution<size_t>(256, 8 << 10)(rng);
+    }
+    if (distribution == "mixed") {
+        double size = std::lognormal_distribution<double>(std::log(16384.0), 1.5)(rng);
+        return static_cast<size_t>(std::clamp(size, 64.0, 4194304.0));
+    }
+    return 1 << 20;
+}
+
+Summary Summary::of(const std::vector<double>& samples) {
+    Summary summary;
+    if (samples.empty()) {
+        return summary;
+    }
+    double sum = 0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    summary.mean = sum / samples.size();
+    summary.min = *std::min_element(samples.begin(), samples.end());
+    summary.max = *std::max_element(samples.begin(), samples.end());
+    if (samples.size() > 1) {
+        double squares = 0;
+        for (double sample : samples) {
+            squares += (sample - summary.mean) * (sample - summary.mean);
+        }
+        summary.stddev = std::sqrt(squares / (samples.size() - 1));
+        summary.ci95 = tCritical(samples.size() - 1) * summary.stddev / std::sqrt(static_cast<double>(samples.size()));
+    }
+    return summary;
+}
+
+Harness::Harness(Options options) : config(std::move(options)) {
+    config.repetitions = std::max<size_t>(config.repetitions, 1);
+}
+
+std::string Harness::caseId(const std::string& workload, const Params& params) {
+    std::string id = workload;
+    for (const auto& [key, value] : params) {
+        id += "/" + key + "=" + value;
+    }
+    return id;
+}
+
+bool Harness::selected(const std::string& workload, const Params& params) const {
+    return config.filter.empty() || caseId(workload, params).find(config.filter) != std::string::npos;
+}
+
+void Harness::run(const std::string& workload, const Params& params, const Body& body) {
+    if (!selected(workload, params)) {
+        return;
+    }
+    CaseResult result;
+    result.id = caseId(workload, params);
+    result.workload = workload;
+    result.params = params;
+
+    common::LatencyHistogram latency;
+    std::vector<double> bandwidth;
+    size_t total = config.warmup + config.repetitions;
+    for (size_t index = 0; index < total; ++index) {
+        if (index == config.warmup) {
+            latency.reset();
+        }
+        Repetition repetition{index, mixSeed(config.seed ^ std::hash<std::string>()(result.id) ^ mixSeed(index)),
+                              latency};
+        RunResult run = body(repetition);
+        if (index < config.warmup) {
+            continue;
+        }
+        double seconds = std::max(run.seconds, 1e-9);
+        result.samples.push_back(run.operations / seconds);
+        bandwidth.push_back(run.bytes / seconds / (1 << 20));
+        for (const auto& [name, value] : run.counters) {
+            result.counters[name] += value / config.repetitions;
+        }
+    }
+    result.throughput = Summary::of(result.samples);
+    result.bandwidth = Summary::of(bandwidth);
+    result.latency = latency.snapshot();
+    cases.push_back(std::move(result));
+}
+
+void Harness::writeJson(const std::string& path) const {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot write " + path);
+    }
+    char timestamp[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    auto summary = [](const Summary& s) {
+        return "{\"mean\": " + number(s.mean) + ", \"stddev\": " + number(s.stddev) + ", \"ci95\": " +
+               number(s.ci95) + ", \"min\": " + number(s.min) + ", \"max\": " + number(s.max) + "}";
+    };
+
+    out << "{\n";
+    out << "  \"format\": " << FORMAT_VERSION << ",\n";
+    out << "  \"timestamp\": " << quoted(timestamp) << ",\n";
+    out << "  \"host\": {\"platform\": " << quoted(platformName()) << ", \"compiler\": " << quoted(compilerName())
+#ifdef NDEBUG
+        << ", \"optimized\": true"
+#else
+        << ", \"optimized\": false"
+#endif
+        << ", \"hardware_threads\": " << std::thread::hardware_concurrency() << "},\n";
+    out << "  \"options\": {\"warmup\": " << config.warmup << ", \"repetitions\": " << config.repetitions
+        << ", \"seed\": " << config.seed << ", \"scale\": " << number(config.scale)
+        << ", \"filter\": " << quoted(config.filter) << "},\n";
+    out << "  \"results\": [";
+    for (size_t i = 0; i < cases.size(); ++i) {
+        const CaseResult& c = cases[i];
+        out << (i ? "," : "") << "\n    {\n";
+        out << "      \"id\": " << quoted(c.id) << ",\n";
+        out << "      \"workload\": " << quoted(c.workload) << ",\n";
+        out << "      \"params\": {";
+        for (size_t p = 0; p < c.params.size(); ++p) {
+            out << (p ? ", " : "") << quoted(c.params[p].first) << ": " << quoted(c.params[p].second);
+        }
+        out << "},\n";
+        out << "      \"unit\": \"ops/s\",\n";
+        out << "      \"samples\": [";
+        for (size_t s = 0; s < c.samples.size(); ++s) {
+            out << (s ? ", " : "") << number(c.samples[s]);
+        }
+        out << "],\n";
+        out << "      \"throughput\": " << summary(c.throughput) << ",\n";
+        out << "      \"mib_per_second\": " << summary(c.bandwidth) << ",\n";
+        out << "      \"latency_ns\": {\"count\": " << c.latency.count() << ", \"mean\": " << number(c.latency.mean())
+            << ", \"p50\": " << c.latency.percentile(50) << ", \"p90\": " << c.latency.percentile(90)
+            << ", \"p99\": " << c.latency.percentile(99) << ", \"p999\": " << c.latency.percentile(99.9)
+            << ", \"max\": " << c.latency.max() << "},\n";
+        out << "      \"counters\": {";
+        size_t n = 0;
+        for (const auto& [name, value] : c.counters) {
+            out << (n++ ? ", " : "") << quoted(name) << ": " << number(value);
+        }
+        out << "}\n    }";
+    }
+    out << "\n  ]\n}\n";
+    if (!out) {
+        throw std::runtime_error("Failed writing " + path);
+    }
+}
+
+std::vector<Comparison> Harness::compare(const std::string& baselinePath, double thresholdPercent) const {
+    std::ifstream in(baselinePath);
+    if (!in) {
+        throw std::runtime_error("Cannot read baseline " + baselinePath);
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string text = buffer.str();
+    Json root = JsonParser(text).parse();
+    const Json* entries = root.field("results");
+    if (!entries || entries->type != Json::Type::Array) {
+        throw std::runtime_error("Baseline has no results: " + baselinePath);
+    }
+
+    std::vector<Comparison> comparisons;
+    for (const CaseResult& current : cases) {
+        for (const Json& entry : entries->items) {
+            const Json* id = entry.field("id");
+            const Json* throughput = entry.field("throughput");
+            if (!id || id->text != current.id || !throughput) {
+                continue;
+            }
+            const Json* mean = throughput->field("mean");
+            const Json* ci95 = throughput->field("ci95");
+            if (!mean || mean->type != Json::Type::Number || mean->value <= 0) {
+                break;
+            }
+            Comparison comparison;
+            comparison.id = current.id;
+            comparison.baseline = mean->value;
+            comparison.current = current.throughput.mean;
+            comparison.changePercent = (comparison.current / comparison.baseline - 1.0) * 100.0;
+            double baselineLow = mean->value - (ci95 ? ci95->value : 0);
+            double currentHigh = current.throughput.mean + current.throughput.ci95;
+            comparison.regressed = comparison.changePercent < -thresholdPercent && currentHigh < baselineLow;
+            comparisons.push_back(comparison);
+            break;
+        }
+    }
+    return comparisons;
+}
+
+} // namespace mtfs::bench
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/metrics.hpp"
+
+namespace mtfs::bench {
+
+// How every case is run. A case runs `warmup` unmeasured repetitions, then
+// `repetitions` measured ones, each with its own seed derived from `seed`.
+struct Options {
+    size_t warmup{1};
+    size_t repetitions{5};
+    uint64_t seed{42};
+    double scale{1.0};   // Multiplies each workload's operation count
+    std::string filter;  // Only cases whose id contains this
+};
+
+// Zipf(skew) ranks over [0, n): rank 0 is the most popular. Sampled by
+// inverting a precomputed CDF, so a draw is one binary search.
+class ZipfGenerator {
+public:
+    ZipfGenerator(size_t n, double skew, uint64_t seed);
+    size_t next();
+
+private:
+    std::vector<double> cdf;
+    std::mt19937_64 rng;
+    std::uniform_real_distribution<double> unit{0.0, 1.0};
+};
+
+// Named file size distributions:
+//   small  uniform 256 B - 8 KiB
+//   mixed  log-normal around 16 KiB, clamped to 64 B - 4 MiB
+//   large  1 MiB
+class SizeDistribution {
+public:
+    explicit SizeDistribution(const std::string& name);  // Throws std::invalid_argument
+    size_t next(std::mt19937_64& rng);
+    const std::string& name() const { return distribution; }
+
+private:
+    std::string distribution;
+};
+
+// What one repetition did; `seconds` covers the measured section only
+struct RunResult {
+    double operations{0};
+    double bytes{0};
+    double seconds{0};
+    std::map<std::string, double> counters;  // Averaged over repetitions
+};
+
+// Mean with a 95% confidence half-width (Student's t) over repetitions
+struct Summary {
+    double mean{0};
+    double stddev{0};
+    double ci95{0};
+    double min{0};
+    double max{0};
+
+    static Summary of(const std::vector<double>& samples);
+};
+
+// Passed to each repetition. Operations time themselves into `latency`.
+struct Repetition {
+    size_t index;  // 0-based; warmup repetitions come first
+    uint64_t seed;
+    common::LatencyHistogram& latency;
+};
+
+using Params = std::vector<std::pair<std::string, std::string>>;
+using Body = std::function<RunResult(Repetition&)>;
+
+struct CaseResult {
+    std::string id;        // workload/key=value/...
+    std::string workload;
+    Params params;
+    std::vector<double> samples;  // Operations per second, one per repetition
+    Summary throughput;           // Operations per second
+    Summary bandwidth;            // MiB per second; zero when no bytes moved
+    common::HistogramSnapshot latency;  // Measured repetitions merged
+    std::map<std::string, double> counters;
+};
+
+// Result of comparing a case against the same id in a baseline file
+struct Comparison {
+    std::string id;
+    double baseline{0};
+    double current{0};
+    double changePercent{0};  // Positive is faster
+    bool regressed{false};
+};
+
+class Harness {
+public:
+    explicit Harness(Options options);
+
+    bool selected(const std::string& workload, const Params& params) const;
+
+    // Runs the case if the filter selects it. `body` runs once per
+    // repetition, warmups included.
+    void run(const std::string& workload, const Params& params, const Body& body);
+
+    const std::vector<CaseResult>& results() const { return cases; }
+    const Options& options() const { return config; }
+
+    // Machine-readable results, with the options and host they came from
+    void writeJson(const std::string& path) const;
+
+    // A case regresses when its mean is more than `thresholdPercent` slower
+    // than the baseline and the two 95% intervals do not overlap, so noise
+    // alone does not fail the gate. Cases missing on either side are skipped.
+    std::vector<Comparison> compare(const std::string& baselinePath, double thresholdPercent) const;
+
+    static std::string caseId(const std::string& workload, const Params& params);
+
+private:
+    Options config;
+    std::vector<CaseResult> cases;
+};
+
+} // namespace mtfs::bench
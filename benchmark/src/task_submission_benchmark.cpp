@@ -0,0 +1,183 @@
+// Task submission microbenchmark: tasks/sec and heap allocations per task for
+// tiny tasks, comparing the original ThreadPool::enqueue implementation
+// (shared_ptr<packaged_task> + std::bind + std::function behind one mutex)
+// against the current pool in both scheduling modes.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <queue>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "threading/thread_pool.hpp"
+
+// Count every global allocation so the report can show allocations per task
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// The pool as it was before allocation-free submission
+class LegacyThreadPool {
+public:
+    explicit LegacyThreadPool(size_t numThreads) {
+        for (size_t i = 0; i < numThreads; ++i) {
+            workers.emplace_back([this]() {
+                for (;;) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(queueMutex);
+                        condition.wait(lock, [this]() { return stop || !tasks.empty(); });
+                        if (stop && tasks.empty()) return;
+                        task = std::move(tasks.front());
+                        tasks.pop();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+
+    ~LegacyThreadPool() {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            stop = true;
+        }
+        condition.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    template<class F, class... Args>
+    auto enqueue(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>> {
+        using return_type = std::invoke_result_t<F, Args...>;
+        auto task = std::make_shared<std::packaged_task<return_type()>>(
+            std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+        std::future<return_type> res = task->get_future();
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            tasks.emplace([task]() { (*task)(); });
+        }
+        condition.notify_one();
+        return res;
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex queueMutex;
+    std::condition_variable condition;
+    bool stop{false};
+};
+
+struct Result {
+    double tasksPerSecond;
+    double allocationsPerTask;
+};
+
+// Submit `count` tiny tasks from this thread in chunks, then drain the futures
+template<typename Pool>
+Result runExternal(Pool& pool, size_t count) {
+    const size_t chunk = 1024;
+    std::vector<std::future<size_t>> futures;
+    futures.reserve(chunk);
+    size_t checksum = 0;
+
+    size_t allocationsBefore = g_allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t done = 0; done < count; done += chunk) {
+        futures.clear();
+        for (size_t i = 0; i < chunk; ++i) {
+            futures.push_back(pool.enqueue([](size_t value) { return value + 1; }, i));
+        }
+        for (auto& future : futures) {
+            checksum += future.get();
+        }
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t allocations = g_allocations.load() - allocationsBefore;
+
+    if (checksum == 0) std::cout << "";  // Keep the work observable
+    return {count / elapsed, static_cast<double>(allocations) / count};
+}
+
+// Fan-out from inside pool tasks, the pattern used by batchCopyWithProgressAsync
+Result runNested(mtfs::threading::ThreadPool& pool, size_t count) {
+    const size_t outerTasks = 64;
+    const size_t innerTasks = count / outerTasks;
+
+    size_t allocationsBefore = g_allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<size_t>> outer;
+    for (size_t o = 0; o < outerTasks; ++o) {
+        outer.push_back(pool.enqueue([&pool, innerTasks]() {
+            std::vector<std::future<size_t>> inner;
+            inner.reserve(innerTasks);
+            for (size_t i = 0; i < innerTasks; ++i) {
+                inner.push_back(pool.enqueue([](size_t value) { return value; }, i));
+            }
+            size_t sum = 0;
+            for (auto& future : inner) {
+                pool.waitFor(future);
+                sum += future.get();
+            }
+            return sum;
+        }));
+    }
+    for (auto& future : outer) {
+        future.get();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t allocations = g_allocations.load() - allocationsBefore;
+    size_t total = outerTasks * (innerTasks + 1);
+    return {total / elapsed, static_cast<double>(allocations) / total};
+}
+
+void printRow(const std::string& name, const Result& result) {
+    std::cout << std::left << std::setw(34) << name
+              << std::right << std::setw(14) << std::fixed << std::setprecision(0) << result.tasksPerSecond
+              << std::setw(14) << std::setprecision(2) << result.allocationsPerTask << std::endl;
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 500000;
+    size_t threads = std::max(2u, std::thread::hardware_concurrency());
+
+    std::cout << "=== Task Submission Benchmark (" << count << " tasks, " << threads << " threads) ===" << std::endl;
+    std::cout << std::left << std::setw(34) << "Configuration"
+              << std::right << std::setw(14) << "tasks/sec" << std::setw(14) << "allocs/task" << std::endl;
+
+    {
+        LegacyThreadPool pool(threads);
+        runExternal(pool, count / 10);  // Warm up
+        printRow("legacy enqueue (external)", runExternal(pool, count));
+    }
+
+    using mtfs::threading::SchedulingMode;
+    using mtfs::threading::ThreadPool;
+    for (auto mode : {SchedulingMode::SHARED_QUEUE, SchedulingMode::WORK_STEALING}) {
+        std::string name = mode == SchedulingMode::SHARED_QUEUE ? "shared queue" : "work stealing";
+        ThreadPool pool(threads, mode);
+        runExternal(pool, count / 10);
+        printRow(name + " (external)", runExternal(pool, count));
+        runNested(pool, count);  // Warm up to the full working set of queued tasks
+        printRow(name + " (nested)", runNested(pool, count));
+    }
+    return 0;
+}
@@ -1,14 +1,18 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <optional>
 #include <list>
 #include <unordered_map>
 #include <unordered_set>
-#include <queue>
-#include <stack>
 #include <chrono>
+#include <functional>
+#include <type_traits>
 #include "common/error.hpp"
+#include "cache/slot_arena.hpp"
 
 namespace mtfs::cache {
 
@@ -17,7 +21,94 @@ enum class CachePolicy {
     LRU,  // Least Recently Used
     LFU,  // Least Frequently Used
     FIFO, // First In First Out
-    LIFO  // Last In First Out
+    LIFO, // Last In First Out
+    ARC   // Adaptive Replacement Cache (scan resistant)
+};
+
+// How cache capacity is measured
+enum class CapacityMode {
+    ENTRIES, // Capacity is a number of entries
+    BYTES    // Capacity is a byte budget; entries are sized by a weigher
+};
+
+// Estimates how many bytes an entry keeps resident
+template<typename Key, typename Value>
+using Weigher = std::function<size_t(const Key&, const Value&)>;
+
+namespace detail {
+
+template<typename T, typename = void>
+struct HasContiguousSize : std::false_type {};
+
+template<typename T>
+struct HasContiguousSize<T, std::void_t<decltype(std::declval<const T&>().size()),
+                                        typename T::value_type>> : std::true_type {};
+
+template<typename T>
+size_t payloadBytes(const T& value);
+
+// Shared buffers are charged for what they point at; readers holding the
+// same buffer do not add to it
+template<typename T>
+size_t payloadBytes(const std::shared_ptr<T>& value) {
+    return sizeof(value) + (value ? payloadBytes(*value) : 0);
+}
+
+template<typename T>
+size_t payloadBytes(const T& value) {
+    if constexpr (HasContiguousSize<T>::value) {
+        return sizeof(T) + value.size() * sizeof(typename T::value_type);
+    } else {
+        return sizeof(T);
+    }
+}
+
+} // namespace detail
+
+// Default weigher: object size plus the payload of string-like keys and values
+template<typename Key, typename Value>
+struct DefaultWeigher {
+    size_t operator()(const Key& key, const Value& value) const {
+        return detail::payloadBytes(key) + detail::payloadBytes(value);
+    }
+};
+
+// Capacity limit and resident byte accounting shared by all cache policies
+template<typename Key, typename Value>
+class CacheBudget {
+public:
+    CacheBudget(size_t limit, CapacityMode mode, Weigher<Key, Value> weigher)
+        : limit(limit), mode(mode),
+          weigher(weigher ? std::move(weigher) : Weigher<Key, Value>(DefaultWeigher<Key, Value>())) {}
+
+    size_t weigh(const Key& key, const Value& value) const { return weigher(key, value); }
+
+    // False when an entry could never fit, even in an otherwise empty cache
+    bool admits(size_t weight) const {
+        return limit > 0 && (mode == CapacityMode::ENTRIES || weight <= limit);
+    }
+
+    // True while `entries` resident entries leave no room for `incomingWeight` more bytes
+    bool needsRoom(size_t entries, size_t incomingWeight) const {
+        if (mode == CapacityMode::ENTRIES) {
+            return entries >= limit;
+        }
+        return entries > 0 && resident + incomingWeight > limit;
+    }
+
+    void charge(size_t weight) { resident += weight; }
+    void release(size_t weight) { resident -= std::min(weight, resident); }
+    void reset() { resident = 0; }
+
+    size_t capacity() const { return limit; }
+    CapacityMode capacityMode() const { return mode; }
+    size_t residentBytes() const { return resident; }
+
+private:
+    size_t limit;
+    CapacityMode mode;
+    Weigher<Key, Value> weigher;
+    size_t resident{0};
 };
 
 // Cache entry with metadata
@@ -26,9 +117,11 @@ struct CacheEntry {
     Key key;
     Value value;
     size_t accessCount{0};
+    size_t weight{0};  // Bytes charged against the cache budget
     std::chrono::system_clock::time_point lastAccessed;
     std::chrono::system_clock::time_point createdAt;
     bool isPinned{false};
+    bool prefetched{false};  // Loaded speculatively and not used since
     
     CacheEntry() : lastAccessed(std::chrono::system_clock::now()),
                    createdAt(std::chrono::system_clock::now()) {}
@@ -58,7 +151,11 @@ struct CacheStatistics {
     size_t totalAccesses{0};
     size_t pinnedItems{0};
     size_t prefetchedItems{0};
+    size_t prefetchHits{0};   // First uses of prefetched entries
+    size_t currentSize{0};    // Resident entries
+    size_t residentBytes{0};  // Bytes charged by the weigher
     double hitRate{0.0};
+    double prefetchHitRate{0.0};  // Share of prefetched entries used before leaving
     std::chrono::system_clock::time_point lastResetTime;
     
     CacheStatistics() : lastResetTime(std::chrono::system_clock::now()) {}
@@ -66,6 +163,7 @@ struct CacheStatistics {
     void updateHitRate() {
         totalAccesses = hits + misses;
         hitRate = totalAccesses > 0 ? (static_cast<double>(hits) / totalAccesses) * 100.0 : 0.0;
+        prefetchHitRate = prefetchedItems > 0 ? (static_cast<double>(prefetchHits) / prefetchedItems) * 100.0 : 0.0;
     }
 };
 
@@ -82,6 +180,7 @@ public:
     virtual void clear() = 0;
     virtual size_t size() const = 0;
     virtual size_t capacity() const = 0;
+    virtual CapacityMode capacityMode() const = 0;
     virtual CacheStatistics getStatistics() const = 0;
     virtual void resetStatistics() = 0;
     
@@ -90,14 +189,26 @@ public:
     virtual void unpin(const Key& key) = 0;
     virtual bool isPinned(const Key& key) const = 0;
     virtual void prefetch(const Key& key, const Value& value) = 0;
+    // A speculative load that only uses free room: nothing resident is
+    // evicted or replaced. False if the key was not admitted.
+    virtual bool prefetchIfRoom(const Key& key, const Value& value) = 0;
     virtual std::vector<Key> getKeys() const = 0;
+    // Each resident key with the hits it has had, in getKeys() order
+    virtual std::vector<std::pair<Key, size_t>> getAccessCounts() const = 0;
+    
+    // Read path for concurrent callers: peek() looks a value up under a shared
+    // lock without touching recency or statistics, and touch() later applies
+    // the hits they stood for in one batch. Keys no longer cached are skipped.
+    virtual std::optional<Value> peek(const Key& key) const = 0;
+    virtual void touch(const Key* keys, size_t count) = 0;
 };
 
 // Enhanced LRU Cache
 template<typename Key, typename Value>
 class EnhancedLRUCache : public CacheInterface<Key, Value> {
 public:
-    explicit EnhancedLRUCache(size_t capacity);
+    explicit EnhancedLRUCache(size_t capacity, CapacityMode mode = CapacityMode::ENTRIES,
+                   Weigher<Key, Value> weigher = nullptr);
     
     void put(const Key& key, const Value& value) override;
     Value get(const Key& key) override;
@@ -106,6 +217,7 @@ public:
     void clear() override;
     size_t size() const override;
     size_t capacity() const override;
+    CapacityMode capacityMode() const override;
     CacheStatistics getStatistics() const override;
     void resetStatistics() override;
     
@@ -114,29 +226,40 @@ public:
     void unpin(const Key& key) override;
     bool isPinned(const Key& key) const override;
     void prefetch(const Key& key, const Value& value) override;
+    bool prefetchIfRoom(const Key& key, const Value& value) override;
     std::vector<Key> getKeys() const override;
+    std::vector<std::pair<Key, size_t>> getAccessCounts() const override;
+    std::optional<Value> peek(const Key& key) const override;
+    void touch(const Key* keys, size_t count) override;
 
 private:
-    using EntryType = CacheEntry<Key, Value>;
-    using EntryList = std::list<EntryType>;
-    using EntryMap = std::unordered_map<Key, typename EntryList::iterator>;
+    using Arena = SlotArena<Key, Value>;
+    using Index = typename Arena::Index;
     
-    void evict();
-    void moveToFront(typename EntryList::iterator it);
+    bool evict();
+    void makeRoom(size_t weight, Index keep = Arena::NIL);
+    void removeLocked(const Key& key);
+    void recordAccess(Index index);
     
-    const size_t maxCapacity;
-    EntryList entries;
-    EntryMap lookup;
-    std::unordered_set<Key> pinnedKeys;
-    mutable std::mutex cacheMutex;
+    CacheBudget<Key, Value> budget;
+    Arena entries;  // Front is the most recently used
+    size_t pinnedCount{0};
+    mutable std::shared_mutex cacheMutex;
     mutable CacheStatistics stats;
 };
 
-// LFU Cache implementation
+// LFU Cache implementation.
+//
+// Nodes with the same use count share a bucket; buckets form a list in
+// ascending frequency order and nodes are threaded through their bucket
+// most recently used first. A hit moves the node to the neighbouring bucket
+// and eviction takes the tail of the lowest bucket, so both are O(1). The key
+// is stored once, as the map key owning the node.
 template<typename Key, typename Value>
 class LFUCache : public CacheInterface<Key, Value> {
 public:
-    explicit LFUCache(size_t capacity);
+    explicit LFUCache(size_t capacity, CapacityMode mode = CapacityMode::ENTRIES,
+                   Weigher<Key, Value> weigher = nullptr);
     
     void put(const Key& key, const Value& value) override;
     Value get(const Key& key) override;
@@ -145,6 +268,7 @@ public:
     void clear() override;
     size_t size() const override;
     size_t capacity() const override;
+    CapacityMode capacityMode() const override;
     CacheStatistics getStatistics() const override;
     void resetStatistics() override;
     
@@ -153,24 +277,53 @@ public:
     void unpin(const Key& key) override;
     bool isPinned(const Key& key) const override;
     void prefetch(const Key& key, const Value& value) override;
+    bool prefetchIfRoom(const Key& key, const Value& value) override;
     std::vector<Key> getKeys() const override;
+    std::vector<std::pair<Key, size_t>> getAccessCounts() const override;
+    std::optional<Value> peek(const Key& key) const override;
+    void touch(const Key* keys, size_t count) override;
 
 private:
-    using EntryType = CacheEntry<Key, Value>;
-    using FrequencyMap = std::unordered_map<size_t, std::list<Key>>;
-    using KeyMap = std::unordered_map<Key, EntryType>;
-    using KeyFreqMap = std::unordered_map<Key, size_t>;
-    
-    void evict();
-    void updateFrequency(const Key& key);
-    
-    const size_t maxCapacity;
-    size_t minFrequency{1};
-    FrequencyMap frequencies;
-    KeyMap keyToEntry;
-    KeyFreqMap keyToFreq;
-    std::unordered_set<Key> pinnedKeys;
-    mutable std::mutex cacheMutex;
+    struct Node;
+    
+    // All nodes sharing one use count
+    struct Bucket {
+        size_t frequency{1};
+        Node* head{nullptr};  // Most recently used
+        Node* tail{nullptr};
+    };
+    using BucketList = std::list<Bucket>;
+    
+    struct Node {
+        Value value;
+        size_t weight{0};
+        size_t accessCount{0};
+        std::chrono::system_clock::time_point lastAccessed;
+        std::chrono::system_clock::time_point createdAt;
+        bool isPinned{false};
+        bool prefetched{false};
+        const Key* key{nullptr};  // Points at the owning map's key
+        typename BucketList::iterator bucket;
+        Node* prev{nullptr};
+        Node* next{nullptr};
+    };
+    using NodeMap = std::unordered_map<Key, Node>;
+    
+    bool evict();
+    void makeRoom(size_t weight, Node* keep = nullptr);
+    void removeLocked(const Key& key);
+    void insertLocked(const Key& key, const Value& value, size_t weight);
+    void updateFrequency(Node& node);
+    void recordAccess(Node& node);
+    void eraseNode(Node& node);
+    void link(typename BucketList::iterator bucket, Node& node);
+    void unlink(Node& node);
+    
+    CacheBudget<Key, Value> budget;
+    NodeMap nodes;
+    BucketList buckets;  // Ascending frequency
+    size_t pinnedCount{0};
+    mutable std::shared_mutex cacheMutex;
     mutable CacheStatistics stats;
 };
 
@@ -178,7 +331,8 @@ private:
 template<typename Key, typename Value>
 class FIFOCache : public CacheInterface<Key, Value> {
 public:
-    explicit FIFOCache(size_t capacity);
+    explicit FIFOCache(size_t capacity, CapacityMode mode = CapacityMode::ENTRIES,
+                   Weigher<Key, Value> weigher = nullptr);
     
     void put(const Key& key, const Value& value) override;
     Value get(const Key& key) override;
@@ -187,6 +341,7 @@ public:
     void clear() override;
     size_t size() const override;
     size_t capacity() const override;
+    CapacityMode capacityMode() const override;
     CacheStatistics getStatistics() const override;
     void resetStatistics() override;
     
@@ -195,20 +350,25 @@ public:
     void unpin(const Key& key) override;
     bool isPinned(const Key& key) const override;
     void prefetch(const Key& key, const Value& value) override;
+    bool prefetchIfRoom(const Key& key, const Value& value) override;
     std::vector<Key> getKeys() const override;
+    std::vector<std::pair<Key, size_t>> getAccessCounts() const override;
+    std::optional<Value> peek(const Key& key) const override;
+    void touch(const Key* keys, size_t count) override;
 
 private:
-    using EntryType = CacheEntry<Key, Value>;
-    using EntryQueue = std::queue<Key>;
-    using EntryMap = std::unordered_map<Key, EntryType>;
+    using Arena = SlotArena<Key, Value>;
+    using Index = typename Arena::Index;
     
-    void evict();
+    bool evict();
+    void makeRoom(size_t weight, Index keep = Arena::NIL);
+    void removeLocked(const Key& key);
+    void recordAccess(Index index);
     
-    const size_t maxCapacity;
-    EntryQueue insertionOrder;
-    EntryMap entries;
-    std::unordered_set<Key> pinnedKeys;
-    mutable std::mutex cacheMutex;
+    CacheBudget<Key, Value> budget;
+    Arena entries;  // Front is the newest, back the next to go
+    size_t pinnedCount{0};
+    mutable std::shared_mutex cacheMutex;
     mutable CacheStatistics stats;
 };
 
@@ -216,7 +376,60 @@ private:
 template<typename Key, typename Value>
 class LIFOCache : public CacheInterface<Key, Value> {
 public:
-    explicit LIFOCache(size_t capacity);
+    explicit LIFOCache(size_t capacity, CapacityMode mode = CapacityMode::ENTRIES,
+                   Weigher<Key, Value> weigher = nullptr);
+    
+    void put(const Key& key, const Value& value) override;
+    Value get(const Key& key) override;
+    bool contains(const Key& key) const override;
+    void remove(const Key& key) override;
+    void clear() override;
+    size_t size() const override;
+    size_t capacity() const override;
+    CapacityMode capacityMode() const override;
+    CacheStatistics getStatistics() const override;
+    void resetStatistics() override;
+    
+    // Enhanced features
+    void pin(const Key& key) override;
+    void unpin(const Key& key) override;
+    bool isPinned(const Key& key) const override;
+    void prefetch(const Key& key, const Value& value) override;
+    bool prefetchIfRoom(const Key& key, const Value& value) override;
+    std::vector<Key> getKeys() const override;
+    std::vector<std::pair<Key, size_t>> getAccessCounts() const override;
+    std::optional<Value> peek(const Key& key) const override;
+    void touch(const Key* keys, size_t count) override;
+
+private:
+    using Arena = SlotArena<Key, Value>;
+    using Index = typename Arena::Index;
+    
+    bool evict();
+    void makeRoom(size_t weight, Index keep = Arena::NIL);
+    void removeLocked(const Key& key);
+    void recordAccess(Index index);
+    
+    CacheBudget<Key, Value> budget;
+    Arena entries;  // Front is the top of the stack
+    size_t pinnedCount{0};
+    mutable std::shared_mutex cacheMutex;
+    mutable CacheStatistics stats;
+};
+
+// Adaptive Replacement Cache (Megiddo & Modha).
+//
+// Resident entries live in T1 (seen once recently) or T2 (seen at least
+// twice). Evicted keys are remembered in the ghost lists B1 and B2, and a hit
+// on a ghost shifts the target size of T1 towards whichever list would have
+// kept it. A one-pass scan only ever passes through T1, so the frequently used
+// working set in T2 survives it. Sizes are counted in budget units: one per
+// entry in ENTRIES mode, the entry weight in BYTES mode.
+template<typename Key, typename Value>
+class ARCCache : public CacheInterface<Key, Value> {
+public:
+    explicit ARCCache(size_t capacity, CapacityMode mode = CapacityMode::ENTRIES,
+                      Weigher<Key, Value> weigher = nullptr);
     
     void put(const Key& key, const Value& value) override;
     Value get(const Key& key) override;
@@ -225,6 +438,7 @@ public:
     void clear() override;
     size_t size() const override;
     size_t capacity() const override;
+    CapacityMode capacityMode() const override;
     CacheStatistics getStatistics() const override;
     void resetStatistics() override;
     
@@ -233,20 +447,45 @@ public:
     void unpin(const Key& key) override;
     bool isPinned(const Key& key) const override;
     void prefetch(const Key& key, const Value& value) override;
+    bool prefetchIfRoom(const Key& key, const Value& value) override;
     std::vector<Key> getKeys() const override;
+    std::vector<std::pair<Key, size_t>> getAccessCounts() const override;
+    std::optional<Value> peek(const Key& key) const override;
+    void touch(const Key* keys, size_t count) override;
+    
+    // Current target size of T1 in budget units, for tests and analytics
+    size_t recencyTarget() const;
 
 private:
     using EntryType = CacheEntry<Key, Value>;
-    using EntryStack = std::stack<Key>;
-    using EntryMap = std::unordered_map<Key, EntryType>;
+    using EntryList = std::list<EntryType>;
+    using GhostList = std::list<std::pair<Key, size_t>>;  // Key and its units
     
-    void evict();
+    enum class Segment { T1, T2, B1, B2 };
     
-    const size_t maxCapacity;
-    EntryStack insertionOrder;
-    EntryMap entries;
+    struct Location {
+        Segment segment;
+        typename EntryList::iterator entry;  // Valid in T1/T2
+        typename GhostList::iterator ghost;  // Valid in B1/B2
+    };
+    
+    size_t units(size_t weight) const;
+    void insertLocked(const Key& key, const Value& value, size_t weight);
+    void adaptOnGhostHit(Segment ghost, size_t incomingUnits);
+    bool replace(bool ghostHitInB2);
+    void makeRoom(size_t incomingUnits, bool ghostHitInB2, const Key* keep = nullptr);
+    void trimGhosts();
+    void removeLocked(const Key& key);
+    void recordAccess(Location& location);
+    
+    CacheBudget<Key, Value> budget;
+    EntryList t1, t2;
+    GhostList b1, b2;
+    size_t t1Units{0}, t2Units{0}, b1Units{0}, b2Units{0};
+    size_t target{0};  // Adaptive target for t1Units
+    std::unordered_map<Key, Location> lookup;
     std::unordered_set<Key> pinnedKeys;
-    mutable std::mutex cacheMutex;
+    mutable std::shared_mutex cacheMutex;
     mutable CacheStatistics stats;
 };
 
@@ -254,7 +493,9 @@ private:
 template<typename Key, typename Value>
 class CacheManager {
 public:
-    explicit CacheManager(size_t capacity, CachePolicy policy = CachePolicy::LRU);
+    explicit CacheManager(size_t capacity, CachePolicy policy = CachePolicy::LRU,
+                          CapacityMode mode = CapacityMode::ENTRIES,
+                          Weigher<Key, Value> weigher = nullptr);
     
     // Cache operations
     void put(const Key& key, const Value& value);
@@ -262,22 +503,37 @@ public:
     bool contains(const Key& key) const;
     void remove(const Key& key);
     void clear();
+
+    // Many entries under one acquisition of the manager lock
+    void putAll(const std::vector<std::pair<Key, Value>>& entries);
+    void removeAll(const std::vector<Key>& keys);
+    
+    // Shared-lock read path, see CacheInterface::peek
+    std::optional<Value> peek(const Key& key) const;
+    void touch(const Key* keys, size_t count);
     
     // Cache management
     void setPolicy(CachePolicy policy);
     CachePolicy getPolicy() const;
     void resize(size_t newCapacity);
+    void setCapacityMode(CapacityMode mode, size_t newCapacity);
+    CapacityMode getCapacityMode() const;
+    void setWeigher(Weigher<Key, Value> newWeigher);
     
     // Enhanced features
     void pin(const Key& key);
     void unpin(const Key& key);
     bool isPinned(const Key& key) const;
     void prefetch(const Key& key, const Value& value);
+    bool prefetchIfRoom(const Key& key, const Value& value);
       // Analytics
     CacheStatistics getStatistics() const;
     void resetStatistics();
     void showCacheAnalytics() const;
     std::vector<Key> getHotKeys(size_t count = 10) const;
+    // Resident keys with their hit counts, most hit first; ties keep the
+    // policy's own order, which puts the more recently used first
+    std::vector<std::pair<Key, size_t>> getAccessCounts() const;
     
     // Hot file analytics
     void showHotFileAnalytics(size_t topCount = 10) const;
@@ -286,7 +542,9 @@ public:
     void monitorPerformance();
     
     // Maintenance
-    void warmup(const std::vector<std::pair<Key, Value>>& data);
+    // Preloads entries into free room only, like prefetchIfRoom, so it never
+    // displaces what is already cached; the number admitted
+    size_t warmup(const std::vector<std::pair<Key, Value>>& data);
     void optimizeForWorkload();
 
 private:
@@ -294,8 +552,10 @@ private:
     
     size_t cacheCapacity;
     CachePolicy currentPolicy;
+    CapacityMode capacityMode;
+    Weigher<Key, Value> weigher;
     std::unique_ptr<CacheInterface<Key, Value>> cache;
-    mutable std::mutex managerMutex;
+    mutable std::shared_mutex managerMutex;
 };
 
 } // namespace mtfs::cache
@@ -10,810 +10,1688 @@ namespace mtfs::cache {
 // ===== EnhancedLRUCache Implementation =====
 
 template<typename Key, typename Value>
-EnhancedLRUCache<Key, Value>::EnhancedLRUCache(size_t capacity) 
-    : maxCapacity(capacity) {}
+EnhancedLRUCache<Key, Value>::EnhancedLRUCache(size_t capacity, CapacityMode mode,
+                                               Weigher<Key, Value> weigher)
+    : budget(capacity, mode, std::move(weigher)) {}
 
 template<typename Key, typename Value>
 void EnhancedLRUCache<Key, Value>::put(const Key& key, const Value& value) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
     
-    auto it = lookup.find(key);
-    if (it != lookup.end()) {
-        // Update existing entry
-        it->second->value = value;
-        it->second->lastAccessed = std::chrono::system_clock::now();
-        moveToFront(it->second);
+    size_t weight = budget.weigh(key, value);
+    if (!budget.admits(weight)) {
+        // Larger than the whole budget: drop any stale copy instead of caching
+        removeLocked(key);
         return;
     }
     
-    // Add new entry
-    if (entries.size() >= maxCapacity) {
-        evict();
+    Index index = entries.find(key);
+    if (index != Arena::NIL) {
+        // Update existing entry
+        auto& entry = entries[index];
+        budget.release(entry.weight);
+        entry.value = value;
+        entry.prefetched = false;
+        entry.weight = weight;
+        entry.lastAccessed = entries.now();
+        entries.moveToFront(index);
+        makeRoom(weight, index);
+        budget.charge(weight);
+        return;
     }
     
-    entries.emplace_front(key, value);
-    lookup[key] = entries.begin();
+    // Add new entry
+    makeRoom(weight);
+    entries[entries.insert(key, value)].weight = weight;
+    budget.charge(weight);
 }
 
 template<typename Key, typename Value>
 Value EnhancedLRUCache<Key, Value>::get(const Key& key) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
     
-    auto it = lookup.find(key);
-    if (it == lookup.end()) {
+    Index index = entries.find(key);
+    if (index == Arena::NIL) {
         stats.misses++;
         stats.updateHitRate();
         throw std::runtime_error("Key not found in cache");
     }
     
-    // Update access info
-    it->second->accessCount++;
-    it->second->lastAccessed = std::chrono::system_clock::now();
-    moveToFront(it->second);
-    
-    stats.hits++;
-    stats.updateHitRate();
-    return it->second->value;
+    recordAccess(index);
+    return entries[index].value;
 }
 
 template<typename Key, typename Value>
 bool EnhancedLRUCache<Key, Value>::contains(const Key& key) const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    return lookup.find(key) != lookup.end();
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    return entries.find(key) != Arena::NIL;
 }
 
 template<typename Key, typename Value>
 void EnhancedLRUCache<Key, Value>::remove(const Key& key) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    
-    auto it = lookup.find(key);
-    if (it != lookup.end()) {
-        entries.erase(it->second);
-        lookup.erase(it);
-        pinnedKeys.erase(key);
-    }
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    removeLocked(key);
 }
 
 template<typename Key, typename Value>
 void EnhancedLRUCache<Key, Value>::clear() {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
     entries.clear();
-    lookup.clear();
-    pinnedKeys.clear();
+    pinnedCount = 0;
+    budget.reset();
 }
 
 template<typename Key, typename Value>
 size_t EnhancedLRUCache<Key, Value>::size() const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
     return entries.size();
 }
 
 template<typename Key, typename Value>
 size_t EnhancedLRUCache<Key, Value>::capacity() const {
-    return maxCapacity;
+    return budget.capacity();
+}
+
+template<typename Key, typename Value>
+CapacityMode EnhancedLRUCache<Key, Value>::capacityMode() const {
+    return budget.capacityMode();
 }
 
 template<typename Key, typename Value>
 CacheStatistics EnhancedLRUCache<Key, Value>::getStatistics() const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
     auto statsCopy = stats;
-    statsCopy.pinnedItems = pinnedKeys.size();
+    statsCopy.pinnedItems = pinnedCount;
+    statsCopy.currentSize = entries.size();
+    statsCopy.residentBytes = budget.residentBytes();
     return statsCopy;
 }
 
 template<typename Key, typename Value>
 void EnhancedLRUCache<Key, Value>::resetStatistics() {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
     stats = CacheStatistics();
 }
 
 template<typename Key, typename Value>
 void EnhancedLRUCache<Key, Value>::pin(const Key& key) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    if (lookup.find(key) != lookup.end()) {
-        pinnedKeys.insert(key);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    Index index = entries.find(key);
+    if (index != Arena::NIL && !entries[index].isPinned) {
+        entries[index].isPinned = true;
+        pinnedCount++;
     }
 }
 
 template<typename Key, typename Value>
 void EnhancedLRUCache<Key, Value>::unpin(const Key& key) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    pinnedKeys.erase(key);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    Index index = entries.find(key);
+    if (index != Arena::NIL && entries[index].isPinned) {
+        entries[index].isPinned = false;
+        pinnedCount--;
+    }
 }
 
 template<typename Key, typename Value>
 bool EnhancedLRUCache<Key, Value>::isPinned(const Key& key) const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    return pinnedKeys.find(key) != pinnedKeys.end();
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    Index index = entries.find(key);
+    return index != Arena::NIL && entries[index].isPinned;
 }
 
 template<typename Key, typename Value>
 void EnhancedLRUCache<Key, Value>::prefetch(const Key& key, const Value& value) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    
-    if (lookup.find(key) == lookup.end()) {
-        // Key doesn't exist, add it if there's space
-        if (entries.size() < maxCapacity) {
-            entries.emplace_front(key, value);
-            lookup[key] = entries.begin();
-            stats.prefetchedItems++;
-        } else {
-            // Need to evict, but treat as prefetch
-            evict();
-            entries.emplace_front(key, value);
-            lookup[key] = entries.begin();
-            stats.prefetchedItems++;
-        }
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    
+    size_t weight = budget.weigh(key, value);
+    if (!budget.admits(weight)) {
+        removeLocked(key);
+        return;
+    }
+    
+    Index index = entries.find(key);
+    if (index == Arena::NIL) {
+        // Key doesn't exist, evict as needed and add it
+        makeRoom(weight);
+        index = entries.insert(key, value);
+        entries[index].weight = weight;
     } else {
         // Key exists, update value and count as prefetch
-        auto it = lookup.find(key);
-        it->second->value = value;
-        it->second->lastAccessed = std::chrono::system_clock::now();
-        moveToFront(it->second);
-        stats.prefetchedItems++;
+        auto& entry = entries[index];
+        budget.release(entry.weight);
+        entry.value = value;
+        entry.weight = weight;
+        entry.lastAccessed = entries.now();
+        entries.moveToFront(index);
+        makeRoom(weight, index);
+    }
+    entries[index].prefetched = true;
+    budget.charge(weight);
+    stats.prefetchedItems++;
+    stats.updateHitRate();
+}
+
+template<typename Key, typename Value>
+bool EnhancedLRUCache<Key, Value>::prefetchIfRoom(const Key& key, const Value& value) {
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    
+    size_t weight = budget.weigh(key, value);
+    if (entries.find(key) != Arena::NIL || !budget.admits(weight) || budget.needsRoom(entries.size(), weight)) {
+        return false;
     }
+    // At the cold end, so later demand displaces it before anything it used
+    Index index = entries.insert(key, value, false);
+    entries[index].weight = weight;
+    entries[index].prefetched = true;
+    budget.charge(weight);
+    stats.prefetchedItems++;
+    stats.updateHitRate();
+    return true;
 }
 
 template<typename Key, typename Value>
 std::vector<Key> EnhancedLRUCache<Key, Value>::getKeys() const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
     std::vector<Key> keys;
-    for (const auto& entry : entries) {
-        keys.push_back(entry.key);
+    keys.reserve(entries.size());
+    for (Index index = entries.front(); index != Arena::NIL; index = entries[index].next) {
+        keys.push_back(entries[index].key);
     }
     return keys;
 }
 
 template<typename Key, typename Value>
-void EnhancedLRUCache<Key, Value>::evict() {
-    while (!entries.empty()) {
-        auto lastIt = std::prev(entries.end());
-        if (pinnedKeys.find(lastIt->key) == pinnedKeys.end()) {
-            lookup.erase(lastIt->key);
-            entries.erase(lastIt);
+std::vector<std::pair<Key, size_t>> EnhancedLRUCache<Key, Value>::getAccessCounts() const {
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    std::vector<std::pair<Key, size_t>> counts;
+    counts.reserve(entries.size());
+    for (Index index = entries.front(); index != Arena::NIL; index = entries[index].next) {
+        counts.emplace_back(entries[index].key, entries[index].accessCount);
+    }
+    return counts;
+}
+
+template<typename Key, typename Value>
+std::optional<Value> EnhancedLRUCache<Key, Value>::peek(const Key& key) const {
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    Index index = entries.find(key);
+    if (index == Arena::NIL) {
+        return std::nullopt;
+    }
+    return entries[index].value;
+}
+
+template<typename Key, typename Value>
+void EnhancedLRUCache<Key, Value>::touch(const Key* keys, size_t count) {
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    for (size_t i = 0; i < count; ++i) {
+        Index index = entries.find(keys[i]);
+        if (index != Arena::NIL) {
+            recordAccess(index);
+        }
+    }
+}
+
+template<typename Key, typename Value>
+void EnhancedLRUCache<Key, Value>::recordAccess(Index index) {
+    auto& entry = entries[index];
+    if (entry.prefetched) {
+        entry.prefetched = false;
+        stats.prefetchHits++;
+    }
+    entry.accessCount++;
+    entry.lastAccessed = entries.now();
+    entries.moveToFront(index);
+    
+    stats.hits++;
+    stats.updateHitRate();
+}
+
+template<typename Key, typename Value>
+bool EnhancedLRUCache<Key, Value>::evict() {
+    // Walk up from the least recently used end, skipping pinned entries
+    for (Index index = entries.back(); index != Arena::NIL; index = entries[index].prev) {
+        if (!entries[index].isPinned) {
+            budget.release(entries[index].weight);
+            entries.erase(index);
             stats.evictions++;
-            break;
+            return true;
         }
-        
-        // Move pinned item to front and try next
-        moveToFront(lastIt);
-        if (entries.size() <= 1) break; // Prevent infinite loop
     }
+    return false;
 }
 
 template<typename Key, typename Value>
-void EnhancedLRUCache<Key, Value>::moveToFront(typename EntryList::iterator it) {
-    if (it != entries.begin()) {
-        entries.splice(entries.begin(), entries, it);
+void EnhancedLRUCache<Key, Value>::makeRoom(size_t weight, Index keep) {
+    // Shield the entry being updated so only other entries are evicted
+    bool shielded = keep != Arena::NIL && !entries[keep].isPinned;
+    if (shielded) {
+        entries[keep].isPinned = true;
+    }
+    size_t kept = keep != Arena::NIL ? 1 : 0;
+    while (budget.needsRoom(entries.size() - kept, weight) && evict()) {}
+    if (shielded) {
+        entries[keep].isPinned = false;
+    }
+}
+
+template<typename Key, typename Value>
+void EnhancedLRUCache<Key, Value>::removeLocked(const Key& key) {
+    Index index = entries.find(key);
+    if (index != Arena::NIL) {
+        budget.release(entries[index].weight);
+        if (entries[index].isPinned) {
+            pinnedCount--;
+        }
+        entries.erase(index);
     }
 }
 
 // ===== LFUCache Implementation =====
 
 template<typename Key, typename Value>
-LFUCache<Key, Value>::LFUCache(size_t capacity) : maxCapacity(capacity) {}
+LFUCache<Key, Value>::LFUCache(size_t capacity, CapacityMode mode, Weigher<Key, Value> weigher)
+    : budget(capacity, mode, std::move(weigher)) {}
 
 template<typename Key, typename Value>
 void LFUCache<Key, Value>::put(const Key& key, const Value& value) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
     
-    if (maxCapacity == 0) return;
+    size_t weight = budget.weigh(key, value);
+    if (!budget.admits(weight)) {
+        // Larger than the whole budget: drop any stale copy instead of caching
+        removeLocked(key);
+        return;
+    }
     
-    auto it = keyToEntry.find(key);
-    if (it != keyToEntry.end()) {
+    auto it = nodes.find(key);
+    if (it != nodes.end()) {
         // Update existing entry
-        it->second.value = value;
-        it->second.lastAccessed = std::chrono::system_clock::now();
-        updateFrequency(key);
+        Node& node = it->second;
+        budget.release(node.weight);
+        node.value = value;
+        node.prefetched = false;
+        node.weight = weight;
+        node.lastAccessed = std::chrono::system_clock::now();
+        updateFrequency(node);
+        makeRoom(weight, &node);
+        budget.charge(weight);
         return;
     }
     
     // Add new entry
-    if (keyToEntry.size() >= maxCapacity) {
-        evict();
-    }
-    
-    keyToEntry[key] = EntryType(key, value);
-    keyToFreq[key] = 1;
-    frequencies[1].push_back(key);
-    minFrequency = 1;
+    makeRoom(weight);
+    insertLocked(key, value, weight);
 }
 
 template<typename Key, typename Value>
 Value LFUCache<Key, Value>::get(const Key& key) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
     
-    auto it = keyToEntry.find(key);
-    if (it == keyToEntry.end()) {
+    auto it = nodes.find(key);
+    if (it == nodes.end()) {
         stats.misses++;
         stats.updateHitRate();
         throw std::runtime_error("Key not found in cache");
     }
     
-    // Update access info
-    it->second.accessCount++;
-    it->second.lastAccessed = std::chrono::system_clock::now();
-    updateFrequency(key);
-    
-    stats.hits++;
-    stats.updateHitRate();
+    recordAccess(it->second);
     return it->second.value;
 }
 
 template<typename Key, typename Value>
 bool LFUCache<Key, Value>::contains(const Key& key) const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    return keyToEntry.find(key) != keyToEntry.end();
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    return nodes.find(key) != nodes.end();
 }
 
 template<typename Key, typename Value>
 void LFUCache<Key, Value>::remove(const Key& key) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    
-    auto it = keyToEntry.find(key);
-    if (it != keyToEntry.end()) {
-        size_t freq = keyToFreq[key];
-        auto& freqList = frequencies[freq];
-        freqList.remove(key);
-        if (freqList.empty() && freq == minFrequency) {
-            minFrequency++;
-        }
-        
-        keyToEntry.erase(key);
-        keyToFreq.erase(key);
-        pinnedKeys.erase(key);
-    }
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    removeLocked(key);
 }
 
 template<typename Key, typename Value>
 void LFUCache<Key, Value>::clear() {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    keyToEntry.clear();
-    keyToFreq.clear();
-    frequencies.clear();
-    pinnedKeys.clear();
-    minFrequency = 1;
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    nodes.clear();
+    buckets.clear();
+    pinnedCount = 0;
+    budget.reset();
 }
 
 template<typename Key, typename Value>
 size_t LFUCache<Key, Value>::size() const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    return keyToEntry.size();
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    return nodes.size();
 }
 
 template<typename Key, typename Value>
 size_t LFUCache<Key, Value>::capacity() const {
-    return maxCapacity;
+    return budget.capacity();
+}
+
+template<typename Key, typename Value>
+CapacityMode LFUCache<Key, Value>::capacityMode() const {
+    return budget.capacityMode();
 }
 
 template<typename Key, typename Value>
 CacheStatistics LFUCache<Key, Value>::getStatistics() const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
     auto statsCopy = stats;
-    statsCopy.pinnedItems = pinnedKeys.size();
+    statsCopy.pinnedItems = pinnedCount;
+    statsCopy.currentSize = nodes.size();
+    statsCopy.residentBytes = budget.residentBytes();
     return statsCopy;
 }
 
 template<typename Key, typename Value>
 void LFUCache<Key, Value>::resetStatistics() {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
     stats = CacheStatistics();
 }
 
 template<typename Key, typename Value>
 void LFUCache<Key, Value>::pin(const Key& key) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    if (keyToEntry.find(key) != keyToEntry.end()) {
-        pinnedKeys.insert(key);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    auto it = nodes.find(key);
+    if (it != nodes.end() && !it->second.isPinned) {
+        it->second.isPinned = true;
+        pinnedCount++;
     }
 }
 
 template<typename Key, typename Value>
 void LFUCache<Key, Value>::unpin(const Key& key) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    pinnedKeys.erase(key);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    auto it = nodes.find(key);
+    if (it != nodes.end() && it->second.isPinned) {
+        it->second.isPinned = false;
+        pinnedCount--;
+    }
 }
 
 template<typename Key, typename Value>
 bool LFUCache<Key, Value>::isPinned(const Key& key) const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    return pinnedKeys.find(key) != pinnedKeys.end();
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    auto it = nodes.find(key);
+    return it != nodes.end() && it->second.isPinned;
 }
 
 template<typename Key, typename Value>
 void LFUCache<Key, Value>::prefetch(const Key& key, const Value& value) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
     
-    auto it = keyToEntry.find(key);
-    if (it == keyToEntry.end()) {
-        // Key doesn't exist, add it
-        if (keyToEntry.size() >= maxCapacity) {
-            evict();
-        }
-        keyToEntry[key] = EntryType(key, value);
-        keyToFreq[key] = 1;
-        frequencies[1].push_back(key);
-        minFrequency = 1;
-        stats.prefetchedItems++;
+    size_t weight = budget.weigh(key, value);
+    if (!budget.admits(weight)) {
+        removeLocked(key);
+        return;
+    }
+    
+    auto it = nodes.find(key);
+    if (it == nodes.end()) {
+        // Key doesn't exist, evict as needed and add it
+        makeRoom(weight);
+        insertLocked(key, value, weight);
     } else {
         // Key exists, update value and count as prefetch
-        it->second.value = value;
-        it->second.lastAccessed = std::chrono::system_clock::now();
-        stats.prefetchedItems++;
+        Node& node = it->second;
+        budget.release(node.weight);
+        node.value = value;
+        node.weight = weight;
+        node.lastAccessed = std::chrono::system_clock::now();
+        makeRoom(weight, &node);
+        budget.charge(weight);
+    }
+    nodes[key].prefetched = true;
+    stats.prefetchedItems++;
+    stats.updateHitRate();
+}
+
+template<typename Key, typename Value>
+bool LFUCache<Key, Value>::prefetchIfRoom(const Key& key, const Value& value) {
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    
+    size_t weight = budget.weigh(key, value);
+    if (nodes.count(key) || !budget.admits(weight) || budget.needsRoom(nodes.size(), weight)) {
+        return false;
     }
+    insertLocked(key, value, weight);
+    nodes[key].prefetched = true;
+    stats.prefetchedItems++;
+    stats.updateHitRate();
+    return true;
 }
 
 template<typename Key, typename Value>
 std::vector<Key> LFUCache<Key, Value>::getKeys() const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
     std::vector<Key> keys;
-    for (const auto& pair : keyToEntry) {
+    keys.reserve(nodes.size());
+    for (const auto& pair : nodes) {
         keys.push_back(pair.first);
     }
     return keys;
 }
 
 template<typename Key, typename Value>
-void LFUCache<Key, Value>::evict() {
-    // Find least frequent unpinned key
-    for (auto freqIt = frequencies.find(minFrequency); 
-         freqIt != frequencies.end(); ++freqIt) {
-        auto& keyList = freqIt->second;
-        
-        for (auto keyIt = keyList.begin(); keyIt != keyList.end(); ++keyIt) {
-            if (pinnedKeys.find(*keyIt) == pinnedKeys.end()) {
-                Key keyToRemove = *keyIt;
-                keyList.erase(keyIt);
-                keyToEntry.erase(keyToRemove);
-                keyToFreq.erase(keyToRemove);
+std::vector<std::pair<Key, size_t>> LFUCache<Key, Value>::getAccessCounts() const {
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    std::vector<std::pair<Key, size_t>> counts;
+    counts.reserve(nodes.size());
+    for (const auto& pair : nodes) {
+        counts.emplace_back(pair.first, pair.second.accessCount);
+    }
+    return counts;
+}
+
+template<typename Key, typename Value>
+std::optional<Value> LFUCache<Key, Value>::peek(const Key& key) const {
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    auto it = nodes.find(key);
+    if (it == nodes.end()) {
+        return std::nullopt;
+    }
+    return it->second.value;
+}
+
+template<typename Key, typename Value>
+void LFUCache<Key, Value>::touch(const Key* keys, size_t count) {
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    for (size_t i = 0; i < count; ++i) {
+        const Key& key = keys[i];
+        auto it = nodes.find(key);
+        if (it != nodes.end()) {
+            recordAccess(it->second);
+        }
+    }
+}
+
+template<typename Key, typename Value>
+void LFUCache<Key, Value>::recordAccess(Node& node) {
+    if (node.prefetched) {
+        node.prefetched = false;
+        stats.prefetchHits++;
+    }
+    node.accessCount++;
+    node.lastAccessed = std::chrono::system_clock::now();
+    updateFrequency(node);
+    
+    stats.hits++;
+    stats.updateHitRate();
+}
+
+template<typename Key, typename Value>
+bool LFUCache<Key, Value>::evict() {
+    // Least frequently used first, least recently used within a frequency;
+    // only pinned nodes make this walk further than the first tail
+    for (auto& bucket : buckets) {
+        for (Node* node = bucket.tail; node; node = node->prev) {
+            if (!node->isPinned) {
+                eraseNode(*node);
                 stats.evictions++;
-                
-                if (keyList.empty() && freqIt->first == minFrequency) {
-                    minFrequency++;
-                }
-                return;
+                return true;
             }
         }
     }
+    return false;
+}
+
+template<typename Key, typename Value>
+void LFUCache<Key, Value>::makeRoom(size_t weight, Node* keep) {
+    // Shield the entry being updated so only other entries are evicted
+    bool shielded = keep && !keep->isPinned;
+    if (shielded) {
+        keep->isPinned = true;
+    }
+    size_t kept = keep ? 1 : 0;
+    while (budget.needsRoom(nodes.size() - kept, weight) && evict()) {}
+    if (shielded) {
+        keep->isPinned = false;
+    }
 }
 
 template<typename Key, typename Value>
-void LFUCache<Key, Value>::updateFrequency(const Key& key) {
-    size_t oldFreq = keyToFreq[key];
-    size_t newFreq = oldFreq + 1;
+void LFUCache<Key, Value>::removeLocked(const Key& key) {
+    auto it = nodes.find(key);
+    if (it != nodes.end()) {
+        eraseNode(it->second);
+    }
+}
+
+template<typename Key, typename Value>
+void LFUCache<Key, Value>::insertLocked(const Key& key, const Value& value, size_t weight) {
+    auto it = nodes.try_emplace(key).first;
+    Node& node = it->second;
+    node.value = value;
+    node.weight = weight;
+    node.lastAccessed = node.createdAt = std::chrono::system_clock::now();
+    node.key = &it->first;
+    
+    if (buckets.empty() || buckets.front().frequency != 1) {
+        buckets.emplace_front();
+    }
+    link(buckets.begin(), node);
+    budget.charge(weight);
+}
+
+template<typename Key, typename Value>
+void LFUCache<Key, Value>::updateFrequency(Node& node) {
+    auto current = node.bucket;
+    auto next = std::next(current);
+    size_t frequency = current->frequency + 1;
     
-    // Remove from old frequency list
-    frequencies[oldFreq].remove(key);
-    if (frequencies[oldFreq].empty() && oldFreq == minFrequency) {
-        minFrequency++;
+    unlink(node);
+    if (next == buckets.end() || next->frequency != frequency) {
+        next = buckets.insert(next, Bucket{frequency});
+    }
+    link(next, node);
+    if (!current->head) {
+        buckets.erase(current);
+    }
+}
+
+template<typename Key, typename Value>
+void LFUCache<Key, Value>::eraseNode(Node& node) {
+    budget.release(node.weight);
+    if (node.isPinned) {
+        pinnedCount--;
     }
     
-    // Add to new frequency list
-    keyToFreq[key] = newFreq;
-    frequencies[newFreq].push_back(key);
+    auto bucket = node.bucket;
+    unlink(node);
+    if (!bucket->head) {
+        buckets.erase(bucket);
+    }
+    nodes.erase(nodes.find(*node.key));
+}
+
+template<typename Key, typename Value>
+void LFUCache<Key, Value>::link(typename BucketList::iterator bucket, Node& node) {
+    node.bucket = bucket;
+    node.prev = nullptr;
+    node.next = bucket->head;
+    if (bucket->head) {
+        bucket->head->prev = &node;
+    } else {
+        bucket->tail = &node;
+    }
+    bucket->head = &node;
+}
+
+template<typename Key, typename Value>
+void LFUCache<Key, Value>::unlink(Node& node) {
+    auto bucket = node.bucket;
+    if (node.prev) {
+        node.prev->next = node.next;
+    } else {
+        bucket->head = node.next;
+    }
+    if (node.next) {
+        node.next->prev = node.prev;
+    } else {
+        bucket->tail = node.prev;
+    }
+    node.prev = node.next = nullptr;
 }
 
 // ===== FIFOCache Implementation =====
 
 template<typename Key, typename Value>
-FIFOCache<Key, Value>::FIFOCache(size_t capacity) : maxCapacity(capacity) {}
+FIFOCache<Key, Value>::FIFOCache(size_t capacity, CapacityMode mode, Weigher<Key, Value> weigher)
+    : budget(capacity, mode, std::move(weigher)) {}
 
 template<typename Key, typename Value>
 void FIFOCache<Key, Value>::put(const Key& key, const Value& value) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
     
-    auto it = entries.find(key);
-    if (it != entries.end()) {
-        // Update existing entry
-        it->second.value = value;
-        it->second.lastAccessed = std::chrono::system_clock::now();
+    size_t weight = budget.weigh(key, value);
+    if (!budget.admits(weight)) {
+        // Larger than the whole budget: drop any stale copy instead of caching
+        removeLocked(key);
         return;
     }
     
-    // Add new entry
-    if (entries.size() >= maxCapacity) {
-        evict();
+    Index index = entries.find(key);
+    if (index != Arena::NIL) {
+        // Update existing entry
+        auto& entry = entries[index];
+        budget.release(entry.weight);
+        entry.value = value;
+        entry.prefetched = false;
+        entry.weight = weight;
+        entry.lastAccessed = entries.now();
+        makeRoom(weight, index);
+        budget.charge(weight);
+        return;
     }
     
-    entries[key] = EntryType(key, value);
-    insertionOrder.push(key);
+    // Add new entry
+    makeRoom(weight);
+    entries[entries.insert(key, value)].weight = weight;
+    budget.charge(weight);
 }
 
 template<typename Key, typename Value>
 Value FIFOCache<Key, Value>::get(const Key& key) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
     
-    auto it = entries.find(key);
-    if (it == entries.end()) {
+    Index index = entries.find(key);
+    if (index == Arena::NIL) {
         stats.misses++;
         stats.updateHitRate();
         throw std::runtime_error("Key not found in cache");
     }
     
-    // Update access info
-    it->second.accessCount++;
-    it->second.lastAccessed = std::chrono::system_clock::now();
-    
-    stats.hits++;
-    stats.updateHitRate();
-    return it->second.value;
+    recordAccess(index);
+    return entries[index].value;
 }
 
 template<typename Key, typename Value>
 bool FIFOCache<Key, Value>::contains(const Key& key) const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    return entries.find(key) != entries.end();
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    return entries.find(key) != Arena::NIL;
 }
 
 template<typename Key, typename Value>
 void FIFOCache<Key, Value>::remove(const Key& key) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    
-    auto it = entries.find(key);
-    if (it != entries.end()) {
-        entries.erase(it);
-        pinnedKeys.erase(key);
-        // Note: Can't efficiently remove from queue, will be handled in evict
-    }
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    removeLocked(key);
 }
 
 template<typename Key, typename Value>
 void FIFOCache<Key, Value>::clear() {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
     entries.clear();
-    pinnedKeys.clear();
-    insertionOrder = EntryQueue(); // Clear queue
+    pinnedCount = 0;
+    budget.reset();
 }
 
 template<typename Key, typename Value>
 size_t FIFOCache<Key, Value>::size() const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
     return entries.size();
 }
 
 template<typename Key, typename Value>
 size_t FIFOCache<Key, Value>::capacity() const {
-    return maxCapacity;
+    return budget.capacity();
+}
+
+template<typename Key, typename Value>
+CapacityMode FIFOCache<Key, Value>::capacityMode() const {
+    return budget.capacityMode();
 }
 
 template<typename Key, typename Value>
 CacheStatistics FIFOCache<Key, Value>::getStatistics() const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
     auto statsCopy = stats;
-    statsCopy.pinnedItems = pinnedKeys.size();
+    statsCopy.pinnedItems = pinnedCount;
+    statsCopy.currentSize = entries.size();
+    statsCopy.residentBytes = budget.residentBytes();
     return statsCopy;
 }
 
 template<typename Key, typename Value>
 void FIFOCache<Key, Value>::resetStatistics() {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
     stats = CacheStatistics();
 }
 
 template<typename Key, typename Value>
 void FIFOCache<Key, Value>::pin(const Key& key) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    if (entries.find(key) != entries.end()) {
-        pinnedKeys.insert(key);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    Index index = entries.find(key);
+    if (index != Arena::NIL && !entries[index].isPinned) {
+        entries[index].isPinned = true;
+        pinnedCount++;
     }
 }
 
 template<typename Key, typename Value>
 void FIFOCache<Key, Value>::unpin(const Key& key) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    pinnedKeys.erase(key);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    Index index = entries.find(key);
+    if (index != Arena::NIL && entries[index].isPinned) {
+        entries[index].isPinned = false;
+        pinnedCount--;
+    }
 }
 
 template<typename Key, typename Value>
 bool FIFOCache<Key, Value>::isPinned(const Key& key) const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    return pinnedKeys.find(key) != pinnedKeys.end();
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    Index index = entries.find(key);
+    return index != Arena::NIL && entries[index].isPinned;
 }
 
 template<typename Key, typename Value>
 void FIFOCache<Key, Value>::prefetch(const Key& key, const Value& value) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
     
-    auto it = entries.find(key);
-    if (it == entries.end()) {
-        // Key doesn't exist, add it
-        if (entries.size() >= maxCapacity) {
-            evict();
-        }
-        entries[key] = EntryType(key, value);
-        insertionOrder.push(key);
-        stats.prefetchedItems++;
+    size_t weight = budget.weigh(key, value);
+    if (!budget.admits(weight)) {
+        removeLocked(key);
+        return;
+    }
+    
+    Index index = entries.find(key);
+    if (index == Arena::NIL) {
+        // Key doesn't exist, evict as needed and add it
+        makeRoom(weight);
+        index = entries.insert(key, value);
+        entries[index].weight = weight;
     } else {
         // Key exists, update value and count as prefetch
-        it->second.value = value;
-        it->second.lastAccessed = std::chrono::system_clock::now();
-        stats.prefetchedItems++;
+        auto& entry = entries[index];
+        budget.release(entry.weight);
+        entry.value = value;
+        entry.weight = weight;
+        entry.lastAccessed = entries.now();
+        makeRoom(weight, index);
+    }
+    entries[index].prefetched = true;
+    budget.charge(weight);
+    stats.prefetchedItems++;
+    stats.updateHitRate();
+}
+
+template<typename Key, typename Value>
+bool FIFOCache<Key, Value>::prefetchIfRoom(const Key& key, const Value& value) {
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    
+    size_t weight = budget.weigh(key, value);
+    if (entries.find(key) != Arena::NIL || !budget.admits(weight) || budget.needsRoom(entries.size(), weight)) {
+        return false;
     }
+    Index index = entries.insert(key, value);
+    entries[index].weight = weight;
+    entries[index].prefetched = true;
+    budget.charge(weight);
+    stats.prefetchedItems++;
+    stats.updateHitRate();
+    return true;
 }
 
 template<typename Key, typename Value>
 std::vector<Key> FIFOCache<Key, Value>::getKeys() const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
     std::vector<Key> keys;
-    for (const auto& pair : entries) {
-        keys.push_back(pair.first);
+    keys.reserve(entries.size());
+    for (Index index = entries.front(); index != Arena::NIL; index = entries[index].next) {
+        keys.push_back(entries[index].key);
     }
     return keys;
 }
 
 template<typename Key, typename Value>
-void FIFOCache<Key, Value>::evict() {
-    while (!insertionOrder.empty()) {
-        Key oldestKey = insertionOrder.front();
-        insertionOrder.pop();
-        
-        // Check if key still exists and is not pinned
-        auto it = entries.find(oldestKey);
-        if (it != entries.end() && pinnedKeys.find(oldestKey) == pinnedKeys.end()) {
-            entries.erase(it);
-            stats.evictions++;
-            break;
+std::vector<std::pair<Key, size_t>> FIFOCache<Key, Value>::getAccessCounts() const {
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    std::vector<std::pair<Key, size_t>> counts;
+    counts.reserve(entries.size());
+    for (Index index = entries.front(); index != Arena::NIL; index = entries[index].next) {
+        counts.emplace_back(entries[index].key, entries[index].accessCount);
+    }
+    return counts;
+}
+
+template<typename Key, typename Value>
+std::optional<Value> FIFOCache<Key, Value>::peek(const Key& key) const {
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    Index index = entries.find(key);
+    if (index == Arena::NIL) {
+        return std::nullopt;
+    }
+    return entries[index].value;
+}
+
+template<typename Key, typename Value>
+void FIFOCache<Key, Value>::touch(const Key* keys, size_t count) {
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    for (size_t i = 0; i < count; ++i) {
+        Index index = entries.find(keys[i]);
+        if (index != Arena::NIL) {
+            recordAccess(index);
+        }
+    }
+}
+
+template<typename Key, typename Value>
+void FIFOCache<Key, Value>::recordAccess(Index index) {
+    auto& entry = entries[index];
+    if (entry.prefetched) {
+        entry.prefetched = false;
+        stats.prefetchHits++;
+    }
+    entry.accessCount++;
+    entry.lastAccessed = entries.now();
+    
+    stats.hits++;
+    stats.updateHitRate();
+}
+
+template<typename Key, typename Value>
+bool FIFOCache<Key, Value>::evict() {
+    // Oldest first; pinned entries rotate to the new end so they are still
+    // in line once unpinned
+    for (size_t remaining = entries.size(); remaining > 0; --remaining) {
+        Index oldest = entries.back();
+        if (entries[oldest].isPinned) {
+            entries.moveToFront(oldest);
+            continue;
+        }
+        budget.release(entries[oldest].weight);
+        entries.erase(oldest);
+        stats.evictions++;
+        return true;
+    }
+    return false;
+}
+
+template<typename Key, typename Value>
+void FIFOCache<Key, Value>::makeRoom(size_t weight, Index keep) {
+    // Shield the entry being updated so only other entries are evicted
+    bool shielded = keep != Arena::NIL && !entries[keep].isPinned;
+    if (shielded) {
+        entries[keep].isPinned = true;
+    }
+    size_t kept = keep != Arena::NIL ? 1 : 0;
+    while (budget.needsRoom(entries.size() - kept, weight) && evict()) {}
+    if (shielded) {
+        entries[keep].isPinned = false;
+    }
+}
+
+template<typename Key, typename Value>
+void FIFOCache<Key, Value>::removeLocked(const Key& key) {
+    Index index = entries.find(key);
+    if (index != Arena::NIL) {
+        budget.release(entries[index].weight);
+        if (entries[index].isPinned) {
+            pinnedCount--;
         }
+        entries.erase(index);
     }
 }
 
 // ===== LIFOCache Implementation =====
 
 template<typename Key, typename Value>
-LIFOCache<Key, Value>::LIFOCache(size_t capacity) : maxCapacity(capacity) {}
+LIFOCache<Key, Value>::LIFOCache(size_t capacity, CapacityMode mode, Weigher<Key, Value> weigher)
+    : budget(capacity, mode, std::move(weigher)) {}
 
 template<typename Key, typename Value>
 void LIFOCache<Key, Value>::put(const Key& key, const Value& value) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
     
-    auto it = entries.find(key);
-    if (it != entries.end()) {
-        // Update existing entry
-        it->second.value = value;
-        it->second.lastAccessed = std::chrono::system_clock::now();
-        
-        // Remove from current position in stack
-        auto& stack = insertionOrder;
-        // Create new stack without this key
-        EntryStack newStack;
-        while (!stack.empty()) {
-            if (stack.top() != key) {
-                newStack.push(stack.top());
-            }
-            stack.pop();
-        }
-        // Reverse back to original order (except removed key)
-        while (!newStack.empty()) {
-            stack.push(newStack.top());
-            newStack.pop();
-        }
-        // Add updated key to top (most recent)
-        stack.push(key);
+    size_t weight = budget.weigh(key, value);
+    if (!budget.admits(weight)) {
+        // Larger than the whole budget: drop any stale copy instead of caching
+        removeLocked(key);
         return;
     }
     
-    // Add new entry
-    if (entries.size() >= maxCapacity) {
-        evict();
+    Index index = entries.find(key);
+    if (index != Arena::NIL) {
+        // Update existing entry
+        auto& entry = entries[index];
+        budget.release(entry.weight);
+        entry.value = value;
+        entry.prefetched = false;
+        entry.weight = weight;
+        entry.lastAccessed = entries.now();
+        entries.moveToFront(index);  // An update counts as the newest addition
+        makeRoom(weight, index);
+        budget.charge(weight);
+        return;
     }
     
-    entries[key] = EntryType(key, value);
-    insertionOrder.push(key);  // Push to top of stack
+    // Add new entry
+    makeRoom(weight);
+    entries[entries.insert(key, value)].weight = weight;
+    budget.charge(weight);
 }
 
 template<typename Key, typename Value>
 Value LIFOCache<Key, Value>::get(const Key& key) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
     
-    auto it = entries.find(key);
-    if (it == entries.end()) {
+    Index index = entries.find(key);
+    if (index == Arena::NIL) {
         stats.misses++;
         stats.updateHitRate();
         throw std::runtime_error("Key not found in cache");
     }
     
-    // Update access info (but don't change LIFO order)
-    it->second.accessCount++;
-    it->second.lastAccessed = std::chrono::system_clock::now();
-    
-    stats.hits++;
-    stats.updateHitRate();
-    return it->second.value;
+    recordAccess(index);
+    return entries[index].value;
 }
 
 template<typename Key, typename Value>
 bool LIFOCache<Key, Value>::contains(const Key& key) const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    return entries.find(key) != entries.end();
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    return entries.find(key) != Arena::NIL;
 }
 
 template<typename Key, typename Value>
 void LIFOCache<Key, Value>::remove(const Key& key) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    
-    auto it = entries.find(key);
-    if (it != entries.end()) {
-        entries.erase(it);
-        pinnedKeys.erase(key);
-        
-        // Remove from stack (similar to put method)
-        auto& stack = insertionOrder;
-        EntryStack newStack;
-        while (!stack.empty()) {
-            if (stack.top() != key) {
-                newStack.push(stack.top());
-            }
-            stack.pop();
-        }
-        while (!newStack.empty()) {
-            stack.push(newStack.top());
-            newStack.pop();
-        }
-    }
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    removeLocked(key);
 }
 
 template<typename Key, typename Value>
 void LIFOCache<Key, Value>::clear() {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
     entries.clear();
-    pinnedKeys.clear();
-    insertionOrder = EntryStack(); // Clear stack
+    pinnedCount = 0;
+    budget.reset();
 }
 
 template<typename Key, typename Value>
 size_t LIFOCache<Key, Value>::size() const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
     return entries.size();
 }
 
 template<typename Key, typename Value>
 size_t LIFOCache<Key, Value>::capacity() const {
-    return maxCapacity;
+    return budget.capacity();
+}
+
+template<typename Key, typename Value>
+CapacityMode LIFOCache<Key, Value>::capacityMode() const {
+    return budget.capacityMode();
 }
 
 template<typename Key, typename Value>
 CacheStatistics LIFOCache<Key, Value>::getStatistics() const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
     auto statsCopy = stats;
-    statsCopy.pinnedItems = pinnedKeys.size();
+    statsCopy.pinnedItems = pinnedCount;
+    statsCopy.currentSize = entries.size();
+    statsCopy.residentBytes = budget.residentBytes();
     return statsCopy;
 }
 
 template<typename Key, typename Value>
 void LIFOCache<Key, Value>::resetStatistics() {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
     stats = CacheStatistics();
 }
 
 template<typename Key, typename Value>
 void LIFOCache<Key, Value>::pin(const Key& key) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    if (entries.find(key) != entries.end()) {
-        pinnedKeys.insert(key);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    Index index = entries.find(key);
+    if (index != Arena::NIL && !entries[index].isPinned) {
+        entries[index].isPinned = true;
+        pinnedCount++;
     }
 }
 
 template<typename Key, typename Value>
 void LIFOCache<Key, Value>::unpin(const Key& key) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    pinnedKeys.erase(key);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    Index index = entries.find(key);
+    if (index != Arena::NIL && entries[index].isPinned) {
+        entries[index].isPinned = false;
+        pinnedCount--;
+    }
 }
 
 template<typename Key, typename Value>
 bool LIFOCache<Key, Value>::isPinned(const Key& key) const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
-    return pinnedKeys.find(key) != pinnedKeys.end();
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    Index index = entries.find(key);
+    return index != Arena::NIL && entries[index].isPinned;
 }
 
 template<typename Key, typename Value>
 void LIFOCache<Key, Value>::prefetch(const Key& key, const Value& value) {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
     
-    auto it = entries.find(key);
-    if (it == entries.end()) {
-        // Key doesn't exist, add it
-        if (entries.size() >= maxCapacity) {
-            evict();
-        }
-        entries[key] = EntryType(key, value);
-        insertionOrder.push(key);  // Add to top of stack
-        stats.prefetchedItems++;
+    size_t weight = budget.weigh(key, value);
+    if (!budget.admits(weight)) {
+        removeLocked(key);
+        return;
+    }
+    
+    Index index = entries.find(key);
+    if (index == Arena::NIL) {
+        // Key doesn't exist, evict as needed and add it
+        makeRoom(weight);
+        index = entries.insert(key, value);
+        entries[index].weight = weight;
     } else {
         // Key exists, update value and count as prefetch
-        it->second.value = value;
-        it->second.lastAccessed = std::chrono::system_clock::now();
-        stats.prefetchedItems++;
+        auto& entry = entries[index];
+        budget.release(entry.weight);
+        entry.value = value;
+        entry.weight = weight;
+        entry.lastAccessed = entries.now();
+        makeRoom(weight, index);
+    }
+    entries[index].prefetched = true;
+    budget.charge(weight);
+    stats.prefetchedItems++;
+    stats.updateHitRate();
+}
+
+template<typename Key, typename Value>
+bool LIFOCache<Key, Value>::prefetchIfRoom(const Key& key, const Value& value) {
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    
+    size_t weight = budget.weigh(key, value);
+    if (entries.find(key) != Arena::NIL || !budget.admits(weight) || budget.needsRoom(entries.size(), weight)) {
+        return false;
     }
+    Index index = entries.insert(key, value);  // On top of the stack
+    entries[index].weight = weight;
+    entries[index].prefetched = true;
+    budget.charge(weight);
+    stats.prefetchedItems++;
+    stats.updateHitRate();
+    return true;
 }
 
 template<typename Key, typename Value>
 std::vector<Key> LIFOCache<Key, Value>::getKeys() const {
-    std::lock_guard<std::mutex> lock(cacheMutex);
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
     std::vector<Key> keys;
-    for (const auto& pair : entries) {
-        keys.push_back(pair.first);
+    keys.reserve(entries.size());
+    for (Index index = entries.front(); index != Arena::NIL; index = entries[index].next) {
+        keys.push_back(entries[index].key);
     }
     return keys;
 }
 
 template<typename Key, typename Value>
-void LIFOCache<Key, Value>::evict() {
+std::vector<std::pair<Key, size_t>> LIFOCache<Key, Value>::getAccessCounts() const {
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    std::vector<std::pair<Key, size_t>> counts;
+    counts.reserve(entries.size());
+    for (Index index = entries.front(); index != Arena::NIL; index = entries[index].next) {
+        counts.emplace_back(entries[index].key, entries[index].accessCount);
+    }
+    return counts;
+}
+
+template<typename Key, typename Value>
+std::optional<Value> LIFOCache<Key, Value>::peek(const Key& key) const {
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    Index index = entries.find(key);
+    if (index == Arena::NIL) {
+        return std::nullopt;
+    }
+    return entries[index].value;
+}
+
+template<typename Key, typename Value>
+void LIFOCache<Key, Value>::touch(const Key* keys, size_t count) {
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    for (size_t i = 0; i < count; ++i) {
+        Index index = entries.find(keys[i]);
+        if (index != Arena::NIL) {
+            recordAccess(index);
+        }
+    }
+}
+
+template<typename Key, typename Value>
+void LIFOCache<Key, Value>::recordAccess(Index index) {
+    auto& entry = entries[index];
+    if (entry.prefetched) {
+        entry.prefetched = false;
+        stats.prefetchHits++;
+    }
+    entry.accessCount++;
+    entry.lastAccessed = entries.now();
+    
+    stats.hits++;
+    stats.updateHitRate();
+}
+
+template<typename Key, typename Value>
+bool LIFOCache<Key, Value>::evict() {
     // LIFO: Remove the most recently added unpinned item (top of stack)
-    EntryStack tempStack;
-    Key keyToRemove;
-    bool found = false;
-    
-    // Find the most recent unpinned item
-    while (!insertionOrder.empty()) {
-        Key topKey = insertionOrder.top();
-        insertionOrder.pop();
+    for (Index index = entries.front(); index != Arena::NIL; index = entries[index].next) {
+        if (!entries[index].isPinned) {
+            budget.release(entries[index].weight);
+            entries.erase(index);
+            stats.evictions++;
+            return true;
+        }
+    }
+    return false;
+}
+
+template<typename Key, typename Value>
+void LIFOCache<Key, Value>::makeRoom(size_t weight, Index keep) {
+    // Shield the entry being updated so only other entries are evicted
+    bool shielded = keep != Arena::NIL && !entries[keep].isPinned;
+    if (shielded) {
+        entries[keep].isPinned = true;
+    }
+    size_t kept = keep != Arena::NIL ? 1 : 0;
+    while (budget.needsRoom(entries.size() - kept, weight) && evict()) {}
+    if (shielded) {
+        entries[keep].isPinned = false;
+    }
+}
+
+template<typename Key, typename Value>
+void LIFOCache<Key, Value>::removeLocked(const Key& key) {
+    Index index = entries.find(key);
+    if (index != Arena::NIL) {
+        budget.release(entries[index].weight);
+        if (entries[index].isPinned) {
+            pinnedCount--;
+        }
+        entries.erase(index);
+    }
+}
+
+// ===== ARCCache Implementation =====
+
+template<typename Key, typename Value>
+ARCCache<Key, Value>::ARCCache(size_t capacity, CapacityMode mode, Weigher<Key, Value> weigher)
+    : budget(capacity, mode, std::move(weigher)) {}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::put(const Key& key, const Value& value) {
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    
+    size_t weight = budget.weigh(key, value);
+    if (!budget.admits(weight)) {
+        // Larger than the whole budget: drop any stale copy instead of caching
+        removeLocked(key);
+        return;
+    }
+    
+    auto it = lookup.find(key);
+    if (it != lookup.end() && (it->second.segment == Segment::T1 || it->second.segment == Segment::T2)) {
+        // Update in place; a write refreshes recency but is not a second use
+        bool inT1 = it->second.segment == Segment::T1;
+        auto& list = inT1 ? t1 : t2;
+        auto& segmentUnits = inT1 ? t1Units : t2Units;
+        auto entry = it->second.entry;
         
-        auto it = entries.find(topKey);
-        if (it != entries.end() && pinnedKeys.find(topKey) == pinnedKeys.end()) {
-            // Found unpinned item to remove
-            keyToRemove = topKey;
-            found = true;
-            break;
+        budget.release(entry->weight);
+        segmentUnits -= units(entry->weight);
+        entry->value = value;
+        entry->prefetched = false;
+        entry->weight = weight;
+        entry->lastAccessed = std::chrono::system_clock::now();
+        list.splice(list.begin(), list, entry);
+        segmentUnits += units(weight);
+        budget.charge(weight);
+        
+        makeRoom(0, false, &key);
+        trimGhosts();
+        return;
+    }
+    
+    insertLocked(key, value, weight);
+}
+
+template<typename Key, typename Value>
+Value ARCCache<Key, Value>::get(const Key& key) {
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    
+    auto it = lookup.find(key);
+    if (it == lookup.end() || it->second.segment == Segment::B1 || it->second.segment == Segment::B2) {
+        stats.misses++;
+        stats.updateHitRate();
+        throw std::runtime_error("Key not found in cache");
+    }
+    
+    recordAccess(it->second);
+    return it->second.entry->value;
+}
+
+template<typename Key, typename Value>
+bool ARCCache<Key, Value>::contains(const Key& key) const {
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    auto it = lookup.find(key);
+    return it != lookup.end() && (it->second.segment == Segment::T1 || it->second.segment == Segment::T2);
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::remove(const Key& key) {
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    removeLocked(key);
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::clear() {
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    t1.clear();
+    t2.clear();
+    b1.clear();
+    b2.clear();
+    t1Units = t2Units = b1Units = b2Units = 0;
+    target = 0;
+    lookup.clear();
+    pinnedKeys.clear();
+    budget.reset();
+}
+
+template<typename Key, typename Value>
+size_t ARCCache<Key, Value>::size() const {
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    return t1.size() + t2.size();
+}
+
+template<typename Key, typename Value>
+size_t ARCCache<Key, Value>::capacity() const {
+    return budget.capacity();
+}
+
+template<typename Key, typename Value>
+CapacityMode ARCCache<Key, Value>::capacityMode() const {
+    return budget.capacityMode();
+}
+
+template<typename Key, typename Value>
+CacheStatistics ARCCache<Key, Value>::getStatistics() const {
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    auto statsCopy = stats;
+    statsCopy.pinnedItems = pinnedKeys.size();
+    statsCopy.currentSize = t1.size() + t2.size();
+    statsCopy.residentBytes = budget.residentBytes();
+    return statsCopy;
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::resetStatistics() {
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    stats = CacheStatistics();
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::pin(const Key& key) {
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    auto it = lookup.find(key);
+    if (it != lookup.end() && (it->second.segment == Segment::T1 || it->second.segment == Segment::T2)) {
+        pinnedKeys.insert(key);
+    }
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::unpin(const Key& key) {
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    pinnedKeys.erase(key);
+}
+
+template<typename Key, typename Value>
+bool ARCCache<Key, Value>::isPinned(const Key& key) const {
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    return pinnedKeys.find(key) != pinnedKeys.end();
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::prefetch(const Key& key, const Value& value) {
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    
+    size_t weight = budget.weigh(key, value);
+    auto it = lookup.find(key);
+    bool frequent = it != lookup.end() && it->second.segment == Segment::T2;
+    
+    // A speculative load says nothing about reuse, so it neither adapts the
+    // target nor promotes a ghost: it enters T1 like any first-time key
+    removeLocked(key);
+    if (!budget.admits(weight)) {
+        return;
+    }
+    insertLocked(key, value, weight);
+    if (frequent) {
+        // Keep the frequency evidence of an entry that was already in T2
+        auto entry = lookup[key].entry;
+        size_t entryUnits = units(weight);
+        t2.splice(t2.begin(), t1, entry);
+        t1Units -= entryUnits;
+        t2Units += entryUnits;
+        lookup[key].segment = Segment::T2;
+    }
+    lookup[key].entry->prefetched = true;
+    stats.prefetchedItems++;
+    stats.updateHitRate();
+}
+
+template<typename Key, typename Value>
+bool ARCCache<Key, Value>::prefetchIfRoom(const Key& key, const Value& value) {
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    
+    size_t weight = budget.weigh(key, value);
+    auto it = lookup.find(key);
+    bool resident = it != lookup.end() && (it->second.segment == Segment::T1 || it->second.segment == Segment::T2);
+    if (resident || !budget.admits(weight) || t1Units + t2Units + units(weight) > budget.capacity()) {
+        return false;
+    }
+    // Like prefetch(): a ghost is forgotten rather than counted as a hit
+    removeLocked(key);
+    insertLocked(key, value, weight);
+    lookup[key].entry->prefetched = true;
+    stats.prefetchedItems++;
+    stats.updateHitRate();
+    return true;
+}
+
+template<typename Key, typename Value>
+std::vector<Key> ARCCache<Key, Value>::getKeys() const {
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    std::vector<Key> keys;
+    keys.reserve(t1.size() + t2.size());
+    for (const auto& entry : t2) {
+        keys.push_back(entry.key);
+    }
+    for (const auto& entry : t1) {
+        keys.push_back(entry.key);
+    }
+    return keys;
+}
+
+template<typename Key, typename Value>
+std::vector<std::pair<Key, size_t>> ARCCache<Key, Value>::getAccessCounts() const {
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    std::vector<std::pair<Key, size_t>> counts;
+    counts.reserve(t1.size() + t2.size());
+    for (const auto& entry : t2) {
+        counts.emplace_back(entry.key, entry.accessCount);
+    }
+    for (const auto& entry : t1) {
+        counts.emplace_back(entry.key, entry.accessCount);
+    }
+    return counts;
+}
+
+template<typename Key, typename Value>
+std::optional<Value> ARCCache<Key, Value>::peek(const Key& key) const {
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    auto it = lookup.find(key);
+    if (it == lookup.end() || it->second.segment == Segment::B1 || it->second.segment == Segment::B2) {
+        return std::nullopt;
+    }
+    return it->second.entry->value;
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::touch(const Key* keys, size_t count) {
+    std::lock_guard<std::shared_mutex> lock(cacheMutex);
+    for (size_t i = 0; i < count; ++i) {
+        const Key& key = keys[i];
+        auto it = lookup.find(key);
+        if (it != lookup.end() && (it->second.segment == Segment::T1 || it->second.segment == Segment::T2)) {
+            recordAccess(it->second);
+        }
+    }
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::recordAccess(Location& location) {
+    // Any hit makes the entry frequent: move it to the MRU end of T2
+    auto entry = location.entry;
+    if (location.segment == Segment::T1) {
+        size_t entryUnits = units(entry->weight);
+        t2.splice(t2.begin(), t1, entry);
+        t1Units -= entryUnits;
+        t2Units += entryUnits;
+        location.segment = Segment::T2;
+    } else {
+        t2.splice(t2.begin(), t2, entry);
+    }
+    
+    if (entry->prefetched) {
+        entry->prefetched = false;
+        stats.prefetchHits++;
+    }
+    entry->accessCount++;
+    entry->lastAccessed = std::chrono::system_clock::now();
+    
+    stats.hits++;
+    stats.updateHitRate();
+}
+
+template<typename Key, typename Value>
+size_t ARCCache<Key, Value>::recencyTarget() const {
+    std::shared_lock<std::shared_mutex> lock(cacheMutex);
+    return target;
+}
+
+template<typename Key, typename Value>
+size_t ARCCache<Key, Value>::units(size_t weight) const {
+    return budget.capacityMode() == CapacityMode::BYTES ? weight : 1;
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::insertLocked(const Key& key, const Value& value, size_t weight) {
+    size_t entryUnits = units(weight);
+    Segment segment = Segment::T1;
+    bool ghostHitInB2 = false;
+    
+    auto it = lookup.find(key);
+    if (it != lookup.end()) {
+        // Ghost hit: the key was evicted too early, so learn from it and
+        // admit it straight into T2
+        Segment ghost = it->second.segment;
+        adaptOnGhostHit(ghost, entryUnits);
+        ghostHitInB2 = ghost == Segment::B2;
+        if (ghost == Segment::B1) {
+            b1Units -= it->second.ghost->second;
+            b1.erase(it->second.ghost);
         } else {
-            // Keep this item, store temporarily
-            tempStack.push(topKey);
+            b2Units -= it->second.ghost->second;
+            b2.erase(it->second.ghost);
         }
+        lookup.erase(it);
+        segment = Segment::T2;
+    }
+    
+    makeRoom(entryUnits, ghostHitInB2);
+    
+    auto& list = segment == Segment::T1 ? t1 : t2;
+    EntryType entry(key, value);
+    entry.weight = weight;
+    list.push_front(std::move(entry));
+    (segment == Segment::T1 ? t1Units : t2Units) += entryUnits;
+    lookup[key] = Location{segment, list.begin(), typename GhostList::iterator()};
+    budget.charge(weight);
+    trimGhosts();
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::adaptOnGhostHit(Segment ghost, size_t incomingUnits) {
+    size_t limit = budget.capacity();
+    if (ghost == Segment::B1) {
+        // Recency would have hit: grow T1's share
+        size_t ratio = b1Units > 0 && b2Units > b1Units ? b2Units / b1Units : 1;
+        target = std::min(limit, target + ratio * incomingUnits);
+    } else {
+        // Frequency would have hit: grow T2's share
+        size_t ratio = b2Units > 0 && b1Units > b2Units ? b1Units / b2Units : 1;
+        size_t delta = ratio * incomingUnits;
+        target = target > delta ? target - delta : 0;
     }
+}
+
+template<typename Key, typename Value>
+bool ARCCache<Key, Value>::replace(bool ghostHitInB2) {
+    auto lruUnpinned = [this](EntryList& list) {
+        for (auto it = list.rbegin(); it != list.rend(); ++it) {
+            if (pinnedKeys.find(it->key) == pinnedKeys.end()) {
+                return std::next(it).base();
+            }
+        }
+        return list.end();
+    };
     
-    // Restore the items we temporarily removed
-    while (!tempStack.empty()) {
-        insertionOrder.push(tempStack.top());
-        tempStack.pop();
+    auto fromT1 = lruUnpinned(t1);
+    auto fromT2 = lruUnpinned(t2);
+    bool takeT1 = fromT1 != t1.end() &&
+                  (fromT2 == t2.end() || t1Units > target || (ghostHitInB2 && t1Units == target));
+    if (!takeT1 && fromT2 == t2.end()) {
+        return false;
     }
     
-    // Remove the found item
-    if (found) {
-        entries.erase(keyToRemove);
-        stats.evictions++;
+    auto& list = takeT1 ? t1 : t2;
+    auto victim = takeT1 ? fromT1 : fromT2;
+    auto& ghosts = takeT1 ? b1 : b2;
+    size_t victimUnits = units(victim->weight);
+    
+    budget.release(victim->weight);
+    (takeT1 ? t1Units : t2Units) -= victimUnits;
+    ghosts.emplace_front(victim->key, victimUnits);
+    (takeT1 ? b1Units : b2Units) += victimUnits;
+    lookup[victim->key] = Location{takeT1 ? Segment::B1 : Segment::B2,
+                                   typename EntryList::iterator(), ghosts.begin()};
+    list.erase(victim);
+    stats.evictions++;
+    return true;
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::makeRoom(size_t incomingUnits, bool ghostHitInB2, const Key* keep) {
+    // Shield the entry being updated so only other entries are evicted
+    bool shielded = keep && pinnedKeys.insert(*keep).second;
+    while (t1Units + t2Units + incomingUnits > budget.capacity() && replace(ghostHitInB2)) {}
+    if (shielded) {
+        pinnedKeys.erase(*keep);
+    }
+}
+
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::trimGhosts() {
+    // Ghosts only remember what could have fit: T1 + B1 stays within the
+    // capacity and the whole directory within twice the capacity
+    size_t limit = budget.capacity();
+    auto dropOldest = [this](GhostList& ghosts, size_t& ghostUnits) {
+        ghostUnits -= ghosts.back().second;
+        lookup.erase(ghosts.back().first);
+        ghosts.pop_back();
+    };
+    while (!b1.empty() && t1Units + b1Units > limit) {
+        dropOldest(b1, b1Units);
+    }
+    while (t1Units + t2Units + b1Units + b2Units > 2 * limit && !(b1.empty() && b2.empty())) {
+        if (!b2.empty()) {
+            dropOldest(b2, b2Units);
+        } else {
+            dropOldest(b1, b1Units);
+        }
     }
 }
 
+template<typename Key, typename Value>
+void ARCCache<Key, Value>::removeLocked(const Key& key) {
+    auto it = lookup.find(key);
+    if (it == lookup.end()) {
+        return;
+    }
+    
+    const Location& location = it->second;
+    switch (location.segment) {
+        case Segment::T1:
+        case Segment::T2: {
+            size_t entryUnits = units(location.entry->weight);
+            budget.release(location.entry->weight);
+            if (location.segment == Segment::T1) {
+                t1Units -= entryUnits;
+                t1.erase(location.entry);
+            } else {
+                t2Units -= entryUnits;
+                t2.erase(location.entry);
+            }
+            break;
+        }
+        case Segment::B1:
+            b1Units -= location.ghost->second;
+            b1.erase(location.ghost);
+            break;
+        case Segment::B2:
+            b2Units -= location.ghost->second;
+            b2.erase(location.ghost);
+            break;
+    }
+    lookup.erase(it);
+    pinnedKeys.erase(key);
+}
+
 // ===== CacheManager Implementation =====
 
 template<typename Key, typename Value>
-CacheManager<Key, Value>::CacheManager(size_t capacity, CachePolicy policy) 
-    : cacheCapacity(capacity), currentPolicy(policy) {
+CacheManager<Key, Value>::CacheManager(size_t capacity, CachePolicy policy,
+                                       CapacityMode mode, Weigher<Key, Value> weigher)
+    : cacheCapacity(capacity), currentPolicy(policy), capacityMode(mode), weigher(std::move(weigher)) {
     recreateCache();
 }
 
+// managerMutex guards the policy cache pointer and its configuration. The
+// policy caches synchronize themselves, so plain operations only need it shared.
+
 template<typename Key, typename Value>
 void CacheManager<Key, Value>::put(const Key& key, const Value& value) {
-    std::lock_guard<std::mutex> lock(managerMutex);
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
     cache->put(key, value);
 }
 
 template<typename Key, typename Value>
 Value CacheManager<Key, Value>::get(const Key& key) {
-    std::lock_guard<std::mutex> lock(managerMutex);
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
     return cache->get(key);
 }
 
 template<typename Key, typename Value>
 bool CacheManager<Key, Value>::contains(const Key& key) const {
-    std::lock_guard<std::mutex> lock(managerMutex);
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
     return cache->contains(key);
 }
 
 template<typename Key, typename Value>
 void CacheManager<Key, Value>::remove(const Key& key) {
-    std::lock_guard<std::mutex> lock(managerMutex);
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
     cache->remove(key);
 }
 
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::putAll(const std::vector<std::pair<Key, Value>>& entries) {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    for (const auto& [key, value] : entries) {
+        cache->put(key, value);
+    }
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::removeAll(const std::vector<Key>& keys) {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    for (const auto& key : keys) {
+        cache->remove(key);
+    }
+}
+
 template<typename Key, typename Value>
 void CacheManager<Key, Value>::clear() {
-    std::lock_guard<std::mutex> lock(managerMutex);
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
     cache->clear();
 }
 
+template<typename Key, typename Value>
+std::optional<Value> CacheManager<Key, Value>::peek(const Key& key) const {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    return cache->peek(key);
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::touch(const Key* keys, size_t count) {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    cache->touch(keys, count);
+}
+
 template<typename Key, typename Value>
 void CacheManager<Key, Value>::setPolicy(CachePolicy policy) {
-    std::lock_guard<std::mutex> lock(managerMutex);
+    std::lock_guard<std::shared_mutex> lock(managerMutex);
     if (currentPolicy != policy) {
         currentPolicy = policy;
         recreateCache();
@@ -822,52 +1700,81 @@ void CacheManager<Key, Value>::setPolicy(CachePolicy policy) {
 
 template<typename Key, typename Value>
 CachePolicy CacheManager<Key, Value>::getPolicy() const {
-    std::lock_guard<std::mutex> lock(managerMutex);
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
     return currentPolicy;
 }
 
 template<typename Key, typename Value>
 void CacheManager<Key, Value>::resize(size_t newCapacity) {
-    std::lock_guard<std::mutex> lock(managerMutex);
+    std::lock_guard<std::shared_mutex> lock(managerMutex);
     if (cacheCapacity != newCapacity) {
         cacheCapacity = newCapacity;
         recreateCache();
     }
 }
 
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::setCapacityMode(CapacityMode mode, size_t newCapacity) {
+    std::lock_guard<std::shared_mutex> lock(managerMutex);
+    if (capacityMode != mode || cacheCapacity != newCapacity) {
+        capacityMode = mode;
+        cacheCapacity = newCapacity;
+        recreateCache();
+    }
+}
+
+template<typename Key, typename Value>
+CapacityMode CacheManager<Key, Value>::getCapacityMode() const {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    return capacityMode;
+}
+
+template<typename Key, typename Value>
+void CacheManager<Key, Value>::setWeigher(Weigher<Key, Value> newWeigher) {
+    std::lock_guard<std::shared_mutex> lock(managerMutex);
+    weigher = std::move(newWeigher);
+    recreateCache();
+}
+
 template<typename Key, typename Value>
 void CacheManager<Key, Value>::pin(const Key& key) {
-    std::lock_guard<std::mutex> lock(managerMutex);
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
     cache->pin(key);
 }
 
 template<typename Key, typename Value>
 void CacheManager<Key, Value>::unpin(const Key& key) {
-    std::lock_guard<std::mutex> lock(managerMutex);
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
     cache->unpin(key);
 }
 
 template<typename Key, typename Value>
 bool CacheManager<Key, Value>::isPinned(const Key& key) const {
-    std::lock_guard<std::mutex> lock(managerMutex);
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
     return cache->isPinned(key);
 }
 
 template<typename Key, typename Value>
 void CacheManager<Key, Value>::prefetch(const Key& key, const Value& value) {
-    std::lock_guard<std::mutex> lock(managerMutex);
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
     cache->prefetch(key, value);
 }
 
+template<typename Key, typename Value>
+bool CacheManager<Key, Value>::prefetchIfRoom(const Key& key, const Value& value) {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    return cache->prefetchIfRoom(key, value);
+}
+
 template<typename Key, typename Value>
 CacheStatistics CacheManager<Key, Value>::getStatistics() const {
-    std::lock_guard<std::mutex> lock(managerMutex);
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
     return cache->getStatistics();
 }
 
 template<typename Key, typename Value>
 void CacheManager<Key, Value>::resetStatistics() {
-    std::lock_guard<std::mutex> lock(managerMutex);
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
     cache->resetStatistics();
 }
 
@@ -882,62 +1789,69 @@ void CacheManager<Key, Value>::showCacheAnalytics() const {
         case CachePolicy::LFU: std::cout << "LFU (Least Frequently Used)"; break;
         case CachePolicy::FIFO: std::cout << "FIFO (First In, First Out)"; break;
         case CachePolicy::LIFO: std::cout << "LIFO (Last In, First Out)"; break;
+        case CachePolicy::ARC: std::cout << "ARC (Adaptive Replacement Cache)"; break;
     }
     std::cout << "\n";
-    std::cout << "Capacity: " << cacheCapacity << "\n";
-    std::cout << "Current Size: " << cache->size() << "\n";
+    if (capacityMode == CapacityMode::BYTES) {
+        std::cout << "Capacity: " << cacheCapacity << " bytes\n";
+    } else {
+        std::cout << "Capacity: " << cacheCapacity << " entries\n";
+    }
+    std::cout << "Current Size: " << stats.currentSize << "\n";
+    std::cout << "Resident Bytes: " << stats.residentBytes << "\n";
     std::cout << "Hit Rate: " << std::fixed << std::setprecision(2) << stats.hitRate << "%\n";
     std::cout << "Total Hits: " << stats.hits << "\n";
     std::cout << "Total Misses: " << stats.misses << "\n";
     std::cout << "Total Evictions: " << stats.evictions << "\n";
     std::cout << "Pinned Items: " << stats.pinnedItems << "\n";
     std::cout << "Prefetched Items: " << stats.prefetchedItems << "\n";
+    std::cout << "Prefetch Hit Rate: " << std::fixed << std::setprecision(2) << stats.prefetchHitRate << "%\n";
     std::cout << "==========================================\n\n";
 }
 
 template<typename Key, typename Value>
 std::vector<Key> CacheManager<Key, Value>::getHotKeys(size_t count) const {
-    std::lock_guard<std::mutex> lock(managerMutex);
-    auto keys = cache->getKeys();
-    
-    // Enhanced hot key detection: sort by access patterns
-    std::sort(keys.begin(), keys.end(), [this](const Key& a, const Key& b) {
-        // Get access statistics for both keys
-        bool aExists = cache->contains(a);
-        bool bExists = cache->contains(b);
-        
-        if (!aExists && !bExists) return false;
-        if (!aExists) return false;
-        if (!bExists) return true;
-        
-        // For now, use simple ordering (this could be enhanced with actual access counts)
-        // In a full implementation, you'd access the entry's accessCount and lastAccessed
-        return a < b;  // Placeholder ordering
-    });
-    
-    if (keys.size() > count) {
-        keys.resize(count);
+    auto counts = getAccessCounts();
+    std::vector<Key> keys;
+    keys.reserve(std::min(count, counts.size()));
+    for (size_t i = 0; i < counts.size() && i < count; ++i) {
+        keys.push_back(counts[i].first);
     }
     return keys;
 }
 
 template<typename Key, typename Value>
-void CacheManager<Key, Value>::warmup(const std::vector<std::pair<Key, Value>>& data) {
-    std::lock_guard<std::mutex> lock(managerMutex);
+std::vector<std::pair<Key, size_t>> CacheManager<Key, Value>::getAccessCounts() const {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    auto counts = cache->getAccessCounts();
+    std::stable_sort(counts.begin(), counts.end(),
+                     [](const std::pair<Key, size_t>& a, const std::pair<Key, size_t>& b) {
+                         return a.second > b.second;
+                     });
+    return counts;
+}
+
+template<typename Key, typename Value>
+size_t CacheManager<Key, Value>::warmup(const std::vector<std::pair<Key, Value>>& data) {
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
+    size_t admitted = 0;
     for (const auto& pair : data) {
-        cache->prefetch(pair.first, pair.second);
+        if (cache->prefetchIfRoom(pair.first, pair.second)) {
+            admitted++;
+        }
     }
+    return admitted;
 }
 
 template<typename Key, typename Value>
 void CacheManager<Key, Value>::optimizeForWorkload() {
-    // This could implement adaptive policy selection based on access patterns
-    // For now, it's a placeholder for future optimization algorithms
+    // A static policy with a low hit rate is handed over to ARC, which tunes
+    // the recency/frequency balance on its own from then on
     auto stats = getStatistics();
     
-    // Simple heuristic: if hit rate is low, consider switching policies
-    if (stats.hitRate < 50.0 && stats.totalAccesses > 100) {
-        std::cout << "Cache performance is suboptimal. Consider switching cache policy.\n";
+    if (stats.hitRate < 50.0 && stats.totalAccesses > 100 && getPolicy() != CachePolicy::ARC) {
+        std::cout << "Cache performance is suboptimal. Switching to the adaptive ARC policy.\n";
+        setPolicy(CachePolicy::ARC);
     }
 }
 
@@ -945,18 +1859,22 @@ template<typename Key, typename Value>
 void CacheManager<Key, Value>::recreateCache() {
     switch (currentPolicy) {
         case CachePolicy::LRU:
-            cache = std::make_unique<EnhancedLRUCache<Key, Value>>(cacheCapacity);
+            cache = std::make_unique<EnhancedLRUCache<Key, Value>>(cacheCapacity, capacityMode, weigher);
             break;
         case CachePolicy::LFU:
-            cache = std::make_unique<LFUCache<Key, Value>>(cacheCapacity);
+            cache = std::make_unique<LFUCache<Key, Value>>(cacheCapacity, capacityMode, weigher);
             break;
         case CachePolicy::FIFO:
-            cache = std::make_unique<FIFOCache<Key, Value>>(cacheCapacity);
-            break;        case CachePolicy::LIFO:
-            cache = std::make_unique<LIFOCache<Key, Value>>(cacheCapacity);
+            cache = std::make_unique<FIFOCache<Key, Value>>(cacheCapacity, capacityMode, weigher);
+            break;
+        case CachePolicy::LIFO:
+            cache = std::make_unique<LIFOCache<Key, Value>>(cacheCapacity, capacityMode, weigher);
+            break;
+        case CachePolicy::ARC:
+            cache = std::make_unique<ARCCache<Key, Value>>(cacheCapacity, capacityMode, weigher);
             break;
         default:
-            cache = std::make_unique<EnhancedLRUCache<Key, Value>>(cacheCapacity);
+            cache = std::make_unique<EnhancedLRUCache<Key, Value>>(cacheCapacity, capacityMode, weigher);
             break;
     }
 }
@@ -975,9 +1893,15 @@ void CacheManager<Key, Value>::showHotFileAnalytics(size_t topCount) const {
         case CachePolicy::LFU: std::cout << "LFU (Least Frequently Used)"; break;
         case CachePolicy::FIFO: std::cout << "FIFO (First In, First Out)"; break;
         case CachePolicy::LIFO: std::cout << "LIFO (Last In, First Out)"; break;
+        case CachePolicy::ARC: std::cout << "ARC (Adaptive Replacement Cache)"; break;
     }
     std::cout << "\n";
-    std::cout << "Total Cache Items: " << cache->size() << "/" << cacheCapacity << "\n";
+    if (capacityMode == CapacityMode::BYTES) {
+        std::cout << "Total Cache Items: " << stats.currentSize << " (" << stats.residentBytes
+                  << "/" << cacheCapacity << " bytes)\n";
+    } else {
+        std::cout << "Total Cache Items: " << stats.currentSize << "/" << cacheCapacity << "\n";
+    }
     std::cout << "Overall Hit Rate: " << std::fixed << std::setprecision(2) << stats.hitRate << "%\n";
     std::cout << "Total Accesses: " << stats.hits + stats.misses << "\n";
     std::cout << "Pinned Items: " << stats.pinnedItems << "\n";
@@ -1004,7 +1928,7 @@ void CacheManager<Key, Value>::showHotFileAnalytics(size_t topCount) const {
 
 template<typename Key, typename Value>
 std::vector<HotFileInfo<Key, Value>> CacheManager<Key, Value>::getHotFileDetails(size_t count) const {
-    std::lock_guard<std::mutex> lock(managerMutex);
+    std::shared_lock<std::shared_mutex> lock(managerMutex);
     std::vector<HotFileInfo<Key, Value>> hotFiles;
     auto keys = cache->getKeys();
     
@@ -1041,7 +1965,7 @@ std::vector<HotFileInfo<Key, Value>> CacheManager<Key, Value>::getHotFileDetails
 
 template<typename Key, typename Value>
 void CacheManager<Key, Value>::trackAccessPattern(const Key& key) {
-    std::lock_guard<std::mutex> lock(managerMutex);
+    std::lock_guard<std::shared_mutex> lock(managerMutex);
     
     // This would implement access pattern tracking
     // For example, detecting sequential access, temporal locality, etc.
@@ -1112,7 +2036,8 @@ void CacheManager<Key, Value>::monitorPerformance() {
     }
     
     // Memory utilization
-    double utilization = static_cast<double>(cache->size()) / cacheCapacity * 100;
+    size_t used = capacityMode == CapacityMode::BYTES ? stats.residentBytes : stats.currentSize;
+    double utilization = cacheCapacity > 0 ? static_cast<double>(used) / cacheCapacity * 100 : 0.0;
     std::cout << "Memory Utilization: " << std::fixed << std::setprecision(1) 
              << utilization << "%\n";
     
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace mtfs::cache {
+
+// Coarse steady-clock time that fits in 32 bits: whole seconds since the
+// owning arena was created
+using Tick = uint32_t;
+
+// Entry storage for the policies that keep their entries in one ordered
+// list (LRU, FIFO, LIFO). Entries live in a single slot array and are
+// threaded onto a doubly linked list by 32-bit slot indexes; a removed
+// entry's slot goes on a free list and is reused by the next insert. Keys
+// are found through an open-addressing table of slot indexes with linear
+// probing and backward-shift deletion, so there are no tombstones and no
+// per-entry heap nodes, and each key is stored once.
+//
+// Indexes stay valid until their entry is erased; references into a slot
+// do not survive an insert, which may grow the array. Not thread safe.
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class SlotArena {
+public:
+    using Index = uint32_t;
+    static constexpr Index NIL = std::numeric_limits<Index>::max();
+
+    struct Slot {
+        Key key{};
+        Value value{};
+        size_t weight{0};          // Bytes charged against the cache budget
+        uint32_t hash{0};          // Of key; compared before the key, and reused when the table grows
+        uint32_t accessCount{0};
+        Tick lastAccessed{0};
+        Index prev{NIL};           // Towards the front
+        Index next{NIL};           // Towards the back; the next free slot once erased
+        bool live{false};
+        bool isPinned{false};
+        bool prefetched{false};    // Loaded speculatively and not used since
+    };
+
+    SlotArena();
+
+    Index find(const Key& key) const;  // NIL if absent
+    // Adds a key that is not present at the front or the back of the list
+    Index insert(const Key& key, const Value& value, bool atFront = true);
+    void erase(Index index);
+    void moveToFront(Index index);
+    void clear();
+
+    Slot& operator[](Index index) { return slots[index]; }
+    const Slot& operator[](Index index) const { return slots[index]; }
+    Index front() const { return head; }
+    Index back() const { return tail; }
+    size_t size() const { return count; }
+    Tick now() const;
+
+    // Bytes held by the slot array and the table, not counting what keys
+    // and values point to
+    size_t footprint() const;
+
+private:
+    static constexpr size_t MIN_BUCKETS = 16;  // A power of two
+
+    uint32_t hashOf(const Key& key) const { return static_cast<uint32_t>(hasher(key)); }
+    size_t bucketOf(uint32_t hash) const { return hash & (table.size() - 1); }
+    void place(Index index);   // Into the table
+    void grow();               // Doubles the table
+    void linkFront(Index index);
+    void linkBack(Index index);
+    void unlink(Index index);
+
+    std::vector<Slot> slots;
+    std::vector<Index> table;  // NIL marks an empty bucket
+    Index freeList{NIL};
+    Index head{NIL};
+    Index tail{NIL};
+    size_t count{0};
+    Hash hasher;
+    std::chrono::steady_clock::time_point epoch;
+};
+
+} // namespace mtfs::cache
+
+#include "slot_arena.tpp"
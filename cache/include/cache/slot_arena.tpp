@@ -0,0 +1,182 @@
+#pragma once
+
+#include <stdexcept>
+
+namespace mtfs::cache {
+
+template<typename Key, typename Value, typename Hash>
+SlotArena<Key, Value, Hash>::SlotArena()
+    : table(MIN_BUCKETS, NIL), epoch(std::chrono::steady_clock::now()) {}
+
+template<typename Key, typename Value, typename Hash>
+typename SlotArena<Key, Value, Hash>::Index SlotArena<Key, Value, Hash>::find(const Key& key) const {
+    uint32_t hash = hashOf(key);
+    size_t mask = table.size() - 1;
+    for (size_t bucket = bucketOf(hash);; bucket = (bucket + 1) & mask) {
+        Index index = table[bucket];
+        if (index == NIL) {
+            return NIL;
+        }
+        if (slots[index].hash == hash && slots[index].key == key) {
+            return index;
+        }
+    }
+}
+
+template<typename Key, typename Value, typename Hash>
+typename SlotArena<Key, Value, Hash>::Index SlotArena<Key, Value, Hash>::insert(const Key& key, const Value& value,
+                                                                                 bool atFront) {
+    // At most three quarters full, so probe runs stay short
+    if ((count + 1) * 4 > table.size() * 3) {
+        grow();
+    }
+    Index index = freeList;
+    if (index != NIL) {
+        freeList = slots[index].next;
+    } else {
+        if (slots.size() >= NIL) {
+            throw std::length_error("SlotArena is full");
+        }
+        slots.emplace_back();
+        index = static_cast<Index>(slots.size() - 1);
+    }
+
+    Slot& slot = slots[index];
+    slot.key = key;
+    slot.value = value;
+    slot.weight = 0;
+    slot.hash = hashOf(key);
+    slot.accessCount = 0;
+    slot.lastAccessed = now();
+    slot.live = true;
+    slot.isPinned = false;
+    slot.prefetched = false;
+    place(index);
+    if (atFront) {
+        linkFront(index);
+    } else {
+        linkBack(index);
+    }
+    count++;
+    return index;
+}
+
+template<typename Key, typename Value, typename Hash>
+void SlotArena<Key, Value, Hash>::erase(Index index) {
+    size_t mask = table.size() - 1;
+    size_t hole = bucketOf(slots[index].hash);
+    while (table[hole] != index) {
+        hole = (hole + 1) & mask;
+    }
+    // Pull later entries of the run back into the hole unless that would put
+    // one before its home bucket
+    for (size_t bucket = (hole + 1) & mask; table[bucket] != NIL; bucket = (bucket + 1) & mask) {
+        size_t home = bucketOf(slots[table[bucket]].hash);
+        if (((bucket - home) & mask) >= ((bucket - hole) & mask)) {
+            table[hole] = table[bucket];
+            hole = bucket;
+        }
+    }
+    table[hole] = NIL;
+
+    unlink(index);
+    Slot& slot = slots[index];
+    slot.key = Key{};
+    slot.value = Value{};  // Release what the value holds now, not when the slot is reused
+    slot.live = false;
+    slot.next = freeList;
+    freeList = index;
+    count--;
+}
+
+template<typename Key, typename Value, typename Hash>
+void SlotArena<Key, Value, Hash>::moveToFront(Index index) {
+    if (index != head) {
+        unlink(index);
+        linkFront(index);
+    }
+}
+
+template<typename Key, typename Value, typename Hash>
+void SlotArena<Key, Value, Hash>::clear() {
+    slots.clear();
+    table.assign(MIN_BUCKETS, NIL);
+    freeList = NIL;
+    head = NIL;
+    tail = NIL;
+    count = 0;
+}
+
+template<typename Key, typename Value, typename Hash>
+Tick SlotArena<Key, Value, Hash>::now() const {
+    return static_cast<Tick>(
+        std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - epoch).count());
+}
+
+template<typename Key, typename Value, typename Hash>
+size_t SlotArena<Key, Value, Hash>::footprint() const {
+    return slots.capacity() * sizeof(Slot) + table.capacity() * sizeof(Index);
+}
+
+template<typename Key, typename Value, typename Hash>
+void SlotArena<Key, Value, Hash>::place(Index index) {
+    size_t mask = table.size() - 1;
+    size_t bucket = bucketOf(slots[index].hash);
+    while (table[bucket] != NIL) {
+        bucket = (bucket + 1) & mask;
+    }
+    table[bucket] = index;
+}
+
+template<typename Key, typename Value, typename Hash>
+void SlotArena<Key, Value, Hash>::grow() {
+    table.assign(table.size() * 2, NIL);
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (slots[i].live) {
+            place(static_cast<Index>(i));
+        }
+    }
+}
+
+template<typename Key, typename Value, typename Hash>
+void SlotArena<Key, Value, Hash>::linkFront(Index index) {
+    slots[index].prev = NIL;
+    slots[index].next = head;
+    if (head != NIL) {
+        slots[head].prev = index;
+    } else {
+        tail = index;
+    }
+    head = index;
+}
+
+template<typename Key, typename Value, typename Hash>
+void SlotArena<Key, Value, Hash>::linkBack(Index index) {
+    slots[index].next = NIL;
+    slots[index].prev = tail;
+    if (tail != NIL) {
+        slots[tail].next = index;
+    } else {
+        head = index;
+    }
+    tail = index;
+}
+
+template<typename Key, typename Value, typename Hash>
+void SlotArena<Key, Value, Hash>::unlink(Index index) {
+    Slot& slot = slots[index];
+    if (slot.prev != NIL) {
+        slots[slot.prev].next = slot.next;
+    } else {
+        head = slot.next;
+    }
+    if (slot.next != NIL) {
+        slots[slot.next].prev = slot.prev;
+    } else {
+        tail = slot.prev;
+    }
+    slot.prev = NIL;
+    slot.next = NIL;
+}
+
+} // namespace mtfs::cache
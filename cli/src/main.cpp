@@ -68,15 +68,17 @@ void printUsage() {
               << "  restore-backup <backup_name> [target_directory]\n"
               << "  delete-backup <backup_name>\n"
               << "  list-backups\n"              << "  backup-dashboard\n"
-              << "  set-cache-policy <policy>    # LRU, LFU, FIFO, LIFO\n"
+              << "  set-cache-policy <policy>    # LRU, LFU, FIFO, LIFO, ARC\n"
               << "  get-cache-policy\n"
               << "  resize-cache <size>\n"
+              << "  set-cache-budget <bytes>     # Bound the cache by resident bytes\n"
               << "  pin-file <filename>\n"
               << "  unpin-file <filename>\n"
               << "  prefetch-file <filename>\n"
               << "  cache-analytics\n"
               << "  hot-files [count]\n"
               << "  show-stats\n"
+              << "  perf-histogram\n"
               << "  reset-stats\n"
               << "  exit\n"
               << std::endl;
@@ -97,6 +99,7 @@ int main() {
 
         std::string line;
         while (true) {
+            mtfs::common::flush_logs();
             std::cout << "> ";
             std::getline(std::cin, line);
 
@@ -193,8 +196,8 @@ int main() {
                         std::cout << "Usage: read-file <filename>" << std::endl;
                         continue;
                     }
-                    std::string content = fs->readFile(tokens[1]);
-                    std::cout << "Content of " << tokens[1] << ":\n" << content << std::endl;
+                    auto content = fs->readFileShared(tokens[1]);
+                    std::cout << "Content of " << tokens[1] << ":\n" << *content << std::endl;
                     LOG_INFO("Read file: " + tokens[1]);
                 }
                 else if (cmd == "delete-file") {
@@ -296,6 +299,10 @@ int main() {
                     fs->showPerformanceDashboard();
                     LOG_INFO("Displayed performance statistics");
                 }
+                else if (cmd == "perf-histogram") {
+                    fs->showLatencyHistograms();
+                    LOG_INFO("Displayed latency histograms");
+                }
                 else if (cmd == "reset-stats") {
                     fs->resetStats();
                     std::cout << "Performance statistics have been reset." << std::endl;
@@ -389,7 +396,7 @@ int main() {
                 }
                 else if (cmd == "set-cache-policy") {
                     if (tokens.size() != 2) {
-                        std::cout << "Usage: set-cache-policy <policy>  # LRU, LFU, FIFO, LIFO" << std::endl;
+                        std::cout << "Usage: set-cache-policy <policy>  # LRU, LFU, FIFO, LIFO, ARC" << std::endl;
                         continue;
                     }                    std::string policyStr = tokens[1];
                     CachePolicy policy;
@@ -397,8 +404,9 @@ int main() {
                     else if (policyStr == "LFU") policy = CachePolicy::LFU;
                     else if (policyStr == "FIFO") policy = CachePolicy::FIFO;
                     else if (policyStr == "LIFO") policy = CachePolicy::LIFO;
+                    else if (policyStr == "ARC") policy = CachePolicy::ARC;
                     else {
-                        std::cout << "Invalid policy. Use: LRU, LFU, FIFO, or LIFO" << std::endl;
+                        std::cout << "Invalid policy. Use: LRU, LFU, FIFO, LIFO, or ARC" << std::endl;
                         continue;
                     }
                     fs->setCachePolicy(policy);
@@ -412,6 +420,7 @@ int main() {
                         case CachePolicy::LFU: policyStr = "LFU"; break;
                         case CachePolicy::FIFO: policyStr = "FIFO"; break;
                         case CachePolicy::LIFO: policyStr = "LIFO"; break;
+                        case CachePolicy::ARC: policyStr = "ARC"; break;
                         default: policyStr = "Unknown"; break;
                     }
                     std::cout << "Current cache policy: " << policyStr << std::endl;
@@ -426,6 +435,16 @@ int main() {
                     std::cout << "Cache resized to: " << newSize << std::endl;
                     LOG_INFO("Resized cache to: " + std::to_string(newSize));
                 }
+                else if (cmd == "set-cache-budget") {
+                    if (tokens.size() != 2) {
+                        std::cout << "Usage: set-cache-budget <bytes>" << std::endl;
+                        continue;
+                    }
+                    size_t budget = std::stoull(tokens[1]);
+                    fs->setCacheByteBudget(budget);
+                    std::cout << "Cache byte budget set to: " << budget << " bytes" << std::endl;
+                    LOG_INFO("Set cache byte budget to: " + std::to_string(budget));
+                }
                 else if (cmd == "pin-file") {
                     if (tokens.size() != 2) {
                         std::cout << "Usage: pin-file <filename>" << std::endl;
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mtfs::common {
+
+// CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320) used to detect torn or
+// corrupted on-disk records. Pass the previous result as `crc` to checksum
+// data incrementally.
+uint32_t crc32(const void* data, std::size_t length, uint32_t crc = 0);
+
+// 128-bit MurmurHash3 (x64 variant), used to address content by value. Fast
+// and well distributed, but not collision resistant against crafted input.
+struct Hash128 {
+    uint64_t low{0};
+    uint64_t high{0};
+
+    bool operator==(const Hash128& other) const { return low == other.low && high == other.high; }
+    bool operator!=(const Hash128& other) const { return !(*this == other); }
+};
+
+Hash128 hash128(const void* data, std::size_t length, uint64_t seed = 0);
+
+} // namespace mtfs::common
@@ -1,15 +1,43 @@
 #pragma once
 #include <string>
 
+// Lowest level compiled in. Calls below it are discarded at compile time,
+// including the construction of their message. Defaults to DEBUG in debug
+// builds and INFO otherwise; set with the MTFS_LOG_LEVEL CMake option.
+#define MTFS_LOG_LEVEL_DEBUG 0
+#define MTFS_LOG_LEVEL_INFO 1
+#define MTFS_LOG_LEVEL_ERROR 2
+
+#ifndef MTFS_LOG_LEVEL
+#ifdef NDEBUG
+#define MTFS_LOG_LEVEL MTFS_LOG_LEVEL_INFO
+#else
+#define MTFS_LOG_LEVEL MTFS_LOG_LEVEL_DEBUG
+#endif
+#endif
+
 namespace mtfs::common {
 
-void log_info(const std::string& message);
-void log_error(const std::string& message);
-void log_debug(const std::string& message);
+// Messages are queued with their timestamp and written in batches by a
+// background thread, which formats them and flushes the streams: DEBUG and
+// INFO to stdout, ERROR to stderr. ERROR wakes the writer immediately.
+void log_info(std::string message);
+void log_error(std::string message);
+void log_debug(std::string message);
+
+// Blocks until every message logged before the call has been written
+void flush_logs();
 
 // Simple macros for logging
-#define LOG_INFO(msg) mtfs::common::log_info(msg)
-#define LOG_ERROR(msg) mtfs::common::log_error(msg)
-#define LOG_DEBUG(msg) mtfs::common::log_debug(msg)
+#define MTFS_LOG_AT(level, function, msg)                   \
+    do {                                                    \
+        if constexpr (MTFS_LOG_LEVEL <= (level)) {          \
+            function(msg);                                  \
+        }                                                   \
+    } while (0)
+
+#define LOG_INFO(msg) MTFS_LOG_AT(MTFS_LOG_LEVEL_INFO, mtfs::common::log_info, msg)
+#define LOG_ERROR(msg) MTFS_LOG_AT(MTFS_LOG_LEVEL_ERROR, mtfs::common::log_error, msg)
+#define LOG_DEBUG(msg) MTFS_LOG_AT(MTFS_LOG_LEVEL_DEBUG, mtfs::common::log_debug, msg)
 
-} // namespace mtfs::common 
\ No newline at end of file
+} // namespace mtfs::common
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace mtfs::common {
+
+// Metrics are recorded into per-thread slots and merged when read, so hot
+// paths never write a cache line another thread writes. Threads past
+// METRIC_THREAD_SLOTS share slots, which stays correct but may contend.
+constexpr size_t METRIC_THREAD_SLOTS = 64;
+size_t metricThreadSlot();  // The calling thread's slot, fixed for its lifetime
+
+class ShardedCounter {
+public:
+    void add(uint64_t amount = 1) {
+        slots[metricThreadSlot()].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+    uint64_t load() const;
+    void reset();
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Slot, METRIC_THREAD_SLOTS> slots;
+};
+
+// Merged contents of a LatencyHistogram. Values are nanoseconds.
+class HistogramSnapshot {
+public:
+    uint64_t count() const { return total; }
+    uint64_t max() const { return maxValue; }
+    double mean() const { return total ? static_cast<double>(sum) / total : 0.0; }
+
+    // Smallest recorded value that `percent` of the values do not exceed,
+    // to the histogram's precision; 0 when empty
+    uint64_t percentile(double percent) const;
+
+    // (lower bound, count) of every non-empty bucket, in value order
+    std::vector<std::pair<uint64_t, uint64_t>> buckets() const;
+
+    void merge(const HistogramSnapshot& other);
+
+private:
+    friend class LatencyHistogram;
+
+    std::vector<uint64_t> counts;
+    uint64_t total{0};
+    uint64_t sum{0};
+    uint64_t maxValue{0};
+};
+
+// HDR-style latency histogram. Buckets are log-linear: exact below 32ns,
+// then 32 per power of two, so a value is reported within 1/32 (about 3%)
+// of itself. Values past 2^42ns (73 minutes) land in the last bucket. A
+// thread slot's buckets are allocated the first time that slot records.
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t GROUPS = 38;
+    static constexpr size_t BUCKETS = GROUPS * SUB_BUCKETS;
+
+    LatencyHistogram() = default;
+    ~LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(uint64_t nanoseconds);
+    void record(std::chrono::nanoseconds duration) {
+        record(static_cast<uint64_t>(duration.count() < 0 ? 0 : duration.count()));
+    }
+
+    HistogramSnapshot snapshot() const;
+    void reset();
+
+    static size_t bucketOf(uint64_t value);
+    static uint64_t bucketLowerBound(size_t bucket);
+    static uint64_t bucketWidth(size_t bucket);
+
+private:
+    struct Slot {
+        std::array<std::atomic<uint64_t>, BUCKETS> counts{};
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> max{0};
+    };
+
+    Slot& slot();
+
+    std::array<std::atomic<Slot*>, METRIC_THREAD_SLOTS> slots{};
+};
+
+// Records the time from construction to destruction into a histogram
+class LatencyTimer {
+public:
+    explicit LatencyTimer(LatencyHistogram& histogram)
+        : histogram(histogram), start(std::chrono::steady_clock::now()) {}
+    ~LatencyTimer() { histogram.record(std::chrono::steady_clock::now() - start); }
+
+    LatencyTimer(const LatencyTimer&) = delete;
+    LatencyTimer& operator=(const LatencyTimer&) = delete;
+
+private:
+    LatencyHistogram& histogram;
+    std::chrono::steady_clock::time_point start;
+};
+
+} // namespace mtfs::common
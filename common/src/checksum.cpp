@@ -0,0 +1,109 @@
+#include "common/checksum.hpp"
+#include <array>
+#include <cstring>
+
+namespace mtfs::common {
+
+namespace {
+
+constexpr std::array<uint32_t, 256> makeCrcTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t value = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            value = (value & 1) ? (value >> 1) ^ 0xEDB88320u : (value >> 1);
+        }
+        table[i] = value;
+    }
+    return table;
+}
+
+constexpr auto CRC_TABLE = makeCrcTable();
+
+uint64_t rotl64(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+uint64_t fmix64(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+} // namespace
+
+uint32_t crc32(const void* data, std::size_t length, uint32_t crc) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (std::size_t i = 0; i < length; ++i) {
+        crc = CRC_TABLE[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+Hash128 hash128(const void* data, std::size_t length, uint64_t seed) {
+    constexpr uint64_t C1 = 0x87c37b91114253d5ULL;
+    constexpr uint64_t C2 = 0x4cf5ad432745937fULL;
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    uint64_t h1 = seed;
+    uint64_t h2 = seed;
+
+    auto mixK1 = [&](uint64_t k1) {
+        k1 *= C1;
+        k1 = rotl64(k1, 31);
+        k1 *= C2;
+        h1 ^= k1;
+    };
+    auto mixK2 = [&](uint64_t k2) {
+        k2 *= C2;
+        k2 = rotl64(k2, 33);
+        k2 *= C1;
+        h2 ^= k2;
+    };
+
+    std::size_t blocks = length / 16;
+    for (std::size_t i = 0; i < blocks; ++i) {
+        uint64_t k1;
+        uint64_t k2;
+        std::memcpy(&k1, bytes + i * 16, sizeof(k1));
+        std::memcpy(&k2, bytes + i * 16 + 8, sizeof(k2));
+        mixK1(k1);
+        h1 = rotl64(h1, 27);
+        h1 += h2;
+        h1 = h1 * 5 + 0x52dce729;
+        mixK2(k2);
+        h2 = rotl64(h2, 31);
+        h2 += h1;
+        h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    // The 0-15 trailing bytes, zero-padded as the reference reads them
+    std::size_t tailLength = length & 15;
+    if (tailLength > 0) {
+        uint8_t tail[16] = {};
+        std::memcpy(tail, bytes + blocks * 16, tailLength);
+        uint64_t k1;
+        uint64_t k2;
+        std::memcpy(&k1, tail, sizeof(k1));
+        std::memcpy(&k2, tail + 8, sizeof(k2));
+        if (tailLength > 8) {
+            mixK2(k2);
+        }
+        mixK1(k1);
+    }
+
+    h1 ^= length;
+    h2 ^= length;
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+    h1 += h2;
+    h2 += h1;
+    return Hash128{h1, h2};
+}
+
+} // namespace mtfs::common
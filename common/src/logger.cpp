@@ -1,29 +1,259 @@
 #include "common/logger.hpp"
-#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
 #include <ctime>
-#include <iomanip>
-#include <sstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace mtfs::common {
 
-static std::string getCurrentTime() {
-    auto now = std::time(nullptr);
-    auto tm = *std::localtime(&now);
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+namespace {
+
+enum class LogLevel { Debug, Info, Error };
+
+struct LogRecord {
+    LogLevel level{LogLevel::Info};
+    std::chrono::system_clock::time_point time;
+    std::string message;
+};
+
+// Bounded lock-free multi-producer ring. Each cell's sequence number says
+// whether it is free for the producer claiming position p (sequence == p)
+// or holds that producer's record (sequence == p + 1). Popping is done by
+// one consumer at a time.
+class LogRing {
+public:
+    static constexpr size_t CAPACITY = 4096;  // Power of two
+
+    LogRing() : cells(new Cell[CAPACITY]) {
+        for (size_t i = 0; i < CAPACITY; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Moves the record in; false and untouched if the ring is full
+    bool tryPush(LogRecord& record) {
+        size_t position = head.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[position & (CAPACITY - 1)];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto lag = static_cast<std::intptr_t>(sequence - position);
+            if (lag == 0) {
+                if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.record = std::move(record);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;
+            } else {
+                position = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // False if the next record is not there yet
+    bool tryPop(LogRecord& record) {
+        Cell& cell = cells[tail & (CAPACITY - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) != tail + 1) {
+            return false;
+        }
+        record = std::move(cell.record);
+        cell.sequence.store(tail + CAPACITY, std::memory_order_release);
+        ++tail;
+        return true;
+    }
+
+    size_t claimed() const { return head.load(std::memory_order_acquire); }
+    size_t popped() const { return tail; }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence{0};
+        LogRecord record;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) size_t tail{0};
+};
+
+class AsyncLogger {
+public:
+    static AsyncLogger& instance() {
+        // Never destroyed, so objects may log from their destructors; the
+        // writer thread is stopped at exit and later messages are written
+        // synchronously
+        static AsyncLogger* logger = [] {
+            auto* created = new AsyncLogger();
+            std::atexit([] { instance().stop(); });
+            return created;
+        }();
+        return *logger;
+    }
+
+    void write(LogLevel level, std::string message) {
+        LogRecord record{level, std::chrono::system_clock::now(), std::move(message)};
+        while (running.load()) {
+            if (ring.tryPush(record)) {
+                if (level == LogLevel::Error) {
+                    urgent.store(true, std::memory_order_relaxed);
+                    wake.notify_one();
+                }
+                if (!running.load()) {
+                    flush();  // The writer may have stopped before seeing it
+                }
+                return;
+            }
+            // Full: let the writer catch up rather than drop the message
+            wake.notify_one();
+            std::this_thread::yield();
+        }
+        std::lock_guard<std::mutex> lock(outputMutex);
+        drainLocked();
+        std::string line;
+        format(record, line);
+        emit(record.level == LogLevel::Error ? std::cerr : std::cout, line);
+    }
+
+    void flush() {
+        if (!running.load()) {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            drainLocked();
+            return;
+        }
+        size_t target = ring.claimed();
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        ++flushWaiters;
+        wake.notify_one();
+        flushed.wait(lock, [&] { return written >= target || !running.load(); });
+        --flushWaiters;
+    }
+
+private:
+    static constexpr auto WRITE_INTERVAL = std::chrono::milliseconds(20);
+
+    AsyncLogger() : writer([this] { run(); }) {}
+
+    void stop() {
+        running.store(false);
+        wake.notify_all();
+        if (writer.joinable()) {
+            writer.join();
+        }
+        {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            drainLocked();
+        }
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        flushed.notify_all();
+    }
+
+    void run() {
+        while (running.load()) {
+            size_t done;
+            {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                drainLocked();
+                done = ring.popped();
+            }
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            written = done;
+            if (flushWaiters > 0) {
+                flushed.notify_all();
+            }
+            wake.wait_for(lock, WRITE_INTERVAL, [&] {
+                return !running.load() || urgent.exchange(false, std::memory_order_relaxed) ||
+                       (flushWaiters > 0 && ring.claimed() > written);
+            });
+        }
+    }
+
+    // Writes out everything queued; the caller holds outputMutex
+    void drainLocked() {
+        out.clear();
+        err.clear();
+        LogRecord record;
+        while (ring.tryPop(record)) {
+            format(record, record.level == LogLevel::Error ? err : out);
+        }
+        if (!out.empty()) {
+            emit(std::cout, out);
+        }
+        if (!err.empty()) {
+            emit(std::cerr, err);
+        }
+    }
+
+    void format(const LogRecord& record, std::string& line) {
+        std::time_t seconds = std::chrono::system_clock::to_time_t(record.time);
+        if (seconds != stampSecond) {
+            std::tm tm{};
+#ifdef _WIN32
+            localtime_s(&tm, &seconds);
+#else
+            localtime_r(&seconds, &tm);
+#endif
+            char text[32];
+            stamp.assign(text, std::strftime(text, sizeof(text), "[%Y-%m-%d %H:%M:%S] ", &tm));
+            stampSecond = seconds;
+        }
+        line += stamp;
+        switch (record.level) {
+            case LogLevel::Debug: line += "[DEBUG] "; break;
+            case LogLevel::Info: line += "[INFO] "; break;
+            case LogLevel::Error: line += "[ERROR] "; break;
+        }
+        line += record.message;
+        line += '\n';
+    }
+
+    static void emit(std::ostream& stream, const std::string& text) {
+        stream.write(text.data(), static_cast<std::streamsize>(text.size()));
+        stream.flush();
+    }
+
+    LogRing ring;
+    std::atomic<bool> running{true};
+    std::atomic<bool> urgent{false};
+
+    // Formatting state and output, owned by whoever drains under outputMutex
+    std::mutex outputMutex;
+    std::string out;
+    std::string err;
+    std::string stamp;
+    std::time_t stampSecond{-1};
+
+    std::mutex wakeMutex;  // written and flushWaiters
+    std::condition_variable wake;
+    std::condition_variable flushed;
+    size_t written{0};
+    size_t flushWaiters{0};
+
+    std::thread writer;  // Last, so it starts after the rest is constructed
+};
+
+} // namespace
+
+void log_debug(std::string message) {
+    AsyncLogger::instance().write(LogLevel::Debug, std::move(message));
 }
 
-void log_debug(const std::string& message) {
-    std::cout << "[" << getCurrentTime() << "] [DEBUG] " << message << std::endl;
+void log_info(std::string message) {
+    AsyncLogger::instance().write(LogLevel::Info, std::move(message));
 }
 
-void log_info(const std::string& message) {
-    std::cout << "[" << getCurrentTime() << "] [INFO] " << message << std::endl;
+void log_error(std::string message) {
+    AsyncLogger::instance().write(LogLevel::Error, std::move(message));
 }
 
-void log_error(const std::string& message) {
-    std::cerr << "[" << getCurrentTime() << "] [ERROR] " << message << std::endl;
+void flush_logs() {
+    AsyncLogger::instance().flush();
 }
 
-} // namespace mtfs::common 
\ No newline at end of file
+} // namespace mtfs::common
@@ -0,0 +1,155 @@
+#include "common/metrics.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace mtfs::common {
+
+size_t metricThreadSlot() {
+    static std::atomic<size_t> nextSlot{0};
+    thread_local size_t slot = nextSlot.fetch_add(1, std::memory_order_relaxed) % METRIC_THREAD_SLOTS;
+    return slot;
+}
+
+uint64_t ShardedCounter::load() const {
+    uint64_t total = 0;
+    for (const auto& slot : slots) {
+        total += slot.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void ShardedCounter::reset() {
+    for (auto& slot : slots) {
+        slot.value.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t HistogramSnapshot::percentile(double percent) const {
+    if (total == 0) {
+        return 0;
+    }
+    double clamped = std::min(std::max(percent, 0.0), 100.0);
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * total)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            // Highest value the bucket holds, but never above what was seen
+            uint64_t highest = LatencyHistogram::bucketLowerBound(i) + LatencyHistogram::bucketWidth(i) - 1;
+            return std::min(highest, maxValue);
+        }
+    }
+    return maxValue;
+}
+
+std::vector<std::pair<uint64_t, uint64_t>> HistogramSnapshot::buckets() const {
+    std::vector<std::pair<uint64_t, uint64_t>> result;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i]) {
+            result.emplace_back(LatencyHistogram::bucketLowerBound(i), counts[i]);
+        }
+    }
+    return result;
+}
+
+void HistogramSnapshot::merge(const HistogramSnapshot& other) {
+    if (counts.size() < other.counts.size()) {
+        counts.resize(other.counts.size(), 0);
+    }
+    for (size_t i = 0; i < other.counts.size(); ++i) {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+    sum += other.sum;
+    maxValue = std::max(maxValue, other.maxValue);
+}
+
+LatencyHistogram::~LatencyHistogram() {
+    for (auto& slot : slots) {
+        delete slot.load(std::memory_order_relaxed);
+    }
+}
+
+size_t LatencyHistogram::bucketOf(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+    }
+    // Group g >= 1 holds [2^(g+4), 2^(g+5)) in buckets 2^(g-1) wide
+    unsigned topBit = 63;
+    while (!(value >> topBit)) {
+        --topBit;
+    }
+    size_t group = topBit - SUB_BUCKET_BITS + 1;
+    if (group >= GROUPS) {
+        return BUCKETS - 1;
+    }
+    return group * SUB_BUCKETS + static_cast<size_t>((value >> (group - 1)) - SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(size_t bucket) {
+    size_t group = bucket / SUB_BUCKETS;
+    uint64_t sub = bucket % SUB_BUCKETS;
+    return group == 0 ? sub : (SUB_BUCKETS + sub) << (group - 1);
+}
+
+uint64_t LatencyHistogram::bucketWidth(size_t bucket) {
+    size_t group = bucket / SUB_BUCKETS;
+    return group == 0 ? 1 : uint64_t(1) << (group - 1);
+}
+
+LatencyHistogram::Slot& LatencyHistogram::slot() {
+    auto& entry = slots[metricThreadSlot()];
+    Slot* current = entry.load(std::memory_order_acquire);
+    if (!current) {
+        auto* fresh = new Slot();
+        if (entry.compare_exchange_strong(current, fresh, std::memory_order_acq_rel)) {
+            current = fresh;
+        } else {
+            delete fresh;  // Another thread sharing the slot won
+        }
+    }
+    return *current;
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    Slot& target = slot();
+    target.counts[bucketOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    target.sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+    uint64_t seen = target.max.load(std::memory_order_relaxed);
+    while (nanoseconds > seen &&
+           !target.max.compare_exchange_weak(seen, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const {
+    HistogramSnapshot merged;
+    merged.counts.assign(BUCKETS, 0);
+    for (const auto& entry : slots) {
+        const Slot* slot = entry.load(std::memory_order_acquire);
+        if (!slot) {
+            continue;
+        }
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            uint64_t count = slot->counts[i].load(std::memory_order_relaxed);
+            merged.counts[i] += count;
+            merged.total += count;
+        }
+        merged.sum += slot->sum.load(std::memory_order_relaxed);
+        merged.maxValue = std::max(merged.maxValue, slot->max.load(std::memory_order_relaxed));
+    }
+    return merged;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& entry : slots) {
+        if (Slot* slot = entry.load(std::memory_order_acquire)) {
+            for (auto& count : slot->counts) {
+                count.store(0, std::memory_order_relaxed);
+            }
+            slot->sum.store(0, std::memory_order_relaxed);
+            slot->max.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+} // namespace mtfs::common
@@ -7,6 +7,10 @@
 #include <memory>
 #include <stdexcept>
 #include "common/error.hpp"
+#include "fs/chunk_store.hpp"
+#include "fs/copy_engine.hpp"
+#include "fs/file_index.hpp"
+#include "fs/directory_walker.hpp"
 
 namespace mtfs::fs {
 
@@ -20,6 +24,7 @@ struct BackupMetadata {
     std::chrono::system_clock::time_point lastModified;
     size_t totalFiles{0};
     size_t totalSize{0};
+    size_t storedSize{0};      // New chunk bytes this backup added to the store
     bool isIncremental{false};
     std::string parentBackup; // For incremental backups
     std::vector<std::string> includedFiles;
@@ -34,10 +39,36 @@ struct BackupStats {
     size_t filesBackedUp{0};
     std::chrono::system_clock::time_point lastBackupTime;
     double compressionRatio{0.0};
+    size_t bytesDeduplicated{0};  // Backed-up bytes that were already in the chunk store
+    std::chrono::nanoseconds backupTime{0};  // Spent writing backups
+    size_t bytesCopied{0};                   // Whole files copied by the CopyEngine
+    std::chrono::nanoseconds copyTime{0};
+    size_t bytesRestored{0};                 // Restored from chunks and verified
+    std::chrono::nanoseconds restoreTime{0};
     
     BackupStats() : lastBackupTime(std::chrono::system_clock::now()) {}
+
+    // MiB per second
+    double backupThroughput() const {
+        double seconds = std::chrono::duration<double>(backupTime).count();
+        return seconds > 0 ? static_cast<double>(totalBackupSize) / (1024.0 * 1024.0) / seconds : 0.0;
+    }
+    double copyThroughput() const {
+        double seconds = std::chrono::duration<double>(copyTime).count();
+        return seconds > 0 ? static_cast<double>(bytesCopied) / (1024.0 * 1024.0) / seconds : 0.0;
+    }
+    double restoreThroughput() const {
+        double seconds = std::chrono::duration<double>(restoreTime).count();
+        return seconds > 0 ? static_cast<double>(bytesRestored) / (1024.0 * 1024.0) / seconds : 0.0;
+    }
 };
 
+// Backups are manifests of content-defined chunks in a store shared by every
+// backup (<backupDirectory>/.chunks), so each backup only writes the chunks
+// that changed. Each backup also keeps a FileIndex of the stamps it saw;
+// incremental backups and getChangedFiles compare against it by stat alone.
+// Backups made before the store existed hold full copies and are still
+// restored from them.
 class BackupManager {
 public:
     explicit BackupManager(const std::string& backupDirectory);
@@ -73,11 +104,16 @@ private:
     std::string backupDirectory;
     std::string metadataFile;
     mutable BackupStats stats;
+    std::unique_ptr<ChunkStore> chunkStore;
     
     // Internal helper methods
     bool initializeBackupDirectory();
     std::string getBackupPath(const std::string& backupName) const;
     std::string getMetadataPath(const std::string& backupName) const;
+    std::string getManifestPath(const std::string& backupName) const;
+    std::string getIndexPath(const std::string& backupName) const;
+    void writeBackup(BackupMetadata& metadata, const std::string& sourceDirectory);
+    void collectUnreferencedChunks();
     
     // Metadata management
     bool saveBackupMetadata(const BackupMetadata& metadata) const;
@@ -88,9 +124,10 @@ private:
     bool copyFileToBackup(const std::string& sourcePath, const std::string& backupPath) const;
     bool copyDirectoryToBackup(const std::string& sourceDir, const std::string& backupDir) const;
     bool restoreFileFromBackup(const std::string& backupPath, const std::string& targetPath) const;
+    void recordCopy(const CopyResult& copied) const;
     
     // Utility methods
-    std::vector<std::string> getDirectoryFiles(const std::string& directory) const;
+    std::vector<DirectoryEntry> getDirectoryFiles(const std::string& directory) const;  // Files only, sorted
     std::string getFileHash(const std::string& filePath) const;
     bool isFileModified(const std::string& filePath, const std::chrono::system_clock::time_point& lastBackupTime) const;
     std::string formatFileSize(size_t bytes) const;
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace mtfs::fs {
+
+struct WarmRestartOptions {
+    bool enabled{false};
+    uint64_t bytesPerSecond{16ull << 20};  // Reload budget, kept well below what demand reads get
+};
+
+// Carries the cache's working set across a restart. save() records which
+// files were resident and how often each was hit, never their contents;
+// start() reads them back hottest first on a thread of its own, in batches
+// paced to a byte rate, so a cold start's demand reads keep the disk.
+class CacheWarmer {
+public:
+    struct Entry {
+        std::string path;
+        uint64_t accessCount{0};
+    };
+    struct Stats {
+        size_t planned{0};   // Files in the snapshot being reloaded
+        size_t loaded{0};    // ... that the loader admitted
+        uint64_t bytes{0};
+        bool running{false};
+    };
+    struct BatchResult {
+        size_t loaded{0};
+        uint64_t bytes{0};
+        bool full{false};    // Nothing more fits; stop warming
+    };
+
+    // Loads what it can of a batch into the cache, skipping files that are
+    // already cached or gone
+    using Loader = std::function<BatchResult(const std::vector<std::string>& paths)>;
+
+    // Writes `entries` in the order given; false if the file cannot be written
+    static bool save(const std::string& file, const std::vector<Entry>& entries);
+    // The saved entries; empty if the file is missing or damaged
+    static std::vector<Entry> load(const std::string& file);
+
+    CacheWarmer(Loader loader, uint64_t bytesPerSecond);
+    ~CacheWarmer();  // stop()
+
+    CacheWarmer(const CacheWarmer&) = delete;
+    CacheWarmer& operator=(const CacheWarmer&) = delete;
+
+    void start(std::vector<Entry> entries);  // Replaces a reload in progress
+    void stop();                             // Abandons the reload and joins its thread
+    void wait();                             // Until the reload finishes
+    Stats getStats() const;
+
+private:
+    static constexpr size_t BATCH = 16;  // Files per loader call
+
+    void run(std::vector<Entry> entries);
+
+    Loader loader;
+    uint64_t bytesPerSecond;
+
+    mutable std::mutex mutex;  // stopping and the thread
+    std::condition_variable wakeup;
+    std::condition_variable finished;
+    bool stopping{false};
+    bool running{false};
+    std::thread worker;
+
+    std::atomic<size_t> planned{0};
+    std::atomic<size_t> loaded{0};
+    std::atomic<uint64_t> bytes{0};
+};
+
+} // namespace mtfs::fs
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <functional>
+#include "common/error.hpp"
+#include "common/checksum.hpp"
+
+namespace mtfs::fs {
+
+// Content address of a chunk: the 128-bit hash of its bytes
+using ChunkId = mtfs::common::Hash128;
+
+struct ChunkIdHash {
+    size_t operator()(const ChunkId& id) const { return static_cast<size_t>(id.low ^ (id.high * 31)); }
+};
+
+using ChunkIdSet = std::unordered_set<ChunkId, ChunkIdHash>;
+
+std::string toHex(const ChunkId& id);
+bool fromHex(const std::string& text, ChunkId& id);
+
+// FastCDC content-defined chunking: a gear rolling hash picks cut points
+// from the data itself, so an insertion only changes the chunks around it
+// instead of shifting every later boundary. Cuts are harder to hit before
+// AVERAGE_CHUNK and easier after it, which keeps sizes close to the average.
+class ContentChunker {
+public:
+    static constexpr size_t MIN_CHUNK = 4 * 1024;
+    static constexpr size_t AVERAGE_CHUNK = 16 * 1024;
+    static constexpr size_t MAX_CHUNK = 64 * 1024;
+
+    // Length of the chunk starting at `data`; `size` bytes are available
+    // and, unless they are the end of the input, at least MAX_CHUNK
+    static size_t nextBoundary(const char* data, size_t size);
+};
+
+// One file of a backup: its chunks in order
+struct ManifestEntry {
+    std::string path;   // Relative to the backed-up directory
+    uint64_t size{0};
+    std::vector<ChunkId> chunks;
+};
+
+// Counters for one storeFile() call, or summed over a backup
+struct ChunkingStats {
+    size_t chunks{0};
+    size_t newChunks{0};
+    uint64_t bytes{0};
+    uint64_t newBytes{0};   // Written to the store; the rest was deduplicated
+    uint64_t storedBytes{0};   // What newBytes took on disk after compression
+};
+
+// Content-addressed store of chunks, one file per chunk under
+// directory/xx/<id>, where xx are the first two hex digits. Compressed
+// chunks are directory/xx/<id>.lz: the raw size as a u32, then the LZ
+// block. A chunk is written once, through a temporary file renamed into
+// place, so concurrent writers of the same chunk are harmless. Safe for
+// concurrent use.
+class ChunkStore {
+public:
+    // Open or create the store; throws FSException on failure
+    explicit ChunkStore(const std::string& directory);
+
+    ChunkStore(const ChunkStore&) = delete;
+    ChunkStore& operator=(const ChunkStore&) = delete;
+
+    // Store `data` unless an identical chunk exists; returns its id and
+    // whether it had to be written
+    ChunkId put(const char* data, size_t size, bool& written);
+    bool contains(const ChunkId& id) const;
+
+    // Store a chunk the caller already hashed. `stored` is the chunk itself
+    // or, when `compressed`, its FileCompression::lzCompress encoding of
+    // rawSize bytes. Returns whether it had to be written.
+    bool putEncoded(const ChunkId& id, const char* stored, size_t storedSize, size_t rawSize, bool compressed);
+
+    // Chunk contents, checked against the id; throws FSException if the
+    // chunk is missing or corrupt
+    std::string get(const ChunkId& id) const;
+
+    // Chunk a file and store its new chunks; throws FSException on I/O errors
+    ManifestEntry storeFile(const std::string& sourcePath, const std::string& relativePath,
+                            ChunkingStats& stats);
+
+    // Stream a file through ContentChunker, calling `onChunk` for each chunk
+    // in order; throws FSException on I/O errors
+    static void chunkFile(const std::string& sourcePath,
+                          const std::function<void(const char* data, size_t size)>& onChunk);
+
+    // Reassemble a stored file at `targetPath`; throws FSException
+    void restoreFile(const ManifestEntry& entry, const std::string& targetPath) const;
+
+    // Delete every chunk not in `live`; returns how many were removed
+    size_t collectGarbage(const ChunkIdSet& live);
+
+    // Manifests are text, one file per line: size, chunk ids, path
+    static bool saveManifest(const std::string& manifestPath, const std::vector<ManifestEntry>& entries);
+    static std::vector<ManifestEntry> loadManifest(const std::string& manifestPath);  // Throws FSException
+
+    const std::string& getDirectory() const { return directory; }
+
+private:
+    std::string chunkPath(const ChunkId& id, bool compressed = false) const;
+
+    std::string directory;
+    std::atomic<uint64_t> temporaryCounter{0};
+
+    // Chunks known to be on disk, sparing an existence check per put
+    mutable std::mutex knownMutex;
+    mutable ChunkIdSet known;
+};
+
+} // namespace mtfs::fs
@@ -3,40 +3,189 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <ios>
+#include <memory>
+#include <mutex>
+#include <functional>
 #include "common/error.hpp"
 
+namespace mtfs::threading {
+class ThreadPool;
+}
+
 namespace mtfs::fs {
 
+class CompressionStreamWriter;
+class CompressionStreamReader;
+class CompressedFile;
+
 class FileCompression {
 public:
     // Compression/Decompression methods
     static std::vector<uint8_t> compress(const std::string& data);
     static std::string decompress(const std::vector<uint8_t>& compressedData);
     
-    // File operations
-    static bool compressFile(const std::string& inputPath, const std::string& outputPath);
+    // File operations; both stream in STREAM_BLOCK_SIZE pieces. compressFile
+    // encodes chunks on `pool`, or the global pool when none is given.
+    static bool compressFile(const std::string& inputPath, const std::string& outputPath,
+                             threading::ThreadPool* pool = nullptr);
     static bool decompressFile(const std::string& inputPath, const std::string& outputPath);
     
     // Utility methods
     static double calculateCompressionRatio(size_t originalSize, size_t compressedSize);
     static bool isCompressed(const std::string& filePath);
+    static bool isCompressedData(const std::string& data);  // Same check on contents in memory
+
+    // LZ4-style block codec: hash-chain match finder with 64-bit match
+    // extension and wide copies. lzDecompress throws on corrupt input.
+    static size_t lzCompressBound(size_t size);
+    static size_t lzCompress(const char* source, size_t size, char* destination, size_t capacity);
+    static void lzDecompress(const char* source, size_t size, char* destination, size_t rawSize);
+
+    // Input per independently compressed chunk of the LZ format
+    static constexpr size_t STREAM_BLOCK_SIZE = 256 * 1024;
     
 private:
-    // Simple RLE (Run-Length Encoding) compression
-    static std::vector<uint8_t> rleCompress(const std::string& data);
-    static std::string rleDecompress(const std::vector<uint8_t>& data);
-    
+    friend class CompressionStreamWriter;
+    friend class CompressionStreamReader;
+    friend class CompressedFile;
+
     // Compression header format
     static constexpr uint32_t COMPRESSION_MAGIC = 0x4D544653; // "MTFS"
-    static constexpr uint16_t COMPRESSION_VERSION = 1;
+    static constexpr uint16_t COMPRESSION_VERSION = 1;        // 32-bit sizes, read only
+    static constexpr uint16_t CHUNKED_VERSION = 2;            // 64-bit sizes and a chunk index
+    static constexpr uint8_t TYPE_RLE = 0;
+    static constexpr uint8_t TYPE_LZ = 1;
     
+    // Version 1 header, read as its in-memory layout
     struct CompressionHeader {
         uint32_t magic;
         uint16_t version;
         uint32_t originalSize;
         uint32_t compressedSize;
-        uint8_t compressionType; // 0 = RLE, 1 = LZ77 (future), etc.
+        uint8_t compressionType; // 0 = RLE, 1 = LZ blocks
+    };
+
+    // Version 2 header, little-endian at fixed offsets:
+    // magic u32, version u16, type u8, reserved u8, chunkSize u32,
+    // reserved u32, originalSize u64, chunkCount u64, indexOffset u64
+    static constexpr size_t CHUNKED_HEADER_SIZE = 40;
+    struct ChunkedHeader {
+        uint32_t chunkSize{0};
+        uint64_t originalSize{0};
+        uint64_t chunkCount{0};
+        uint64_t indexOffset{0};
+    };
+    static std::string encodeChunkedHeader(const ChunkedHeader& header);
+    static ChunkedHeader decodeChunkedHeader(const char* bytes);  // Throws on a bad header
+
+    // An LZ payload is a sequence of chunks, each preceded by its raw size
+    // and stored size; chunks that do not shrink are stored uncompressed
+    // with STORED_RAW set in the stored size. Version 2 ends with an index
+    // of ChunkIndexEntry, one per chunk, at indexOffset.
+    static constexpr uint32_t STORED_RAW = 0x80000000u;
+    static constexpr size_t CHUNK_FRAME_SIZE = 2 * sizeof(uint32_t);
+    struct ChunkIndexEntry {
+        uint64_t offset;       // Of the chunk's frame
+        uint32_t rawSize;
+        uint32_t storedField;  // Stored size, with STORED_RAW for raw chunks
     };
+    static void decodeChunk(const char* stored, uint32_t storedField, char* out, uint32_t rawSize);
+};
+
+// Incremental encoder for the chunked LZ format. Input is cut into
+// STREAM_BLOCK_SIZE chunks; with a pool, a batch of chunks is compressed
+// in parallel and written in order, so memory stays bounded by the batch
+// however much is written. finish() appends the chunk index and patches
+// the header, so `out` must be seekable.
+class CompressionStreamWriter {
+public:
+    explicit CompressionStreamWriter(std::ostream& out, threading::ThreadPool* pool = nullptr);
+
+    void write(const char* data, size_t size);
+    void finish();
+
+    uint64_t getOriginalSize() const { return originalSize; }
+    uint64_t getCompressedSize() const { return compressedSize; }
+
+private:
+    struct Chunk {
+        std::vector<char> raw;
+        std::vector<char> encoded;
+        uint32_t storedField{0};
+    };
+    static void encodeChunk(Chunk& chunk);
+    void flushBatch();
+
+    std::ostream& out;
+    threading::ThreadPool* pool;
+    std::streampos headerPosition;
+    std::vector<Chunk> batch;   // Chunks filled in order; the last may be partial
+    size_t filling{0};          // Index of the chunk receiving input
+    std::vector<FileCompression::ChunkIndexEntry> index;
+    uint64_t originalSize{0};
+    uint64_t compressedSize{0};
+    bool finished{false};
+};
+
+// Incremental decoder for both formats. Throws std::runtime_error on a bad
+// header or corrupt block.
+class CompressionStreamReader {
+public:
+    explicit CompressionStreamReader(std::istream& in);
+
+    // Up to `size` bytes of decompressed data; 0 once everything is read
+    size_t read(char* buffer, size_t size);
+    uint64_t getOriginalSize() const { return originalSize; }
+
+private:
+    bool fillBlock();
+
+    std::istream& in;
+    uint8_t compressionType;
+    uint16_t version;
+    uint64_t originalSize{0};
+    uint64_t delivered{0};
+    std::vector<char> block;
+    std::vector<char> encoded;
+    size_t blockPosition{0};
+};
+
+// Random access to a chunked (version 2) compressed file: read() decodes
+// only the chunks overlapping the requested range, using the chunk index.
+// The most recently decoded chunk is kept for the next sequential read.
+// Safe for concurrent readers.
+class CompressedFile {
+public:
+    // Positional reader over the compressed bytes, like FileHandle::readAt
+    using Source = std::function<size_t(void* buffer, size_t count, uint64_t offset)>;
+
+    // Throws std::runtime_error if the data is not in the chunked format
+    static std::shared_ptr<const CompressedFile> open(Source source);
+    static std::shared_ptr<const CompressedFile> open(const std::string& fullPath);
+
+    CompressedFile(const CompressedFile&) = delete;
+    CompressedFile& operator=(const CompressedFile&) = delete;
+
+    // Decompressed bytes [offset, offset + count); returns the number copied
+    size_t read(void* buffer, size_t count, uint64_t offset) const;
+    uint64_t size() const { return originalSize; }
+    size_t getChunkCount() const { return index.size(); }
+
+private:
+    explicit CompressedFile(Source source) : source(std::move(source)) {}
+
+    void readExactly(void* buffer, size_t count, uint64_t offset) const;
+    std::shared_ptr<const std::vector<char>> chunk(size_t number) const;
+
+    Source source;
+    uint64_t originalSize{0};
+    uint32_t chunkSize{0};
+    std::vector<FileCompression::ChunkIndexEntry> index;
+
+    mutable std::mutex cacheMutex;
+    mutable size_t cachedNumber{0};
+    mutable std::shared_ptr<const std::vector<char>> cachedChunk;
 };
 
 // Compression statistics
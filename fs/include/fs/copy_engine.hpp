@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "common/error.hpp"
+
+namespace mtfs::fs {
+
+// How a copy moved its bytes, fastest first
+enum class CopyMethod {
+    CLONE,      // Extents shared with the source (FICLONE reflink)
+    KERNEL,     // Copied inside the kernel: copy_file_range, or CopyFileEx, which block-clones on ReFS
+    SENDFILE,   // sendfile between two files
+    BUFFERED    // Large aligned blocks through user space
+};
+
+const char* copyMethodName(CopyMethod method);
+
+struct CopyResult {
+    uint64_t bytes{0};
+    CopyMethod method{CopyMethod::BUFFERED};  // The last one used; a copy may fall back partway
+    std::chrono::nanoseconds elapsed{0};
+
+    double throughput() const;  // MiB per second
+};
+
+// Whole-file copies through the fastest primitive the platform and both file
+// systems support. Each primitive falls back to the next when it is
+// unsupported, continuing from where it stopped, and ends in a buffered copy.
+// The destination is created or truncated and takes the source's permission bits.
+class CopyEngine {
+public:
+    static constexpr size_t BUFFER_SIZE = 8 * 1024 * 1024;
+    static constexpr size_t ALIGNMENT = 4096;
+
+    // Throws FSException
+    static CopyResult copy(const std::string& source, const std::string& destination);
+};
+
+// Reads one file front to back, with the OS told to read ahead
+// (FILE_FLAG_SEQUENTIAL_SCAN on Windows, POSIX_FADV_SEQUENTIAL elsewhere)
+class SequentialReader {
+public:
+    explicit SequentialReader(const std::string& path);  // Throws FSException
+    ~SequentialReader();
+
+    SequentialReader(const SequentialReader&) = delete;
+    SequentialReader& operator=(const SequentialReader&) = delete;
+
+    // Fills up to `size` bytes; short only at the end of the file. Throws FSException.
+    size_t read(char* buffer, size_t size);
+
+private:
+    std::string path;
+#ifdef _WIN32
+    void* handle{nullptr};
+#else
+    int fd{-1};
+#endif
+};
+
+} // namespace mtfs::fs
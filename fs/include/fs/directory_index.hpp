@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <shared_mutex>
+#include <cstddef>
+#include <cstdint>
+
+namespace mtfs::threading {
+class ThreadPool;
+}
+
+namespace mtfs::fs {
+
+// In-memory namespace of a host directory tree: a trie of path components
+// whose directories keep their children in a sorted vector. It is built by
+// one parallel walk and then kept current by the FileSystem's own changes,
+// so existence checks, listings and attribute lookups need no system call.
+// Changes made behind the FileSystem's back are only seen after rebuild(),
+// except that callers add paths they found on disk after a miss.
+//
+// Paths are relative to the root, separated by '/' or '\\'; "" and "." are
+// the root. Paths with ".." are never indexed.
+class DirectoryIndex {
+public:
+    struct Entry {
+        bool isDirectory{false};
+        bool hasAttributes{false};  // False once the entry changes, until it is stat'ed again
+        uint64_t size{0};
+        int64_t modifiedNs{0};
+        int64_t createdNs{0};
+        uint32_t permissions{0};
+    };
+
+    DirectoryIndex();
+    ~DirectoryIndex();
+
+    // Replaces the contents with a walk of `root`; throws FSException if it
+    // cannot be listed
+    void rebuild(const std::string& root, threading::ThreadPool* pool = nullptr);
+
+    bool find(const std::string& path, Entry& entry) const;  // False if not indexed
+    // Sorted child names; false unless the path is a directory whose
+    // children are all known
+    bool list(const std::string& path, std::vector<std::string>& names) const;
+
+    // Adds or replaces an entry, creating missing parents as directories
+    // with unknown children. A directory added with `complete` set is known
+    // to hold nothing yet.
+    void put(const std::string& path, const Entry& entry, bool complete = false);
+    void invalidate(const std::string& path);  // Forget the attributes, keep the entry
+    void erase(const std::string& path);       // With everything below it
+    size_t size() const;                       // Entries, not counting the root
+
+private:
+    struct Node;
+
+    static bool split(const std::string& path, std::vector<std::string>& components);
+    // The node for `components` under `top`, adding it and any missing parents
+    static Node& insert(Node& top, const std::vector<std::string>& components, size_t& added);
+    const Node* findNode(const std::vector<std::string>& components) const;
+    Node* findNode(const std::vector<std::string>& components);
+
+    mutable std::shared_mutex mutex;
+    std::unique_ptr<Node> root;
+    size_t entries{0};
+};
+
+} // namespace mtfs::fs
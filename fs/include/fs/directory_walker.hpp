@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include "fs/file_index.hpp"
+
+namespace mtfs::threading {
+class ThreadPool;
+}
+
+namespace mtfs::fs {
+
+struct DirectoryEntry {
+    std::string path;          // Relative to the walk root, '/'-separated
+    FileStamp stamp;           // From the listing itself; size is 0 for directories
+    bool isDirectory{false};
+    uint32_t permissions{0};   // Mode bits
+    int64_t createdNs{0};      // Creation time on Windows, status change time elsewhere
+
+    std::string name() const { return path.substr(path.find_last_of('/') + 1); }
+};
+
+struct WalkOptions {
+    bool recursive{true};
+    bool includeDirectories{false};  // Report directories as entries too
+};
+
+// Recursive directory walk whose subdirectories are listed in parallel on a
+// thread pool. Sizes and modification times come with the listing
+// (FindFirstFileEx on Windows, fstatat against the open directory
+// elsewhere), so no file is stat'ed by path. Entries are handed to the
+// visitor one directory at a time as they are listed and are not kept, so
+// a walk's memory does not grow with the tree. Symbolic links to
+// directories are not followed.
+class DirectoryWalker {
+public:
+    // Calls never overlap but come from pool threads, in no fixed order
+    using Visitor = std::function<void(const DirectoryEntry&)>;
+
+    explicit DirectoryWalker(threading::ThreadPool* pool = nullptr);  // Default: the global pool
+
+    // Returns the number of entries visited. Throws FSException if root
+    // cannot be listed; unreadable subdirectories are logged and skipped.
+    // An exception from the visitor stops the walk and is rethrown.
+    size_t walk(const std::string& root, const Visitor& visit, const WalkOptions& options = {}) const;
+
+    // Every entry, sorted by path
+    std::vector<DirectoryEntry> collect(const std::string& root, const WalkOptions& options = {}) const;
+
+private:
+    threading::ThreadPool* pool;
+};
+
+} // namespace mtfs::fs
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+#include "common/error.hpp"
+#include "fs/file_metadata.hpp"
+#include "storage/block_manager.hpp"
+
+namespace mtfs::fs {
+
+// File contents packed into one BlockManager container instead of one host
+// file each. Files up to the inline threshold are kept in their FileLayout
+// (and so in the metadata record); larger files get extents of consecutive
+// blocks. Whole-file writes build a new layout before the caller releases
+// the old one, so a crash in between leaks blocks rather than losing data;
+// reconcile() reclaims them on the next mount.
+class ExtentStore {
+public:
+    static constexpr size_t BLOCK_SIZE = storage::BlockManager::BLOCK_SIZE;
+    static constexpr size_t DEFAULT_INLINE_THRESHOLD = 1024;
+    static constexpr size_t MAX_INLINE_THRESHOLD = 64 * 1024;  // Bounded by the metadata record size
+    static constexpr size_t MAX_EXTENT_BLOCKS = 4096;           // 16MB per extent
+
+    // Open or create the container; throws FSException if it cannot be opened
+    ExtentStore(const std::string& containerPath, size_t inlineThreshold,
+                size_t initialBlocks = storage::BlockManager::INITIAL_BLOCKS);
+
+    ExtentStore(const ExtentStore&) = delete;
+    ExtentStore& operator=(const ExtentStore&) = delete;
+
+    // Whole-file operations. store() returns a fresh layout for `data`;
+    // the caller releases the previous one once the new layout is recorded.
+    FileLayout store(const std::string& data);
+    std::string load(const FileLayout& layout, size_t fileSize);
+    void release(const FileLayout& layout);
+
+    // Positional I/O, updating `layout` and `fileSize` in place on writes
+    size_t readAt(const FileLayout& layout, size_t fileSize, void* buffer, size_t count, size_t offset);
+    size_t writeAt(FileLayout& layout, size_t& fileSize, const void* buffer, size_t count, size_t offset);
+
+    // Free blocks that no layout in `metadata` references; returns how many
+    size_t reconcile(const std::unordered_map<std::string, FileMetadata>& metadata);
+
+    bool sync() { return blocks->sync(); }
+    size_t getInlineThreshold() const { return inlineThreshold; }
+    storage::BlockManager& getBlockManager() { return *blocks; }
+
+private:
+    std::vector<Extent> allocate(size_t count);
+    void writeRange(const std::vector<Extent>& extents, size_t firstBlock, const char* data, size_t size);
+    void readRange(const std::vector<Extent>& extents, size_t firstBlock, size_t count, char* out);
+    static size_t blockCount(const std::vector<Extent>& extents);
+
+    std::unique_ptr<storage::BlockManager> blocks;
+    size_t inlineThreshold;
+};
+
+} // namespace mtfs::fs
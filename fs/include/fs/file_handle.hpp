@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include "common/error.hpp"
+#include "fs/open_file_cache.hpp"
+
+namespace mtfs::fs {
+
+// Open native file handle doing positional I/O (pread/pwrite on POSIX,
+// ReadFile/WriteFile with an explicit offset on Windows). Reads and writes
+// never move a shared file pointer, so one handle can serve concurrent
+// callers. The tracked size covers changes made through this handle only.
+class FileHandle {
+public:
+    // Open `fullPath` read-write, falling back to read-only; `create` makes
+    // or truncates the file. Throws FSException on failure.
+    static std::shared_ptr<FileHandle> open(const std::string& fullPath, bool create = false);
+    ~FileHandle();
+
+    FileHandle(const FileHandle&) = delete;
+    FileHandle& operator=(const FileHandle&) = delete;
+
+    // Transfer up to `count` bytes at `offset`; returns the number transferred
+    size_t readAt(void* buffer, size_t count, size_t offset) const;
+    size_t writeAt(const void* buffer, size_t count, size_t offset);
+    void truncate(size_t newSize);
+
+    size_t size() const { return length.load(std::memory_order_acquire); }
+    bool isWritable() const { return writable; }
+
+private:
+    FileHandle() = default;
+
+    void growTo(size_t end);
+
+#ifdef _WIN32
+    void* handle{nullptr};
+#else
+    int fd{-1};
+#endif
+    std::string path;
+    std::atomic<size_t> length{0};
+    bool writable{false};
+};
+
+// Handles kept open for repeated offset I/O, most recently used first
+using FileHandleCache = OpenFileCache<FileHandle>;
+
+} // namespace mtfs::fs
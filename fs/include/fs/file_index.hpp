@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+#include "common/error.hpp"
+#include "fs/chunk_store.hpp"
+
+namespace mtfs::fs {
+
+// What stat() says about a file. When two stamps match, the file is assumed
+// unchanged without reading it.
+struct FileStamp {
+    uint64_t size{0};
+    int64_t modifiedNs{0};   // Last write time, nanoseconds since the epoch
+    uint64_t fileId{0};      // Inode and device on POSIX; 0 where not available cheaply
+
+    bool operator==(const FileStamp& other) const {
+        return size == other.size && modifiedNs == other.modifiedNs && fileId == other.fileId;
+    }
+    bool operator!=(const FileStamp& other) const { return !(*this == other); }
+
+    // One stat call (GetFileAttributesEx on Windows); false if the file is gone
+    static bool of(const std::string& path, FileStamp& stamp);
+};
+
+struct FileIndexEntry {
+    FileStamp stamp;
+    ChunkId contentHash;   // Of the file's chunk ids, see contentHash()
+};
+
+// Persisted (path -> stamp, content hash) table taken when a backup is made.
+// Change detection compares stamps only and falls back to hashing content
+// for the files whose stamp differs. Stored as one binary file with a
+// trailing CRC; save() replaces it atomically.
+class FileIndex {
+public:
+    // Throws FSException if the file exists but is corrupt; a missing file
+    // loads as an empty index and returns false
+    bool load(const std::string& indexPath);
+    bool save(const std::string& indexPath) const;
+
+    const FileIndexEntry* find(const std::string& path) const;
+    void put(const std::string& path, const FileIndexEntry& entry) { entries[path] = entry; }
+    size_t size() const { return entries.size(); }
+    void reserve(size_t count) { entries.reserve(count); }
+
+    // Identity of a file's contents: the hash of its chunk ids in order,
+    // so it falls out of chunking without a second pass over the data
+    static ChunkId contentHash(const std::vector<ChunkId>& chunks);
+    static ChunkId hashFile(const std::string& path);  // Chunks without storing; throws FSException
+
+private:
+    static constexpr uint32_t INDEX_MAGIC = 0x4946544D;  // "MTFI"
+    static constexpr uint32_t INDEX_VERSION = 1;
+
+    std::unordered_map<std::string, FileIndexEntry> entries;
+};
+
+} // namespace mtfs::fs
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <chrono>
+#include <vector>
+
+namespace mtfs::fs {
+
+// Run of consecutive blocks holding part of a file in the block store
+struct Extent {
+    int32_t firstBlock{0};
+    uint32_t blockCount{0};
+};
+
+// Where a block-store file's contents live: entirely in `inlineData` for
+// small files, otherwise in `extents`, in file order. Both are empty for
+// host-file storage.
+struct FileLayout {
+    std::vector<Extent> extents;
+    std::string inlineData;
+
+    bool empty() const { return extents.empty() && inlineData.empty(); }
+};
+
+struct FileMetadata {
+    std::string name;
+    std::size_t size{0};
+    bool isDirectory{false};
+    std::chrono::system_clock::time_point createdAt;
+    std::chrono::system_clock::time_point modifiedAt;
+    uint32_t permissions{0644};  // Default Unix-style permissions
+    std::string owner;           // Username of file owner
+    std::string group;           // Group (optional, for future use)
+    FileLayout layout;           // Block store placement
+    bool compressed{false};      // Set by compressFile; read() decompresses
+};
+
+} // namespace mtfs::fs
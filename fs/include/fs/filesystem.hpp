@@ -7,23 +7,60 @@
 #include <chrono>
 #include <unordered_map>
 #include <future>
+#include <functional>
+#include <mutex>
+#include <atomic>
 #include "common/error.hpp"
 #include "common/auth.hpp"
+#include "common/metrics.hpp"
 #include "cache/enhanced_cache.hpp"
 #include "fs/compression.hpp"
 #include "fs/backup_manager.hpp"
+#include "fs/file_metadata.hpp"
+#include "fs/metadata_log.hpp"
+#include "fs/mapped_file.hpp"
+#include "fs/file_handle.hpp"
+#include "fs/extent_store.hpp"
+#include "fs/path_locks.hpp"
+#include "fs/metadata_table.hpp"
+#include "fs/directory_index.hpp"
+#include "fs/prefetch_engine.hpp"
+#include "fs/cache_warmer.hpp"
+#include "fs/write_back_buffer.hpp"
 
 namespace mtfs::fs {
 
-struct FileMetadata {
-    std::string name;
-    std::size_t size{0};
-    bool isDirectory{false};
-    std::chrono::system_clock::time_point createdAt;
-    std::chrono::system_clock::time_point modifiedAt;
-    uint32_t permissions{0644};  // Default Unix-style permissions
-    std::string owner;           // Username of file owner
-    std::string group;           // Group (optional, for future use)
+// Immutable file contents shared by the cache and every reader holding them
+using SharedBuffer = std::shared_ptr<const std::string>;
+
+// Where file contents are kept
+enum class StorageMode {
+    HostFiles,   // One host file per file under rootPath
+    BlockStore   // Packed into a single block container with extent maps
+};
+
+struct FileSystemOptions {
+    StorageMode storageMode{StorageMode::HostFiles};
+    // Block store only: files up to this size live in their metadata record
+    size_t inlineThreshold{ExtentStore::DEFAULT_INLINE_THRESHOLD};
+    // Block store only: capacity of a new container, which grows on demand
+    size_t initialBlocks{storage::BlockManager::INITIAL_BLOCKS};
+    // Host files only: answer exists, listDirectory and getFileInfo from an
+    // in-memory tree built at mount; see rescan()
+    bool directoryIndex{false};
+    // Background read-ahead learned from readFile calls; it only fills free
+    // cache room, so it never evicts anything
+    PrefetchOptions prefetch;
+    // Record the cached files at unmount() and reload them, hottest first and
+    // paced to a byte rate, in the background after the next mount()
+    WarmRestartOptions warmRestart;
+    // Offset writes through write() are buffered per file and coalesced;
+    // reads, the cache and metadata see them at once, the disk on sync(), at
+    // the size and age limits, or when an operation needs the file on disk.
+    // A crash loses what had not reached the disk. Bytes that fail to reach
+    // it stay buffered, and the failure is reported once, by sync() or the
+    // file's next read() or write().
+    WriteBackOptions writeBack;
 };
 
 struct PerformanceStats {
@@ -34,6 +71,11 @@ struct PerformanceStats {
     size_t totalFileOperations{0};
     double avgReadTime{0.0};
     double avgWriteTime{0.0};
+    // Open file handle reuse, filled in by getStats()
+    size_t handleCacheHits{0};
+    size_t handleCacheMisses{0};
+    size_t handleEvictions{0};
+    size_t openHandles{0};
     std::chrono::system_clock::time_point lastResetTime;
     
     PerformanceStats() : lastResetTime(std::chrono::system_clock::now()) {}
@@ -44,15 +86,34 @@ struct PerformanceStats {
     }
 };
 
+// Latency distributions of whole-file operations and, in block store mode,
+// of the container's block I/O
+struct LatencyReport {
+    common::HistogramSnapshot read;        // Cache hits and misses together
+    common::HistogramSnapshot write;
+    common::HistogramSnapshot cacheHit;
+    common::HistogramSnapshot cacheMiss;
+    common::HistogramSnapshot blockRead;
+    common::HistogramSnapshot blockWrite;
+};
+
+// Safe for concurrent use. Each operation holds its path's stripe of a
+// PathLockTable, shared to read a file and exclusive to change it, so
+// operations on different files run in parallel and those on one file are
+// serialized; copies and moves lock both paths.
 class FileSystem {
 public:
     // Factory method
     static std::shared_ptr<FileSystem> create(const std::string& rootPath, mtfs::common::AuthManager* auth = nullptr);
+    static std::shared_ptr<FileSystem> create(const std::string& rootPath, const FileSystemOptions& options,
+                                              mtfs::common::AuthManager* auth = nullptr);
 
     // Basic file operations
     bool createFile(const std::string& path);
     bool writeFile(const std::string& path, const std::string& data);
-    std::string readFile(const std::string& path);
+    bool writeFile(const std::string& path, SharedBuffer data);   // Caches the buffer itself
+    std::string readFile(const std::string& path);                // Copy of readFileShared
+    SharedBuffer readFileShared(const std::string& path);         // No copy on a cache hit
     bool deleteFile(const std::string& path);
     
     // Directory operations
@@ -65,18 +126,35 @@ public:
     bool renameFile(const std::string& oldName, const std::string& newName);
     std::vector<std::string> findFiles(const std::string& pattern, const std::string& directory = ".");
     FileMetadata getFileInfo(const std::string& path);
+
+    // Batch operations: one login and owner lookup for the caller, every
+    // path locked once for the whole batch, and one metadata log commit and
+    // cache update at the end. Items run grouped by directory rather than in
+    // input order, so they should not depend on each other; items on the
+    // same path keep their order. Results are per item in input order, and
+    // a failed item does not stop the rest. writeBatch creates the files
+    // that do not exist yet.
+    std::vector<bool> writeBatch(const std::vector<std::pair<std::string, std::string>>& files);
+    std::vector<bool> deleteBatch(const std::vector<std::string>& paths);
+    std::vector<bool> copyBatch(const std::vector<std::pair<std::string, std::string>>& operations);
     
-    // Advanced operations
+    // Advanced operations. read() serves a compressed file's original
+    // contents; write() refuses compressed files and, with write-back on,
+    // returns once the bytes are buffered.
     std::size_t write(const std::string& path, const void* buffer, std::size_t size, std::size_t offset);
     std::size_t read(const std::string& path, void* buffer, std::size_t size, std::size_t offset);
     void setPermissions(const std::string& path, uint32_t permissions);
     FileMetadata getMetadata(const std::string& path);
     
     // System operations
+    // Writes out buffered offset writes, then commits metadata. Throws
+    // FSException naming the files whose buffered writes failed to reach disk.
     void sync();
     void mount();
     void unmount();
+    void rescan();  // Rebuild the directory index to see changes made outside the FileSystem
     bool exists(const std::string& path);
+    StorageMode getStorageMode() const { return options.storageMode; }
     
     // Async file operations (multi-threaded)
     std::future<std::string> readFileAsync(const std::string& path);
@@ -98,11 +176,22 @@ public:
     // Enhanced cache management
     void setCachePolicy(cache::CachePolicy policy);
     cache::CachePolicy getCachePolicy() const;
-    void resizeCache(size_t newCapacity);
+    void resizeCache(size_t newCapacity);           // Entries, or bytes once a byte budget is set
+    void setCacheByteBudget(size_t bytes);           // Bound cached contents by total size
+    void setCacheEntryLimit(size_t entries);         // Back to counting entries
+    cache::CapacityMode getCacheCapacityMode() const;
+    void setMmapThreshold(size_t bytes);             // read() maps files at least this large
+    size_t getMmapThreshold() const;
+    size_t getOpenMappingCount() const;
     void pinFile(const std::string& path);
     void unpinFile(const std::string& path);
     bool isFilePinned(const std::string& path) const;
     void prefetchFile(const std::string& path);
+    PrefetchEngine::Stats getPrefetchStats() const;  // Zero unless FileSystemOptions::prefetch is enabled
+    void drainPrefetch();                            // Wait for background prefetches in flight
+    CacheWarmer::Stats getWarmupStats() const;       // Zero unless FileSystemOptions::warmRestart is enabled
+    WriteBackBuffer::Stats getWriteBackStats() const;  // Zero unless FileSystemOptions::writeBack is enabled
+    void waitForWarmup();                            // Until the reload started by mount() finishes
     cache::CacheStatistics getCacheStatistics() const;
     void resetCacheStatistics();
     void showCacheAnalytics() const;
@@ -110,8 +199,10 @@ public:
     
     // Performance monitoring
     PerformanceStats getStats() const;
+    LatencyReport getLatencyReport() const;
     void resetStats();
     void showPerformanceDashboard() const;
+    void showLatencyHistograms() const;
     
     // File compression
     bool compressFile(const std::string& filePath);
@@ -127,27 +218,83 @@ public:
     void showBackupDashboard() const;
     BackupStats getBackupStats() const;
     
-    virtual ~FileSystem() = default;
+    virtual ~FileSystem();  // Writes out buffered offset writes
 
 protected:
-    explicit FileSystem(const std::string& rootPath, mtfs::common::AuthManager* auth = nullptr);
+    explicit FileSystem(const std::string& rootPath, mtfs::common::AuthManager* auth = nullptr,
+                        const FileSystemOptions& options = FileSystemOptions());
 
 private:
     FileMetadata resolvePath(const std::string& path);
-    
-    // Helper function for glob pattern matching
-    bool matchesPattern(const std::string& filename, const std::string& pattern);
+
+    // Bodies of the public operations, for callers already holding the
+    // path locks they need
+    void requireLogin(const std::string& action) const;
+    void requireOwner(const std::string& path);
+    static void requireRecordable(const std::string& path);  // Fits a metadata log record
+    bool pathExists(const std::string& path);
+    FileMetadata lookupMetadata(const std::string& path);
+    void createEntry(const std::string& path);
+    SharedBuffer loadContents(const std::string& path);
+    void storeContents(const std::string& path, SharedBuffer data);
+    bool removeEntry(const std::string& path);
+    void copyEntry(const std::string& source, const std::string& destination);
+
+    // A batch running on this thread; the bodies above defer their metadata
+    // records and cache updates to it instead of applying them one by one
+    struct Batch;
+    static thread_local Batch* activeBatch;
+    Batch* currentBatch() const;
+    // Runs item(i) for each target in directory order, holding `locks`
+    std::vector<bool> runBatch(const std::string& action, const std::vector<std::string>& targets,
+                               const std::vector<std::pair<std::string, PathLockTable::Mode>>& locks,
+                               const std::function<bool(size_t)>& item);
+    void cachePut(const std::string& path, SharedBuffer data);
+    void cacheRemove(const std::string& path);
+    SharedBuffer cachedContents(const std::string& path) const;  // Null when not cached
     
     std::string rootPath;
+    FileSystemOptions options;
+
+    // Block store mode: contents live here and every file and directory is
+    // known only through fileMetadataMap
+    std::unique_ptr<ExtentStore> extentStore;
+
+    // Host mode with FileSystemOptions::directoryIndex; null otherwise
+    std::unique_ptr<DirectoryIndex> directoryIndex;
+    bool usesBlockStore() const { return extentStore != nullptr; }
+    FileMetadata blockStoreFile(const std::string& path);  // Throws FileNotFoundException
+    bool blockStoreDirectoryExists(const std::string& path) const;
     
     // Enhanced cache for file contents
     static constexpr size_t CACHE_CAPACITY = 1000;
-    std::unique_ptr<cache::CacheManager<std::string, std::string>> enhancedCache;
-    
-    // Performance statistics
-    mutable PerformanceStats stats;
+    std::unique_ptr<cache::CacheManager<std::string, SharedBuffer>> enhancedCache;
+
+    // Open mappings serving read() for files above the threshold
+    static constexpr size_t DEFAULT_MMAP_THRESHOLD = 1 << 20;
+    static constexpr size_t MAX_OPEN_MAPPINGS = 64;
+    std::atomic<size_t> mmapThreshold{DEFAULT_MMAP_THRESHOLD};
+    MappingCache mappings{MAX_OPEN_MAPPINGS};
+
+    // Native handles reused by offset I/O, whole-file reads and writes
+    static constexpr size_t MAX_OPEN_HANDLES = 128;
+    FileHandleCache handles{MAX_OPEN_HANDLES};
+    std::shared_ptr<FileHandle> acquireHandle(const std::string& path);  // Throws FileNotFoundException
+    void closeOpenFile(const std::string& path);                        // Drop mapping and handle
+
+    // Chunk indexes of compressed files, so read() decodes only what it needs
+    static constexpr size_t MAX_OPEN_COMPRESSED = 32;
+    OpenFileCache<const CompressedFile> compressedFiles{MAX_OPEN_COMPRESSED};
+    std::shared_ptr<const CompressedFile> openCompressed(const std::string& path);
     
-    // Compression statistics
+    // Whole-file operation latencies, recorded per thread; the counters in
+    // PerformanceStats are their counts
+    common::LatencyHistogram cacheHitLatency;
+    common::LatencyHistogram cacheMissLatency;
+    common::LatencyHistogram writeLatency;
+
+    mutable std::mutex statsMutex;  // statsResetTime and compressionStats
+    std::chrono::system_clock::time_point statsResetTime{std::chrono::system_clock::now()};
     mutable CompressionStats compressionStats;
     
     // Backup manager
@@ -156,11 +303,42 @@ private:
     // Auth manager for permission checks
     mtfs::common::AuthManager* authManager{nullptr};
 
-    // Metadata persistence
-    std::unordered_map<std::string, FileMetadata> fileMetadataMap;
+    mutable PathLockTable pathLocks;
+
+    // Metadata persistence. logMutex orders log records against compaction.
+    MetadataTable fileMetadataMap;
+    std::mutex logMutex;
     std::string metadataFilePath;
-    bool saveMetadata() const;
+    std::unique_ptr<MetadataLog> metadataLog;
+    bool saveMetadata();                        // full snapshot (compaction)
     bool loadMetadata();
+    bool persistMetadata(const std::string& path); // append the entry's current state
+    bool commitMetadata(const std::vector<std::string>& paths);  // the same, with one flush
+    void releaseLayout(FileLayout layout, bool persisted);  // at the batch's commit, if in one
+
+    // Background loaders, last so they stop before anything their loads use
+    // is destroyed
+    std::string cacheSnapshotPath;
+    std::unique_ptr<PrefetchEngine> prefetcher;
+    size_t prefetchLoad(const std::string& path);  // PrefetchEngine::Loader
+    std::unique_ptr<CacheWarmer> warmer;
+    CacheWarmer::BatchResult warmLoad(const std::vector<std::string>& paths);  // CacheWarmer::Loader
+    // Contents for a background load, without the cache; false if the path
+    // is missing or a directory. The caller holds the path's lock.
+    bool readUncached(const std::string& path, std::string& contents);
+
+    // Buffered offset writes; null when FileSystemOptions::writeBack is off.
+    // Flushing needs the path held exclusively, discarding too.
+    std::unique_ptr<WriteBackBuffer> writeBack;
+    void flushWrites(const std::string& path);
+    void flushAllWrites();  // Takes each path's lock
+    void discardWrites(const std::string& path);
+    std::mutex writeErrorMutex;
+    std::unordered_map<std::string, std::string> writeErrors;  // Failed flushes not yet reported, by path
+    void recordWriteError(const std::string& path, const std::string& error);
+    void reportWriteError(const std::string& path);  // Throws, once, a failed flush of the path
+    size_t writeThrough(const std::string& path, const void* buffer, size_t size, size_t offset);
+    size_t readThrough(const std::string& path, void* buffer, size_t size, size_t offset);
 };
 
 } // namespace mtfs::fs
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <bitset>
+#include <cstddef>
+
+namespace mtfs::fs {
+
+// A file name pattern compiled once and matched against many names.
+//
+//   *        any run of characters, including none
+//   ?        any one character
+//   [abc]    one of a set; ranges like [a-z], negated with [!...] or [^...]
+//   {a,b}    either alternative; may nest, and holds any of the above
+//
+// A pattern using none of these matches any name containing it, as
+// FileSystem::findFiles always has. An unclosed '[' or '{' is literal.
+//
+// Each brace alternative is split at its stars into fixed-length segments.
+// The first and last are anchored to the ends of the name and the rest are
+// found leftmost-first, which for such patterns never needs backtracking;
+// segments without ? or sets are found with string_view::find.
+class GlobMatcher {
+public:
+    static constexpr size_t MAX_ALTERNATIVES = 1024;  // Brace expansion limit; more throws FSException
+
+    explicit GlobMatcher(const std::string& pattern);
+
+    bool matches(std::string_view name) const;
+    const std::string& pattern() const { return source; }
+
+private:
+    struct Atom {
+        enum class Kind { Literal, AnyChar, Set } kind;
+        char literal;
+        size_t set;  // Index into Alternative::sets
+    };
+
+    // Fixed-length run between stars
+    struct Segment {
+        std::vector<Atom> atoms;
+        std::string literal;     // The atoms as text when all of them are literals
+        bool isLiteral{true};
+    };
+
+    struct Alternative {
+        std::vector<Segment> segments;
+        std::vector<std::bitset<256>> sets;
+        bool anchoredStart{true};  // No leading star
+        bool anchoredEnd{true};    // No trailing star
+        size_t minLength{0};
+
+        bool matches(std::string_view name) const;
+        bool matchesAt(const Segment& segment, std::string_view name, size_t at) const;
+        size_t find(const Segment& segment, std::string_view name, size_t from) const;
+    };
+
+    static Alternative compile(const std::string& glob);
+
+    std::string source;
+    bool substring{false};  // No wildcards: plain containment
+    std::vector<Alternative> alternatives;
+};
+
+} // namespace mtfs::fs
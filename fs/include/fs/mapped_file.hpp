@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <cstddef>
+#include "common/error.hpp"
+#include "fs/open_file_cache.hpp"
+
+namespace mtfs::fs {
+
+// Read-only view of a whole file mapped into the address space
+// (CreateFileMapping/MapViewOfFile on Windows, mmap on POSIX).
+// The view reflects the file as it was when mapped; callers that change the
+// file's length must drop the mapping and map it again.
+class MappedFile {
+public:
+    // Map `fullPath`; throws FSException if the file cannot be opened or mapped
+    static std::shared_ptr<const MappedFile> open(const std::string& fullPath);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return view; }
+    size_t size() const { return length; }
+
+    // Copy up to `count` bytes starting at `offset`; returns the number copied
+    size_t read(void* buffer, size_t count, size_t offset) const;
+
+private:
+    MappedFile() = default;
+
+    const char* view{nullptr};
+    size_t length{0};
+};
+
+// Mappings kept open for repeated reads, most recently used first
+using MappingCache = OpenFileCache<const MappedFile>;
+
+} // namespace mtfs::fs
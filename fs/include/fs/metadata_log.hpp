@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <unordered_map>
+#include "common/error.hpp"
+#include "fs/file_metadata.hpp"
+
+namespace mtfs::fs {
+
+// Append-only persistence for the FileSystem metadata map.
+//
+// State lives in two files: a binary snapshot (`<basePath>`) holding the full
+// map as of the last compaction, and a log (`<basePath>.log`) of PUT/ERASE
+// records applied since. Each mutation appends one checksummed record, so the
+// cost of a metadata update no longer depends on how many files are tracked.
+// Replaying the log is idempotent, which keeps a crash between writing the
+// snapshot and truncating the log harmless.
+class MetadataLog {
+public:
+    using MetadataMap = std::unordered_map<std::string, FileMetadata>;
+
+    // Compaction is triggered once the log holds more than
+    // max(MIN_COMPACTION_RECORDS, COMPACTION_FACTOR * live entries) records.
+    static constexpr size_t MIN_COMPACTION_RECORDS = 4096;
+    static constexpr size_t COMPACTION_FACTOR = 2;
+    // Longest path, name, owner or group a record holds; encoding a longer
+    // one throws FSException
+    static constexpr size_t MAX_STRING_LENGTH = 0xFFFF;
+
+    explicit MetadataLog(const std::string& basePath);
+    ~MetadataLog();
+
+    MetadataLog(const MetadataLog&) = delete;
+    MetadataLog& operator=(const MetadataLog&) = delete;
+
+    // Rebuild the map from the snapshot and replay the log on top of it.
+    // A legacy text snapshot is accepted and rewritten in binary form.
+    bool load(MetadataMap& metadata);
+
+    // O(1) incremental updates
+    bool appendPut(const std::string& path, const FileMetadata& metadata);
+    bool appendErase(const std::string& path);
+
+    // Several records with a single flush; a null metadata is an erase
+    bool appendBatch(const std::vector<std::pair<std::string, const FileMetadata*>>& records);
+
+    // Write a fresh snapshot of `metadata` and start an empty log.
+    bool compact(const MetadataMap& metadata);
+    bool needsCompaction(size_t liveEntries) const;
+
+    void flush();
+    size_t getLogRecordCount() const { return logRecords; }
+    const std::string& getSnapshotPath() const { return snapshotPath; }
+    const std::string& getLogPath() const { return logPath; }
+
+private:
+    enum class RecordType : uint8_t {
+        PUT = 1,
+        ERASE = 2
+    };
+
+    static constexpr uint32_t SNAPSHOT_MAGIC = 0x534D544D; // "MTMS"
+    static constexpr uint32_t RECORD_MAGIC = 0x4C4D544D;   // "MTML"
+    static constexpr uint16_t FORMAT_VERSION = 1;
+    static constexpr size_t RECORD_HEADER_SIZE = 3 * sizeof(uint32_t);
+    static constexpr uint32_t MAX_RECORD_SIZE = 1u << 20;
+    static constexpr uint8_t FLAG_COMPRESSED = 1;             // FileMetadata::compressed
+
+    std::string snapshotPath;
+    std::string logPath;
+    std::ofstream logStream;
+    size_t logRecords{0};
+
+    bool openLogForAppend();
+    bool loadSnapshot(MetadataMap& metadata, bool& legacyFormat);
+    bool loadLegacySnapshot(MetadataMap& metadata);
+    bool replayLog(MetadataMap& metadata);
+    bool writeRecord(std::ostream& out, RecordType type, const std::string& path,
+                     const FileMetadata* metadata);
+
+    static std::vector<uint8_t> encodePayload(RecordType type, const std::string& path,
+                                              const FileMetadata* metadata);
+    static bool decodePayload(const std::vector<uint8_t>& payload, RecordType& type,
+                              std::string& path, FileMetadata& metadata);
+};
+
+} // namespace mtfs::fs
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+#include <array>
+#include <shared_mutex>
+#include <mutex>
+#include <unordered_map>
+#include <cstddef>
+#include "fs/file_metadata.hpp"
+
+namespace mtfs::fs {
+
+// FileSystem's path -> metadata map, split by path hash into SHARDS maps
+// behind their own reader-writer locks, so metadata of different files is
+// read and updated in parallel. Visitors run under the entry's shard lock
+// and must not call back into the table. Whole-table views lock one shard
+// at a time and are not atomic across shards.
+class MetadataTable {
+public:
+    static constexpr size_t SHARDS = 16;
+    using MetadataMap = std::unordered_map<std::string, FileMetadata>;
+
+    bool find(const std::string& path, FileMetadata& metadata) const;  // Copies the entry
+    bool contains(const std::string& path) const;
+    void put(const std::string& path, const FileMetadata& metadata);
+    bool erase(const std::string& path);
+
+    // visit(const FileMetadata&) on the entry; false if there is none
+    template<typename Visit>
+    bool inspect(const std::string& path, Visit&& visit) const {
+        const Shard& shard = shardOf(path);
+        std::shared_lock<std::shared_mutex> lock(shard.lock);
+        auto it = shard.entries.find(path);
+        if (it == shard.entries.end()) {
+            return false;
+        }
+        visit(it->second);
+        return true;
+    }
+
+    // update(FileMetadata&) on the entry; false if there is none
+    template<typename Update>
+    bool update(const std::string& path, Update&& update) {
+        Shard& shard = shardOf(path);
+        std::unique_lock<std::shared_mutex> lock(shard.lock);
+        auto it = shard.entries.find(path);
+        if (it == shard.entries.end()) {
+            return false;
+        }
+        update(it->second);
+        return true;
+    }
+
+    // Like update(), creating a default entry first if there is none
+    template<typename Update>
+    void upsert(const std::string& path, Update&& update) {
+        Shard& shard = shardOf(path);
+        std::unique_lock<std::shared_mutex> lock(shard.lock);
+        update(shard.entries[path]);
+    }
+
+    // visit(path, const FileMetadata&) for every entry
+    template<typename Visit>
+    void forEach(Visit&& visit) const {
+        for (const auto& shard : shards) {
+            std::shared_lock<std::shared_mutex> lock(shard.lock);
+            for (const auto& [path, metadata] : shard.entries) {
+                visit(path, metadata);
+            }
+        }
+    }
+
+    MetadataMap snapshot() const;
+    void assign(const MetadataMap& metadata);
+    size_t size() const;
+
+private:
+    struct alignas(64) Shard {
+        mutable std::shared_mutex lock;
+        MetadataMap entries;
+    };
+
+    Shard& shardOf(const std::string& path);
+    const Shard& shardOf(const std::string& path) const;
+
+    std::array<Shard, SHARDS> shards;
+};
+
+} // namespace mtfs::fs
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <list>
+#include <unordered_map>
+#include <cstddef>
+
+namespace mtfs::fs {
+
+// Bounded LRU of open per-file resources (mappings, native handles) keyed by
+// the path relative to the filesystem root. Resources are shared: one evicted
+// or invalidated while a caller still uses it stays valid until released.
+// FileSystem invalidates an entry whenever it changes or removes the file.
+template<typename Resource>
+class OpenFileCache {
+public:
+    using Pointer = std::shared_ptr<Resource>;
+
+    struct Statistics {
+        size_t hits{0};
+        size_t misses{0};
+        size_t evictions{0};
+        size_t open{0};
+    };
+
+    explicit OpenFileCache(size_t maxOpen);
+
+    OpenFileCache(const OpenFileCache&) = delete;
+    OpenFileCache& operator=(const OpenFileCache&) = delete;
+
+    // Cached resource for `path`, or nullptr
+    Pointer find(const std::string& path);
+
+    // Remember `resource` as `path`, evicting the least recently used entry
+    Pointer insert(const std::string& path, Pointer resource);
+
+    void invalidate(const std::string& path);
+    void clear();
+    size_t size() const;
+
+    Statistics getStatistics() const;
+    void resetStatistics();
+
+private:
+    using LruList = std::list<std::string>;
+
+    struct Slot {
+        Pointer resource;
+        LruList::iterator position;
+    };
+
+    size_t maxOpen;
+    LruList lru;  // Most recently used at the front
+    std::unordered_map<std::string, Slot> slots;
+    Statistics stats;
+    mutable std::mutex mutex;
+};
+
+} // namespace mtfs::fs
+
+// Template implementation
+#include "open_file_cache.tpp"
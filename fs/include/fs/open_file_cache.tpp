@@ -0,0 +1,80 @@
+#pragma once
+
+namespace mtfs::fs {
+
+template<typename Resource>
+OpenFileCache<Resource>::OpenFileCache(size_t maxOpen)
+    : maxOpen(maxOpen > 0 ? maxOpen : 1) {}
+
+template<typename Resource>
+typename OpenFileCache<Resource>::Pointer OpenFileCache<Resource>::find(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = slots.find(path);
+    if (it == slots.end()) {
+        stats.misses++;
+        return nullptr;
+    }
+    stats.hits++;
+    lru.splice(lru.begin(), lru, it->second.position);
+    return it->second.resource;
+}
+
+template<typename Resource>
+typename OpenFileCache<Resource>::Pointer OpenFileCache<Resource>::insert(const std::string& path,
+                                                                          Pointer resource) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = slots.find(path);
+    if (it != slots.end()) {
+        // A racing caller opened the same file; the newer resource wins
+        it->second.resource = resource;
+        lru.splice(lru.begin(), lru, it->second.position);
+        return resource;
+    }
+    while (slots.size() >= maxOpen) {
+        slots.erase(lru.back());
+        lru.pop_back();
+        stats.evictions++;
+    }
+    lru.push_front(path);
+    slots.emplace(path, Slot{resource, lru.begin()});
+    return resource;
+}
+
+template<typename Resource>
+void OpenFileCache<Resource>::invalidate(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = slots.find(path);
+    if (it != slots.end()) {
+        lru.erase(it->second.position);
+        slots.erase(it);
+    }
+}
+
+template<typename Resource>
+void OpenFileCache<Resource>::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    slots.clear();
+    lru.clear();
+}
+
+template<typename Resource>
+size_t OpenFileCache<Resource>::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return slots.size();
+}
+
+template<typename Resource>
+typename OpenFileCache<Resource>::Statistics OpenFileCache<Resource>::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Statistics result = stats;
+    result.open = slots.size();
+    return result;
+}
+
+template<typename Resource>
+void OpenFileCache<Resource>::resetStatistics() {
+    std::lock_guard<std::mutex> lock(mutex);
+    stats = Statistics();
+}
+
+} // namespace mtfs::fs
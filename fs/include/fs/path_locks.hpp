@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <array>
+#include <vector>
+#include <utility>
+#include <shared_mutex>
+#include <cstddef>
+#include <cstdint>
+
+namespace mtfs::fs {
+
+// Reader-writer locks striped by path: a path hashes to one of STRIPES
+// locks, so operations on different files rarely contend while those on the
+// same file always meet on the same lock. Two paths sharing a stripe just
+// serialize. Locks are not recursive; take one guard per operation.
+class PathLockTable {
+public:
+    static constexpr size_t STRIPES = 64;
+
+    enum class Mode { Shared, Exclusive };
+
+    // Holds its stripes until destroyed
+    class Guard {
+    public:
+        Guard() = default;
+        Guard(Guard&& other) noexcept;
+        Guard& operator=(Guard&& other) noexcept;
+        ~Guard() { release(); }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        friend class PathLockTable;
+
+        void acquire(PathLockTable& table, size_t stripe, Mode mode);
+        void release();
+
+        // One bit per stripe, so any set of them fits
+        PathLockTable* table{nullptr};
+        uint64_t exclusive{0};
+        uint64_t shared{0};
+    };
+
+    Guard lock(const std::string& path, Mode mode);
+
+    // Both paths, taken in stripe order so callers locking the same pair
+    // cannot deadlock. A stripe both map to is taken once, exclusively if
+    // either mode asks for it.
+    Guard lock(const std::string& first, Mode firstMode, const std::string& second, Mode secondMode);
+
+    // Any number of paths, on the same terms: for batches that hold every
+    // path they touch for the whole batch
+    Guard lock(const std::vector<std::pair<std::string, Mode>>& paths);
+
+private:
+    static size_t stripeOf(const std::string& path);
+    static_assert(STRIPES <= 64, "Guard keeps one bit per stripe");
+
+    // Padded so neighbouring stripes do not share a cache line
+    struct alignas(64) Stripe {
+        std::shared_mutex lock;
+    };
+    std::array<Stripe, STRIPES> stripes;
+};
+
+} // namespace mtfs::fs
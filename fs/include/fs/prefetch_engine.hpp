@@ -0,0 +1,113 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace mtfs::threading {
+class ThreadPool;
+}
+
+namespace mtfs::fs {
+
+struct PrefetchOptions {
+    bool enabled{false};
+    size_t readAhead{4};                     // Siblings loaded ahead of a sequential scan
+    size_t coAccessThreshold{2};             // Times B followed A before reading A loads B
+    size_t maxInFlight{2};                   // Background loads at once
+    uint64_t bytesPerSecond{64ull << 20};    // Load budget
+};
+
+// Learns from the stream of demand reads and loads what is likely to be
+// read next on a thread pool:
+//
+//   sequential  two or more reads in one directory in ascending name order
+//               make the next `readAhead` files of that directory candidates
+//   co-access   a file read within the last few reads before another, often
+//               enough, is loaded whenever that other file is read
+//
+// Prefetching is best effort. Candidates beyond the in-flight limit or the
+// byte budget are dropped rather than queued, so a burst of demand never
+// builds a backlog. What the loader does with a candidate, such as only
+// filling free cache room, is up to it.
+class PrefetchEngine {
+public:
+    struct Stats {
+        size_t scheduled{0};   // Candidates handed to the loader
+        size_t loaded{0};      // ... that it admitted
+        size_t throttled{0};   // Dropped by the in-flight limit or the budget
+    };
+
+    // Loads the path; the bytes admitted, or 0 if it skipped it
+    using Loader = std::function<size_t(const std::string& path)>;
+    // Names in a directory; "" is the root
+    using Lister = std::function<std::vector<std::string>(const std::string& directory)>;
+
+    PrefetchEngine(Loader loader, Lister lister, const PrefetchOptions& options,
+                   threading::ThreadPool* pool = nullptr);
+    ~PrefetchEngine();  // Waits for the loads in flight
+
+    PrefetchEngine(const PrefetchEngine&) = delete;
+    PrefetchEngine& operator=(const PrefetchEngine&) = delete;
+
+    void recordAccess(const std::string& path);  // A demand read; '/'-separated
+    void drain();                                // Wait for the loads in flight
+    Stats getStats() const;
+
+private:
+    static constexpr size_t HISTORY = 4;          // Recent reads a co-access is counted against
+    static constexpr size_t MAX_FOLLOWERS = 4;    // Per file; the least seen is replaced
+    static constexpr size_t MAX_TRACKED = 4096;   // Files and directories remembered
+
+    struct Stream {
+        std::string lastName;
+        size_t run{0};    // Ascending reads after the first
+        size_t ahead{0};  // Files loaded past the last read
+    };
+    struct Follower {
+        std::string path;
+        size_t count{0};
+    };
+    struct Work {
+        std::vector<std::string> paths;
+        bool scan{false};           // Also list scanDirectory for the files after scanAfter
+        std::string scanDirectory;
+        std::string scanAfter;
+    };
+
+    void learnFollower(const std::string& previous, const std::string& path);
+    void schedule(Work work);
+    void run(const Work& work);
+    bool withinBudget();
+    void charge(uint64_t bytes);
+
+    Loader loader;
+    Lister lister;
+    PrefetchOptions options;
+    threading::ThreadPool* pool;
+
+    std::mutex learnMutex;  // recent, streams and followers
+    std::deque<std::string> recent;
+    std::unordered_map<std::string, Stream> streams;  // By directory
+    std::unordered_map<std::string, std::vector<Follower>> followers;
+
+    std::mutex flightMutex;  // inFlight and the budget window
+    std::condition_variable idle;
+    size_t inFlight{0};
+    std::chrono::steady_clock::time_point windowStart;
+    uint64_t windowBytes{0};
+
+    std::atomic<size_t> scheduled{0};
+    std::atomic<size_t> loaded{0};
+    std::atomic<size_t> throttled{0};
+};
+
+} // namespace mtfs::fs
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "fs/chunk_store.hpp"
+
+namespace mtfs::threading {
+class ThreadPool;
+struct TaskOptions;
+}
+
+namespace mtfs::fs {
+
+struct RestoreResult {
+    size_t files{0};                   // Restored and verified
+    size_t failed{0};
+    uint64_t bytes{0};
+    size_t chunks{0};
+    std::chrono::nanoseconds elapsed{0};
+    std::vector<std::string> failures;  // Paths of the failed files
+
+    double throughput() const;  // MiB per second
+};
+
+// Restores the files of a manifest in one pass over a thread pool. Files go
+// largest first, so the longest restores start at once and small files fill
+// in behind them, and every directory is created before any file is. One
+// driver task per pool worker takes files in that order; for each it keeps up
+// to MAX_CHUNKS_IN_FLIGHT chunks being read and decompressed on other workers
+// and appends them in order as they finish.
+// ChunkStore::get checks every chunk against its hash as it decodes it and
+// the file is checked against its manifest size, so no separate verification
+// pass is needed. A file that fails is removed rather than left partial.
+class RestorePlan {
+public:
+    static constexpr size_t MAX_CHUNKS_IN_FLIGHT = 16;
+
+    // Called as each file finishes, from the worker that restored it
+    using FileCallback = std::function<void(const ManifestEntry& entry, bool restored)>;
+
+    RestorePlan(const ChunkStore& store, std::vector<ManifestEntry> entries, const std::string& targetDirectory);
+
+    const std::vector<ManifestEntry>& files() const { return entries; }  // In restore order
+    uint64_t totalBytes() const { return bytes; }
+
+    // Waits by running pool tasks, so it may be called from a worker of `pool`
+    RestoreResult run(threading::ThreadPool& pool, const threading::TaskOptions& options,
+                      const FileCallback& onFile = nullptr) const;
+
+private:
+    // Throws FSException; returns the chunks written
+    size_t restoreFile(const ManifestEntry& entry, threading::ThreadPool& pool,
+                       const threading::TaskOptions& options) const;
+
+    const ChunkStore& store;
+    std::vector<ManifestEntry> entries;
+    std::string targetDirectory;
+    uint64_t bytes{0};
+};
+
+} // namespace mtfs::fs
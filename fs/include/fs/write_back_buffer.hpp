@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace mtfs::fs {
+
+struct WriteBackOptions {
+    bool enabled{true};
+    size_t maxFileBytes{1 << 20};             // A write taking a file past this flushes it
+    uint64_t maxTotalBytes{64ull << 20};      // Past this a write flushes its file and every file is due
+    std::chrono::milliseconds maxAge{1000};   // Since a file's oldest buffered write
+};
+
+// Offset writes held in memory per file and coalesced into extents: writes
+// that overlap or touch merge into one, the newer bytes winning. The owner
+// flushes a file by taking its extents and writing them out while it holds
+// the file exclusively, restoring the ones it could not write; readers lay
+// the extents over what they read from disk. A thread of its own hands files that are due (maxAge reached, or
+// the total past maxTotalBytes) to the Flusher.
+class WriteBackBuffer {
+public:
+    using Extents = std::map<uint64_t, std::string>;  // By offset; disjoint, never adjacent
+    // Takes and writes out the path's extents; called from the flusher thread
+    using Flusher = std::function<void(const std::string& path)>;
+
+    struct Stats {
+        size_t writes{0};
+        uint64_t bytesWritten{0};
+        size_t flushes{0};          // take() calls that found extents
+        size_t extentsFlushed{0};
+        uint64_t bytesFlushed{0};
+        size_t dirtyFiles{0};
+        uint64_t pendingBytes{0};
+    };
+
+    WriteBackBuffer(Flusher flusher, const WriteBackOptions& options);
+    ~WriteBackBuffer();  // stop(); whatever is still buffered is dropped
+
+    WriteBackBuffer(const WriteBackBuffer&) = delete;
+    WriteBackBuffer& operator=(const WriteBackBuffer&) = delete;
+
+    // True when the file should be flushed right away
+    bool add(const std::string& path, uint64_t offset, const void* data, size_t size);
+    Extents take(const std::string& path);  // Empty when nothing is buffered
+    // Puts back taken extents that could not be written, under anything
+    // buffered since; the file is due again after maxAge
+    void restore(const std::string& path, Extents extents);
+    bool contains(const std::string& path) const;
+    std::vector<std::string> dirtyPaths() const;
+    uint64_t end(const std::string& path) const;  // One past the last buffered byte; 0 if none
+
+    // Lays buffered bytes over a read of [offset, offset + size) whose first
+    // `valid` bytes came from disk, a short read meaning the end of the file.
+    // Bytes between that end and a later extent read as zeros. Returns the
+    // bytes now valid.
+    size_t overlay(const std::string& path, uint64_t offset, char* buffer, size_t size, size_t valid) const;
+    void overlay(const std::string& path, std::string& contents) const;  // Whole file
+
+    void stop();  // Joins the flusher thread, which add() does not restart
+    Stats getStats() const;
+
+private:
+    struct File {
+        Extents extents;
+        uint64_t bytes{0};
+        std::chrono::steady_clock::time_point firstWrite;
+    };
+
+    void place(File& file, uint64_t offset, const void* data, size_t size);  // Newer bytes win
+    void run();
+
+    Flusher flusher;
+    WriteBackOptions options;
+    mutable std::mutex mutex;  // Everything below
+    std::condition_variable wakeup;
+    std::unordered_map<std::string, File> files;
+    uint64_t pendingBytes{0};
+    Stats stats;
+    bool stopping{false};
+    std::thread worker;  // Started by the first add()
+};
+
+} // namespace mtfs::fs
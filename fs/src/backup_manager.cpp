@@ -1,5 +1,7 @@
 #include "fs/backup_manager.hpp"
 #include "common/logger.hpp"
+#include "fs/restore_plan.hpp"
+#include "threading/thread_pool.hpp"
 #include <fstream>
 #include <sstream>
 #include <filesystem>
@@ -7,6 +9,7 @@
 #include <iostream>
 #include <algorithm>
 #include <ctime>
+#include <unordered_map>
 
 namespace mtfs::fs {
 
@@ -19,6 +22,11 @@ BackupManager::BackupManager(const std::string& backupDirectory)
     if (!initializeBackupDirectory()) {
         throw BackupException("Failed to initialize backup directory: " + backupDirectory);
     }
+    try {
+        chunkStore = std::make_unique<ChunkStore>(backupDirectory + "/.chunks");
+    } catch (const std::exception& e) {
+        throw BackupException(e.what());
+    }
     
     LOG_INFO("Backup manager initialized at: " + backupDirectory);
 }
@@ -53,40 +61,11 @@ bool BackupManager::createBackup(const std::string& backupName, const std::strin
         metadata.backupName = backupName;
         metadata.backupPath = getBackupPath(backupName);
         metadata.isIncremental = false;
-        
-        // Create backup directory
-        fs::create_directories(metadata.backupPath);
-        
-        // Copy files
-        auto sourceFiles = getDirectoryFiles(sourceDirectory);
-        metadata.includedFiles = sourceFiles;
-        metadata.totalFiles = sourceFiles.size();
-        
-        size_t totalSize = 0;
-        for (const auto& file : sourceFiles) {
-            std::string sourcePath = sourceDirectory + "/" + file;
-            std::string backupPath = metadata.backupPath + "/" + file;
-            
-            if (copyFileToBackup(sourcePath, backupPath)) {
-                if (fs::exists(sourcePath)) {
-                    totalSize += fs::file_size(sourcePath);
-                }
-            }
-        }
-        
-        metadata.totalSize = totalSize;
-        
-        // Save metadata
-        if (!saveBackupMetadata(metadata)) {
-            throw BackupException("Failed to save backup metadata");
-        }
-        
-        // Update statistics
-        updateGlobalStats(metadata);
+        writeBackup(metadata, sourceDirectory);
         
         LOG_INFO("Backup created successfully: " + backupName + 
                 " (" + std::to_string(metadata.totalFiles) + " files, " + 
-                formatFileSize(metadata.totalSize) + ")");
+                formatFileSize(metadata.totalSize) + ", " + formatFileSize(metadata.storedSize) + " new)");
         
         return true;
     } catch (const std::exception& e) {
@@ -95,6 +74,151 @@ bool BackupManager::createBackup(const std::string& backupName, const std::strin
     }
 }
 
+bool BackupManager::createIncrementalBackup(const std::string& backupName, const std::string& parentBackup,
+                                            const std::string& sourceDirectory) {
+    try {
+        LOG_INFO("Creating incremental backup: " + backupName + " from " + sourceDirectory +
+                 " (parent " + parentBackup + ")");
+
+        if (backupExists(backupName)) {
+            throw BackupAlreadyExistsException(backupName);
+        }
+        if (!backupExists(parentBackup)) {
+            throw BackupNotFoundException(parentBackup);
+        }
+        if (!fs::exists(sourceDirectory)) {
+            throw BackupException("Source directory does not exist: " + sourceDirectory);
+        }
+
+        BackupMetadata metadata;
+        metadata.backupName = backupName;
+        metadata.backupPath = getBackupPath(backupName);
+        metadata.isIncremental = true;
+        metadata.parentBackup = parentBackup;
+        writeBackup(metadata, sourceDirectory);
+
+        LOG_INFO("Incremental backup created successfully: " + backupName + " (" +
+                 std::to_string(metadata.includedFiles.size()) + " of " + std::to_string(metadata.totalFiles) +
+                 " files read, " + formatFileSize(metadata.storedSize) + " new)");
+        return true;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to create incremental backup: " + std::string(e.what()));
+        throw;
+    }
+}
+
+// Every backup gets a complete manifest, so restoring never needs its
+// parent. Files whose stamp matches the parent's index are taken from the
+// parent's manifest without being read; includedFiles lists the rest.
+void BackupManager::writeBackup(BackupMetadata& metadata, const std::string& sourceDirectory) {
+    auto startTime = std::chrono::steady_clock::now();
+    FileIndex parentIndex;
+    std::unordered_map<std::string, ManifestEntry> parentFiles;
+    if (metadata.isIncremental && fs::exists(getManifestPath(metadata.parentBackup)) &&
+        parentIndex.load(getIndexPath(metadata.parentBackup))) {
+        for (auto& entry : ChunkStore::loadManifest(getManifestPath(metadata.parentBackup))) {
+            std::string path = entry.path;
+            parentFiles.emplace(std::move(path), std::move(entry));
+        }
+    }
+
+    fs::create_directories(metadata.backupPath);
+    auto sourceFiles = getDirectoryFiles(sourceDirectory);
+    std::vector<ManifestEntry> manifest;
+    manifest.reserve(sourceFiles.size());
+    FileIndex index;
+    index.reserve(sourceFiles.size());
+    ChunkingStats chunking;
+    uint64_t totalSize = 0;
+    for (const auto& source : sourceFiles) {
+        const std::string& file = source.path;
+        std::string sourcePath = sourceDirectory + "/" + file;
+        // Stamped by the listing, before reading, so a write during the
+        // backup shows up next time
+        FileIndexEntry indexed;
+        indexed.stamp = source.stamp;
+        const FileIndexEntry* previous = parentIndex.find(file);
+        auto parentFile = parentFiles.find(file);
+        if (previous && previous->stamp == indexed.stamp && parentFile != parentFiles.end()) {
+            manifest.push_back(std::move(parentFile->second));
+            index.put(file, *previous);
+            totalSize += manifest.back().size;
+            continue;
+        }
+
+        try {
+            manifest.push_back(chunkStore->storeFile(sourcePath, file, chunking));
+        } catch (const std::exception& e) {
+            LOG_ERROR("Failed to back up file: " + file + ": " + e.what());
+            continue;
+        }
+        indexed.contentHash = FileIndex::contentHash(manifest.back().chunks);
+        index.put(file, indexed);
+        metadata.includedFiles.push_back(file);
+        totalSize += manifest.back().size;
+    }
+    metadata.totalFiles = manifest.size();
+    metadata.totalSize = static_cast<size_t>(totalSize);
+    metadata.storedSize = static_cast<size_t>(chunking.newBytes);
+
+    // Save the manifest and index, then the metadata that marks the backup complete
+    if (!ChunkStore::saveManifest(getManifestPath(metadata.backupName), manifest) ||
+        !index.save(getIndexPath(metadata.backupName))) {
+        throw BackupException("Failed to save backup manifest");
+    }
+    if (!saveBackupMetadata(metadata)) {
+        throw BackupException("Failed to save backup metadata");
+    }
+    stats.backupTime += std::chrono::steady_clock::now() - startTime;
+    updateGlobalStats(metadata);
+}
+
+std::vector<std::string> BackupManager::getChangedFiles(const std::string& sourceDirectory,
+                                                        const std::string& lastBackupName) const {
+    std::vector<std::string> changed;
+    FileIndex index;
+    try {
+        index.load(getIndexPath(lastBackupName));
+    } catch (const std::exception& e) {
+        LOG_ERROR("Ignoring unreadable file index of " + lastBackupName + ": " + e.what());
+    }
+
+    // Stamps decide; content is hashed only for files whose stamp moved
+    for (const auto& source : getDirectoryFiles(sourceDirectory)) {
+        const std::string& file = source.path;
+        const FileStamp& stamp = source.stamp;
+        std::string sourcePath = sourceDirectory + "/" + file;
+        const FileIndexEntry* previous = index.find(file);
+        if (previous && previous->stamp == stamp) {
+            continue;
+        }
+        try {
+            if (!previous || previous->stamp.size != stamp.size ||
+                FileIndex::hashFile(sourcePath) != previous->contentHash) {
+                changed.push_back(file);
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR("Failed to hash file: " + file + ": " + e.what());
+            changed.push_back(file);
+        }
+    }
+    return changed;
+}
+
+bool BackupManager::isFileModified(const std::string& filePath,
+                                   const std::chrono::system_clock::time_point& lastBackupTime) const {
+    FileStamp stamp;
+    if (!FileStamp::of(filePath, stamp)) {
+        return false;
+    }
+    auto since = std::chrono::duration_cast<std::chrono::nanoseconds>(lastBackupTime.time_since_epoch()).count();
+    return stamp.modifiedNs > since;
+}
+
+std::string BackupManager::getFileHash(const std::string& filePath) const {
+    return toHex(FileIndex::hashFile(filePath));
+}
+
 bool BackupManager::restoreBackup(const std::string& backupName, const std::string& targetDirectory) {
     try {
         LOG_INFO("Restoring backup: " + backupName + " to " + targetDirectory);
@@ -108,17 +232,35 @@ bool BackupManager::restoreBackup(const std::string& backupName, const std::stri
         // Create target directory
         fs::create_directories(targetDirectory);
         
-        // Restore files
+        // Restore files, from chunks or from a full copy made before the chunk store
         size_t restoredFiles = 0;
-        for (const auto& file : metadata.includedFiles) {
-            std::string backupPath = metadata.backupPath + "/" + file;
-            std::string targetPath = targetDirectory + "/" + file;
-            
-            if (restoreFileFromBackup(backupPath, targetPath)) {
-                restoredFiles++;
+        size_t failedFiles = 0;
+        std::string manifestPath = getManifestPath(backupName);
+        if (fs::exists(manifestPath)) {
+            RestorePlan plan(*chunkStore, ChunkStore::loadManifest(manifestPath), targetDirectory);
+            RestoreResult restored = plan.run(threading::GlobalThreadPool::getInstance(), threading::TaskOptions());
+            restoredFiles = restored.files;
+            failedFiles = restored.failed;
+            stats.bytesRestored += static_cast<size_t>(restored.bytes);
+            stats.restoreTime += restored.elapsed;
+        } else {
+            for (const auto& file : metadata.includedFiles) {
+                std::string backupPath = metadata.backupPath + "/" + file;
+                std::string targetPath = targetDirectory + "/" + file;
+                
+                if (restoreFileFromBackup(backupPath, targetPath)) {
+                    restoredFiles++;
+                } else {
+                    failedFiles++;
+                }
             }
         }
         
+        if (failedFiles > 0) {
+            LOG_ERROR("Backup restored with errors: " + backupName + " (" + std::to_string(restoredFiles) +
+                      " files restored, " + std::to_string(failedFiles) + " failed)");
+            return false;
+        }
         LOG_INFO("Backup restored successfully: " + backupName + 
                 " (" + std::to_string(restoredFiles) + " files restored)");
         
@@ -147,6 +289,7 @@ bool BackupManager::deleteBackup(const std::string& backupName) {
         if (fs::exists(metadataPath)) {
             fs::remove(metadataPath);
         }
+        collectUnreferencedChunks();
         
         LOG_INFO("Backup deleted successfully: " + backupName);
         return true;
@@ -188,6 +331,42 @@ std::vector<BackupMetadata> BackupManager::listBackups() const {
     return backups;
 }
 
+BackupMetadata BackupManager::getBackupInfo(const std::string& backupName) const {
+    if (!backupExists(backupName)) {
+        throw BackupNotFoundException(backupName);
+    }
+    return loadBackupMetadata(backupName);
+}
+
+bool BackupManager::verifyBackup(const std::string& backupName) const {
+    try {
+        if (!backupExists(backupName)) {
+            throw BackupNotFoundException(backupName);
+        }
+        std::string manifestPath = getManifestPath(backupName);
+        if (!fs::exists(manifestPath)) {
+            // Full copy: every listed file must still be there
+            BackupMetadata metadata = loadBackupMetadata(backupName);
+            return std::all_of(metadata.includedFiles.begin(), metadata.includedFiles.end(),
+                               [&](const std::string& file) { return fs::exists(metadata.backupPath + "/" + file); });
+        }
+
+        // get() re-hashes each chunk against its id; shared chunks are read once
+        ChunkIdSet checked;
+        for (const auto& entry : ChunkStore::loadManifest(manifestPath)) {
+            for (const auto& id : entry.chunks) {
+                if (checked.insert(id).second) {
+                    chunkStore->get(id);
+                }
+            }
+        }
+        return true;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Backup verification failed: " + backupName + ": " + e.what());
+        return false;
+    }
+}
+
 bool BackupManager::backupExists(const std::string& backupName) const {
     return fs::exists(getBackupPath(backupName)) && fs::exists(getMetadataPath(backupName));
 }
@@ -203,6 +382,15 @@ void BackupManager::showBackupDashboard() const {
     std::cout << "Total Backups: " << backups.size() << "\n";
     std::cout << "Total Files Backed Up: " << stats.filesBackedUp << "\n";
     std::cout << "Total Backup Size: " << formatFileSize(stats.totalBackupSize) << "\n";
+    std::cout << "Deduplicated: " << formatFileSize(stats.bytesDeduplicated) << "\n";
+    std::cout << "Backup Throughput: " << std::fixed << std::setprecision(1) << stats.backupThroughput()
+              << " MiB/s\n";
+    if (stats.bytesCopied > 0) {
+        std::cout << "Copy Throughput: " << stats.copyThroughput() << " MiB/s\n";
+    }
+    if (stats.bytesRestored > 0) {
+        std::cout << "Restore Throughput: " << stats.restoreThroughput() << " MiB/s\n";
+    }
     
     if (!backups.empty()) {
         auto lastBackup_time = std::chrono::system_clock::to_time_t(stats.lastBackupTime);
@@ -238,6 +426,28 @@ std::string BackupManager::getMetadataPath(const std::string& backupName) const
     return backupDirectory + "/" + backupName + "_metadata.txt";
 }
 
+std::string BackupManager::getManifestPath(const std::string& backupName) const {
+    return getBackupPath(backupName) + "/.mtfs_manifest";
+}
+
+std::string BackupManager::getIndexPath(const std::string& backupName) const {
+    return getBackupPath(backupName) + "/.mtfs_index";
+}
+
+// Mark every chunk a remaining manifest references, then sweep the rest
+void BackupManager::collectUnreferencedChunks() {
+    ChunkIdSet live;
+    for (const auto& entry : fs::directory_iterator(backupDirectory)) {
+        std::string manifestPath = getManifestPath(entry.path().filename().string());
+        if (entry.is_directory() && fs::exists(manifestPath)) {
+            for (const auto& file : ChunkStore::loadManifest(manifestPath)) {
+                live.insert(file.chunks.begin(), file.chunks.end());
+            }
+        }
+    }
+    chunkStore->collectGarbage(live);
+}
+
 bool BackupManager::saveBackupMetadata(const BackupMetadata& metadata) const {
     try {
         std::ofstream file(getMetadataPath(metadata.backupName));
@@ -254,6 +464,7 @@ bool BackupManager::saveBackupMetadata(const BackupMetadata& metadata) const {
         file << "modified=" << modified << "\n";
         file << "files=" << metadata.totalFiles << "\n";
         file << "size=" << metadata.totalSize << "\n";
+        file << "stored=" << metadata.storedSize << "\n";
         file << "incremental=" << (metadata.isIncremental ? "1" : "0") << "\n";
         file << "parent=" << metadata.parentBackup << "\n";
         
@@ -299,6 +510,7 @@ BackupMetadata BackupManager::loadBackupMetadata(const std::string& backupName)
                 }
                 else if (key == "files") metadata.totalFiles = std::stoull(value);
                 else if (key == "size") metadata.totalSize = std::stoull(value);
+                else if (key == "stored") metadata.storedSize = std::stoull(value);
                 else if (key == "incremental") metadata.isIncremental = (value == "1");
                 else if (key == "parent") metadata.parentBackup = value;
                 else if (key == "filelist") {
@@ -324,11 +536,10 @@ bool BackupManager::copyFileToBackup(const std::string& sourcePath, const std::s
         fs::path backupDir = fs::path(backupPath).parent_path();
         fs::create_directories(backupDir);
         
-        // Copy file
-        fs::copy_file(sourcePath, backupPath, fs::copy_options::overwrite_existing);
+        recordCopy(CopyEngine::copy(sourcePath, backupPath));
         return true;
     } catch (const std::exception& e) {
-        LOG_ERROR("Failed to copy file to backup: " + sourcePath + " -> " + backupPath);
+        LOG_ERROR("Failed to copy file to backup: " + sourcePath + " -> " + backupPath + ": " + e.what());
         return false;
     }
 }
@@ -339,35 +550,32 @@ bool BackupManager::restoreFileFromBackup(const std::string& backupPath, const s
         fs::path targetDir = fs::path(targetPath).parent_path();
         fs::create_directories(targetDir);
         
-        // Copy file
-        fs::copy_file(backupPath, targetPath, fs::copy_options::overwrite_existing);
+        recordCopy(CopyEngine::copy(backupPath, targetPath));
         return true;
     } catch (const std::exception& e) {
-        LOG_ERROR("Failed to restore file from backup: " + backupPath + " -> " + targetPath);
+        LOG_ERROR("Failed to restore file from backup: " + backupPath + " -> " + targetPath + ": " + e.what());
         return false;
     }
 }
 
-std::vector<std::string> BackupManager::getDirectoryFiles(const std::string& directory) const {
-    std::vector<std::string> files;
-    
+void BackupManager::recordCopy(const CopyResult& copied) const {
+    stats.bytesCopied += static_cast<size_t>(copied.bytes);
+    stats.copyTime += copied.elapsed;
+}
+
+std::vector<DirectoryEntry> BackupManager::getDirectoryFiles(const std::string& directory) const {
     try {
-        for (const auto& entry : fs::recursive_directory_iterator(directory)) {
-            if (entry.is_regular_file()) {
-                fs::path relativePath = fs::relative(entry.path(), directory);
-                files.push_back(relativePath.string());
-            }
-        }
+        return DirectoryWalker().collect(directory);
     } catch (const std::exception& e) {
         LOG_ERROR("Failed to get directory files: " + std::string(e.what()));
+        return {};
     }
-    
-    return files;
 }
 
 void BackupManager::updateGlobalStats(const BackupMetadata& metadata) {
     stats.totalBackups++;
     stats.totalBackupSize += metadata.totalSize;
+    stats.bytesDeduplicated += metadata.totalSize - metadata.storedSize;
     stats.filesBackedUp += metadata.totalFiles;
     stats.lastBackupTime = metadata.createdAt;
 }
@@ -0,0 +1,200 @@
+#include "fs/cache_warmer.hpp"
+#include "common/checksum.hpp"
+#include "common/logger.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <chrono>
+#include <cstring>
+
+namespace mtfs::fs {
+
+using namespace mtfs::common;
+
+namespace {
+
+constexpr uint32_t SNAPSHOT_MAGIC = 0x4D545743;  // "MTWC"
+constexpr uint16_t FORMAT_VERSION = 1;
+
+template<typename T>
+void put(std::string& buffer, T value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool get(const std::string& buffer, size_t& position, T& value) {
+    if (position + sizeof(T) > buffer.size()) return false;
+    std::memcpy(&value, buffer.data() + position, sizeof(T));
+    position += sizeof(T);
+    return true;
+}
+
+} // namespace
+
+// Layout: magic, version, count, then per entry its access count and a
+// 16-bit length-prefixed path, followed by a CRC-32 of everything before it
+bool CacheWarmer::save(const std::string& file, const std::vector<Entry>& entries) {
+    std::string buffer;
+    put(buffer, SNAPSHOT_MAGIC);
+    put(buffer, FORMAT_VERSION);
+    put(buffer, static_cast<uint64_t>(entries.size()));
+    for (const auto& entry : entries) {
+        put(buffer, entry.accessCount);
+        put(buffer, static_cast<uint16_t>(entry.path.size()));
+        buffer.append(entry.path);
+    }
+    put(buffer, crc32(buffer.data(), buffer.size()));
+
+    std::string tempPath = file + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        out.flush();
+        if (!out) {
+            LOG_ERROR("Failed to write cache snapshot: " + tempPath);
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tempPath, file, ec);
+    if (ec) {
+        LOG_ERROR("Failed to publish cache snapshot " + file + ": " + ec.message());
+        return false;
+    }
+    return true;
+}
+
+std::vector<CacheWarmer::Entry> CacheWarmer::load(const std::string& file) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+        return {};
+    }
+    std::string buffer((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    uint32_t storedCrc = 0;
+    if (buffer.size() < sizeof(storedCrc)) {
+        LOG_ERROR("Ignoring damaged cache snapshot: " + file);
+        return {};
+    }
+    size_t trailer = buffer.size() - sizeof(storedCrc);
+    get(buffer, trailer, storedCrc);
+    buffer.resize(buffer.size() - sizeof(storedCrc));
+    if (crc32(buffer.data(), buffer.size()) != storedCrc) {
+        LOG_ERROR("Ignoring damaged cache snapshot: " + file);
+        return {};
+    }
+
+    size_t position = 0;
+    uint32_t magic = 0;
+    uint16_t version = 0;
+    uint64_t count = 0;
+    if (!get(buffer, position, magic) || magic != SNAPSHOT_MAGIC || !get(buffer, position, version) ||
+        version != FORMAT_VERSION || !get(buffer, position, count)) {
+        LOG_ERROR("Ignoring cache snapshot in an unknown format: " + file);
+        return {};
+    }
+    std::vector<Entry> entries;
+    for (uint64_t i = 0; i < count; ++i) {
+        Entry entry;
+        uint16_t length = 0;
+        if (!get(buffer, position, entry.accessCount) || !get(buffer, position, length) ||
+            position + length > buffer.size()) {
+            LOG_ERROR("Ignoring truncated cache snapshot: " + file);
+            return {};
+        }
+        entry.path.assign(buffer, position, length);
+        position += length;
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+CacheWarmer::CacheWarmer(Loader loader, uint64_t bytesPerSecond)
+    : loader(std::move(loader)), bytesPerSecond(bytesPerSecond) {}
+
+CacheWarmer::~CacheWarmer() {
+    stop();
+}
+
+void CacheWarmer::start(std::vector<Entry> entries) {
+    stop();
+    planned = entries.size();
+    loaded = 0;
+    bytes = 0;
+    std::lock_guard<std::mutex> lock(mutex);
+    running = true;
+    worker = std::thread([this, entries = std::move(entries)]() mutable { run(std::move(entries)); });
+}
+
+void CacheWarmer::stop() {
+    std::thread stopped;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        stopped = std::move(worker);
+    }
+    wakeup.notify_all();
+    if (stopped.joinable()) {
+        stopped.join();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = false;
+}
+
+void CacheWarmer::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return !running; });
+}
+
+CacheWarmer::Stats CacheWarmer::getStats() const {
+    Stats stats;
+    stats.planned = planned.load();
+    stats.loaded = loaded.load();
+    stats.bytes = bytes.load();
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.running = running;
+    return stats;
+}
+
+void CacheWarmer::run(std::vector<Entry> entries) {
+    auto begin = std::chrono::steady_clock::now();
+    auto due = begin;
+    uint64_t total = 0;
+    for (size_t first = 0; first < entries.size(); first += BATCH) {
+        {
+            // Each batch waits until the bytes loaded so far are within budget
+            std::unique_lock<std::mutex> lock(mutex);
+            if (wakeup.wait_until(lock, due, [this] { return stopping; })) {
+                break;
+            }
+        }
+        std::vector<std::string> paths;
+        for (size_t i = first; i < entries.size() && i < first + BATCH; ++i) {
+            paths.push_back(entries[i].path);
+        }
+        BatchResult result;
+        try {
+            result = loader(paths);
+        } catch (const std::exception& e) {
+            LOG_DEBUG(std::string("Cache warm-up batch failed: ") + e.what());
+        }
+        loaded += result.loaded;
+        bytes += result.bytes;
+        total += result.bytes;
+        if (result.full) {
+            break;
+        }
+        if (bytesPerSecond > 0) {
+            due = begin + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                              std::chrono::duration<double>(static_cast<double>(total) / bytesPerSecond));
+        }
+    }
+    LOG_INFO("Cache warm-up reloaded " + std::to_string(loaded.load()) + " of " + std::to_string(entries.size()) +
+             " files (" + std::to_string(bytes.load()) + " bytes)");
+
+    std::lock_guard<std::mutex> lock(mutex);
+    running = false;
+    finished.notify_all();
+}
+
+} // namespace mtfs::fs
@@ -0,0 +1,360 @@
+#include "fs/chunk_store.hpp"
+#include "common/logger.hpp"
+#include "fs/compression.hpp"
+#include "fs/copy_engine.hpp"
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <cstring>
+
+namespace mtfs::fs {
+
+using namespace mtfs::common;
+namespace stdfs = std::filesystem;
+
+namespace {
+
+constexpr char MANIFEST_HEADER[] = "MTFS-MANIFEST 1";
+constexpr char COMPRESSED_SUFFIX[] = ".lz";
+constexpr size_t READ_BUFFER_SIZE = 16 * ContentChunker::MAX_CHUNK;
+
+// A cut needs the top MASK bits of the gear hash clear: 16 bits (1 in 64KB)
+// before the average size and 12 bits (1 in 4KB) after it
+constexpr uint64_t MASK_SMALL = ~uint64_t(0) << (64 - 16);
+constexpr uint64_t MASK_LARGE = ~uint64_t(0) << (64 - 12);
+
+constexpr std::array<uint64_t, 256> makeGearTable() {
+    std::array<uint64_t, 256> table{};
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (auto& value : table) {
+        // splitmix64
+        state += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        value = z ^ (z >> 31);
+    }
+    return table;
+}
+
+constexpr auto GEAR = makeGearTable();
+
+} // namespace
+
+std::string toHex(const ChunkId& id) {
+    static const char digits[] = "0123456789abcdef";
+    std::string text(32, '0');
+    for (int i = 0; i < 16; ++i) {
+        uint64_t word = i < 8 ? id.high : id.low;
+        unsigned byte = static_cast<unsigned>(word >> (56 - 8 * (i % 8))) & 0xFF;
+        text[2 * i] = digits[byte >> 4];
+        text[2 * i + 1] = digits[byte & 15];
+    }
+    return text;
+}
+
+bool fromHex(const std::string& text, ChunkId& id) {
+    if (text.size() != 32) {
+        return false;
+    }
+    uint64_t words[2] = {0, 0};
+    for (size_t i = 0; i < 32; ++i) {
+        char c = text[i];
+        unsigned digit;
+        if (c >= '0' && c <= '9') digit = static_cast<unsigned>(c - '0');
+        else if (c >= 'a' && c <= 'f') digit = static_cast<unsigned>(c - 'a' + 10);
+        else return false;
+        words[i / 16] = (words[i / 16] << 4) | digit;
+    }
+    id.high = words[0];
+    id.low = words[1];
+    return true;
+}
+
+size_t ContentChunker::nextBoundary(const char* data, size_t size) {
+    if (size <= MIN_CHUNK) {
+        return size;
+    }
+    size_t limit = std::min(size, MAX_CHUNK);
+    size_t normal = std::min(limit, AVERAGE_CHUNK);
+    const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+
+    uint64_t hash = 0;
+    size_t i = MIN_CHUNK;
+    for (; i < normal; ++i) {
+        hash = (hash << 1) + GEAR[bytes[i]];
+        if ((hash & MASK_SMALL) == 0) {
+            return i + 1;
+        }
+    }
+    for (; i < limit; ++i) {
+        hash = (hash << 1) + GEAR[bytes[i]];
+        if ((hash & MASK_LARGE) == 0) {
+            return i + 1;
+        }
+    }
+    return limit;
+}
+
+ChunkStore::ChunkStore(const std::string& directory) : directory(directory) {
+    std::error_code error;
+    stdfs::create_directories(directory, error);
+    if (!stdfs::is_directory(directory)) {
+        throw FSException("Failed to create chunk store: " + directory);
+    }
+}
+
+std::string ChunkStore::chunkPath(const ChunkId& id, bool compressed) const {
+    std::string hex = toHex(id);
+    return directory + "/" + hex.substr(0, 2) + "/" + hex + (compressed ? COMPRESSED_SUFFIX : "");
+}
+
+ChunkId ChunkStore::put(const char* data, size_t size, bool& written) {
+    ChunkId id = hash128(data, size);
+    written = putEncoded(id, data, size, size, false);
+    return id;
+}
+
+bool ChunkStore::putEncoded(const ChunkId& id, const char* stored, size_t storedSize, size_t rawSize,
+                            bool compressed) {
+    if (contains(id)) {
+        return false;
+    }
+
+    std::string path = chunkPath(id, compressed);
+    std::error_code error;
+    stdfs::create_directories(stdfs::path(path).parent_path(), error);
+    std::string temporary = path + ".tmp" + std::to_string(temporaryCounter.fetch_add(1));
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (compressed) {
+            uint32_t size = static_cast<uint32_t>(rawSize);
+            out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        }
+        out.write(stored, static_cast<std::streamsize>(storedSize));
+        if (!out) {
+            out.close();
+            stdfs::remove(temporary, error);
+            throw FSException("Failed to write chunk " + toHex(id));
+        }
+    }
+    stdfs::rename(temporary, path, error);
+    if (error) {
+        stdfs::remove(temporary, error);
+        throw FSException("Failed to store chunk " + toHex(id));
+    }
+
+    std::lock_guard<std::mutex> lock(knownMutex);
+    known.insert(id);
+    return true;
+}
+
+bool ChunkStore::contains(const ChunkId& id) const {
+    {
+        std::lock_guard<std::mutex> lock(knownMutex);
+        if (known.count(id)) {
+            return true;
+        }
+    }
+    std::error_code error;
+    if (!stdfs::exists(chunkPath(id), error) && !stdfs::exists(chunkPath(id, true), error)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(knownMutex);
+    known.insert(id);
+    return true;
+}
+
+std::string ChunkStore::get(const ChunkId& id) const {
+    bool compressed = false;
+    std::ifstream in(chunkPath(id), std::ios::binary | std::ios::ate);
+    if (!in) {
+        in.open(chunkPath(id, true), std::ios::binary | std::ios::ate);
+        compressed = true;
+    }
+    if (!in) {
+        throw FSException("Missing chunk " + toHex(id));
+    }
+    std::string stored(static_cast<size_t>(in.tellg()), '\0');
+    in.seekg(0);
+    if (!in.read(&stored[0], static_cast<std::streamsize>(stored.size()))) {
+        throw FSException("Corrupt chunk " + toHex(id));
+    }
+
+    std::string data;
+    if (!compressed) {
+        data = std::move(stored);
+    } else {
+        uint32_t rawSize = 0;
+        if (stored.size() < sizeof(rawSize)) {
+            throw FSException("Corrupt chunk " + toHex(id));
+        }
+        std::memcpy(&rawSize, stored.data(), sizeof(rawSize));
+        data.resize(rawSize);
+        try {
+            FileCompression::lzDecompress(stored.data() + sizeof(rawSize), stored.size() - sizeof(rawSize),
+                                          &data[0], rawSize);
+        } catch (const std::exception&) {
+            throw FSException("Corrupt chunk " + toHex(id));
+        }
+    }
+    if (hash128(data.data(), data.size()) != id) {
+        throw FSException("Corrupt chunk " + toHex(id));
+    }
+    return data;
+}
+
+ManifestEntry ChunkStore::storeFile(const std::string& sourcePath, const std::string& relativePath,
+                                    ChunkingStats& stats) {
+    ManifestEntry entry;
+    entry.path = relativePath;
+    chunkFile(sourcePath, [&](const char* data, size_t size) {
+        bool written = false;
+        entry.chunks.push_back(put(data, size, written));
+        entry.size += size;
+        stats.chunks++;
+        stats.bytes += size;
+        if (written) {
+            stats.newChunks++;
+            stats.newBytes += size;
+            stats.storedBytes += size;
+        }
+    });
+    return entry;
+}
+
+void ChunkStore::chunkFile(const std::string& sourcePath,
+                           const std::function<void(const char* data, size_t size)>& onChunk) {
+    std::unique_ptr<SequentialReader> in;
+    try {
+        in = std::make_unique<SequentialReader>(sourcePath);
+    } catch (const FSException&) {
+        throw FSException("Cannot open file for backup: " + sourcePath);
+    }
+
+    std::vector<char> buffer(READ_BUFFER_SIZE);
+    size_t begin = 0;
+    size_t end = 0;
+    bool atEnd = false;
+    while (true) {
+        // Keep a full MAX_CHUNK window ahead of the cursor until the input ends
+        if (!atEnd && end - begin < ContentChunker::MAX_CHUNK) {
+            std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+            end -= begin;
+            begin = 0;
+            size_t wanted = buffer.size() - end;
+            size_t got = in->read(buffer.data() + end, wanted);
+            end += got;
+            atEnd = got < wanted;
+        }
+        if (begin == end) {
+            break;
+        }
+
+        size_t length = ContentChunker::nextBoundary(buffer.data() + begin, end - begin);
+        onChunk(buffer.data() + begin, length);
+        begin += length;
+    }
+}
+
+void ChunkStore::restoreFile(const ManifestEntry& entry, const std::string& targetPath) const {
+    std::error_code error;
+    stdfs::create_directories(stdfs::path(targetPath).parent_path(), error);
+    std::ofstream out(targetPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw FSException("Cannot create restored file: " + targetPath);
+    }
+    uint64_t restored = 0;
+    for (const auto& id : entry.chunks) {
+        std::string data = get(id);
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        restored += data.size();
+    }
+    if (!out || restored != entry.size) {
+        throw FSException("Failed to restore file: " + entry.path);
+    }
+}
+
+size_t ChunkStore::collectGarbage(const ChunkIdSet& live) {
+    size_t removed = 0;
+    std::error_code error;
+    for (const auto& entry : stdfs::recursive_directory_iterator(directory, error)) {
+        if (!entry.is_regular_file(error)) {
+            continue;
+        }
+        // Unparsable names are temporaries left by an interrupted put
+        const stdfs::path& path = entry.path();
+        std::string name = (path.extension() == COMPRESSED_SUFFIX ? path.stem() : path.filename()).string();
+        ChunkId id;
+        if (fromHex(name, id) && live.count(id)) {
+            continue;
+        }
+        if (stdfs::remove(entry.path(), error)) {
+            ++removed;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(knownMutex);
+    known.clear();
+    if (removed > 0) {
+        LOG_INFO("Removed " + std::to_string(removed) + " unreferenced chunks from " + directory);
+    }
+    return removed;
+}
+
+bool ChunkStore::saveManifest(const std::string& manifestPath, const std::vector<ManifestEntry>& entries) {
+    std::ofstream out(manifestPath, std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    out << MANIFEST_HEADER << "\n";
+    for (const auto& entry : entries) {
+        out << entry.size << ' ';
+        if (entry.chunks.empty()) {
+            out << '-';
+        }
+        for (size_t i = 0; i < entry.chunks.size(); ++i) {
+            out << (i ? "," : "") << toHex(entry.chunks[i]);
+        }
+        out << ' ' << entry.path << "\n";
+    }
+    return out.good();
+}
+
+std::vector<ManifestEntry> ChunkStore::loadManifest(const std::string& manifestPath) {
+    std::ifstream in(manifestPath);
+    std::string line;
+    if (!in || !std::getline(in, line) || line != MANIFEST_HEADER) {
+        throw FSException("Invalid backup manifest: " + manifestPath);
+    }
+
+    std::vector<ManifestEntry> entries;
+    while (std::getline(in, line)) {
+        size_t first = line.find(' ');
+        size_t second = first == std::string::npos ? first : line.find(' ', first + 1);
+        if (second == std::string::npos) {
+            throw FSException("Invalid backup manifest line in " + manifestPath);
+        }
+        ManifestEntry entry;
+        entry.size = std::stoull(line.substr(0, first));
+        entry.path = line.substr(second + 1);
+        std::string ids = line.substr(first + 1, second - first - 1);
+        if (ids != "-") {
+            std::stringstream list(ids);
+            std::string hex;
+            while (std::getline(list, hex, ',')) {
+                ChunkId id;
+                if (!fromHex(hex, id)) {
+                    throw FSException("Invalid chunk id in " + manifestPath);
+                }
+                entry.chunks.push_back(id);
+            }
+        }
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+} // namespace mtfs::fs
@@ -1,84 +1,345 @@
 #include "fs/compression.hpp"
 #include "common/logger.hpp"
+#include "threading/thread_pool.hpp"
 #include <fstream>
+#include <sstream>
 #include <algorithm>
 #include <cstring>
+#include <stdexcept>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 namespace mtfs::fs {
 
 using namespace mtfs::common;
 
-// Simple RLE compression implementation
-std::vector<uint8_t> FileCompression::rleCompress(const std::string& data) {
-    std::vector<uint8_t> compressed;
-    
-    if (data.empty()) {
-        return compressed;
-    }
-    
-    for (size_t i = 0; i < data.size(); ) {
-        char currentChar = data[i];
-        uint8_t count = 1;
-        
-        // Count consecutive identical characters (max 255)
-        while (i + count < data.size() && data[i + count] == currentChar && count < 255) {
-            count++;
+namespace {
+
+// LZ4 block format: a token byte (literal length << 4 | match length - 4),
+// extended lengths as runs of 255, the literals, then a 16-bit offset.
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t LAST_LITERALS = 5;   // Final bytes are always literals
+constexpr size_t MATCH_LIMIT = 12;    // No match starts this close to the end
+constexpr size_t MAX_DISTANCE = 65535;
+constexpr unsigned HASH_BITS = 16;
+constexpr size_t WINDOW_MASK = 0xFFFF;
+constexpr int MAX_CHAIN = 16;         // Candidates tried per position
+
+uint32_t read32(const char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint64_t read64(const char* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t hashPosition(const char* p) {
+    return (read32(p) * 2654435761u) >> (32 - HASH_BITS);
+}
+
+unsigned trailingZeroBytes(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<unsigned>(index) / 8;
+#else
+    return static_cast<unsigned>(__builtin_ctzll(value)) / 8;
+#endif
+}
+
+// Length of the common prefix of a and b, comparing 8 bytes at a time
+size_t matchLength(const char* a, const char* b, const char* limit) {
+    const char* start = a;
+    while (a + 8 <= limit) {
+        uint64_t diff = read64(a) ^ read64(b);
+        if (diff != 0) {
+            return static_cast<size_t>(a - start) + trailingZeroBytes(diff);
         }
-        
-        // Store count and character
-        compressed.push_back(count);
-        compressed.push_back(static_cast<uint8_t>(currentChar));
-        
-        i += count;
+        a += 8;
+        b += 8;
+    }
+    while (a < limit && *a == *b) {
+        ++a;
+        ++b;
+    }
+    return static_cast<size_t>(a - start);
+}
+
+char* writeLength(char* op, size_t length) {
+    while (length >= 255) {
+        *op++ = static_cast<char>(255);
+        length -= 255;
+    }
+    *op++ = static_cast<char>(length);
+    return op;
+}
+
+char* emitSequence(char* op, const char* literals, size_t literalLength, size_t offset, size_t matchLength) {
+    char* token = op++;
+    uint8_t tokenValue = static_cast<uint8_t>(std::min<size_t>(literalLength, 15) << 4);
+    if (literalLength >= 15) {
+        op = writeLength(op, literalLength - 15);
+    }
+    std::memcpy(op, literals, literalLength);
+    op += literalLength;
+    if (matchLength > 0) {
+        *op++ = static_cast<char>(offset & 0xFF);
+        *op++ = static_cast<char>(offset >> 8);
+        size_t code = matchLength - MIN_MATCH;
+        tokenValue |= static_cast<uint8_t>(std::min<size_t>(code, 15));
+        if (code >= 15) {
+            op = writeLength(op, code - 15);
+        }
+    }
+    *token = static_cast<char>(tokenValue);
+    return op;
+}
+
+size_t readLength(const char*& ip, const char* end) {
+    size_t length = 0;
+    uint8_t byte;
+    do {
+        if (ip >= end) {
+            throw std::runtime_error("Corrupt LZ block: truncated length");
+        }
+        byte = static_cast<uint8_t>(*ip++);
+        length += byte;
+    } while (byte == 255);
+    return length;
+}
+
+} // namespace
+
+size_t FileCompression::lzCompressBound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+size_t FileCompression::lzCompress(const char* source, size_t size, char* destination, size_t capacity) {
+    if (capacity < lzCompressBound(size)) {
+        throw std::runtime_error("LZ output buffer too small");
     }
-    
-    return compressed;
+    char* op = destination;
+    const char* anchor = source;
+    const char* end = source + size;
+
+    if (size > MATCH_LIMIT) {
+        // head: last position per hash; chain: distance to the previous
+        // position with the same hash, within the 64KB window
+        std::vector<int32_t> head(size_t(1) << HASH_BITS, -1);
+        std::vector<uint16_t> chain(WINDOW_MASK + 1, 0);
+        const char* matchEnd = end - LAST_LITERALS;
+        const char* searchLimit = end - MATCH_LIMIT;
+
+        auto insert = [&](const char* p) {
+            size_t position = static_cast<size_t>(p - source);
+            uint32_t hash = hashPosition(p);
+            int32_t previous = head[hash];
+            size_t distance = previous < 0 ? 0 : position - static_cast<size_t>(previous);
+            chain[position & WINDOW_MASK] = static_cast<uint16_t>(distance <= MAX_DISTANCE ? distance : 0);
+            head[hash] = static_cast<int32_t>(position);
+            return previous;
+        };
+
+        const char* ip = source;
+        while (ip < searchLimit) {
+            int32_t candidate = insert(ip);
+            size_t bestLength = 0;
+            const char* bestMatch = nullptr;
+            size_t position = static_cast<size_t>(ip - source);
+            for (int attempts = MAX_CHAIN; candidate >= 0 && attempts > 0; --attempts) {
+                size_t distance = position - static_cast<size_t>(candidate);
+                if (distance > MAX_DISTANCE) {
+                    break;
+                }
+                const char* match = source + candidate;
+                if (read32(match) == read32(ip)) {
+                    size_t length = MIN_MATCH + matchLength(ip + MIN_MATCH, match + MIN_MATCH, matchEnd);
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestMatch = match;
+                    }
+                }
+                uint16_t step = chain[static_cast<size_t>(candidate) & WINDOW_MASK];
+                if (step == 0) {
+                    break;
+                }
+                candidate -= step;
+            }
+
+            if (bestLength < MIN_MATCH) {
+                // Step faster through data that keeps failing to match
+                ip += 1 + (static_cast<size_t>(ip - anchor) >> 8);
+                continue;
+            }
+
+            op = emitSequence(op, anchor, static_cast<size_t>(ip - anchor),
+                              static_cast<size_t>(ip - bestMatch), bestLength);
+            const char* next = ip + bestLength;
+            for (const char* p = ip + 1; p < next && p < searchLimit; ++p) {
+                insert(p);
+            }
+            ip = next;
+            anchor = ip;
+        }
+    }
+
+    op = emitSequence(op, anchor, static_cast<size_t>(end - anchor), 0, 0);
+    return static_cast<size_t>(op - destination);
 }
 
-std::string FileCompression::rleDecompress(const std::vector<uint8_t>& data) {
-    std::string decompressed;
-    
-    for (size_t i = 0; i < data.size(); i += 2) {
-        if (i + 1 < data.size()) {
-            uint8_t count = data[i];
-            char character = static_cast<char>(data[i + 1]);
-            
-            decompressed.append(count, character);
+void FileCompression::lzDecompress(const char* source, size_t size, char* destination, size_t rawSize) {
+    const char* ip = source;
+    const char* inputEnd = source + size;
+    char* op = destination;
+    char* outputEnd = destination + rawSize;
+
+    while (ip < inputEnd) {
+        uint8_t token = static_cast<uint8_t>(*ip++);
+        size_t literalLength = token >> 4;
+        size_t length = token & 15;
+
+        // Common case: short literals and a short, non-overlapping match,
+        // copied with fixed-size moves while every buffer has slack
+        if (literalLength < 15 && length < 15 && inputEnd - ip >= 32 && outputEnd - op >= 32) {
+            std::memcpy(op, ip, 16);
+            op += literalLength;
+            ip += literalLength;
+            size_t offset = static_cast<uint8_t>(ip[0]) | (static_cast<size_t>(static_cast<uint8_t>(ip[1])) << 8);
+            ip += 2;
+            if (offset >= 8 && offset <= static_cast<size_t>(op - destination)) {
+                const char* match = op - offset;
+                std::memcpy(op, match, 8);
+                std::memcpy(op + 8, match + 8, 8);
+                std::memcpy(op + 16, match + 16, 2);
+                op += length + MIN_MATCH;
+                continue;
+            }
+            ip -= 2;  // Rare short offset: back to the general path for the match
+        } else {
+            if (literalLength == 15) {
+                literalLength += readLength(ip, inputEnd);
+            }
+            if (literalLength > static_cast<size_t>(inputEnd - ip) ||
+                literalLength > static_cast<size_t>(outputEnd - op)) {
+                throw std::runtime_error("Corrupt LZ block: literals overrun");
+            }
+            // Copy in 16-byte pieces while both buffers have room for the overshoot
+            if (literalLength + 16 <= static_cast<size_t>(inputEnd - ip) &&
+                literalLength + 16 <= static_cast<size_t>(outputEnd - op)) {
+                for (size_t i = 0; i < literalLength; i += 16) {
+                    std::memcpy(op + i, ip + i, 16);
+                }
+            } else {
+                std::memcpy(op, ip, literalLength);
+            }
+            ip += literalLength;
+            op += literalLength;
+            if (ip == inputEnd) {
+                break;  // The last sequence has no match
+            }
+        }
+
+        if (inputEnd - ip < 2) {
+            throw std::runtime_error("Corrupt LZ block: truncated offset");
         }
+        size_t offset = static_cast<uint8_t>(ip[0]) | (static_cast<size_t>(static_cast<uint8_t>(ip[1])) << 8);
+        ip += 2;
+        if (length == 15) {
+            length += readLength(ip, inputEnd);
+        }
+        length += MIN_MATCH;
+        if (offset == 0 || offset > static_cast<size_t>(op - destination) ||
+            length > static_cast<size_t>(outputEnd - op)) {
+            throw std::runtime_error("Corrupt LZ block: bad match");
+        }
+
+        const char* match = op - offset;
+        if (offset >= 8 && length + 8 <= static_cast<size_t>(outputEnd - op)) {
+            // Eight bytes at a time; an offset of at least 8 keeps each copy disjoint
+            for (size_t i = 0; i < length; i += 8) {
+                std::memcpy(op + i, match + i, 8);
+            }
+        } else {
+            // Short offsets repeat a pattern; copy forwards byte by byte
+            for (size_t i = 0; i < length; ++i) {
+                op[i] = match[i];
+            }
+        }
+        op += length;
+    }
+
+    if (op != outputEnd) {
+        throw std::runtime_error("Corrupt LZ block: size mismatch");
+    }
+}
+
+std::string FileCompression::encodeChunkedHeader(const ChunkedHeader& header) {
+    char bytes[CHUNKED_HEADER_SIZE] = {};
+    uint16_t version = CHUNKED_VERSION;
+    std::memcpy(bytes, &COMPRESSION_MAGIC, sizeof(uint32_t));
+    std::memcpy(bytes + 4, &version, sizeof(version));
+    bytes[6] = static_cast<char>(TYPE_LZ);
+    std::memcpy(bytes + 8, &header.chunkSize, sizeof(header.chunkSize));
+    std::memcpy(bytes + 16, &header.originalSize, sizeof(header.originalSize));
+    std::memcpy(bytes + 24, &header.chunkCount, sizeof(header.chunkCount));
+    std::memcpy(bytes + 32, &header.indexOffset, sizeof(header.indexOffset));
+    return std::string(bytes, sizeof(bytes));
+}
+
+FileCompression::ChunkedHeader FileCompression::decodeChunkedHeader(const char* bytes) {
+    uint32_t magic;
+    uint16_t version;
+    std::memcpy(&magic, bytes, sizeof(magic));
+    std::memcpy(&version, bytes + 4, sizeof(version));
+    if (magic != COMPRESSION_MAGIC) {
+        throw std::runtime_error("Invalid compression magic number");
+    }
+    if (version != CHUNKED_VERSION || static_cast<uint8_t>(bytes[6]) != TYPE_LZ) {
+        throw std::runtime_error("Not a chunked compressed stream");
+    }
+    ChunkedHeader header;
+    std::memcpy(&header.chunkSize, bytes + 8, sizeof(header.chunkSize));
+    std::memcpy(&header.originalSize, bytes + 16, sizeof(header.originalSize));
+    std::memcpy(&header.chunkCount, bytes + 24, sizeof(header.chunkCount));
+    std::memcpy(&header.indexOffset, bytes + 32, sizeof(header.indexOffset));
+    if (header.chunkSize == 0 || header.chunkSize > STREAM_BLOCK_SIZE ||
+        header.chunkCount != (header.originalSize + header.chunkSize - 1) / header.chunkSize) {
+        throw std::runtime_error("Corrupt chunked compression header");
+    }
+    return header;
+}
+
+void FileCompression::decodeChunk(const char* stored, uint32_t storedField, char* out, uint32_t rawSize) {
+    uint32_t storedSize = storedField & ~STORED_RAW;
+    if (storedField & STORED_RAW) {
+        if (storedSize != rawSize) {
+            throw std::runtime_error("Corrupt compressed block header");
+        }
+        std::memcpy(out, stored, rawSize);
+    } else {
+        lzDecompress(stored, storedSize, out, rawSize);
     }
-    
-    return decompressed;
 }
 
 std::vector<uint8_t> FileCompression::compress(const std::string& data) {
     try {
         LOG_INFO("Compressing data of size: " + std::to_string(data.size()) + " bytes");
-        
-        // Compress using RLE
-        auto rleCompressed = rleCompress(data);
-        
-        // Create header
-        CompressionHeader header;
-        header.magic = COMPRESSION_MAGIC;
-        header.version = COMPRESSION_VERSION;
-        header.originalSize = static_cast<uint32_t>(data.size());
-        header.compressedSize = static_cast<uint32_t>(rleCompressed.size());
-        header.compressionType = 0; // RLE
-        
-        // Combine header and compressed data
-        std::vector<uint8_t> result;
-        result.resize(sizeof(CompressionHeader) + rleCompressed.size());
-        
-        // Copy header
-        std::memcpy(result.data(), &header, sizeof(CompressionHeader));
-        
-        // Copy compressed data
-        std::memcpy(result.data() + sizeof(CompressionHeader), 
-                   rleCompressed.data(), rleCompressed.size());
-        
+
+        std::ostringstream out(std::ios::binary);
+        CompressionStreamWriter writer(out);
+        writer.write(data.data(), data.size());
+        writer.finish();
+        std::string encoded = out.str();
+        std::vector<uint8_t> result(encoded.begin(), encoded.end());
+
         double ratio = calculateCompressionRatio(data.size(), result.size());
         LOG_INFO("Compression completed. Ratio: " + std::to_string(ratio) + "%");
-        
         return result;
     } catch (const std::exception& e) {
         LOG_ERROR("Compression failed: " + std::string(e.what()));
@@ -88,47 +349,25 @@ std::vector<uint8_t> FileCompression::compress(const std::string& data) {
 
 std::string FileCompression::decompress(const std::vector<uint8_t>& compressedData) {
     try {
-        if (compressedData.size() < sizeof(CompressionHeader)) {
-            throw std::runtime_error("Invalid compressed data: too small");
-        }
-        
-        // Read header
-        CompressionHeader header;
-        std::memcpy(&header, compressedData.data(), sizeof(CompressionHeader));
-        
-        // Validate header
-        if (header.magic != COMPRESSION_MAGIC) {
-            throw std::runtime_error("Invalid compression magic number");
-        }
-        
-        if (header.version != COMPRESSION_VERSION) {
-            throw std::runtime_error("Unsupported compression version");
-        }
-        
-        LOG_INFO("Decompressing data. Original size: " + std::to_string(header.originalSize) + " bytes");
-        
-        // Extract compressed data
-        std::vector<uint8_t> compressedPayload(
-            compressedData.begin() + sizeof(CompressionHeader),
-            compressedData.end()
-        );
-        
-        // Decompress based on type
-        std::string result;
-        switch (header.compressionType) {
-            case 0: // RLE
-                result = rleDecompress(compressedPayload);
+        std::istringstream in(std::string(compressedData.begin(), compressedData.end()), std::ios::binary);
+        CompressionStreamReader reader(in);
+        LOG_INFO("Decompressing data. Original size: " + std::to_string(reader.getOriginalSize()) + " bytes");
+
+        std::string result(static_cast<size_t>(reader.getOriginalSize()), '\0');
+        size_t total = 0;
+        while (total < result.size()) {
+            size_t count = reader.read(&result[total], result.size() - total);
+            if (count == 0) {
                 break;
-            default:
-                throw std::runtime_error("Unsupported compression type: " + 
-                                       std::to_string(header.compressionType));
+            }
+            total += count;
         }
-        
+
         // Validate decompressed size
-        if (result.size() != header.originalSize) {
+        if (total != result.size()) {
             throw std::runtime_error("Decompressed size mismatch");
         }
-        
+
         LOG_INFO("Decompression completed successfully");
         return result;
     } catch (const std::exception& e) {
@@ -137,33 +376,37 @@ std::string FileCompression::decompress(const std::vector<uint8_t>& compressedDa
     }
 }
 
-bool FileCompression::compressFile(const std::string& inputPath, const std::string& outputPath) {
+bool FileCompression::compressFile(const std::string& inputPath, const std::string& outputPath,
+                                   threading::ThreadPool* pool) {
     try {
         LOG_INFO("Compressing file: " + inputPath + " -> " + outputPath);
-        
-        // Read input file
-        std::ifstream inputFile(inputPath, std::ios::binary);
+
+        std::ifstream inputFile(inputPath, std::ios::binary | std::ios::ate);
         if (!inputFile) {
             throw std::runtime_error("Cannot open input file: " + inputPath);
         }
-        
-        std::string fileContent((std::istreambuf_iterator<char>(inputFile)),
-                               std::istreambuf_iterator<char>());
-        inputFile.close();
-        
-        // Compress data
-        auto compressedData = compress(fileContent);
-        
-        // Write compressed file
-        std::ofstream outputFile(outputPath, std::ios::binary);
+        uint64_t inputSize = static_cast<uint64_t>(inputFile.tellg());
+        inputFile.seekg(0);
+        std::ofstream outputFile(outputPath, std::ios::binary | std::ios::trunc);
         if (!outputFile) {
             throw std::runtime_error("Cannot create output file: " + outputPath);
         }
-        
-        outputFile.write(reinterpret_cast<const char*>(compressedData.data()), 
-                        compressedData.size());
-        outputFile.close();
-        
+
+        // A single chunk gains nothing from the pool
+        if (!pool && inputSize > STREAM_BLOCK_SIZE) {
+            pool = &threading::GlobalThreadPool::getInstance();
+        }
+        CompressionStreamWriter writer(outputFile, pool);
+        std::vector<char> buffer(STREAM_BLOCK_SIZE);
+        while (inputFile) {
+            inputFile.read(buffer.data(), buffer.size());
+            writer.write(buffer.data(), static_cast<size_t>(inputFile.gcount()));
+        }
+        writer.finish();
+        if (!outputFile) {
+            throw std::runtime_error("Failed writing output file: " + outputPath);
+        }
+
         LOG_INFO("File compression completed: " + inputPath + " -> " + outputPath);
         return true;
     } catch (const std::exception& e) {
@@ -175,29 +418,28 @@ bool FileCompression::compressFile(const std::string& inputPath, const std::stri
 bool FileCompression::decompressFile(const std::string& inputPath, const std::string& outputPath) {
     try {
         LOG_INFO("Decompressing file: " + inputPath + " -> " + outputPath);
-        
-        // Read compressed file
+
         std::ifstream inputFile(inputPath, std::ios::binary);
         if (!inputFile) {
             throw std::runtime_error("Cannot open compressed file: " + inputPath);
         }
-        
-        std::vector<uint8_t> compressedData((std::istreambuf_iterator<char>(inputFile)),
-                                           std::istreambuf_iterator<char>());
-        inputFile.close();
-        
-        // Decompress data
-        std::string decompressedContent = decompress(compressedData);
-        
-        // Write decompressed file
-        std::ofstream outputFile(outputPath);
+        CompressionStreamReader reader(inputFile);
+
+        std::ofstream outputFile(outputPath, std::ios::binary | std::ios::trunc);
         if (!outputFile) {
             throw std::runtime_error("Cannot create output file: " + outputPath);
         }
-        
-        outputFile.write(decompressedContent.c_str(), decompressedContent.size());
-        outputFile.close();
-        
+
+        std::vector<char> buffer(STREAM_BLOCK_SIZE);
+        uint64_t total = 0;
+        while (size_t count = reader.read(buffer.data(), buffer.size())) {
+            outputFile.write(buffer.data(), count);
+            total += count;
+        }
+        if (total != reader.getOriginalSize() || !outputFile) {
+            throw std::runtime_error("Decompressed size mismatch");
+        }
+
         LOG_INFO("File decompression completed: " + inputPath + " -> " + outputPath);
         return true;
     } catch (const std::exception& e) {
@@ -227,4 +469,313 @@ bool FileCompression::isCompressed(const std::string& filePath) {
     }
 }
 
+bool FileCompression::isCompressedData(const std::string& data) {
+    uint32_t magic = 0;
+    if (data.size() < sizeof(magic)) {
+        return false;
+    }
+    std::memcpy(&magic, data.data(), sizeof(magic));
+    return magic == COMPRESSION_MAGIC;
+}
+
+
+// Streaming encoder
+
+CompressionStreamWriter::CompressionStreamWriter(std::ostream& out, threading::ThreadPool* pool)
+    : out(out), pool(pool) {
+    headerPosition = out.tellp();
+    std::string placeholder = FileCompression::encodeChunkedHeader(FileCompression::ChunkedHeader());
+    out.write(placeholder.data(), placeholder.size());
+    compressedSize = placeholder.size();
+
+    // Enough chunks in flight to keep every worker busy while one batch is written
+    size_t batchSize = pool && pool->getThreadCount() > 1 ? 2 * pool->getThreadCount() : 1;
+    batch.resize(batchSize);
+    batch[0].raw.reserve(FileCompression::STREAM_BLOCK_SIZE);
+}
+
+void CompressionStreamWriter::write(const char* data, size_t size) {
+    while (size > 0) {
+        auto& raw = batch[filling].raw;
+        size_t take = std::min(size, FileCompression::STREAM_BLOCK_SIZE - raw.size());
+        raw.insert(raw.end(), data, data + take);
+        data += take;
+        size -= take;
+        if (raw.size() == FileCompression::STREAM_BLOCK_SIZE && ++filling == batch.size()) {
+            flushBatch();
+        }
+    }
+}
+
+void CompressionStreamWriter::finish() {
+    if (finished) {
+        return;
+    }
+    finished = true;
+    flushBatch();
+
+    FileCompression::ChunkedHeader header;
+    header.chunkSize = static_cast<uint32_t>(FileCompression::STREAM_BLOCK_SIZE);
+    header.originalSize = originalSize;
+    header.chunkCount = index.size();
+    header.indexOffset = compressedSize;
+    size_t indexBytes = index.size() * sizeof(FileCompression::ChunkIndexEntry);
+    out.write(reinterpret_cast<const char*>(index.data()), indexBytes);
+    compressedSize += indexBytes;
+
+    std::streampos endPosition = out.tellp();
+    std::string encodedHeader = FileCompression::encodeChunkedHeader(header);
+    out.seekp(headerPosition);
+    out.write(encodedHeader.data(), encodedHeader.size());
+    out.seekp(endPosition);
+    out.flush();
+}
+
+void CompressionStreamWriter::encodeChunk(Chunk& chunk) {
+    chunk.encoded.resize(FileCompression::lzCompressBound(chunk.raw.size()));
+    size_t storedSize = FileCompression::lzCompress(chunk.raw.data(), chunk.raw.size(),
+                                                    chunk.encoded.data(), chunk.encoded.size());
+    if (storedSize >= chunk.raw.size()) {
+        // Incompressible: store as is
+        chunk.storedField = static_cast<uint32_t>(chunk.raw.size()) | FileCompression::STORED_RAW;
+    } else {
+        chunk.storedField = static_cast<uint32_t>(storedSize);
+    }
+}
+
+void CompressionStreamWriter::flushBatch() {
+    size_t count = filling + (filling < batch.size() && !batch[filling].raw.empty() ? 1 : 0);
+    if (count == 0) {
+        return;
+    }
+
+    if (pool && count > 1) {
+        std::vector<std::future<void>> encoded;
+        encoded.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            encoded.push_back(pool->enqueue([chunk = &batch[i]] { encodeChunk(*chunk); }));
+        }
+        // get() on every future before rethrowing, so no task still uses the batch
+        std::exception_ptr failure;
+        for (auto& future : encoded) {
+            pool->waitFor(future);
+            try {
+                future.get();
+            } catch (...) {
+                failure = std::current_exception();
+            }
+        }
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            encodeChunk(batch[i]);
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        Chunk& chunk = batch[i];
+        uint32_t rawSize = static_cast<uint32_t>(chunk.raw.size());
+        uint32_t storedSize = chunk.storedField & ~FileCompression::STORED_RAW;
+        const char* payload = (chunk.storedField & FileCompression::STORED_RAW) ? chunk.raw.data()
+                                                                                : chunk.encoded.data();
+        index.push_back({compressedSize, rawSize, chunk.storedField});
+        out.write(reinterpret_cast<const char*>(&rawSize), sizeof(rawSize));
+        out.write(reinterpret_cast<const char*>(&chunk.storedField), sizeof(chunk.storedField));
+        out.write(payload, storedSize);
+        originalSize += rawSize;
+        compressedSize += FileCompression::CHUNK_FRAME_SIZE + storedSize;
+        chunk.raw.clear();
+    }
+    filling = 0;
+}
+
+// Streaming decoder
+
+CompressionStreamReader::CompressionStreamReader(std::istream& in) : in(in) {
+    char prefix[6];
+    if (!in.read(prefix, sizeof(prefix))) {
+        throw std::runtime_error("Invalid compressed data: too small");
+    }
+    uint32_t magic;
+    std::memcpy(&magic, prefix, sizeof(magic));
+    std::memcpy(&version, prefix + 4, sizeof(version));
+    if (magic != FileCompression::COMPRESSION_MAGIC) {
+        throw std::runtime_error("Invalid compression magic number");
+    }
+
+    if (version == FileCompression::CHUNKED_VERSION) {
+        char bytes[FileCompression::CHUNKED_HEADER_SIZE];
+        std::memcpy(bytes, prefix, sizeof(prefix));
+        if (!in.read(bytes + sizeof(prefix), sizeof(bytes) - sizeof(prefix))) {
+            throw std::runtime_error("Invalid compressed data: too small");
+        }
+        compressionType = FileCompression::TYPE_LZ;
+        originalSize = FileCompression::decodeChunkedHeader(bytes).originalSize;
+        return;
+    }
+    if (version != FileCompression::COMPRESSION_VERSION) {
+        throw std::runtime_error("Unsupported compression version");
+    }
+
+    FileCompression::CompressionHeader header;
+    std::memcpy(&header, prefix, sizeof(prefix));
+    if (!in.read(reinterpret_cast<char*>(&header) + sizeof(prefix), sizeof(header) - sizeof(prefix))) {
+        throw std::runtime_error("Invalid compressed data: too small");
+    }
+    if (header.compressionType != FileCompression::TYPE_RLE &&
+        header.compressionType != FileCompression::TYPE_LZ) {
+        throw std::runtime_error("Unsupported compression type: " + std::to_string(header.compressionType));
+    }
+    compressionType = header.compressionType;
+    originalSize = header.originalSize;
+}
+
+size_t CompressionStreamReader::read(char* buffer, size_t size) {
+    size_t copied = 0;
+    while (copied < size) {
+        if (blockPosition == block.size() && !fillBlock()) {
+            break;
+        }
+        size_t take = std::min(size - copied, block.size() - blockPosition);
+        std::memcpy(buffer + copied, block.data() + blockPosition, take);
+        blockPosition += take;
+        copied += take;
+        delivered += take;
+    }
+    return copied;
+}
+
+bool CompressionStreamReader::fillBlock() {
+    block.clear();
+    blockPosition = 0;
+    if (delivered >= originalSize) {
+        return false;
+    }
+
+    if (compressionType == FileCompression::TYPE_RLE) {
+        // Legacy payload of (count, byte) pairs, expanded a buffer at a time
+        char pair[2];
+        while (block.size() < FileCompression::STREAM_BLOCK_SIZE && in.read(pair, sizeof(pair))) {
+            block.insert(block.end(), static_cast<uint8_t>(pair[0]), pair[1]);
+        }
+        return !block.empty();
+    }
+
+    uint32_t rawSize = 0;
+    uint32_t storedField = 0;
+    if (!in.read(reinterpret_cast<char*>(&rawSize), sizeof(rawSize)) ||
+        !in.read(reinterpret_cast<char*>(&storedField), sizeof(storedField))) {
+        throw std::runtime_error("Compressed stream is truncated");
+    }
+    uint32_t storedSize = storedField & ~FileCompression::STORED_RAW;
+    if (rawSize == 0 || rawSize > FileCompression::STREAM_BLOCK_SIZE ||
+        storedSize > FileCompression::lzCompressBound(rawSize)) {
+        throw std::runtime_error("Corrupt compressed block header");
+    }
+
+    encoded.resize(storedSize);
+    if (!in.read(encoded.data(), storedSize)) {
+        throw std::runtime_error("Compressed stream is truncated");
+    }
+    block.resize(rawSize);
+    FileCompression::decodeChunk(encoded.data(), storedField, block.data(), rawSize);
+    return true;
+}
+
+// Random access
+
+std::shared_ptr<const CompressedFile> CompressedFile::open(Source source) {
+    std::shared_ptr<CompressedFile> file(new CompressedFile(std::move(source)));
+
+    char bytes[FileCompression::CHUNKED_HEADER_SIZE];
+    file->readExactly(bytes, sizeof(bytes), 0);
+    auto header = FileCompression::decodeChunkedHeader(bytes);
+    file->originalSize = header.originalSize;
+    file->chunkSize = header.chunkSize;
+
+    // Every entry is checked once here, so read() can trust the index
+    file->index.resize(static_cast<size_t>(header.chunkCount));
+    file->readExactly(file->index.data(), file->index.size() * sizeof(FileCompression::ChunkIndexEntry),
+                      header.indexOffset);
+    for (size_t i = 0; i < file->index.size(); ++i) {
+        const auto& entry = file->index[i];
+        uint64_t expected = i + 1 < file->index.size()
+            ? header.chunkSize
+            : header.originalSize - static_cast<uint64_t>(i) * header.chunkSize;
+        uint32_t storedSize = entry.storedField & ~FileCompression::STORED_RAW;
+        if (entry.rawSize != expected || storedSize > FileCompression::lzCompressBound(entry.rawSize) ||
+            entry.offset < FileCompression::CHUNKED_HEADER_SIZE ||
+            entry.offset + FileCompression::CHUNK_FRAME_SIZE + storedSize > header.indexOffset) {
+            throw std::runtime_error("Corrupt chunk index entry " + std::to_string(i));
+        }
+    }
+    return file;
+}
+
+std::shared_ptr<const CompressedFile> CompressedFile::open(const std::string& fullPath) {
+    auto stream = std::make_shared<std::ifstream>(fullPath, std::ios::binary);
+    if (!*stream) {
+        throw std::runtime_error("Cannot open compressed file: " + fullPath);
+    }
+    // One stream, so positioned reads take turns
+    auto streamMutex = std::make_shared<std::mutex>();
+    return open([stream, streamMutex](void* buffer, size_t count, uint64_t offset) -> size_t {
+        std::lock_guard<std::mutex> lock(*streamMutex);
+        stream->clear();
+        stream->seekg(static_cast<std::streamoff>(offset));
+        stream->read(static_cast<char*>(buffer), static_cast<std::streamsize>(count));
+        return static_cast<size_t>(stream->gcount());
+    });
+}
+
+size_t CompressedFile::read(void* buffer, size_t count, uint64_t offset) const {
+    if (offset >= originalSize || count == 0) {
+        return 0;
+    }
+    count = static_cast<size_t>(std::min<uint64_t>(count, originalSize - offset));
+
+    auto* out = static_cast<char*>(buffer);
+    size_t copied = 0;
+    while (copied < count) {
+        uint64_t position = offset + copied;
+        size_t number = static_cast<size_t>(position / chunkSize);
+        size_t within = static_cast<size_t>(position % chunkSize);
+        auto data = chunk(number);
+        size_t take = std::min(count - copied, data->size() - within);
+        std::memcpy(out + copied, data->data() + within, take);
+        copied += take;
+    }
+    return copied;
+}
+
+void CompressedFile::readExactly(void* buffer, size_t count, uint64_t offset) const {
+    if (count > 0 && source(buffer, count, offset) != count) {
+        throw std::runtime_error("Compressed stream is truncated");
+    }
+}
+
+std::shared_ptr<const std::vector<char>> CompressedFile::chunk(size_t number) const {
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        if (cachedChunk && cachedNumber == number) {
+            return cachedChunk;
+        }
+    }
+
+    // Decoded outside the lock so readers of other chunks proceed in parallel
+    const auto& entry = index[number];
+    uint32_t storedSize = entry.storedField & ~FileCompression::STORED_RAW;
+    std::vector<char> stored(storedSize);
+    readExactly(stored.data(), storedSize, entry.offset + FileCompression::CHUNK_FRAME_SIZE);
+    auto data = std::make_shared<std::vector<char>>(entry.rawSize);
+    FileCompression::decodeChunk(stored.data(), entry.storedField, data->data(), entry.rawSize);
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cachedNumber = number;
+    cachedChunk = data;
+    return data;
+}
+
 } // namespace mtfs::fs
@@ -0,0 +1,282 @@
+#include "fs/copy_engine.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#endif
+#endif
+
+namespace mtfs::fs {
+
+using namespace mtfs::common;
+
+namespace {
+
+struct AlignedDelete {
+    void operator()(char* buffer) const { ::operator delete[](buffer, std::align_val_t(CopyEngine::ALIGNMENT)); }
+};
+
+using AlignedBuffer = std::unique_ptr<char[], AlignedDelete>;
+
+// Sized for the file, so small copies do not allocate the full block
+size_t bufferSize(uint64_t fileSize) {
+    size_t size = static_cast<size_t>(std::min<uint64_t>(CopyEngine::BUFFER_SIZE, fileSize));
+    size = (size + CopyEngine::ALIGNMENT - 1) / CopyEngine::ALIGNMENT * CopyEngine::ALIGNMENT;
+    return std::max(CopyEngine::ALIGNMENT, size);
+}
+
+AlignedBuffer allocateBuffer(size_t size) {
+    return AlignedBuffer(static_cast<char*>(::operator new[](size, std::align_val_t(CopyEngine::ALIGNMENT))));
+}
+
+#ifdef _WIN32
+constexpr uint64_t NO_BUFFERING_THRESHOLD = 256ull * 1024 * 1024;  // CopyFileEx bypasses the cache above this
+constexpr DWORD MAX_TRANSFER = 1u << 30;
+
+struct HandleCloser {
+    HANDLE handle;
+    ~HandleCloser() {
+        if (handle != INVALID_HANDLE_VALUE) CloseHandle(handle);
+    }
+};
+
+void bufferedCopy(const std::string& source, const std::string& destination, CopyResult& result) {
+    HandleCloser in{CreateFileA(source.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr)};
+    if (in.handle == INVALID_HANDLE_VALUE) {
+        throw FSException("Cannot open copy source: " + source);
+    }
+    HandleCloser out{CreateFileA(destination.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                 CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr)};
+    if (out.handle == INVALID_HANDLE_VALUE) {
+        throw FSException("Cannot create copy destination: " + destination);
+    }
+    LARGE_INTEGER fileSize{};
+    GetFileSizeEx(in.handle, &fileSize);
+    size_t size = bufferSize(static_cast<uint64_t>(fileSize.QuadPart));
+    AlignedBuffer buffer = allocateBuffer(size);
+    result.method = CopyMethod::BUFFERED;
+    result.bytes = 0;
+    while (true) {
+        DWORD got = 0;
+        if (!ReadFile(in.handle, buffer.get(), static_cast<DWORD>(std::min<size_t>(size, MAX_TRANSFER)), &got,
+                      nullptr)) {
+            throw FSException("Failed reading copy source: " + source);
+        }
+        if (got == 0) break;
+        DWORD written = 0;
+        if (!WriteFile(out.handle, buffer.get(), got, &written, nullptr) || written != got) {
+            throw FSException("Failed writing copy destination: " + destination);
+        }
+        result.bytes += got;
+    }
+}
+#else
+struct FdCloser {
+    int fd;
+    ~FdCloser() {
+        if (fd >= 0) ::close(fd);
+    }
+};
+
+// Errors meaning "not here", after which the next method is tried
+bool unsupported(int error) {
+    return error == EXDEV || error == ENOSYS || error == EINVAL || error == EOPNOTSUPP || error == ENOTSUP ||
+           error == EBADF || error == EPERM || error == ETXTBSY;
+}
+
+#ifdef __linux__
+constexpr size_t MAX_KERNEL_TRANSFER = 1u << 30;
+
+// Returns false, having copied nothing further, when the kernel cannot copy
+// between these files
+bool kernelCopy(int in, int out, CopyResult& result) {
+    while (true) {
+        loff_t inOffset = static_cast<loff_t>(result.bytes);
+        loff_t outOffset = inOffset;
+        ssize_t copied = copy_file_range(in, &inOffset, out, &outOffset, MAX_KERNEL_TRANSFER, 0);
+        if (copied < 0) {
+            if (errno == EINTR) continue;
+            if (unsupported(errno)) return false;
+            throw FSException(std::string("copy_file_range failed: ") + std::strerror(errno));
+        }
+        if (copied == 0) return true;
+        result.bytes += static_cast<uint64_t>(copied);
+        result.method = CopyMethod::KERNEL;
+    }
+}
+
+bool sendfileCopy(int in, int out, CopyResult& result) {
+    if (lseek(out, static_cast<off_t>(result.bytes), SEEK_SET) < 0) {
+        return false;
+    }
+    while (true) {
+        off_t offset = static_cast<off_t>(result.bytes);
+        ssize_t copied = sendfile(out, in, &offset, MAX_KERNEL_TRANSFER);
+        if (copied < 0) {
+            if (errno == EINTR) continue;
+            if (unsupported(errno)) return false;
+            throw FSException(std::string("sendfile failed: ") + std::strerror(errno));
+        }
+        if (copied == 0) return true;
+        result.bytes += static_cast<uint64_t>(copied);
+        result.method = CopyMethod::SENDFILE;
+    }
+}
+#endif
+
+void bufferedCopy(int in, int out, uint64_t fileSize, CopyResult& result) {
+    size_t size = bufferSize(fileSize);
+    AlignedBuffer buffer = allocateBuffer(size);
+    result.method = CopyMethod::BUFFERED;
+    while (true) {
+        ssize_t got = pread(in, buffer.get(), size, static_cast<off_t>(result.bytes));
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            throw FSException(std::string("Failed reading copy source: ") + std::strerror(errno));
+        }
+        if (got == 0) return;
+        size_t written = 0;
+        while (written < static_cast<size_t>(got)) {
+            ssize_t put = pwrite(out, buffer.get() + written, static_cast<size_t>(got) - written,
+                                 static_cast<off_t>(result.bytes + written));
+            if (put < 0) {
+                if (errno == EINTR) continue;
+                throw FSException(std::string("Failed writing copy destination: ") + std::strerror(errno));
+            }
+            written += static_cast<size_t>(put);
+        }
+        result.bytes += static_cast<uint64_t>(got);
+    }
+}
+#endif
+
+} // namespace
+
+const char* copyMethodName(CopyMethod method) {
+    switch (method) {
+        case CopyMethod::CLONE: return "clone";
+        case CopyMethod::KERNEL: return "kernel";
+        case CopyMethod::SENDFILE: return "sendfile";
+        case CopyMethod::BUFFERED: return "buffered";
+    }
+    return "unknown";
+}
+
+double CopyResult::throughput() const {
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    return seconds > 0 ? static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds : 0.0;
+}
+
+CopyResult CopyEngine::copy(const std::string& source, const std::string& destination) {
+    auto startTime = std::chrono::steady_clock::now();
+    CopyResult result;
+
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExA(source.c_str(), GetFileExInfoStandard, &attributes)) {
+        throw FSException("Cannot open copy source: " + source);
+    }
+    uint64_t fileSize = (static_cast<uint64_t>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+    DWORD flags = fileSize >= NO_BUFFERING_THRESHOLD ? COPY_FILE_NO_BUFFERING : 0;
+    if (CopyFileExA(source.c_str(), destination.c_str(), nullptr, nullptr, nullptr, flags)) {
+        result.bytes = fileSize;
+        result.method = CopyMethod::KERNEL;
+    } else {
+        bufferedCopy(source, destination, result);
+    }
+#else
+    FdCloser in{::open(source.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (in.fd < 0) {
+        throw FSException("Cannot open copy source: " + source + ": " + std::strerror(errno));
+    }
+    struct stat sourceStats;
+    if (fstat(in.fd, &sourceStats) != 0) {
+        throw FSException("Cannot stat copy source: " + source + ": " + std::strerror(errno));
+    }
+    FdCloser out{::open(destination.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, sourceStats.st_mode & 0777)};
+    if (out.fd < 0) {
+        throw FSException("Cannot create copy destination: " + destination + ": " + std::strerror(errno));
+    }
+    fchmod(out.fd, sourceStats.st_mode & 07777);
+
+    bool done = false;
+#ifdef __linux__
+    if (ioctl(out.fd, FICLONE, in.fd) == 0) {
+        result.bytes = static_cast<uint64_t>(sourceStats.st_size);
+        result.method = CopyMethod::CLONE;
+        done = true;
+    }
+    done = done || kernelCopy(in.fd, out.fd, result) || sendfileCopy(in.fd, out.fd, result);
+#endif
+    if (!done) {
+        bufferedCopy(in.fd, out.fd, static_cast<uint64_t>(sourceStats.st_size), result);
+    }
+#endif
+
+    result.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                          startTime);
+    return result;
+}
+
+SequentialReader::SequentialReader(const std::string& path) : path(path) {
+#ifdef _WIN32
+    handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                         OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        throw FSException("Cannot open file: " + path);
+    }
+#else
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw FSException("Cannot open file: " + path + ": " + std::strerror(errno));
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+#endif
+}
+
+SequentialReader::~SequentialReader() {
+#ifdef _WIN32
+    CloseHandle(handle);
+#else
+    ::close(fd);
+#endif
+}
+
+size_t SequentialReader::read(char* buffer, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+#ifdef _WIN32
+        DWORD got = 0;
+        if (!ReadFile(handle, buffer + total, static_cast<DWORD>(std::min<size_t>(size - total, MAX_TRANSFER)), &got,
+                      nullptr)) {
+            throw FSException("Failed reading file: " + path);
+        }
+#else
+        ssize_t got = ::read(fd, buffer + total, size - total);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            throw FSException("Failed reading file: " + path + ": " + std::strerror(errno));
+        }
+#endif
+        if (got == 0) break;
+        total += static_cast<size_t>(got);
+    }
+    return total;
+}
+
+} // namespace mtfs::fs
@@ -0,0 +1,220 @@
+#include "fs/directory_index.hpp"
+#include "fs/directory_walker.hpp"
+#include <algorithm>
+#include <mutex>
+
+namespace mtfs::fs {
+
+struct DirectoryIndex::Node {
+    std::string name;
+    Entry entry;
+    bool complete{false};                        // Every child is known
+    std::vector<std::unique_ptr<Node>> children;  // Sorted by name
+
+    std::vector<std::unique_ptr<Node>>::const_iterator lowerBound(const std::string& childName) const {
+        return std::lower_bound(children.begin(), children.end(), childName,
+                                [](const std::unique_ptr<Node>& node, const std::string& key) {
+                                    return node->name < key;
+                                });
+    }
+
+    Node* child(const std::string& childName) const {
+        auto it = lowerBound(childName);
+        return it != children.end() && (*it)->name == childName ? it->get() : nullptr;
+    }
+
+    size_t count() const {
+        size_t total = children.size();
+        for (const auto& node : children) {
+            total += node->count();
+        }
+        return total;
+    }
+};
+
+DirectoryIndex::DirectoryIndex() : root(std::make_unique<Node>()) {
+    root->entry.isDirectory = true;
+}
+
+DirectoryIndex::~DirectoryIndex() = default;
+
+bool DirectoryIndex::split(const std::string& path, std::vector<std::string>& components) {
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = path.find_first_of("/\\", start);
+        if (end == std::string::npos) {
+            end = path.size();
+        }
+        std::string component = path.substr(start, end - start);
+        if (component == "..") {
+            return false;
+        }
+        if (!component.empty() && component != ".") {
+            components.push_back(std::move(component));
+        }
+        start = end + 1;
+    }
+    return true;
+}
+
+DirectoryIndex::Node& DirectoryIndex::insert(Node& top, const std::vector<std::string>& components, size_t& added) {
+    Node* node = &top;
+    for (const auto& component : components) {
+        if (!node->entry.isDirectory) {
+            // A file where a directory is now known to be
+            node->entry = Entry{};
+            node->entry.isDirectory = true;
+        }
+        Node* next = node->child(component);
+        if (!next) {
+            auto created = std::make_unique<Node>();
+            created->name = component;
+            created->entry.isDirectory = true;  // Until the caller says otherwise
+            next = created.get();
+            auto position = node->children.begin() + (node->lowerBound(component) - node->children.cbegin());
+            node->children.insert(position, std::move(created));
+            added++;
+        }
+        node = next;
+    }
+    return *node;
+}
+
+const DirectoryIndex::Node* DirectoryIndex::findNode(const std::vector<std::string>& components) const {
+    const Node* node = root.get();
+    for (const auto& component : components) {
+        node = node->child(component);
+        if (!node) {
+            return nullptr;
+        }
+    }
+    return node;
+}
+
+DirectoryIndex::Node* DirectoryIndex::findNode(const std::vector<std::string>& components) {
+    return const_cast<Node*>(static_cast<const DirectoryIndex*>(this)->findNode(components));
+}
+
+// Listings may arrive before the entry of the directory they belong to, so
+// entries are inserted wherever they fall. Every directory the walk saw is
+// complete at the end; one that could not be listed looks empty until the
+// next rebuild.
+void DirectoryIndex::rebuild(const std::string& rootPath, threading::ThreadPool* pool) {
+    auto tree = std::make_unique<Node>();
+    tree->entry.isDirectory = true;
+    size_t added = 0;
+    WalkOptions options;
+    options.includeDirectories = true;
+    std::vector<std::string> components;
+    DirectoryWalker(pool).walk(rootPath, [&](const DirectoryEntry& listed) {
+        components.clear();
+        split(listed.path, components);
+        Node& node = insert(*tree, components, added);
+        node.entry.isDirectory = listed.isDirectory;
+        node.entry.hasAttributes = true;
+        node.entry.size = listed.stamp.size;
+        node.entry.modifiedNs = listed.stamp.modifiedNs;
+        node.entry.createdNs = listed.createdNs;
+        node.entry.permissions = listed.permissions;
+    }, options);
+
+    std::vector<Node*> directories{tree.get()};
+    while (!directories.empty()) {
+        Node* directory = directories.back();
+        directories.pop_back();
+        directory->complete = true;
+        for (const auto& child : directory->children) {
+            if (child->entry.isDirectory) {
+                directories.push_back(child.get());
+            }
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    root = std::move(tree);
+    entries = added;
+}
+
+bool DirectoryIndex::find(const std::string& path, Entry& entry) const {
+    std::vector<std::string> components;
+    if (!split(path, components)) {
+        return false;
+    }
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    const Node* node = findNode(components);
+    if (!node) {
+        return false;
+    }
+    entry = node->entry;
+    return true;
+}
+
+bool DirectoryIndex::list(const std::string& path, std::vector<std::string>& names) const {
+    std::vector<std::string> components;
+    if (!split(path, components)) {
+        return false;
+    }
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    const Node* node = findNode(components);
+    if (!node || !node->entry.isDirectory || !node->complete) {
+        return false;
+    }
+    names.clear();
+    names.reserve(node->children.size());
+    for (const auto& child : node->children) {
+        names.push_back(child->name);
+    }
+    return true;
+}
+
+void DirectoryIndex::put(const std::string& path, const Entry& entry, bool complete) {
+    std::vector<std::string> components;
+    if (!split(path, components) || components.empty()) {
+        return;
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    Node& node = insert(*root, components, entries);
+    if (!entry.isDirectory && !node.children.empty()) {
+        entries -= node.count();
+        node.children.clear();
+    }
+    node.entry = entry;
+    node.complete = entry.isDirectory && (complete || node.complete);
+}
+
+void DirectoryIndex::invalidate(const std::string& path) {
+    std::vector<std::string> components;
+    if (!split(path, components)) {
+        return;
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (Node* node = findNode(components)) {
+        node->entry.hasAttributes = false;
+    }
+}
+
+void DirectoryIndex::erase(const std::string& path) {
+    std::vector<std::string> components;
+    if (!split(path, components) || components.empty()) {
+        return;
+    }
+    std::string name = components.back();
+    components.pop_back();
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    Node* parent = findNode(components);
+    if (!parent) {
+        return;
+    }
+    auto it = parent->lowerBound(name);
+    if (it != parent->children.end() && (*it)->name == name) {
+        entries -= 1 + (*it)->count();
+        parent->children.erase(parent->children.begin() + (it - parent->children.cbegin()));
+    }
+}
+
+size_t DirectoryIndex::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return entries;
+}
+
+} // namespace mtfs::fs
@@ -0,0 +1,207 @@
+#include "fs/directory_walker.hpp"
+#include "native_stamp.hpp"
+#include "common/error.hpp"
+#include "common/logger.hpp"
+#include "threading/thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <future>
+#include <mutex>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#endif
+
+namespace mtfs::fs {
+
+using namespace mtfs::common;
+
+namespace {
+
+struct WalkState {
+    WalkState(const std::string& root, const DirectoryWalker::Visitor& visit, const WalkOptions& options,
+              threading::ThreadPool& pool)
+        : root(root), visit(visit), options(options), pool(pool) {}
+
+    std::string root;
+    const DirectoryWalker::Visitor& visit;
+    WalkOptions options;
+    threading::ThreadPool& pool;
+
+    std::mutex pendingMutex;
+    std::deque<std::future<void>> pending;  // Subdirectory listings not yet waited for
+
+    std::mutex visitMutex;                  // One visitor call at a time
+    size_t visited{0};
+    std::atomic<bool> stopped{false};       // The visitor threw
+};
+
+void listDirectory(WalkState& state, const std::string& relative);
+
+// Lists the directory into `entries`; false if it cannot be opened
+bool readDirectory(const std::string& fullPath, const std::string& relative,
+                   std::vector<DirectoryEntry>& entries) {
+    std::string prefix = relative.empty() ? std::string() : relative + "/";
+#ifdef _WIN32
+    WIN32_FIND_DATAA data;
+    HANDLE handle = FindFirstFileExA((fullPath + "\\*").c_str(), FindExInfoBasic, &data,
+                                     FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    do {
+        std::string name = data.cFileName;
+        if (name == "." || name == "..") {
+            continue;
+        }
+        DirectoryEntry entry;
+        entry.path = prefix + name;
+        entry.isDirectory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        if (entry.isDirectory && (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)) {
+            continue;  // Junctions and directory links
+        }
+        entry.stamp = stampFromAttributes(entry.isDirectory ? 0 : data.nFileSizeHigh,
+                                          entry.isDirectory ? 0 : data.nFileSizeLow, data.ftLastWriteTime);
+        entry.permissions = permissionsFromAttributes(data.dwFileAttributes);
+        entry.createdNs = fileTimeToNs(data.ftCreationTime);
+        entries.push_back(std::move(entry));
+    } while (FindNextFileA(handle, &data));
+    FindClose(handle);
+#else
+    DIR* directory = ::opendir(fullPath.c_str());
+    if (!directory) {
+        return false;
+    }
+    int descriptor = ::dirfd(directory);
+    while (dirent* item = ::readdir(directory)) {
+        std::string name = item->d_name;
+        if (name == "." || name == "..") {
+            continue;
+        }
+        // Relative to the open directory, so the path is not resolved again
+        struct stat info;
+        if (::fstatat(descriptor, item->d_name, &info, AT_SYMLINK_NOFOLLOW) != 0) {
+            continue;
+        }
+        if (S_ISLNK(info.st_mode) &&
+            (::fstatat(descriptor, item->d_name, &info, 0) != 0 || !S_ISREG(info.st_mode))) {
+            continue;  // Dangling, or a link to a directory
+        }
+        if (!S_ISREG(info.st_mode) && !S_ISDIR(info.st_mode)) {
+            continue;
+        }
+        DirectoryEntry entry;
+        entry.path = prefix + name;
+        entry.isDirectory = S_ISDIR(info.st_mode);
+        entry.stamp = stampFromStat(info);
+        if (entry.isDirectory) {
+            entry.stamp.size = 0;
+        }
+        entry.permissions = static_cast<uint32_t>(info.st_mode & 0777);
+        entry.createdNs = changeTimeNs(info);
+        entries.push_back(std::move(entry));
+    }
+    ::closedir(directory);
+#endif
+    return true;
+}
+
+void listDirectory(WalkState& state, const std::string& relative) {
+    if (state.stopped.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::string fullPath = relative.empty() ? state.root : state.root + "/" + relative;
+    std::vector<DirectoryEntry> entries;
+    if (!readDirectory(fullPath, relative, entries)) {
+        if (relative.empty()) {
+            throw FSException("Cannot list directory: " + fullPath);
+        }
+        LOG_ERROR("Skipping unreadable directory: " + fullPath);
+        return;
+    }
+
+    // Fan out before visiting, so subdirectories are listed meanwhile
+    if (state.options.recursive) {
+        for (const auto& entry : entries) {
+            if (entry.isDirectory) {
+                std::string child = entry.path;
+                auto future = state.pool.enqueue([&state, child] { listDirectory(state, child); });
+                std::lock_guard<std::mutex> lock(state.pendingMutex);
+                state.pending.push_back(std::move(future));
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(state.visitMutex);
+    for (const auto& entry : entries) {
+        if (state.stopped.load(std::memory_order_relaxed)) {
+            return;
+        }
+        if (entry.isDirectory && !state.options.includeDirectories) {
+            continue;
+        }
+        try {
+            state.visit(entry);
+        } catch (...) {
+            state.stopped.store(true, std::memory_order_relaxed);
+            throw;
+        }
+        state.visited++;
+    }
+}
+
+} // namespace
+
+DirectoryWalker::DirectoryWalker(threading::ThreadPool* pool)
+    : pool(pool ? pool : &threading::GlobalThreadPool::getInstance()) {}
+
+size_t DirectoryWalker::walk(const std::string& root, const Visitor& visit, const WalkOptions& options) const {
+    WalkState state(root, visit, options, *pool);
+    std::exception_ptr error;
+    try {
+        listDirectory(state, "");
+    } catch (...) {
+        error = std::current_exception();
+        state.stopped.store(true, std::memory_order_relaxed);
+    }
+
+    // A listing queues its subdirectories before it completes, so once the
+    // queue is empty after waiting, every listing has run. Tasks refer to
+    // `state`, so all of them are waited for even after a failure.
+    while (true) {
+        std::future<void> next;
+        {
+            std::lock_guard<std::mutex> lock(state.pendingMutex);
+            if (state.pending.empty()) {
+                break;
+            }
+            next = std::move(state.pending.front());
+            state.pending.pop_front();
+        }
+        pool->waitFor(next);
+        try {
+            next.get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return state.visited;
+}
+
+std::vector<DirectoryEntry> DirectoryWalker::collect(const std::string& root, const WalkOptions& options) const {
+    std::vector<DirectoryEntry> entries;
+    walk(root, [&](const DirectoryEntry& entry) { entries.push_back(entry); }, options);
+    std::sort(entries.begin(), entries.end(),
+              [](const DirectoryEntry& a, const DirectoryEntry& b) { return a.path < b.path; });
+    return entries;
+}
+
+} // namespace mtfs::fs
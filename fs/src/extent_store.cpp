@@ -0,0 +1,274 @@
+#include "fs/extent_store.hpp"
+#include "common/logger.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace mtfs::fs {
+
+using namespace mtfs::common;
+using storage::BlockId;
+
+namespace {
+
+// Blocks moved per BlockManager batch, bounding the staging buffers
+constexpr size_t BATCH_BLOCKS = 256;
+
+size_t blocksFor(size_t bytes) {
+    return (bytes + ExtentStore::BLOCK_SIZE - 1) / ExtentStore::BLOCK_SIZE;
+}
+
+// Physical block IDs behind logical blocks [first, first + count) of a file
+std::vector<BlockId> physicalBlocks(const std::vector<Extent>& extents, size_t first, size_t count) {
+    std::vector<BlockId> ids;
+    ids.reserve(count);
+    size_t logical = 0;
+    for (const auto& extent : extents) {
+        if (ids.size() == count) {
+            break;
+        }
+        size_t extentEnd = logical + extent.blockCount;
+        if (first + ids.size() < extentEnd) {
+            size_t from = first + ids.size() - logical;
+            size_t take = std::min<size_t>(extent.blockCount - from, count - ids.size());
+            for (size_t i = 0; i < take; ++i) {
+                ids.push_back(extent.firstBlock + static_cast<BlockId>(from + i));
+            }
+        }
+        logical = extentEnd;
+    }
+    if (ids.size() != count) {
+        throw FSException("File extents do not cover block " + std::to_string(first + ids.size()));
+    }
+    return ids;
+}
+
+void appendExtents(std::vector<Extent>& extents, const std::vector<Extent>& more) {
+    for (const auto& extent : more) {
+        if (!extents.empty() &&
+            extents.back().firstBlock + static_cast<BlockId>(extents.back().blockCount) == extent.firstBlock) {
+            extents.back().blockCount += extent.blockCount;
+        } else {
+            extents.push_back(extent);
+        }
+    }
+}
+
+} // namespace
+
+ExtentStore::ExtentStore(const std::string& containerPath, size_t inlineThreshold, size_t initialBlocks)
+    : inlineThreshold(std::min(inlineThreshold, MAX_INLINE_THRESHOLD)) {
+    try {
+        blocks = std::make_unique<storage::BlockManager>(containerPath, initialBlocks);
+    } catch (const std::exception& e) {
+        throw FSException("Failed to open block store " + containerPath + ": " + e.what());
+    }
+    LOG_INFO("Extent store opened at: " + containerPath);
+}
+
+FileLayout ExtentStore::store(const std::string& data) {
+    FileLayout layout;
+    if (data.size() <= inlineThreshold) {
+        layout.inlineData = data;
+        return layout;
+    }
+
+    layout.extents = allocate(blocksFor(data.size()));
+    try {
+        writeRange(layout.extents, 0, data.data(), data.size());
+    } catch (...) {
+        release(layout);
+        throw;
+    }
+    return layout;
+}
+
+std::string ExtentStore::load(const FileLayout& layout, size_t fileSize) {
+    if (layout.extents.empty()) {
+        std::string data = layout.inlineData;
+        data.resize(fileSize, '\0');
+        return data;
+    }
+
+    std::string data(blocksFor(fileSize) * BLOCK_SIZE, '\0');
+    readRange(layout.extents, 0, blocksFor(fileSize), &data[0]);
+    data.resize(fileSize);
+    return data;
+}
+
+void ExtentStore::release(const FileLayout& layout) {
+    for (const auto& extent : layout.extents) {
+        if (!blocks->freeExtent(extent.firstBlock, extent.blockCount)) {
+            LOG_ERROR("Failed to free extent " + std::to_string(extent.firstBlock) + "+" +
+                      std::to_string(extent.blockCount));
+        }
+    }
+}
+
+size_t ExtentStore::readAt(const FileLayout& layout, size_t fileSize, void* buffer, size_t count, size_t offset) {
+    if (offset >= fileSize || count == 0) {
+        return 0;
+    }
+    count = std::min(count, fileSize - offset);
+
+    if (layout.extents.empty()) {
+        size_t available = offset < layout.inlineData.size() ? layout.inlineData.size() - offset : 0;
+        size_t copied = std::min(count, available);
+        std::memcpy(buffer, layout.inlineData.data() + offset, copied);
+        std::memset(static_cast<char*>(buffer) + copied, 0, count - copied);
+        return count;
+    }
+
+    size_t firstBlock = offset / BLOCK_SIZE;
+    size_t lastBlock = (offset + count - 1) / BLOCK_SIZE;
+    std::vector<char> staging((lastBlock - firstBlock + 1) * BLOCK_SIZE);
+    readRange(layout.extents, firstBlock, lastBlock - firstBlock + 1, staging.data());
+    std::memcpy(buffer, staging.data() + offset % BLOCK_SIZE, count);
+    return count;
+}
+
+size_t ExtentStore::writeAt(FileLayout& layout, size_t& fileSize, const void* buffer, size_t count, size_t offset) {
+    if (count == 0) {
+        return 0;
+    }
+    size_t newSize = std::max(fileSize, offset + count);
+
+    if (layout.extents.empty()) {
+        // Still small enough to stay inline; gaps read back as zeros
+        std::string image = layout.inlineData;
+        image.resize(fileSize, '\0');
+        image.resize(newSize, '\0');
+        std::memcpy(&image[offset], buffer, count);
+        if (newSize <= inlineThreshold) {
+            layout.inlineData = std::move(image);
+        } else {
+            layout = store(image);
+        }
+        fileSize = newSize;
+        return count;
+    }
+
+    // Blocks beyond the current allocation are appended; reused blocks may
+    // hold stale data, so everything from the old end of file is rewritten
+    size_t have = blockCount(layout.extents);
+    size_t needed = blocksFor(newSize);
+    if (needed > have) {
+        appendExtents(layout.extents, allocate(needed - have));
+    }
+
+    size_t writeStart = std::min(offset, fileSize);
+    size_t firstBlock = writeStart / BLOCK_SIZE;
+    size_t lastBlock = (newSize - 1) / BLOCK_SIZE;
+    std::vector<char> staging((lastBlock - firstBlock + 1) * BLOCK_SIZE, 0);
+
+    // Preserve existing bytes in the partially overwritten blocks
+    size_t validBlocks = blocksFor(fileSize);
+    if (firstBlock < validBlocks) {
+        size_t readBlocks = std::min(lastBlock + 1, validBlocks) - firstBlock;
+        readRange(layout.extents, firstBlock, readBlocks, staging.data());
+    }
+    size_t base = firstBlock * BLOCK_SIZE;
+    if (fileSize > base && fileSize - base < staging.size()) {
+        std::fill(staging.begin() + (fileSize - base), staging.end(), 0);
+    }
+    std::memcpy(staging.data() + (offset - base), buffer, count);
+
+    writeRange(layout.extents, firstBlock, staging.data(), newSize - base);
+    fileSize = newSize;
+    return count;
+}
+
+size_t ExtentStore::reconcile(const std::unordered_map<std::string, FileMetadata>& metadata) {
+    size_t total = blocks->getTotalBlocks();
+    std::vector<bool> referenced(total, false);
+    for (const auto& entry : metadata) {
+        for (const auto& extent : entry.second.layout.extents) {
+            for (size_t i = 0; i < extent.blockCount; ++i) {
+                size_t blockId = static_cast<size_t>(extent.firstBlock) + i;
+                if (blockId < total) {
+                    referenced[blockId] = true;
+                }
+            }
+        }
+    }
+
+    size_t reclaimed = 0;
+    for (size_t blockId = 0; blockId < total; ++blockId) {
+        if (!referenced[blockId] && !blocks->isBlockFree(static_cast<BlockId>(blockId)) &&
+            blocks->freeBlock(static_cast<BlockId>(blockId))) {
+            ++reclaimed;
+        }
+    }
+    if (reclaimed > 0) {
+        LOG_INFO("Reclaimed " + std::to_string(reclaimed) + " unreferenced blocks");
+    }
+    return reclaimed;
+}
+
+// Prefer long extents, settling for shorter ones when free space is fragmented
+std::vector<Extent> ExtentStore::allocate(size_t count) {
+    std::vector<Extent> extents;
+    size_t wanted = std::min(count, MAX_EXTENT_BLOCKS);
+    while (count > 0) {
+        size_t take = std::min(count, wanted);
+        BlockId first = blocks->allocateExtent(take);
+        if (first < 0) {
+            if (take > 1) {
+                wanted = take / 2;
+                continue;
+            }
+            FileLayout partial;
+            partial.extents = std::move(extents);
+            release(partial);
+            throw FSException("Block store is full");
+        }
+        appendExtents(extents, {Extent{first, static_cast<uint32_t>(take)}});
+        count -= take;
+    }
+    return extents;
+}
+
+// Write `size` bytes to logical blocks starting at `firstBlock`; the last block is zero-padded
+void ExtentStore::writeRange(const std::vector<Extent>& extents, size_t firstBlock, const char* data, size_t size) {
+    size_t count = blocksFor(size);
+    auto ids = physicalBlocks(extents, firstBlock, count);
+    std::vector<BlockId> batchIds;
+    std::vector<std::vector<char>> batch;
+    for (size_t start = 0; start < count; start += BATCH_BLOCKS) {
+        size_t end = std::min(count, start + BATCH_BLOCKS);
+        batchIds.assign(ids.begin() + start, ids.begin() + end);
+        batch.clear();
+        for (size_t i = start; i < end; ++i) {
+            const char* from = data + i * BLOCK_SIZE;
+            batch.emplace_back(from, from + std::min(BLOCK_SIZE, size - i * BLOCK_SIZE));
+        }
+        if (!blocks->writeBlocks(batchIds, batch)) {
+            throw FSException("Failed to write file blocks");
+        }
+    }
+}
+
+void ExtentStore::readRange(const std::vector<Extent>& extents, size_t firstBlock, size_t count, char* out) {
+    auto ids = physicalBlocks(extents, firstBlock, count);
+    std::vector<BlockId> batchIds;
+    std::vector<std::vector<char>> batch;
+    for (size_t start = 0; start < count; start += BATCH_BLOCKS) {
+        size_t end = std::min(count, start + BATCH_BLOCKS);
+        batchIds.assign(ids.begin() + start, ids.begin() + end);
+        if (!blocks->readBlocks(batchIds, batch)) {
+            throw FSException("Failed to read file blocks");
+        }
+        for (size_t i = 0; i < batch.size(); ++i) {
+            std::memcpy(out + (start + i) * BLOCK_SIZE, batch[i].data(), BLOCK_SIZE);
+        }
+    }
+}
+
+size_t ExtentStore::blockCount(const std::vector<Extent>& extents) {
+    size_t count = 0;
+    for (const auto& extent : extents) {
+        count += extent.blockCount;
+    }
+    return count;
+}
+
+} // namespace mtfs::fs
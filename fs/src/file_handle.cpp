@@ -0,0 +1,178 @@
+#include "fs/file_handle.hpp"
+#include "common/logger.hpp"
+#include <algorithm>
+#include <cerrno>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mtfs::fs {
+
+using namespace mtfs::common;
+
+namespace {
+
+#ifdef _WIN32
+// Explicit offset for one synchronous ReadFile/WriteFile call
+OVERLAPPED overlappedAt(size_t offset) {
+    OVERLAPPED overlapped{};
+    overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFFull);
+    overlapped.OffsetHigh = static_cast<DWORD>(static_cast<unsigned long long>(offset) >> 32);
+    return overlapped;
+}
+
+// Largest transfer a single call accepts
+constexpr size_t MAX_TRANSFER = 1u << 30;
+#endif
+
+} // namespace
+
+std::shared_ptr<FileHandle> FileHandle::open(const std::string& fullPath, bool create) {
+    std::shared_ptr<FileHandle> file(new FileHandle());
+    file->path = fullPath;
+
+#ifdef _WIN32
+    const DWORD share = FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE;
+    const DWORD disposition = create ? CREATE_ALWAYS : OPEN_EXISTING;
+    HANDLE handle = CreateFileA(fullPath.c_str(), GENERIC_READ | GENERIC_WRITE, share, nullptr,
+                                disposition, FILE_ATTRIBUTE_NORMAL, nullptr);
+    file->writable = handle != INVALID_HANDLE_VALUE;
+    if (handle == INVALID_HANDLE_VALUE && !create && GetLastError() == ERROR_ACCESS_DENIED) {
+        handle = CreateFileA(fullPath.c_str(), GENERIC_READ, share, nullptr,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    }
+    if (handle == INVALID_HANDLE_VALUE) {
+        throw FSException("Failed to open file handle: " + fullPath);
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize)) {
+        CloseHandle(handle);
+        throw FSException("Failed to size file: " + fullPath);
+    }
+    file->handle = handle;
+    file->length = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int flags = create ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDWR;
+    int fd = ::open(fullPath.c_str(), flags, 0644);
+    file->writable = fd >= 0;
+    if (fd < 0 && !create && (errno == EACCES || errno == EROFS)) {
+        fd = ::open(fullPath.c_str(), O_RDONLY);
+    }
+    if (fd < 0) {
+        throw FSException("Failed to open file handle: " + fullPath);
+    }
+    struct stat fileStats;
+    if (fstat(fd, &fileStats) != 0 || !S_ISREG(fileStats.st_mode)) {
+        ::close(fd);
+        throw FSException("Not a regular file: " + fullPath);
+    }
+    file->fd = fd;
+    file->length = static_cast<size_t>(fileStats.st_size);
+#endif
+
+    LOG_DEBUG("Opened file handle: " + fullPath);
+    return file;
+}
+
+FileHandle::~FileHandle() {
+#ifdef _WIN32
+    if (handle) {
+        CloseHandle(handle);
+    }
+#else
+    if (fd >= 0) {
+        ::close(fd);
+    }
+#endif
+}
+
+size_t FileHandle::readAt(void* buffer, size_t count, size_t offset) const {
+    char* out = static_cast<char*>(buffer);
+    size_t done = 0;
+    while (done < count) {
+#ifdef _WIN32
+        OVERLAPPED overlapped = overlappedAt(offset + done);
+        DWORD chunk = static_cast<DWORD>(std::min(count - done, MAX_TRANSFER));
+        DWORD transferred = 0;
+        if (!ReadFile(handle, out + done, chunk, &transferred, &overlapped)) {
+            if (GetLastError() == ERROR_HANDLE_EOF) {
+                break;
+            }
+            throw FSException("Failed to read file: " + path);
+        }
+#else
+        ssize_t transferred = pread(fd, out + done, count - done, static_cast<off_t>(offset + done));
+        if (transferred < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw FSException("Failed to read file: " + path);
+        }
+#endif
+        if (transferred == 0) {
+            break;  // End of file
+        }
+        done += static_cast<size_t>(transferred);
+    }
+    return done;
+}
+
+size_t FileHandle::writeAt(const void* buffer, size_t count, size_t offset) {
+    if (!writable) {
+        throw FSException("File is read-only: " + path);
+    }
+    const char* in = static_cast<const char*>(buffer);
+    size_t done = 0;
+    while (done < count) {
+#ifdef _WIN32
+        OVERLAPPED overlapped = overlappedAt(offset + done);
+        DWORD chunk = static_cast<DWORD>(std::min(count - done, MAX_TRANSFER));
+        DWORD transferred = 0;
+        if (!WriteFile(handle, in + done, chunk, &transferred, &overlapped)) {
+            throw FSException("Failed to write file: " + path);
+        }
+#else
+        ssize_t transferred = pwrite(fd, in + done, count - done, static_cast<off_t>(offset + done));
+        if (transferred < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw FSException("Failed to write file: " + path);
+        }
+#endif
+        done += static_cast<size_t>(transferred);
+    }
+    growTo(offset + done);
+    return done;
+}
+
+void FileHandle::truncate(size_t newSize) {
+    if (!writable) {
+        throw FSException("File is read-only: " + path);
+    }
+#ifdef _WIN32
+    FILE_END_OF_FILE_INFO endOfFile;
+    endOfFile.EndOfFile.QuadPart = static_cast<LONGLONG>(newSize);
+    if (!SetFileInformationByHandle(handle, FileEndOfFileInfo, &endOfFile, sizeof(endOfFile))) {
+        throw FSException("Failed to truncate file: " + path);
+    }
+#else
+    if (ftruncate(fd, static_cast<off_t>(newSize)) != 0) {
+        throw FSException("Failed to truncate file: " + path);
+    }
+#endif
+    length.store(newSize, std::memory_order_release);
+}
+
+void FileHandle::growTo(size_t end) {
+    size_t current = length.load(std::memory_order_acquire);
+    while (end > current && !length.compare_exchange_weak(current, end, std::memory_order_acq_rel)) {
+    }
+}
+
+} // namespace mtfs::fs
@@ -0,0 +1,147 @@
+#include "fs/file_index.hpp"
+#include "native_stamp.hpp"
+#include "common/checksum.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace mtfs::fs {
+
+using namespace mtfs::common;
+
+bool FileStamp::of(const std::string& path, FileStamp& stamp) {
+#ifdef _WIN32
+    // Attributes come from the directory entry, so the file is not opened
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data)) {
+        return false;
+    }
+    stamp = stampFromAttributes(data.nFileSizeHigh, data.nFileSizeLow, data.ftLastWriteTime);
+#else
+    struct stat info;
+    if (::stat(path.c_str(), &info) != 0) {
+        return false;
+    }
+    stamp = stampFromStat(info);
+#endif
+    return true;
+}
+
+ChunkId FileIndex::contentHash(const std::vector<ChunkId>& chunks) {
+    return hash128(chunks.data(), chunks.size() * sizeof(ChunkId));
+}
+
+ChunkId FileIndex::hashFile(const std::string& path) {
+    std::vector<ChunkId> chunks;
+    ChunkStore::chunkFile(path, [&](const char* data, size_t size) {
+        chunks.push_back(hash128(data, size));
+    });
+    return contentHash(chunks);
+}
+
+const FileIndexEntry* FileIndex::find(const std::string& path) const {
+    auto it = entries.find(path);
+    return it == entries.end() ? nullptr : &it->second;
+}
+
+// Layout: magic, version, entry count, then per entry a u16 path length,
+// the path, size, mtime, file ID and content hash; a CRC of everything
+// before it closes the file
+bool FileIndex::save(const std::string& indexPath) const {
+    std::vector<char> buffer;
+    auto put = [&](const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        buffer.insert(buffer.end(), bytes, bytes + size);
+    };
+    uint64_t count = entries.size();
+    put(&INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    put(&INDEX_VERSION, sizeof(INDEX_VERSION));
+    put(&count, sizeof(count));
+    for (const auto& [path, entry] : entries) {
+        if (path.size() > UINT16_MAX) {
+            return false;
+        }
+        uint16_t length = static_cast<uint16_t>(path.size());
+        put(&length, sizeof(length));
+        put(path.data(), path.size());
+        put(&entry.stamp.size, sizeof(entry.stamp.size));
+        put(&entry.stamp.modifiedNs, sizeof(entry.stamp.modifiedNs));
+        put(&entry.stamp.fileId, sizeof(entry.stamp.fileId));
+        put(&entry.contentHash.low, sizeof(entry.contentHash.low));
+        put(&entry.contentHash.high, sizeof(entry.contentHash.high));
+    }
+    uint32_t crc = crc32(buffer.data(), buffer.size());
+    put(&crc, sizeof(crc));
+
+    std::string temporary = indexPath + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!out) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    std::remove(indexPath.c_str());
+    return std::rename(temporary.c_str(), indexPath.c_str()) == 0;
+}
+
+bool FileIndex::load(const std::string& indexPath) {
+    entries.clear();
+    std::ifstream in(indexPath, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return false;
+    }
+    std::vector<char> buffer(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    constexpr size_t HEADER = 2 * sizeof(uint32_t) + sizeof(uint64_t);
+    if (!in.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) ||
+        buffer.size() < HEADER + sizeof(uint32_t)) {
+        throw FSException("Truncated file index: " + indexPath);
+    }
+
+    uint32_t storedCrc;
+    size_t body = buffer.size() - sizeof(storedCrc);
+    std::memcpy(&storedCrc, buffer.data() + body, sizeof(storedCrc));
+    uint32_t magic;
+    uint32_t version;
+    uint64_t count;
+    std::memcpy(&magic, buffer.data(), sizeof(magic));
+    std::memcpy(&version, buffer.data() + 4, sizeof(version));
+    std::memcpy(&count, buffer.data() + 8, sizeof(count));
+    if (magic != INDEX_MAGIC || version != INDEX_VERSION || crc32(buffer.data(), body) != storedCrc) {
+        throw FSException("Corrupt file index: " + indexPath);
+    }
+
+    constexpr size_t FIXED = sizeof(uint16_t) + 5 * sizeof(uint64_t);
+    size_t position = HEADER;
+    entries.reserve(static_cast<size_t>(count));
+    for (uint64_t i = 0; i < count; ++i) {
+        uint16_t length;
+        if (position + FIXED > body) {
+            throw FSException("Corrupt file index: " + indexPath);
+        }
+        std::memcpy(&length, buffer.data() + position, sizeof(length));
+        position += sizeof(length);
+        if (position + length + FIXED - sizeof(length) > body) {
+            throw FSException("Corrupt file index: " + indexPath);
+        }
+        std::string path(buffer.data() + position, length);
+        position += length;
+
+        FileIndexEntry entry;
+        std::memcpy(&entry.stamp.size, buffer.data() + position, sizeof(uint64_t));
+        std::memcpy(&entry.stamp.modifiedNs, buffer.data() + position + 8, sizeof(int64_t));
+        std::memcpy(&entry.stamp.fileId, buffer.data() + position + 16, sizeof(uint64_t));
+        std::memcpy(&entry.contentHash.low, buffer.data() + position + 24, sizeof(uint64_t));
+        std::memcpy(&entry.contentHash.high, buffer.data() + position + 32, sizeof(uint64_t));
+        position += 5 * sizeof(uint64_t);
+        entries.emplace(std::move(path), entry);
+    }
+    if (position != body) {
+        throw FSException("Corrupt file index: " + indexPath);
+    }
+    return true;
+}
+
+} // namespace mtfs::fs
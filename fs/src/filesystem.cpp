@@ -1,5 +1,8 @@
 #include "fs/filesystem.hpp"
 #include "fs/compression.hpp"
+#include "fs/copy_engine.hpp"
+#include "fs/directory_walker.hpp"
+#include "fs/glob_matcher.hpp"
 #include "common/logger.hpp"
 #include "common/error.hpp"
 #include <direct.h>
@@ -7,23 +10,125 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <fstream>
-#include <sstream>
 #include <iomanip>
+#include <sstream>
+#include <algorithm>
 #include <iostream>
 #include <cstdio>
+#include <numeric>
+#include <unordered_set>
 
 namespace mtfs::fs {
 
 using namespace mtfs::common;  // Add this to use exceptions from common namespace
 
-FileSystem::FileSystem(const std::string& rootPath, mtfs::common::AuthManager* auth)
+namespace {
+
+// Block store paths are relative to the root, which itself is "", "." or "/"
+bool isRootPath(const std::string& path) {
+    return path.empty() || path == "." || path == "/";
+}
+
+std::string parentPath(const std::string& path) {
+    size_t separator = path.find_last_of("/\\");
+    return separator == std::string::npos ? std::string() : path.substr(0, separator);
+}
+
+std::string baseName(const std::string& path) {
+    return path.substr(path.find_last_of("/\\") + 1);
+}
+
+DirectoryIndex::Entry indexEntry(const struct stat& fileStats) {
+    DirectoryIndex::Entry entry;
+    entry.isDirectory = (fileStats.st_mode & S_IFDIR) != 0;
+    entry.hasAttributes = true;
+    entry.size = entry.isDirectory ? 0 : static_cast<uint64_t>(fileStats.st_size);
+    entry.modifiedNs = static_cast<int64_t>(fileStats.st_mtime) * 1000000000LL;
+    entry.createdNs = static_cast<int64_t>(fileStats.st_ctime) * 1000000000LL;
+    entry.permissions = fileStats.st_mode & 0777;
+    return entry;
+}
+
+std::string formatLatency(uint64_t nanoseconds) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1);
+    if (nanoseconds < 1000) {
+        text << nanoseconds << "ns";
+    } else if (nanoseconds < 1000000) {
+        text << nanoseconds / 1e3 << "us";
+    } else if (nanoseconds < 1000000000) {
+        text << nanoseconds / 1e6 << "ms";
+    } else {
+        text << nanoseconds / 1e9 << "s";
+    }
+    return text.str();
+}
+
+std::vector<std::pair<const char*, const common::HistogramSnapshot*>> latencyRows(const LatencyReport& report) {
+    return {{"Read", &report.read},           {"Write", &report.write},
+            {"Cache hit", &report.cacheHit},  {"Cache miss", &report.cacheMiss},
+            {"Block read", &report.blockRead}, {"Block write", &report.blockWrite}};
+}
+
+} // namespace
+
+struct FileSystem::Batch {
+    const FileSystem* owner{nullptr};
+    std::string user;
+    bool admin{false};
+
+    std::vector<std::string> persisted;  // Paths whose metadata changed, once each
+    std::unordered_set<std::string> persistedSet;
+    std::unordered_map<std::string, SharedBuffer> cached;  // Newest contents; null once removed
+    std::vector<FileLayout> released;  // Old extents, freed once the commit lands
+};
+
+thread_local FileSystem::Batch* FileSystem::activeBatch = nullptr;
+
+FileSystem::FileSystem(const std::string& rootPath, mtfs::common::AuthManager* auth,
+                       const FileSystemOptions& options)
     : rootPath(rootPath),
-      enhancedCache(std::make_unique<cache::CacheManager<std::string, std::string>>(CACHE_CAPACITY)),
+      options(options),
+      enhancedCache(std::make_unique<cache::CacheManager<std::string, SharedBuffer>>(CACHE_CAPACITY)),
       authManager(auth),
-      metadataFilePath(rootPath + "/.mtfs_metadata") {
+      metadataFilePath(rootPath + "/.mtfs_metadata"),
+      cacheSnapshotPath(rootPath + "/.mtfs_cache_keys") {
     LOG_INFO("Initializing filesystem at: " + rootPath);
     _mkdir(rootPath.c_str());
+    metadataLog = std::make_unique<MetadataLog>(metadataFilePath);
     loadMetadata();
+
+    if (options.storageMode == StorageMode::BlockStore) {
+        extentStore = std::make_unique<ExtentStore>(rootPath + "/.mtfs_blocks", options.inlineThreshold,
+                                                    options.initialBlocks);
+        // Blocks written for a layout that never reached the metadata log
+        extentStore->reconcile(fileMetadataMap.snapshot());
+    } else if (options.directoryIndex) {
+        directoryIndex = std::make_unique<DirectoryIndex>();
+        directoryIndex->rebuild(rootPath);
+    }
+    if (options.prefetch.enabled) {
+        prefetcher = std::make_unique<PrefetchEngine>(
+            [this](const std::string& path) { return prefetchLoad(path); },
+            [this](const std::string& directory) { return listDirectory(directory); }, options.prefetch);
+    }
+    if (options.warmRestart.enabled) {
+        warmer = std::make_unique<CacheWarmer>(
+            [this](const std::vector<std::string>& paths) { return warmLoad(paths); },
+            options.warmRestart.bytesPerSecond);
+    }
+    if (options.writeBack.enabled) {
+        writeBack = std::make_unique<WriteBackBuffer>(
+            [this](const std::string& path) {
+                try {
+                    auto lock = pathLocks.lock(path, PathLockTable::Mode::Exclusive);
+                    flushWrites(path);
+                } catch (const std::exception& e) {
+                    recordWriteError(path, e.what());
+                }
+            },
+            options.writeBack);
+    }
     
     // Initialize backup manager
     std::string backupDir = rootPath + "_backups";
@@ -35,60 +140,116 @@ FileSystem::FileSystem(const std::string& rootPath, mtfs::common::AuthManager* a
     }
 }
 
+FileSystem::~FileSystem() {
+    if (writeBack) {
+        writeBack->stop();
+        flushAllWrites();
+    }
+}
+
 std::shared_ptr<FileSystem> FileSystem::create(const std::string& rootPath, mtfs::common::AuthManager* auth) {
     return std::shared_ptr<FileSystem>(new FileSystem(rootPath, auth));
 }
 
-bool FileSystem::saveMetadata() const {
-    std::ofstream ofs(metadataFilePath, std::ios::trunc);
-    if (!ofs) return false;
-    for (const auto& [path, meta] : fileMetadataMap) {
-        ofs << path << '\t' << meta.owner << '\t' << meta.permissions << '\t' << meta.size << '\t' << meta.isDirectory << '\n';
-    }
-    return true;
+std::shared_ptr<FileSystem> FileSystem::create(const std::string& rootPath, const FileSystemOptions& options,
+                                               mtfs::common::AuthManager* auth) {
+    return std::shared_ptr<FileSystem>(new FileSystem(rootPath, auth, options));
+}
+
+bool FileSystem::saveMetadata() {
+    std::lock_guard<std::mutex> lock(logMutex);
+    return metadataLog->compact(fileMetadataMap.snapshot());
 }
 
 bool FileSystem::loadMetadata() {
-    std::ifstream ifs(metadataFilePath);
-    if (!ifs) return false;
-    fileMetadataMap.clear();
-    std::string path, owner;
-    uint32_t permissions;
-    std::size_t size;
-    int isDir;
-    while (ifs >> path >> owner >> permissions >> size >> isDir) {
-        FileMetadata meta;
-        meta.name = path;
-        meta.owner = owner;
-        meta.permissions = permissions;
-        meta.size = size;
-        meta.isDirectory = (isDir != 0);
-        fileMetadataMap[path] = meta;
+    MetadataLog::MetadataMap metadata;
+    bool ok = metadataLog->load(metadata);
+    fileMetadataMap.assign(metadata);
+    return ok;
+}
+
+bool FileSystem::persistMetadata(const std::string& path) {
+    if (Batch* batch = currentBatch()) {
+        if (batch->persistedSet.insert(path).second) {
+            batch->persisted.push_back(path);
+        }
+        return true;
     }
-    return true;
+    // Reading the entry under logMutex records its newest state, and a
+    // compaction cannot fall between the change and its record
+    std::lock_guard<std::mutex> lock(logMutex);
+    FileMetadata metadata;
+    bool ok = fileMetadataMap.find(path, metadata)
+        ? metadataLog->appendPut(path, metadata)
+        : metadataLog->appendErase(path);
+    if (metadataLog->needsCompaction(fileMetadataMap.size())) {
+        ok = metadataLog->compact(fileMetadataMap.snapshot()) && ok;
+    }
+    return ok;
 }
 
-bool FileSystem::createFile(const std::string& path) {
-    try {
-        if (authManager && !authManager->isLoggedIn()) {
-            throw FSException("Authentication required to create file");
+bool FileSystem::commitMetadata(const std::vector<std::string>& paths) {
+    std::lock_guard<std::mutex> lock(logMutex);
+    std::vector<FileMetadata> states(paths.size());
+    std::vector<std::pair<std::string, const FileMetadata*>> records;
+    records.reserve(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        records.emplace_back(paths[i], fileMetadataMap.find(paths[i], states[i]) ? &states[i] : nullptr);
+    }
+    bool ok = metadataLog->appendBatch(records);
+    if (metadataLog->needsCompaction(fileMetadataMap.size())) {
+        ok = metadataLog->compact(fileMetadataMap.snapshot()) && ok;
+    }
+    return ok;
+}
+
+// A record still naming old blocks must never find them holding new data, so
+// they are freed only once the change is in the log. Blocks kept after a
+// failed append are reclaimed at the next mount.
+void FileSystem::releaseLayout(FileLayout layout, bool persisted) {
+    if (Batch* batch = currentBatch()) {
+        batch->released.push_back(std::move(layout));
+    } else if (persisted) {
+        extentStore->release(layout);
+    }
+}
+
+// Checked before an entry is added, so the table never holds one the log
+// cannot record
+void FileSystem::requireRecordable(const std::string& path) {
+    if (path.size() > MetadataLog::MAX_STRING_LENGTH) {
+        throw FSException("Path of " + std::to_string(path.size()) + " bytes is too long");
+    }
+}
+
+void FileSystem::requireLogin(const std::string& action) const {
+    if (currentBatch()) {
+        return;  // Checked when the batch started
+    }
+    if (authManager && !authManager->isLoggedIn()) {
+        throw FSException("Authentication required to " + action);
+    }
+}
+
+// Only the owner or an admin may read, change or delete a file
+void FileSystem::requireOwner(const std::string& path) {
+    if (authManager) {
+        Batch* batch = currentBatch();
+        if (batch && batch->admin) {
+            return;
         }
-        std::string fullPath = rootPath + "/" + path;
-        std::ofstream file(fullPath);
-        if (!file) {
-            LOG_ERROR("Failed to create file: " + path);
-            throw FSException("Failed to create file: " + path);
+        FileMetadata meta = lookupMetadata(path);
+        std::string user = batch ? batch->user : authManager->getCurrentUser();
+        if (meta.owner != user && (batch || !authManager->isAdmin(user))) {
+            throw FSException("Permission denied: not owner or admin");
         }
-        file.close();
-        // Set file owner and persist metadata
-        FileMetadata meta;
-        meta.name = path;
-        meta.owner = authManager ? authManager->getCurrentUser() : "unknown";
-        meta.permissions = 0644;
-        meta.size = 0;
-        meta.isDirectory = false;
-        fileMetadataMap[path] = meta;
-        saveMetadata();
+    }
+}
+
+bool FileSystem::createFile(const std::string& path) {
+    try {
+        auto lock = pathLocks.lock(path, PathLockTable::Mode::Exclusive);
+        createEntry(path);
         return true;
     } catch (const std::exception& e) {
         LOG_ERROR(std::string("Error creating file: ") + e.what());
@@ -96,45 +257,59 @@ bool FileSystem::createFile(const std::string& path) {
     }
 }
 
-bool FileSystem::writeFile(const std::string& path, const std::string& data) {
-    try {
-        auto startTime = std::chrono::high_resolution_clock::now();
-        
-        if (authManager && !authManager->isLoggedIn()) {
-            throw FSException("Authentication required to write file");
-        }
-        // Permission check: only owner or admin can write
-        if (authManager) {
-            FileMetadata meta = getFileInfo(path);
-            std::string user = authManager->getCurrentUser();
-            if (meta.owner != user && !authManager->isAdmin(user)) {
-                throw FSException("Permission denied: not owner or admin");
-            }
+void FileSystem::createEntry(const std::string& path) {
+    requireLogin("create file");
+    requireRecordable(path);
+    discardWrites(path);  // An existing file is emptied
+    FileLayout previousLayout;
+    if (usesBlockStore()) {
+        // Creating an existing file empties it, as truncation would
+        FileMetadata existing;
+        bool exists = fileMetadataMap.find(path, existing);
+        if (exists && existing.isDirectory) {
+            throw FSException("Path is a directory: " + path);
         }
-        std::string fullPath = rootPath + "/" + path;
-        if (!exists(path)) {
-            throw FileNotFoundException(path);
+        if (!blockStoreDirectoryExists(parentPath(path))) {
+            throw FileNotFoundException(parentPath(path));
         }
-        std::ofstream file(fullPath);
-        if (!file) {
-            throw FSException("Failed to open file for writing: " + path);
+        if (exists) {
+            previousLayout = std::move(existing.layout);
         }
-        file << data;
-        enhancedCache->put(path, data);
-        stats.totalWrites++;
-        stats.totalFileOperations++;
+        cacheRemove(path);
+    } else {
+        std::string fullPath = rootPath + "/" + path;
+        mappings.invalidate(path);
+        // Keep the new file's handle open for the writes that usually follow
+        handles.insert(path, FileHandle::open(fullPath, true));
+        if (directoryIndex) {
+            directoryIndex->put(path, DirectoryIndex::Entry{});
+        }
+    }
+    // Set file owner and persist metadata
+    FileMetadata meta;
+    meta.name = path;
+    meta.owner = authManager ? authManager->getCurrentUser() : "unknown";
+    meta.permissions = 0644;
+    meta.size = 0;
+    meta.isDirectory = false;
+    meta.createdAt = meta.modifiedAt = std::chrono::system_clock::now();
+    fileMetadataMap.put(path, meta);
+    bool persisted = persistMetadata(path);
+    if (usesBlockStore()) {
+        releaseLayout(std::move(previousLayout), persisted);
+    }
+}
 
-        // Update metadata
-        FileMetadata& meta = fileMetadataMap[path];
-        meta.size = data.size();
-        meta.modifiedAt = std::chrono::system_clock::now();
-        saveMetadata();
-        
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-        double writeTime = duration.count() / 1000.0; // Convert to milliseconds
-        stats.avgWriteTime = (stats.avgWriteTime * (stats.totalWrites - 1) + writeTime) / stats.totalWrites;
+bool FileSystem::writeFile(const std::string& path, const std::string& data) {
+    return writeFile(path, std::make_shared<const std::string>(data));
+}
 
+bool FileSystem::writeFile(const std::string& path, SharedBuffer data) {
+    try {
+        auto lock = pathLocks.lock(path, PathLockTable::Mode::Exclusive);
+        requireLogin("write file");
+        requireOwner(path);
+        storeContents(path, std::move(data));
         return true;
     } catch (const std::exception& e) {
         LOG_ERROR(std::string("Error writing file: ") + e.what());
@@ -142,94 +317,192 @@ bool FileSystem::writeFile(const std::string& path, const std::string& data) {
     }
 }
 
+void FileSystem::storeContents(const std::string& path, SharedBuffer data) {
+    auto startTime = std::chrono::steady_clock::now();
+    if (!data) {
+        data = std::make_shared<const std::string>();
+    }
+    discardWrites(path);  // Replaced by the new contents
+    if (usesBlockStore()) {
+        // The new layout is recorded before the old one's blocks are freed
+        blockStoreFile(path);
+        FileLayout layout = extentStore->store(*data);
+        FileLayout previousLayout;
+        fileMetadataMap.update(path, [&](FileMetadata& meta) {
+            previousLayout = std::move(meta.layout);
+            meta.layout = std::move(layout);
+            meta.size = data->size();
+            meta.compressed = false;
+            meta.modifiedAt = std::chrono::system_clock::now();
+        });
+        releaseLayout(std::move(previousLayout), persistMetadata(path));
+    } else {
+        auto handle = acquireHandle(path);
+        // Shrinking a mapped file faults its readers on POSIX and fails on Windows
+        mappings.invalidate(path);
+        handle->writeAt(data->data(), data->size(), 0);
+        handle->truncate(data->size());
+        if (directoryIndex) {
+            directoryIndex->invalidate(path);
+        }
+    }
+    cachePut(path, data);
+
+    // Update metadata
+    if (!usesBlockStore()) {
+        fileMetadataMap.upsert(path, [&](FileMetadata& meta) {
+            meta.size = data->size();
+            meta.compressed = false;
+            meta.modifiedAt = std::chrono::system_clock::now();
+        });
+        persistMetadata(path);
+    }
+
+    writeLatency.record(std::chrono::steady_clock::now() - startTime);
+}
+
 std::string FileSystem::readFile(const std::string& path) {
+    return *readFileShared(path);
+}
+
+SharedBuffer FileSystem::readFileShared(const std::string& path) {
     try {
-        if (authManager && !authManager->isLoggedIn()) {
-            throw FSException("Authentication required to read file");
-        }
-        // Permission check: only owner or admin can read (customize as needed)
-        if (authManager) {
-            FileMetadata meta = getFileInfo(path);
-            std::string user = authManager->getCurrentUser();
-            if (meta.owner != user && !authManager->isAdmin(user)) {
-                throw FSException("Permission denied: not owner or admin");
+        auto lock = pathLocks.lock(path, PathLockTable::Mode::Shared);
+        requireLogin("read file");
+        requireOwner(path);
+        SharedBuffer data = loadContents(path);
+        if (prefetcher) {
+            prefetcher->recordAccess(path);
+        }
+        return data;
+    } catch (const std::exception& e) {
+        LOG_ERROR(std::string("Error reading file: ") + e.what());
+        throw;
+    }
+}
+
+SharedBuffer FileSystem::loadContents(const std::string& path) {
+    // Try to get from cache first
+    auto startTime = std::chrono::steady_clock::now();
+    bool changedInBatch = false;
+    if (Batch* batch = currentBatch()) {
+        auto pending = batch->cached.find(path);
+        if (pending != batch->cached.end()) {
+            // Changed earlier in the batch, so the cache is stale until it ends
+            if (pending->second) {
+                cacheHitLatency.record(std::chrono::steady_clock::now() - startTime);
+                return pending->second;
             }
-        }        // Try to get from cache first
-        auto startTime = std::chrono::high_resolution_clock::now();
+            changedInBatch = true;
+        }
+    }
+    if (!changedInBatch) {
         try {
-            std::string cachedData = enhancedCache->get(path);
+            SharedBuffer cachedData = enhancedCache->get(path);
             LOG_DEBUG("Cache hit for file: " + path);
-            stats.cacheHits++;
-            stats.totalReads++;
-            stats.totalFileOperations++;
-            
-            auto endTime = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-            double readTime = duration.count() / 1000.0; // Convert to milliseconds
-            stats.avgReadTime = (stats.avgReadTime * (stats.totalReads - 1) + readTime) / stats.totalReads;
-            
+            cacheHitLatency.record(std::chrono::steady_clock::now() - startTime);
             return cachedData;
         } catch (const std::runtime_error&) {
             // Cache miss, continue to read from disk
         }
-        LOG_DEBUG("Cache miss for file: " + path);
-        stats.cacheMisses++;
-        stats.totalReads++;
-        stats.totalFileOperations++;
-        std::string fullPath = rootPath + "/" + path;
-        if (!exists(path)) {
-            throw FileNotFoundException(path);
-        }
-        std::ifstream file(fullPath);
-        if (!file) {
-            throw FSException("Failed to open file for reading: " + path);
-        }        std::stringstream buffer;
-        buffer << file.rdbuf();
-        std::string data = buffer.str();
-        enhancedCache->put(path, data);
-        
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
-        double readTime = duration.count() / 1000.0; // Convert to milliseconds
-        stats.avgReadTime = (stats.avgReadTime * (stats.totalReads - 1) + readTime) / stats.totalReads;
-        
-        return data;
-    } catch (const std::exception& e) {
-        LOG_ERROR(std::string("Error reading file: ") + e.what());
-        throw;
     }
+    LOG_DEBUG("Cache miss for file: " + path);
+    std::string contents;
+    if (usesBlockStore()) {
+        FileMetadata meta = blockStoreFile(path);
+        contents = extentStore->load(meta.layout, meta.size);
+    } else {
+        auto handle = acquireHandle(path);
+        contents.assign(handle->size(), '\0');
+        contents.resize(handle->readAt(&contents[0], contents.size(), 0));
+    }
+    if (writeBack) {
+        writeBack->overlay(path, contents);
+    }
+    // Readers racing on a miss put equal buffers; writers are locked out
+    auto data = std::make_shared<const std::string>(std::move(contents));
+    cachePut(path, data);
+
+    cacheMissLatency.record(std::chrono::steady_clock::now() - startTime);
+    return data;
 }
 
 bool FileSystem::deleteFile(const std::string& path) {
     try {
-        if (authManager && !authManager->isLoggedIn()) {
-            throw FSException("Authentication required to delete file");
-        }
-        if (authManager) {
-            FileMetadata meta = getFileInfo(path);
-            std::string user = authManager->getCurrentUser();
-            if (meta.owner != user && !authManager->isAdmin(user)) {
-                throw FSException("Permission denied: not owner or admin");
-            }
-        }
-        std::string fullPath = rootPath + "/" + path;
-        if (!exists(path)) {
-            throw FileNotFoundException(path);
-        }
-        enhancedCache->clear();
-        fileMetadataMap.erase(path);
-        saveMetadata();
-        return remove(fullPath.c_str()) == 0;
+        auto lock = pathLocks.lock(path, PathLockTable::Mode::Exclusive);
+        return removeEntry(path);
     } catch (const std::exception& e) {
         LOG_ERROR(std::string("Error deleting file: ") + e.what());
         throw;
     }
 }
 
+bool FileSystem::removeEntry(const std::string& path) {
+    requireLogin("delete file");
+    requireOwner(path);
+    std::string fullPath = rootPath + "/" + path;
+    if (!pathExists(path)) {
+        throw FileNotFoundException(path);
+    }
+    discardWrites(path);
+    if (usesBlockStore()) {
+        FileMetadata meta;
+        fileMetadataMap.find(path, meta);
+        if (meta.isDirectory) {
+            return false;  // Like remove() on a host directory
+        }
+        cacheRemove(path);
+        fileMetadataMap.erase(path);
+        releaseLayout(std::move(meta.layout), persistMetadata(path));
+        return true;
+    }
+    cacheRemove(path);
+    closeOpenFile(path);  // Windows keeps the name reserved while handles are open
+    fileMetadataMap.erase(path);
+    persistMetadata(path);
+    if (remove(fullPath.c_str()) != 0) {
+        return false;
+    }
+    if (directoryIndex) {
+        directoryIndex->erase(path);
+    }
+    return true;
+}
+
 bool FileSystem::createDirectory(const std::string& path) {
     try {
+        if (usesBlockStore()) {
+            auto lock = pathLocks.lock(path, PathLockTable::Mode::Exclusive);
+            if (isRootPath(path) || blockStoreDirectoryExists(path)) {
+                return false;
+            }
+            requireRecordable(path);
+            if (fileMetadataMap.contains(path)) {
+                throw FSException("File exists: " + path);
+            }
+            if (!blockStoreDirectoryExists(parentPath(path))) {
+                throw FileNotFoundException(parentPath(path));
+            }
+            FileMetadata meta;
+            meta.name = path;
+            meta.owner = authManager ? authManager->getCurrentUser() : "unknown";
+            meta.permissions = 0755;
+            meta.isDirectory = true;
+            meta.createdAt = meta.modifiedAt = std::chrono::system_clock::now();
+            fileMetadataMap.put(path, meta);
+            persistMetadata(path);
+            return true;
+        }
         std::string fullPath = rootPath + "/" + path;
-        return _mkdir(fullPath.c_str()) == 0;
+        if (_mkdir(fullPath.c_str()) != 0) {
+            return false;
+        }
+        if (directoryIndex) {
+            DirectoryIndex::Entry entry;
+            entry.isDirectory = true;
+            directoryIndex->put(path, entry, true);
+        }
+        return true;
     } catch (const std::exception& e) {
         LOG_ERROR(std::string("Error creating directory: ") + e.what());
         throw;
@@ -239,11 +512,27 @@ bool FileSystem::createDirectory(const std::string& path) {
 std::vector<std::string> FileSystem::listDirectory(const std::string& path) {
     try {
         std::string fullPath = rootPath + "/" + path;
-        if (!exists(path)) {
+        if (!pathExists(path)) {
             throw FileNotFoundException(path);
         }
 
         std::vector<std::string> entries;
+        if (usesBlockStore()) {
+            if (!blockStoreDirectoryExists(path)) {
+                throw FSException("Not a directory: " + path);
+            }
+            std::string directory = isRootPath(path) ? std::string() : path;
+            fileMetadataMap.forEach([&](const std::string& entryPath, const FileMetadata&) {
+                if (parentPath(entryPath) == directory) {
+                    entries.push_back(baseName(entryPath));
+                }
+            });
+            return entries;
+        }
+        if (directoryIndex && directoryIndex->list(path, entries)) {
+            return entries;
+        }
+
         _finddata_t fileinfo;
         intptr_t handle = _findfirst((fullPath + "/*").c_str(), &fileinfo);
         
@@ -266,88 +555,205 @@ std::vector<std::string> FileSystem::listDirectory(const std::string& path) {
 
 FileMetadata FileSystem::getMetadata(const std::string& path) {
     try {
-        std::string fullPath = rootPath + "/" + path;
-        if (!exists(path)) {
-            throw FileNotFoundException(path);
-        }        struct stat fileStats;
+        auto lock = pathLocks.lock(path, PathLockTable::Mode::Shared);
+        return lookupMetadata(path);
+    } catch (const std::exception& e) {
+        LOG_ERROR(std::string("Error getting metadata: ") + e.what());
+        throw;
+    }
+}
+
+FileMetadata FileSystem::lookupMetadata(const std::string& path) {
+    std::string fullPath = rootPath + "/" + path;
+    if (!pathExists(path)) {
+        throw FileNotFoundException(path);
+    }
+    if (usesBlockStore()) {
+        FileMetadata metadata;
+        if (isRootPath(path)) {
+            metadata.name = path;
+            metadata.isDirectory = true;
+            metadata.permissions = 0755;
+            return metadata;
+        }
+        fileMetadataMap.find(path, metadata);
+        metadata.name = baseName(path);
+        metadata.layout = FileLayout();  // Placement is internal to the store
+        if (writeBack) {
+            metadata.size = std::max<size_t>(metadata.size, writeBack->end(path));
+        }
+        return metadata;
+    }
+    DirectoryIndex::Entry entry;
+    if (!directoryIndex || !directoryIndex->find(path, entry) || !entry.hasAttributes) {
+        struct stat fileStats;
         if (stat(fullPath.c_str(), &fileStats) != 0) {
             throw FSException("Failed to get file stats: " + path);
         }
+        entry = indexEntry(fileStats);
+        if (directoryIndex) {
+            directoryIndex->put(path, entry);
+        }
+    }
 
-        FileMetadata metadata;
-        metadata.name = path.substr(path.find_last_of("/\\") + 1);
-        metadata.size = fileStats.st_size;
-        metadata.isDirectory = (fileStats.st_mode & S_IFDIR) != 0;
-        metadata.permissions = fileStats.st_mode & 0777;
-        metadata.modifiedAt = std::chrono::system_clock::from_time_t(fileStats.st_mtime);
-        metadata.createdAt = std::chrono::system_clock::from_time_t(fileStats.st_ctime);
-
-        return metadata;
-    } catch (const std::exception& e) {
-        LOG_ERROR(std::string("Error getting metadata: ") + e.what());
-        throw;
+    FileMetadata metadata;
+    metadata.name = path.substr(path.find_last_of("/\\") + 1);
+    metadata.size = static_cast<size_t>(entry.size);
+    metadata.isDirectory = entry.isDirectory;
+    metadata.permissions = entry.permissions;
+    metadata.modifiedAt = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(entry.modifiedNs)));
+    metadata.createdAt = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(entry.createdNs)));
+    fileMetadataMap.inspect(path, [&](const FileMetadata& entry) { metadata.compressed = entry.compressed; });
+    if (writeBack) {
+        metadata.size = std::max<size_t>(metadata.size, writeBack->end(path));
     }
+    return metadata;
 }
 
 void FileSystem::setPermissions(const std::string& path, uint32_t permissions) {
     try {
+        auto lock = pathLocks.lock(path, PathLockTable::Mode::Exclusive);
         std::string fullPath = rootPath + "/" + path;
-        if (!exists(path)) {
+        if (!pathExists(path)) {
             throw FileNotFoundException(path);
         }
 
-        if (_chmod(fullPath.c_str(), permissions) != 0) {
+        if (!usesBlockStore() && _chmod(fullPath.c_str(), permissions) != 0) {
             throw FSException("Failed to set permissions: " + path);
         }
+        if (directoryIndex) {
+            directoryIndex->invalidate(path);
+        }
 
         // Update metadata
-        fileMetadataMap[path].permissions = permissions;
-        saveMetadata();
+        fileMetadataMap.upsert(path, [&](FileMetadata& meta) { meta.permissions = permissions; });
+        persistMetadata(path);
     } catch (const std::exception& e) {
         LOG_ERROR(std::string("Error setting permissions: ") + e.what());
         throw;
     }
 }
 
+// A single lookup, so it takes no path lock
 bool FileSystem::exists(const std::string& path) {
     try {
-        std::string fullPath = rootPath + "/" + path;        struct stat fileStats;
-        return stat(fullPath.c_str(), &fileStats) == 0;
+        return pathExists(path);
     } catch (const std::exception& e) {
         LOG_ERROR(std::string("Error checking existence: ") + e.what());
         throw;
     }
 }
 
+bool FileSystem::pathExists(const std::string& path) {
+    if (usesBlockStore()) {
+        return isRootPath(path) || fileMetadataMap.contains(path);
+    }
+    if (handles.find(path)) {
+        return true;
+    }
+    DirectoryIndex::Entry entry;
+    if (directoryIndex && directoryIndex->find(path, entry)) {
+        return true;
+    }
+    // A miss goes to the host; what it finds there is indexed from then on
+    std::string fullPath = rootPath + "/" + path;
+    struct stat fileStats;
+    if (stat(fullPath.c_str(), &fileStats) != 0) {
+        return false;
+    }
+    if (directoryIndex) {
+        directoryIndex->put(path, indexEntry(fileStats));
+    }
+    return true;
+}
+
 void FileSystem::sync() {
-    // In a real implementation, this would flush all buffers to disk
     LOG_INFO("Syncing filesystem");
+    flushAllWrites();
+    if (usesBlockStore()) {
+        extentStore->sync();
+    }
+    {
+        std::lock_guard<std::mutex> lock(logMutex);
+        metadataLog->flush();
+    }
+
+    std::unordered_map<std::string, std::string> failed;
+    {
+        std::lock_guard<std::mutex> lock(writeErrorMutex);
+        failed.swap(writeErrors);
+    }
+    if (!failed.empty()) {
+        std::string paths;
+        for (const auto& [path, error] : failed) {
+            paths += (paths.empty() ? "" : ", ") + path;
+        }
+        throw FSException("Buffered writes did not reach the disk: " + paths);
+    }
 }
 
 void FileSystem::mount() {
     LOG_INFO("Mounting filesystem at: " + rootPath);
     _mkdir(rootPath.c_str());
+    if (directoryIndex) {
+        directoryIndex->rebuild(rootPath);
+    }
+    if (warmer) {
+        auto entries = CacheWarmer::load(cacheSnapshotPath);
+        if (!entries.empty()) {
+            LOG_INFO("Warming cache from " + std::to_string(entries.size()) + " saved entries");
+            warmer->start(std::move(entries));
+        }
+    }
+}
+
+void FileSystem::rescan() {
+    if (directoryIndex) {
+        directoryIndex->rebuild(rootPath);
+        LOG_INFO("Directory index rebuilt: " + std::to_string(directoryIndex->size()) + " entries");
+    }
 }
 
 void FileSystem::unmount() {
     LOG_INFO("Unmounting filesystem from: " + rootPath);
+    if (warmer) {
+        // Keys and hit counts only, hottest first; a reload still running is dropped
+        warmer->stop();
+        std::vector<CacheWarmer::Entry> entries;
+        for (const auto& [path, count] : enhancedCache->getAccessCounts()) {
+            entries.push_back({path, count});
+        }
+        CacheWarmer::save(cacheSnapshotPath, entries);
+    }
     sync();
+    saveMetadata();
 }
 
 std::size_t FileSystem::write(const std::string& path, const void* buffer, std::size_t size, std::size_t offset) {
     try {
-        std::string fullPath = rootPath + "/" + path;
-        if (!exists(path)) {
-            throw FileNotFoundException(path);
+        auto lock = pathLocks.lock(path, PathLockTable::Mode::Exclusive);
+        reportWriteError(path);
+        bool compressed = false;
+        fileMetadataMap.inspect(path, [&](const FileMetadata& meta) { compressed = meta.compressed; });
+        if (compressed) {
+            throw FSException("File is compressed; decompress it before writing: " + path);
         }
-
-        std::fstream file(fullPath, std::ios::binary | std::ios::in | std::ios::out);
-        if (!file) {
-            throw FSException("Failed to open file for writing: " + path);
+        if (!writeBack) {
+            cacheRemove(path);  // Cached contents are stale now
+            return writeThrough(path, buffer, size, offset);
+        }
+        // Fails as a direct write would, and keeps the handle open for the flush
+        if (usesBlockStore()) {
+            blockStoreFile(path);
+        } else {
+            acquireHandle(path);
+        }
+        cacheRemove(path);  // Cached contents are stale now
+        if (writeBack->add(path, offset, buffer, size)) {
+            flushWrites(path);
         }
-
-        file.seekp(offset);
-        file.write(static_cast<const char*>(buffer), size);
         return size;
     } catch (const std::exception& e) {
         LOG_ERROR(std::string("Error in low-level write: ") + e.what());
@@ -355,27 +761,189 @@ std::size_t FileSystem::write(const std::string& path, const void* buffer, std::
     }
 }
 
+size_t FileSystem::writeThrough(const std::string& path, const void* buffer, size_t size, size_t offset) {
+    if (usesBlockStore()) {
+        FileMetadata meta = blockStoreFile(path);
+        size_t written = extentStore->writeAt(meta.layout, meta.size, buffer, size, offset);
+        meta.modifiedAt = std::chrono::system_clock::now();
+        fileMetadataMap.put(path, meta);
+        persistMetadata(path);
+        return written;
+    }
+    auto handle = acquireHandle(path);
+
+    // In-place writes show through a shared mapping; growing the file does not
+    if (auto mapping = mappings.find(path); mapping && offset + size > mapping->size()) {
+        mappings.invalidate(path);
+    }
+    if (directoryIndex) {
+        directoryIndex->invalidate(path);
+    }
+    return handle->writeAt(buffer, size, offset);
+}
+
 std::size_t FileSystem::read(const std::string& path, void* buffer, std::size_t size, std::size_t offset) {
     try {
-        std::string fullPath = rootPath + "/" + path;
-        if (!exists(path)) {
-            throw FileNotFoundException(path);
+        auto lock = pathLocks.lock(path, PathLockTable::Mode::Shared);
+        reportWriteError(path);
+        bool compressed = false;
+        fileMetadataMap.inspect(path, [&](const FileMetadata& meta) { compressed = meta.compressed; });
+        if (compressed) {
+            return openCompressed(path)->read(buffer, size, offset);
         }
-
-        std::ifstream file(fullPath, std::ios::binary);
-        if (!file) {
-            throw FSException("Failed to open file for reading: " + path);
-        }
-
-        file.seekg(offset);
-        file.read(static_cast<char*>(buffer), size);
-        return file.gcount();
+        size_t got = readThrough(path, buffer, size, offset);
+        return writeBack ? writeBack->overlay(path, offset, static_cast<char*>(buffer), size, got) : got;
     } catch (const std::exception& e) {
         LOG_ERROR(std::string("Error in low-level read: ") + e.what());
         throw;
     }
 }
 
+size_t FileSystem::readThrough(const std::string& path, void* buffer, size_t size, size_t offset) {
+    if (usesBlockStore()) {
+        FileMetadata meta = blockStoreFile(path);
+        return extentStore->readAt(meta.layout, meta.size, buffer, size, offset);
+    }
+    if (auto mapping = mappings.find(path)) {
+        return mapping->read(buffer, size, offset);
+    }
+
+    // Large files are mapped once and served from the mapping from then on
+    auto handle = acquireHandle(path);
+    if (handle->size() >= mmapThreshold) {
+        auto mapping = mappings.insert(path, MappedFile::open(rootPath + "/" + path));
+        return mapping->read(buffer, size, offset);
+    }
+    return handle->readAt(buffer, size, offset);
+}
+
+// Extents are written in offset order, one call each however many writes
+// they coalesced. Cached contents already include them. When one fails, it
+// and the rest go back to the buffer before the error propagates.
+void FileSystem::flushWrites(const std::string& path) {
+    if (!writeBack) {
+        return;
+    }
+    auto extents = writeBack->take(path);
+    while (!extents.empty()) {
+        auto first = extents.begin();
+        try {
+            writeThrough(path, first->second.data(), first->second.size(), static_cast<size_t>(first->first));
+        } catch (...) {
+            writeBack->restore(path, std::move(extents));
+            throw;
+        }
+        extents.erase(first);
+    }
+}
+
+void FileSystem::flushAllWrites() {
+    if (!writeBack) {
+        return;
+    }
+    for (const auto& path : writeBack->dirtyPaths()) {
+        try {
+            auto lock = pathLocks.lock(path, PathLockTable::Mode::Exclusive);
+            flushWrites(path);
+        } catch (const std::exception& e) {
+            recordWriteError(path, e.what());
+        }
+    }
+}
+
+void FileSystem::discardWrites(const std::string& path) {
+    if (writeBack) {
+        writeBack->take(path);
+        std::lock_guard<std::mutex> lock(writeErrorMutex);
+        writeErrors.erase(path);  // The failed bytes are gone with the rest
+    }
+}
+
+// For flushes nobody is waiting on: the flusher thread and flushAllWrites
+void FileSystem::recordWriteError(const std::string& path, const std::string& error) {
+    LOG_ERROR("Failed to write out buffered writes for " + path + ": " + error);
+    std::lock_guard<std::mutex> lock(writeErrorMutex);
+    writeErrors[path] = error;
+}
+
+void FileSystem::reportWriteError(const std::string& path) {
+    std::string error;
+    {
+        std::lock_guard<std::mutex> lock(writeErrorMutex);
+        auto entry = writeErrors.find(path);
+        if (entry == writeErrors.end()) {
+            return;
+        }
+        error = std::move(entry->second);
+        writeErrors.erase(entry);
+    }
+    throw FSException("Buffered writes to " + path + " did not reach the disk: " + error);
+}
+
+WriteBackBuffer::Stats FileSystem::getWriteBackStats() const {
+    return writeBack ? writeBack->getStats() : WriteBackBuffer::Stats{};
+}
+
+std::shared_ptr<FileHandle> FileSystem::acquireHandle(const std::string& path) {
+    if (auto handle = handles.find(path)) {
+        return handle;
+    }
+    if (!pathExists(path)) {
+        throw FileNotFoundException(path);
+    }
+    return handles.insert(path, FileHandle::open(rootPath + "/" + path));
+}
+
+FileMetadata FileSystem::blockStoreFile(const std::string& path) {
+    FileMetadata meta;
+    if (!fileMetadataMap.find(path, meta)) {
+        throw FileNotFoundException(path);
+    }
+    if (meta.isDirectory) {
+        throw FSException("Path is a directory: " + path);
+    }
+    return meta;
+}
+
+bool FileSystem::blockStoreDirectoryExists(const std::string& path) const {
+    if (isRootPath(path)) {
+        return true;
+    }
+    bool isDirectory = false;
+    fileMetadataMap.inspect(path, [&](const FileMetadata& meta) { isDirectory = meta.isDirectory; });
+    return isDirectory;
+}
+
+void FileSystem::closeOpenFile(const std::string& path) {
+    mappings.invalidate(path);
+    handles.invalidate(path);
+    compressedFiles.invalidate(path);
+}
+
+std::shared_ptr<const CompressedFile> FileSystem::openCompressed(const std::string& path) {
+    if (auto file = compressedFiles.find(path)) {
+        return file;
+    }
+    CompressedFile::Source source;
+    if (usesBlockStore()) {
+        // The layout is captured as of now; changing the file drops this entry
+        FileMetadata meta = blockStoreFile(path);
+        source = [store = extentStore.get(), layout = std::move(meta.layout), size = meta.size](
+                     void* buffer, size_t count, uint64_t offset) {
+            return store->readAt(layout, size, buffer, count, static_cast<size_t>(offset));
+        };
+    } else {
+        source = [handle = acquireHandle(path)](void* buffer, size_t count, uint64_t offset) {
+            return handle->readAt(buffer, count, static_cast<size_t>(offset));
+        };
+    }
+    try {
+        return compressedFiles.insert(path, CompressedFile::open(std::move(source)));
+    } catch (const std::runtime_error& e) {
+        throw FSException("Cannot read compressed file " + path + ": " + e.what());
+    }
+}
+
 FileMetadata FileSystem::resolvePath(const std::string& path) {
     LOG_DEBUG("Resolving path: " + path);
     return getMetadata(path);
@@ -384,11 +952,13 @@ FileMetadata FileSystem::resolvePath(const std::string& path) {
 // Cache control methods
 void FileSystem::clearCache() {
     enhancedCache->clear();
+    mappings.clear();
+    handles.clear();
     LOG_INFO("File system cache cleared");
 }
 
 size_t FileSystem::getCacheSize() const {
-    return enhancedCache->getStatistics().hits + enhancedCache->getStatistics().misses;
+    return enhancedCache->getStatistics().currentSize;
 }
 
 // Enhanced cache management methods
@@ -406,11 +976,38 @@ void FileSystem::resizeCache(size_t newCapacity) {
     LOG_INFO("Cache resized to: " + std::to_string(newCapacity));
 }
 
+void FileSystem::setCacheByteBudget(size_t bytes) {
+    enhancedCache->setCapacityMode(cache::CapacityMode::BYTES, bytes);
+    LOG_INFO("Cache byte budget set to: " + std::to_string(bytes));
+}
+
+void FileSystem::setCacheEntryLimit(size_t entries) {
+    enhancedCache->setCapacityMode(cache::CapacityMode::ENTRIES, entries);
+    LOG_INFO("Cache entry limit set to: " + std::to_string(entries));
+}
+
+cache::CapacityMode FileSystem::getCacheCapacityMode() const {
+    return enhancedCache->getCapacityMode();
+}
+
+void FileSystem::setMmapThreshold(size_t bytes) {
+    mmapThreshold = bytes;
+    LOG_INFO("Memory-mapped read threshold set to: " + std::to_string(bytes));
+}
+
+size_t FileSystem::getMmapThreshold() const {
+    return mmapThreshold;
+}
+
+size_t FileSystem::getOpenMappingCount() const {
+    return mappings.size();
+}
+
 void FileSystem::pinFile(const std::string& path) {
     try {
         // Ensure file is in cache first
         if (!enhancedCache->contains(path)) {
-            std::string data = readFile(path);
+            readFileShared(path);
         }
         enhancedCache->pin(path);
         LOG_DEBUG("File pinned in cache: " + path);
@@ -434,14 +1031,92 @@ void FileSystem::prefetchFile(const std::string& path) {
             return;
         }
         
-        std::string data = readFile(path);
-        enhancedCache->prefetch(path, data);
+        enhancedCache->prefetch(path, readFileShared(path));
         LOG_DEBUG("File prefetched: " + path);
     } catch (const std::exception& e) {
         LOG_ERROR("Failed to prefetch file: " + std::string(e.what()));
     }
 }
 
+// Reads straight into the cache without going through loadContents, so a
+// background load counts neither as a demand miss nor as an access to learn
+size_t FileSystem::prefetchLoad(const std::string& path) {
+    auto lock = pathLocks.lock(path, PathLockTable::Mode::Shared);
+    std::string contents;
+    if (enhancedCache->contains(path) || !readUncached(path, contents)) {
+        return 0;
+    }
+    size_t size = contents.size();
+    return enhancedCache->prefetchIfRoom(path, std::make_shared<const std::string>(std::move(contents))) ? size : 0;
+}
+
+bool FileSystem::readUncached(const std::string& path, std::string& contents) {
+    if (usesBlockStore()) {
+        FileMetadata meta;
+        if (!fileMetadataMap.find(path, meta) || meta.isDirectory) {
+            return false;
+        }
+        contents = extentStore->load(meta.layout, meta.size);
+    } else {
+        if (!pathExists(path) || lookupMetadata(path).isDirectory) {
+            return false;
+        }
+        auto handle = acquireHandle(path);
+        contents.assign(handle->size(), '\0');
+        contents.resize(handle->readAt(&contents[0], contents.size(), 0));
+    }
+    if (writeBack) {
+        writeBack->overlay(path, contents);
+    }
+    return true;
+}
+
+// Each file is read and cached under its own shared lock, as prefetchLoad
+// does, so a delete or write that follows cannot be undone by stale bytes.
+// Only free room is taken.
+CacheWarmer::BatchResult FileSystem::warmLoad(const std::vector<std::string>& paths) {
+    CacheWarmer::BatchResult result;
+    for (const auto& path : paths) {
+        auto lock = pathLocks.lock(path, PathLockTable::Mode::Shared);
+        std::string contents;
+        try {
+            if (enhancedCache->contains(path) || !readUncached(path, contents)) {
+                continue;
+            }
+        } catch (const std::exception& e) {
+            LOG_DEBUG("Cache warm-up skipped " + path + ": " + e.what());
+            continue;
+        }
+        result.bytes += contents.size();
+        if (enhancedCache->prefetchIfRoom(path, std::make_shared<const std::string>(std::move(contents)))) {
+            result.loaded++;
+        } else {
+            result.full = true;
+        }
+    }
+    return result;
+}
+
+CacheWarmer::Stats FileSystem::getWarmupStats() const {
+    return warmer ? warmer->getStats() : CacheWarmer::Stats{};
+}
+
+void FileSystem::waitForWarmup() {
+    if (warmer) {
+        warmer->wait();
+    }
+}
+
+PrefetchEngine::Stats FileSystem::getPrefetchStats() const {
+    return prefetcher ? prefetcher->getStats() : PrefetchEngine::Stats{};
+}
+
+void FileSystem::drainPrefetch() {
+    if (prefetcher) {
+        prefetcher->drain();
+    }
+}
+
 cache::CacheStatistics FileSystem::getCacheStatistics() const {
     return enhancedCache->getStatistics();
 }
@@ -457,13 +1132,14 @@ void FileSystem::showCacheAnalytics() const {
     
     // Get enhanced cache statistics for consistent reporting
     auto cacheStats = enhancedCache->getStatistics();
+    PerformanceStats current = getStats();
     std::cout << "File Operations:\n";
-    std::cout << "  Total Reads: " << this->stats.totalReads << "\n";
-    std::cout << "  Total Writes: " << this->stats.totalWrites << "\n";
+    std::cout << "  Total Reads: " << current.totalReads << "\n";
+    std::cout << "  Total Writes: " << current.totalWrites << "\n";
     std::cout << "  Enhanced Cache Hit Rate: " << std::fixed << std::setprecision(2) 
               << cacheStats.hitRate << "%\n";
     std::cout << "  Legacy Cache Hit Rate: " << std::fixed << std::setprecision(2) 
-              << this->stats.getCacheHitRate() << "%\n";
+              << current.getCacheHitRate() << "%\n";
     std::cout << "=============================================\n\n";
 }
 
@@ -475,24 +1151,8 @@ std::vector<std::string> FileSystem::getHotFiles(size_t count) const {
 bool FileSystem::copyFile(const std::string& source, const std::string& destination) {
     try {
         LOG_INFO("Copying file: " + source + " -> " + destination);
-        
-        // Check if source file exists
-        if (!exists(source)) {
-            throw FileNotFoundException(source);
-        }
-        
-        // Read source file content
-        std::string content = readFile(source);
-        
-        // Create destination file and write content
-        if (!createFile(destination)) {
-            throw FSException("Failed to create destination file: " + destination);
-        }
-        
-        if (!writeFile(destination, content)) {
-            throw FSException("Failed to write to destination file: " + destination);
-        }
-        
+        auto lock = pathLocks.lock(source, PathLockTable::Mode::Shared, destination, PathLockTable::Mode::Exclusive);
+        copyEntry(source, destination);
         LOG_INFO("File copied successfully: " + source + " -> " + destination);
         return true;
     } catch (const std::exception& e) {
@@ -501,19 +1161,196 @@ bool FileSystem::copyFile(const std::string& source, const std::string& destinat
     }
 }
 
+void FileSystem::copyEntry(const std::string& source, const std::string& destination) {
+    // Check if source file exists
+    if (!pathExists(source)) {
+        throw FileNotFoundException(source);
+    }
+    
+    requireLogin("read file");
+    requireOwner(source);
+    bool compressed = false;
+    fileMetadataMap.inspect(source, [&](const FileMetadata& meta) { compressed = meta.compressed; });
+    if (usesBlockStore() || (writeBack && writeBack->contains(source))) {
+        // Read source file content, buffered writes included; the destination
+        // caches the same buffer
+        SharedBuffer content = loadContents(source);
+        createEntry(destination);
+        storeContents(destination, content);
+    } else {
+        // Host files are written through, so the bytes on disk are current and
+        // the copy engine moves them without passing through the cache
+        createEntry(destination);
+        closeOpenFile(destination);
+        cacheRemove(destination);
+        CopyResult copied = CopyEngine::copy(rootPath + "/" + source, rootPath + "/" + destination);
+        LOG_DEBUG("Copied " + std::to_string(copied.bytes) + " bytes by " + copyMethodName(copied.method));
+        if (directoryIndex) {
+            directoryIndex->invalidate(destination);
+        }
+        // A cached source buffer is shared with the destination, as reads would load the same bytes
+        if (SharedBuffer cached = cachedContents(source); cached && cached->size() == copied.bytes) {
+            cachePut(destination, cached);
+        }
+        fileMetadataMap.update(destination, [&](FileMetadata& meta) {
+            meta.size = static_cast<size_t>(copied.bytes);
+            meta.modifiedAt = std::chrono::system_clock::now();
+        });
+    }
+    if (compressed) {
+        fileMetadataMap.upsert(destination, [](FileMetadata& meta) { meta.compressed = true; });
+    }
+    persistMetadata(destination);
+}
+
+std::vector<bool> FileSystem::writeBatch(const std::vector<std::pair<std::string, std::string>>& files) {
+    std::vector<std::string> targets;
+    std::vector<std::pair<std::string, PathLockTable::Mode>> locks;
+    for (const auto& file : files) {
+        targets.push_back(file.first);
+        locks.emplace_back(file.first, PathLockTable::Mode::Exclusive);
+    }
+    return runBatch("write files", targets, locks, [&](size_t i) {
+        const std::string& path = files[i].first;
+        if (!pathExists(path)) {
+            createEntry(path);
+        }
+        requireOwner(path);
+        storeContents(path, std::make_shared<const std::string>(files[i].second));
+        return true;
+    });
+}
+
+std::vector<bool> FileSystem::deleteBatch(const std::vector<std::string>& paths) {
+    std::vector<std::pair<std::string, PathLockTable::Mode>> locks;
+    for (const auto& path : paths) {
+        locks.emplace_back(path, PathLockTable::Mode::Exclusive);
+    }
+    return runBatch("delete files", paths, locks, [&](size_t i) { return removeEntry(paths[i]); });
+}
+
+std::vector<bool> FileSystem::copyBatch(const std::vector<std::pair<std::string, std::string>>& operations) {
+    std::vector<std::string> targets;
+    std::vector<std::pair<std::string, PathLockTable::Mode>> locks;
+    for (const auto& [source, destination] : operations) {
+        targets.push_back(destination);
+        locks.emplace_back(source, PathLockTable::Mode::Shared);
+        locks.emplace_back(destination, PathLockTable::Mode::Exclusive);
+    }
+    return runBatch("copy files", targets, locks, [&](size_t i) {
+        copyEntry(operations[i].first, operations[i].second);
+        return true;
+    });
+}
+
+FileSystem::Batch* FileSystem::currentBatch() const {
+    return activeBatch && activeBatch->owner == this ? activeBatch : nullptr;
+}
+
+std::vector<bool> FileSystem::runBatch(const std::string& action, const std::vector<std::string>& targets,
+                                       const std::vector<std::pair<std::string, PathLockTable::Mode>>& locks,
+                                       const std::function<bool(size_t)>& item) {
+    requireLogin(action);
+    Batch batch;
+    batch.owner = this;
+    if (authManager) {
+        batch.user = authManager->getCurrentUser();
+        batch.admin = authManager->isAdmin(batch.user);
+    }
+
+    // Neighbours in a directory are handled together
+    std::vector<size_t> order(targets.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        std::string parentA = parentPath(targets[a]);
+        std::string parentB = parentPath(targets[b]);
+        return parentA != parentB ? parentA < parentB : targets[a] < targets[b];
+    });
+
+    std::vector<bool> results(targets.size(), false);
+    size_t succeeded = 0;
+    auto lock = pathLocks.lock(locks);
+    struct Activation {
+        explicit Activation(Batch* batch) : previous(std::exchange(activeBatch, batch)) {}
+        ~Activation() { activeBatch = previous; }
+        Batch* previous;
+    };
+    {
+        Activation active(&batch);
+        for (size_t i : order) {
+            try {
+                results[i] = item(i);
+            } catch (const std::exception& e) {
+                LOG_ERROR("Batch failed to " + action + " at " + targets[i] + ": " + e.what());
+            }
+            succeeded += results[i] ? 1 : 0;
+        }
+    }
+
+    // Still under the path locks, so no reader sees the stale cache entries
+    std::vector<std::string> removed;
+    std::vector<std::pair<std::string, SharedBuffer>> stored;
+    for (auto& [path, data] : batch.cached) {
+        if (data) {
+            stored.emplace_back(path, std::move(data));
+        } else {
+            removed.push_back(path);
+        }
+    }
+    enhancedCache->removeAll(removed);
+    enhancedCache->putAll(stored);
+    if (commitMetadata(batch.persisted)) {
+        for (const auto& layout : batch.released) {
+            extentStore->release(layout);
+        }
+    } else {
+        LOG_ERROR("Batch " + action + " failed to commit its metadata");
+    }
+
+    LOG_INFO("Batch " + action + ": " + std::to_string(succeeded) + " of " + std::to_string(targets.size()) +
+             " succeeded");
+    return results;
+}
+
+void FileSystem::cachePut(const std::string& path, SharedBuffer data) {
+    if (Batch* batch = currentBatch()) {
+        batch->cached[path] = std::move(data);
+        return;
+    }
+    enhancedCache->put(path, std::move(data));
+}
+
+SharedBuffer FileSystem::cachedContents(const std::string& path) const {
+    if (Batch* batch = currentBatch()) {
+        auto pending = batch->cached.find(path);
+        if (pending != batch->cached.end()) {
+            return pending->second;
+        }
+    }
+    return enhancedCache->peek(path).value_or(nullptr);
+}
+
+void FileSystem::cacheRemove(const std::string& path) {
+    if (Batch* batch = currentBatch()) {
+        batch->cached[path] = nullptr;
+        return;
+    }
+    enhancedCache->remove(path);
+}
+
 bool FileSystem::moveFile(const std::string& source, const std::string& destination) {
     try {
         LOG_INFO("Moving file: " + source + " -> " + destination);
+        auto lock = pathLocks.lock(source, PathLockTable::Mode::Exclusive,
+                                   destination, PathLockTable::Mode::Exclusive);
         
         // Copy the file first
-        if (!copyFile(source, destination)) {
-            throw FSException("Failed to copy file during move operation");
-        }
+        copyEntry(source, destination);
         
         // Delete the source file
-        if (!deleteFile(source)) {
+        if (!removeEntry(source)) {
             // If delete fails, try to clean up the destination
-            deleteFile(destination);
+            removeEntry(destination);
             throw FSException("Failed to delete source file during move operation");
         }
         
@@ -535,71 +1372,36 @@ bool FileSystem::renameFile(const std::string& oldName, const std::string& newNa
     }
 }
 
-// Helper function for glob pattern matching
-bool FileSystem::matchesPattern(const std::string& filename, const std::string& pattern) {
-    // If pattern contains wildcards (* or ?), use glob matching
-    if (pattern.find('*') != std::string::npos || pattern.find('?') != std::string::npos) {
-        // Handle glob patterns with * and ?
-        size_t patternPos = 0;
-        size_t filenamePos = 0;
-        size_t starIdx = std::string::npos;
-        size_t match = 0;
-        
-        while (filenamePos < filename.length()) {
-            // If we have a direct character match or a '?' wildcard
-            if (patternPos < pattern.length() && 
-                (pattern[patternPos] == filename[filenamePos] || pattern[patternPos] == '?')) {
-                filenamePos++;
-                patternPos++;
-            }
-            // If we encounter a '*' wildcard
-            else if (patternPos < pattern.length() && pattern[patternPos] == '*') {
-                starIdx = patternPos;
-                match = filenamePos;
-                patternPos++;
-            }
-            // If we had a previous '*' wildcard, backtrack to it
-            else if (starIdx != std::string::npos) {
-                patternPos = starIdx + 1;
-                match++;
-                filenamePos = match;
-            }
-            // No match
-            else {
-                return false;
-            }
-        }
-        
-        // Skip any remaining '*' at the end of pattern
-        while (patternPos < pattern.length() && pattern[patternPos] == '*') {
-            patternPos++;
-        }
-        
-        return patternPos == pattern.length();
-    } else {
-        // For patterns without wildcards, do substring matching (like original behavior)
-        return filename.find(pattern) != std::string::npos;
-    }
-}
-
+// Recursive; a host-mode search walks the tree in parallel and matches
+// names as each directory is listed
 std::vector<std::string> FileSystem::findFiles(const std::string& pattern, const std::string& directory) {
     try {
         LOG_INFO("Searching for files with pattern: " + pattern + " in directory: " + directory);
-        
+        if (!pathExists(directory)) {
+            throw FileNotFoundException(directory);
+        }
+
+        GlobMatcher matcher(pattern);
+        std::string prefix = isRootPath(directory) ? std::string() : directory + "/";
         std::vector<std::string> results;
-        std::vector<std::string> files = listDirectory(directory);
-        
-        // Use glob pattern matching
-        for (const auto& file : files) {
-            if (matchesPattern(file, pattern)) {
-                if (directory == ".") {
-                    results.push_back(file);
-                } else {
-                    results.push_back(directory + "/" + file);
+        if (usesBlockStore()) {
+            fileMetadataMap.forEach([&](const std::string& entryPath, const FileMetadata&) {
+                if (entryPath.compare(0, prefix.size(), prefix) == 0 && entryPath.size() > prefix.size() &&
+                    matcher.matches(baseName(entryPath))) {
+                    results.push_back(entryPath);
                 }
-            }
+            });
+        } else {
+            WalkOptions options;
+            options.includeDirectories = true;
+            DirectoryWalker().walk(rootPath + "/" + directory, [&](const DirectoryEntry& entry) {
+                if (matcher.matches(entry.name())) {
+                    results.push_back(prefix + entry.path);
+                }
+            }, options);
         }
-        
+        std::sort(results.begin(), results.end());
+
         LOG_INFO("Found " + std::to_string(results.size()) + " files matching pattern: " + pattern);
         return results;
     } catch (const std::exception& e) {
@@ -620,18 +1422,66 @@ FileMetadata FileSystem::getFileInfo(const std::string& path) {
 
 // Performance monitoring methods
 PerformanceStats FileSystem::getStats() const {
-    return stats;
+    PerformanceStats current;
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        current.lastResetTime = statsResetTime;
+    }
+    auto hits = cacheHitLatency.snapshot();
+    auto misses = cacheMissLatency.snapshot();
+    auto writes = writeLatency.snapshot();
+    current.cacheHits = hits.count();
+    current.cacheMisses = misses.count();
+    current.totalReads = current.cacheHits + current.cacheMisses;
+    current.totalWrites = writes.count();
+    current.totalFileOperations = current.totalReads + current.totalWrites;
+    if (current.totalReads > 0) {
+        current.avgReadTime = (hits.mean() * hits.count() + misses.mean() * misses.count()) /
+                              current.totalReads / 1e6;
+    }
+    current.avgWriteTime = writes.mean() / 1e6;
+    auto handleStats = handles.getStatistics();
+    current.handleCacheHits = handleStats.hits;
+    current.handleCacheMisses = handleStats.misses;
+    current.handleEvictions = handleStats.evictions;
+    current.openHandles = handleStats.open;
+    return current;
+}
+
+LatencyReport FileSystem::getLatencyReport() const {
+    LatencyReport report;
+    report.cacheHit = cacheHitLatency.snapshot();
+    report.cacheMiss = cacheMissLatency.snapshot();
+    report.read = report.cacheHit;
+    report.read.merge(report.cacheMiss);
+    report.write = writeLatency.snapshot();
+    if (usesBlockStore()) {
+        report.blockRead = extentStore->getBlockManager().getReadLatency().snapshot();
+        report.blockWrite = extentStore->getBlockManager().getWriteLatency().snapshot();
+    }
+    return report;
 }
 
 void FileSystem::resetStats() {
-    stats = PerformanceStats();
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        statsResetTime = std::chrono::system_clock::now();
+    }
+    cacheHitLatency.reset();
+    cacheMissLatency.reset();
+    writeLatency.reset();
+    if (usesBlockStore()) {
+        extentStore->getBlockManager().resetLatency();
+    }
     enhancedCache->resetStatistics();
+    handles.resetStatistics();
     LOG_INFO("Performance statistics reset");
 }
 
 void FileSystem::showPerformanceDashboard() const {
+    PerformanceStats current = getStats();
     auto now = std::chrono::system_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - stats.lastResetTime);
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - current.lastResetTime);
     
     // Get enhanced cache statistics for accurate reporting
     auto cacheStats = enhancedCache->getStatistics();
@@ -644,27 +1494,122 @@ void FileSystem::showPerformanceDashboard() const {
     std::cout << "  Cache Hits: " << cacheStats.hits << "\n";
     std::cout << "  Cache Misses: " << cacheStats.misses << "\n";
     std::cout << "  Cache Hit Rate: " << std::fixed << std::setprecision(2) << cacheStats.hitRate << "%\n";
-    std::cout << "  Cache Size: " << (cacheStats.hits + cacheStats.misses > 0 ? enhancedCache->getHotKeys(1000).size() : 0) << "/" << CACHE_CAPACITY << "\n";
+    std::cout << "  Cache Size: " << cacheStats.currentSize << " entries\n";
+    std::cout << "  Resident Bytes: " << cacheStats.residentBytes << "\n";
     std::cout << "  Pinned Items: " << cacheStats.pinnedItems << "\n";
     std::cout << "  Prefetched Items: " << cacheStats.prefetchedItems << "\n";
+    std::cout << "  Prefetch Hit Rate: " << std::fixed << std::setprecision(2) << cacheStats.prefetchHitRate
+              << "%\n";
+    if (prefetcher) {
+        PrefetchEngine::Stats prefetchStats = prefetcher->getStats();
+        std::cout << "  Background Prefetches: " << prefetchStats.loaded << " of " << prefetchStats.scheduled
+                  << " admitted, " << prefetchStats.throttled << " throttled\n";
+    }
     std::cout << "-----------------------------------------------------------\n";
     std::cout << "FILE OPERATIONS:\n";
-    std::cout << "  Total Reads: " << stats.totalReads << "\n";
-    std::cout << "  Total Writes: " << stats.totalWrites << "\n";
-    std::cout << "  Total File Operations: " << stats.totalFileOperations << "\n";
-    std::cout << "  Average Read Time: " << std::fixed << std::setprecision(3) << stats.avgReadTime << " ms\n";
-    std::cout << "  Average Write Time: " << std::fixed << std::setprecision(3) << stats.avgWriteTime << " ms\n";
+    std::cout << "  Total Reads: " << current.totalReads << "\n";
+    std::cout << "  Total Writes: " << current.totalWrites << "\n";
+    std::cout << "  Total File Operations: " << current.totalFileOperations << "\n";
+    std::cout << "  Average Read Time: " << std::fixed << std::setprecision(3) << current.avgReadTime << " ms\n";
+    std::cout << "  Average Write Time: " << std::fixed << std::setprecision(3) << current.avgWriteTime << " ms\n";
+    std::cout << "-----------------------------------------------------------\n";
+    LatencyReport latency = getLatencyReport();
+    std::cout << "LATENCY (p50 / p99 / p99.9):\n";
+    for (const auto& [name, histogram] : latencyRows(latency)) {
+        if (histogram->count() > 0) {
+            std::cout << "  " << std::left << std::setw(12) << name << std::right
+                      << formatLatency(histogram->percentile(50)) << " / "
+                      << formatLatency(histogram->percentile(99)) << " / "
+                      << formatLatency(histogram->percentile(99.9)) << "\n";
+        }
+    }
+    std::cout << "-----------------------------------------------------------\n";
+    auto handleStats = handles.getStatistics();
+    std::cout << "FILE HANDLES:\n";
+    std::cout << "  Open Handles: " << handleStats.open << "\n";
+    std::cout << "  Handle Reuses: " << handleStats.hits << "\n";
+    std::cout << "  Handle Opens: " << handleStats.misses << "\n";
+    std::cout << "  Handle Evictions: " << handleStats.evictions << "\n";
     std::cout << "==========================================================\n\n";
 }
 
+void FileSystem::showLatencyHistograms() const {
+    LatencyReport latency = getLatencyReport();
+    std::cout << "\n==================== LATENCY HISTOGRAMS ====================\n";
+    for (const auto& [name, histogram] : latencyRows(latency)) {
+        std::cout << name << ": " << histogram->count() << " samples";
+        if (histogram->count() == 0) {
+            std::cout << "\n";
+            continue;
+        }
+        std::cout << ", mean " << formatLatency(static_cast<uint64_t>(histogram->mean()))
+                  << ", max " << formatLatency(histogram->max()) << "\n";
+        std::cout << "  p50 " << formatLatency(histogram->percentile(50))
+                  << "  p90 " << formatLatency(histogram->percentile(90))
+                  << "  p99 " << formatLatency(histogram->percentile(99))
+                  << "  p99.9 " << formatLatency(histogram->percentile(99.9)) << "\n";
+
+        // One bar per power of two
+        std::vector<std::pair<uint64_t, uint64_t>> octaves;
+        for (const auto& [lowerBound, count] : histogram->buckets()) {
+            uint64_t octave = 1;
+            while (octave <= lowerBound / 2) {
+                octave *= 2;
+            }
+            if (lowerBound == 0) {
+                octave = 0;
+            }
+            if (octaves.empty() || octaves.back().first != octave) {
+                octaves.emplace_back(octave, 0);
+            }
+            octaves.back().second += count;
+        }
+        uint64_t widest = 0;
+        for (const auto& octave : octaves) {
+            widest = std::max(widest, octave.second);
+        }
+        for (const auto& [octave, count] : octaves) {
+            size_t bar = static_cast<size_t>((count * 40 + widest - 1) / widest);
+            std::cout << "  >= " << std::setw(8) << formatLatency(octave) << " |" << std::string(bar, '#')
+                      << " " << count << "\n";
+        }
+    }
+    std::cout << "============================================================\n\n";
+}
+
 // File compression methods
 bool FileSystem::compressFile(const std::string& filePath) {
     try {
         LOG_INFO("Compressing file: " + filePath);
+        auto lock = pathLocks.lock(filePath, PathLockTable::Mode::Exclusive);
         
-        if (!exists(filePath)) {
+        if (!pathExists(filePath)) {
             throw FileNotFoundException(filePath);
         }
+        bool alreadyCompressed = false;
+        fileMetadataMap.inspect(filePath, [&](const FileMetadata& meta) { alreadyCompressed = meta.compressed; });
+        if (alreadyCompressed) {
+            throw FSException("File is already compressed: " + filePath);
+        }
+        flushWrites(filePath);
+
+        if (usesBlockStore()) {
+            requireLogin("write file");
+            requireOwner(filePath);
+            SharedBuffer original = loadContents(filePath);
+            auto compressed = FileCompression::compress(*original);
+            storeContents(filePath, std::make_shared<const std::string>(compressed.begin(), compressed.end()));
+            compressedFiles.invalidate(filePath);
+            fileMetadataMap.update(filePath, [](FileMetadata& meta) { meta.compressed = true; });
+            persistMetadata(filePath);
+            {
+                std::lock_guard<std::mutex> statsLock(statsMutex);
+                compressionStats.addCompressionOperation(original->size(), compressed.size());
+            }
+            double ratio = FileCompression::calculateCompressionRatio(original->size(), compressed.size());
+            LOG_INFO("File compressed successfully. Compression ratio: " + std::to_string(ratio) + "%");
+            return true;
+        }
         
         std::string fullPath = rootPath + "/" + filePath;
         std::string compressedPath = fullPath + ".mtfs";
@@ -685,11 +1630,26 @@ bool FileSystem::compressFile(const std::string& filePath) {
         compressedFile.close();
         
         // Update statistics
-        compressionStats.addCompressionOperation(originalSize, compressedSize);
+        {
+            std::lock_guard<std::mutex> statsLock(statsMutex);
+            compressionStats.addCompressionOperation(originalSize, compressedSize);
+        }
         
         // Remove original file and rename compressed file
+        closeOpenFile(filePath);
+        enhancedCache->remove(filePath);
         std::remove(fullPath.c_str());
         std::rename(compressedPath.c_str(), fullPath.c_str());
+        if (directoryIndex) {
+            directoryIndex->invalidate(filePath);
+        }
+
+        fileMetadataMap.upsert(filePath, [&](FileMetadata& meta) {
+            meta.size = compressedSize;
+            meta.compressed = true;
+            meta.modifiedAt = std::chrono::system_clock::now();
+        });
+        persistMetadata(filePath);
         
         double ratio = FileCompression::calculateCompressionRatio(originalSize, compressedSize);
         LOG_INFO("File compressed successfully. Compression ratio: " + std::to_string(ratio) + "%");
@@ -704,11 +1664,26 @@ bool FileSystem::compressFile(const std::string& filePath) {
 bool FileSystem::decompressFile(const std::string& filePath) {
     try {
         LOG_INFO("Decompressing file: " + filePath);
+        auto lock = pathLocks.lock(filePath, PathLockTable::Mode::Exclusive);
         
-        if (!exists(filePath)) {
+        if (!pathExists(filePath)) {
             throw FileNotFoundException(filePath);
         }
         
+        if (usesBlockStore()) {
+            requireLogin("write file");
+            requireOwner(filePath);
+            SharedBuffer compressed = loadContents(filePath);
+            if (!FileCompression::isCompressedData(*compressed)) {
+                throw FSException("File is not compressed: " + filePath);
+            }
+            storeContents(filePath, std::make_shared<const std::string>(FileCompression::decompress(
+                std::vector<uint8_t>(compressed->begin(), compressed->end()))));
+            compressedFiles.invalidate(filePath);
+            LOG_INFO("File decompressed successfully: " + filePath);
+            return true;
+        }
+
         std::string fullPath = rootPath + "/" + filePath;
         
         // Check if file is actually compressed
@@ -724,8 +1699,23 @@ bool FileSystem::decompressFile(const std::string& filePath) {
         }
         
         // Replace original with decompressed
+        closeOpenFile(filePath);
+        enhancedCache->remove(filePath);
         std::remove(fullPath.c_str());
         std::rename(tempPath.c_str(), fullPath.c_str());
+        if (directoryIndex) {
+            directoryIndex->invalidate(filePath);
+        }
+
+        std::ifstream decompressed(fullPath, std::ios::binary | std::ios::ate);
+        size_t decompressedSize = static_cast<size_t>(decompressed.tellg());
+        if (fileMetadataMap.update(filePath, [&](FileMetadata& meta) {
+                meta.size = decompressedSize;
+                meta.compressed = false;
+                meta.modifiedAt = std::chrono::system_clock::now();
+            })) {
+            persistMetadata(filePath);
+        }
         
         LOG_INFO("File decompressed successfully: " + filePath);
         return true;
@@ -736,11 +1726,15 @@ bool FileSystem::decompressFile(const std::string& filePath) {
 }
 
 CompressionStats FileSystem::getCompressionStats() const {
+    std::lock_guard<std::mutex> lock(statsMutex);
     return compressionStats;
 }
 
 void FileSystem::resetCompressionStats() {
-    compressionStats = CompressionStats();
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        compressionStats = CompressionStats();
+    }
     LOG_INFO("Compression statistics reset");
 }
 
@@ -752,6 +1746,7 @@ bool FileSystem::createBackup(const std::string& backupName) {
         }
         
         LOG_INFO("Creating backup: " + backupName);
+        flushAllWrites();  // The backup reads the host files
         return backupManager->createBackup(backupName, rootPath);
     } catch (const std::exception& e) {
         LOG_ERROR("Error creating backup: " + std::string(e.what()));
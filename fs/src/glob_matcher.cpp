@@ -0,0 +1,257 @@
+#include "fs/glob_matcher.hpp"
+#include "common/error.hpp"
+
+namespace mtfs::fs {
+
+using namespace mtfs::common;
+
+namespace {
+
+// End of the class opened at `open`, or npos when it is unclosed. A ']'
+// first in the class, after any negation, is a member.
+size_t classEnd(const std::string& glob, size_t open) {
+    size_t i = open + 1;
+    if (i < glob.size() && (glob[i] == '!' || glob[i] == '^')) {
+        ++i;
+    }
+    if (i < glob.size() && glob[i] == ']') {
+        ++i;
+    }
+    while (i < glob.size() && glob[i] != ']') {
+        ++i;
+    }
+    return i < glob.size() ? i : std::string::npos;
+}
+
+// Expands the first brace group that has a top-level comma, recursively,
+// so "{a,b}{c,d}" gives four alternatives. Braces inside [...] are members.
+void expandBraces(const std::string& glob, std::vector<std::string>& out) {
+    for (size_t open = 0; open < glob.size(); ++open) {
+        if (glob[open] == '[') {
+            size_t end = classEnd(glob, open);
+            if (end != std::string::npos) {
+                open = end;
+            }
+            continue;
+        }
+        if (glob[open] != '{') {
+            continue;
+        }
+
+        int depth = 0;
+        size_t close = std::string::npos;
+        std::vector<size_t> commas;
+        for (size_t i = open; i < glob.size() && close == std::string::npos; ++i) {
+            if (glob[i] == '[') {
+                size_t end = classEnd(glob, i);
+                if (end != std::string::npos) {
+                    i = end;
+                }
+            } else if (glob[i] == '{') {
+                depth++;
+            } else if (glob[i] == '}' && --depth == 0) {
+                close = i;
+            } else if (glob[i] == ',' && depth == 1) {
+                commas.push_back(i);
+            }
+        }
+        if (close == std::string::npos || commas.empty()) {
+            continue;  // Literal brace; a group nested inside may still expand
+        }
+
+        std::string prefix = glob.substr(0, open);
+        std::string suffix = glob.substr(close + 1);
+        commas.push_back(close);
+        size_t start = open + 1;
+        for (size_t comma : commas) {
+            expandBraces(prefix + glob.substr(start, comma - start) + suffix, out);
+            start = comma + 1;
+        }
+        return;
+    }
+    if (out.size() >= GlobMatcher::MAX_ALTERNATIVES) {
+        throw FSException("Glob pattern has too many brace alternatives: " + glob);
+    }
+    out.push_back(glob);
+}
+
+} // namespace
+
+GlobMatcher::GlobMatcher(const std::string& pattern) : source(pattern) {
+    std::vector<std::string> globs;
+    expandBraces(pattern, globs);
+    for (const auto& glob : globs) {
+        alternatives.push_back(compile(glob));
+    }
+
+    // Nothing to interpret: keep the substring search findFiles always did
+    if (alternatives.size() == 1 && alternatives[0].segments.size() == 1 && alternatives[0].anchoredStart &&
+        alternatives[0].anchoredEnd && alternatives[0].segments[0].isLiteral) {
+        substring = true;
+    }
+}
+
+GlobMatcher::Alternative GlobMatcher::compile(const std::string& glob) {
+    Alternative alternative;
+    Segment current;
+    bool starSeen = false;
+    auto endSegment = [&](bool atStar) {
+        if (current.atoms.empty()) {
+            // Only the ends are significant: "*x" floats the start, "x*" the end
+            if (atStar && !starSeen) {
+                alternative.anchoredStart = false;
+            } else if (!atStar && starSeen) {
+                alternative.anchoredEnd = false;
+            }
+            if (!(atStar || starSeen)) {
+                alternative.segments.push_back(std::move(current));  // Whole pattern is empty
+            }
+        } else {
+            alternative.minLength += current.atoms.size();
+            alternative.segments.push_back(std::move(current));
+        }
+        current = Segment{};
+    };
+    auto add = [&](Atom atom) {
+        if (atom.kind == Atom::Kind::Literal) {
+            current.literal += atom.literal;
+        } else {
+            current.isLiteral = false;
+        }
+        current.atoms.push_back(atom);
+    };
+
+    for (size_t i = 0; i < glob.size(); ++i) {
+        char c = glob[i];
+        if (c == '*') {
+            endSegment(true);
+            starSeen = true;
+            while (i + 1 < glob.size() && glob[i + 1] == '*') {
+                ++i;
+            }
+        } else if (c == '?') {
+            add({Atom::Kind::AnyChar, 0, 0});
+        } else if (c == '[' && classEnd(glob, i) != std::string::npos) {
+            size_t end = classEnd(glob, i);
+            size_t j = i + 1;
+            bool negate = glob[j] == '!' || glob[j] == '^';
+            if (negate) {
+                ++j;
+            }
+            std::bitset<256> members;
+            while (j < end) {
+                auto low = static_cast<unsigned char>(glob[j]);
+                if (j + 2 < end && glob[j + 1] == '-') {
+                    auto high = static_cast<unsigned char>(glob[j + 2]);
+                    for (unsigned value = low; value <= high; ++value) {
+                        members.set(value);
+                    }
+                    j += 3;
+                } else {
+                    members.set(low);
+                    ++j;
+                }
+            }
+            if (negate) {
+                members.flip();
+            }
+            alternative.sets.push_back(members);
+            add({Atom::Kind::Set, 0, alternative.sets.size() - 1});
+            i = end;
+        } else {
+            add({Atom::Kind::Literal, c, 0});
+        }
+    }
+    endSegment(false);
+    return alternative;
+}
+
+bool GlobMatcher::matches(std::string_view name) const {
+    if (substring) {
+        return name.find(alternatives[0].segments[0].literal) != std::string_view::npos;
+    }
+    for (const auto& alternative : alternatives) {
+        if (alternative.matches(name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool GlobMatcher::Alternative::matchesAt(const Segment& segment, std::string_view name, size_t at) const {
+    if (segment.isLiteral) {
+        return name.compare(at, segment.literal.size(), segment.literal) == 0;
+    }
+    for (size_t i = 0; i < segment.atoms.size(); ++i) {
+        const Atom& atom = segment.atoms[i];
+        char c = name[at + i];
+        if ((atom.kind == Atom::Kind::Literal && c != atom.literal) ||
+            (atom.kind == Atom::Kind::Set && !sets[atom.set].test(static_cast<unsigned char>(c)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t GlobMatcher::Alternative::find(const Segment& segment, std::string_view name, size_t from) const {
+    if (segment.isLiteral) {
+        return name.find(segment.literal, from);
+    }
+    size_t length = segment.atoms.size();
+    const Atom& first = segment.atoms[0];
+    for (size_t at = from; at + length <= name.size(); ++at) {
+        if (first.kind == Atom::Kind::Literal) {
+            // Skip straight to the next place the segment can start
+            at = name.find(first.literal, at);
+            if (at == std::string_view::npos || at + length > name.size()) {
+                return std::string_view::npos;
+            }
+        }
+        if (matchesAt(segment, name, at)) {
+            return at;
+        }
+    }
+    return std::string_view::npos;
+}
+
+// Segments between stars are searched leftmost-first: taking the earliest
+// place a fixed-length segment fits leaves the most room for the rest
+bool GlobMatcher::Alternative::matches(std::string_view name) const {
+    if (name.size() < minLength) {
+        return false;
+    }
+    bool starred = !anchoredStart || !anchoredEnd || segments.size() > 1;
+    if (!starred) {
+        return segments[0].atoms.size() == name.size() && matchesAt(segments[0], name, 0);
+    }
+
+    size_t first = 0;
+    size_t last = segments.size();
+    size_t position = 0;
+    if (anchoredStart) {
+        if (!matchesAt(segments[0], name, 0)) {
+            return false;
+        }
+        position = segments[0].atoms.size();
+        first = 1;
+    }
+    if (anchoredEnd) {
+        const Segment& tail = segments.back();
+        size_t tailStart = name.size() - tail.atoms.size();
+        if (tailStart < position || !matchesAt(tail, name, tailStart)) {
+            return false;
+        }
+        name = name.substr(0, tailStart);
+        last--;
+    }
+    for (size_t i = first; i < last; ++i) {
+        size_t at = find(segments[i], name, position);
+        if (at == std::string_view::npos) {
+            return false;
+        }
+        position = at + segments[i].atoms.size();
+    }
+    return true;
+}
+
+} // namespace mtfs::fs
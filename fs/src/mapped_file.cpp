@@ -0,0 +1,97 @@
+#include "fs/mapped_file.hpp"
+#include "common/logger.hpp"
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mtfs::fs {
+
+using namespace mtfs::common;
+
+std::shared_ptr<const MappedFile> MappedFile::open(const std::string& fullPath) {
+    std::shared_ptr<MappedFile> file(new MappedFile());
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(fullPath.c_str(), GENERIC_READ,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        throw FSException("Failed to open file for mapping: " + fullPath);
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize)) {
+        CloseHandle(handle);
+        throw FSException("Failed to size file for mapping: " + fullPath);
+    }
+    file->length = static_cast<size_t>(fileSize.QuadPart);
+    if (file->length > 0) {
+        // The view keeps the section and file alive, so both handles can go
+        HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(handle);
+        if (!mapping) {
+            throw FSException("Failed to create file mapping: " + fullPath);
+        }
+        file->view = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+        if (!file->view) {
+            throw FSException("Failed to map view of file: " + fullPath);
+        }
+    } else {
+        CloseHandle(handle);
+    }
+#else
+    int fd = ::open(fullPath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw FSException("Failed to open file for mapping: " + fullPath);
+    }
+    struct stat fileStats;
+    if (fstat(fd, &fileStats) != 0) {
+        ::close(fd);
+        throw FSException("Failed to size file for mapping: " + fullPath);
+    }
+    file->length = static_cast<size_t>(fileStats.st_size);
+    if (file->length > 0) {
+        void* view = mmap(nullptr, file->length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) {
+            throw FSException("Failed to map file: " + fullPath);
+        }
+        file->view = static_cast<const char*>(view);
+    } else {
+        ::close(fd);
+    }
+#endif
+
+    LOG_DEBUG("Mapped " + std::to_string(file->length) + " bytes: " + fullPath);
+    return file;
+}
+
+MappedFile::~MappedFile() {
+    if (!view) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(view);
+#else
+    munmap(const_cast<char*>(view), length);
+#endif
+}
+
+size_t MappedFile::read(void* buffer, size_t count, size_t offset) const {
+    if (offset >= length) {
+        return 0;
+    }
+    size_t available = std::min(count, length - offset);
+    std::memcpy(buffer, view + offset, available);
+    return available;
+}
+
+} // namespace mtfs::fs
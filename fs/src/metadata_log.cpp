@@ -0,0 +1,421 @@
+#include "fs/metadata_log.hpp"
+#include "common/checksum.hpp"
+#include "common/logger.hpp"
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+
+namespace mtfs::fs {
+
+using namespace mtfs::common;
+
+namespace {
+
+// Little helpers for the fixed-width binary encoding used by the log
+class ByteWriter {
+public:
+    explicit ByteWriter(std::vector<uint8_t>& buffer) : buffer(buffer) {}
+
+    template<typename T>
+    void put(T value) {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    // A wrapped length would still pass the record's CRC and decode as garbage
+    void putString(const std::string& value) {
+        if (value.size() > MetadataLog::MAX_STRING_LENGTH) {
+            throw FSException("Metadata string of " + std::to_string(value.size()) + " bytes is too long: " +
+                              value.substr(0, 64) + "...");
+        }
+        put(static_cast<uint16_t>(value.size()));
+        buffer.insert(buffer.end(), value.begin(), value.end());
+    }
+
+    void putBlob(const std::string& value) {
+        put(static_cast<uint32_t>(value.size()));
+        buffer.insert(buffer.end(), value.begin(), value.end());
+    }
+
+private:
+    std::vector<uint8_t>& buffer;
+};
+
+class ByteReader {
+public:
+    explicit ByteReader(const std::vector<uint8_t>& buffer) : buffer(buffer) {}
+
+    template<typename T>
+    bool get(T& value) {
+        if (position + sizeof(T) > buffer.size()) return false;
+        std::memcpy(&value, buffer.data() + position, sizeof(T));
+        position += sizeof(T);
+        return true;
+    }
+
+    bool getString(std::string& value) {
+        uint16_t length = 0;
+        if (!get(length) || position + length > buffer.size()) return false;
+        value.assign(reinterpret_cast<const char*>(buffer.data() + position), length);
+        position += length;
+        return true;
+    }
+
+    bool getBlob(std::string& value) {
+        uint32_t length = 0;
+        if (!get(length) || length > buffer.size() - position) return false;
+        value.assign(reinterpret_cast<const char*>(buffer.data() + position), length);
+        position += length;
+        return true;
+    }
+
+    bool atEnd() const { return position == buffer.size(); }
+
+private:
+    const std::vector<uint8_t>& buffer;
+    size_t position{0};
+};
+
+int64_t toTicks(const std::chrono::system_clock::time_point& time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point fromTicks(int64_t ticks) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(ticks)));
+}
+
+} // namespace
+
+MetadataLog::MetadataLog(const std::string& basePath)
+    : snapshotPath(basePath), logPath(basePath + ".log") {}
+
+MetadataLog::~MetadataLog() {
+    flush();
+}
+
+bool MetadataLog::load(MetadataMap& metadata) {
+    metadata.clear();
+    logStream.close();
+
+    bool legacyFormat = false;
+    bool haveSnapshot = loadSnapshot(metadata, legacyFormat);
+    bool haveLog = replayLog(metadata);
+
+    // Convert a legacy text snapshot (or an oversized log) right away so the
+    // next mount only has to read binary records.
+    if (legacyFormat || needsCompaction(metadata.size())) {
+        compact(metadata);
+    } else {
+        openLogForAppend();
+    }
+
+    LOG_INFO("Loaded metadata for " + std::to_string(metadata.size()) + " entries (" +
+             std::to_string(logRecords) + " log records pending compaction)");
+    return haveSnapshot || haveLog;
+}
+
+bool MetadataLog::appendPut(const std::string& path, const FileMetadata& metadata) {
+    if (!logStream.is_open() && !openLogForAppend()) return false;
+    if (!writeRecord(logStream, RecordType::PUT, path, &metadata)) return false;
+    logStream.flush();
+    ++logRecords;
+    return logStream.good();
+}
+
+bool MetadataLog::appendErase(const std::string& path) {
+    if (!logStream.is_open() && !openLogForAppend()) return false;
+    if (!writeRecord(logStream, RecordType::ERASE, path, nullptr)) return false;
+    logStream.flush();
+    ++logRecords;
+    return logStream.good();
+}
+
+bool MetadataLog::appendBatch(const std::vector<std::pair<std::string, const FileMetadata*>>& records) {
+    if (records.empty()) return true;
+    if (!logStream.is_open() && !openLogForAppend()) return false;
+    for (const auto& [path, metadata] : records) {
+        if (!writeRecord(logStream, metadata ? RecordType::PUT : RecordType::ERASE, path, metadata)) return false;
+        ++logRecords;
+    }
+    logStream.flush();
+    return logStream.good();
+}
+
+bool MetadataLog::compact(const MetadataMap& metadata) {
+    std::string tempPath = snapshotPath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            LOG_ERROR("Failed to open metadata snapshot for writing: " + tempPath);
+            return false;
+        }
+
+        uint32_t magic = SNAPSHOT_MAGIC;
+        uint16_t version = FORMAT_VERSION;
+        uint64_t count = metadata.size();
+        out.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+        out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+
+        for (const auto& [path, meta] : metadata) {
+            if (!writeRecord(out, RecordType::PUT, path, &meta)) {
+                return false;
+            }
+        }
+        out.flush();
+        if (!out) {
+            LOG_ERROR("Failed to write metadata snapshot: " + tempPath);
+            return false;
+        }
+    }
+
+    // Publish the snapshot before discarding the log; replaying a stale log
+    // over a newer snapshot yields the same map.
+    std::error_code ec;
+    std::filesystem::rename(tempPath, snapshotPath, ec);
+    if (ec) {
+        LOG_ERROR("Failed to publish metadata snapshot: " + ec.message());
+        return false;
+    }
+
+    logStream.close();
+    logStream.open(logPath, std::ios::binary | std::ios::trunc);
+    logRecords = 0;
+    return logStream.good();
+}
+
+bool MetadataLog::needsCompaction(size_t liveEntries) const {
+    return logRecords > std::max(MIN_COMPACTION_RECORDS, COMPACTION_FACTOR * liveEntries);
+}
+
+void MetadataLog::flush() {
+    if (logStream.is_open()) {
+        logStream.flush();
+    }
+}
+
+bool MetadataLog::openLogForAppend() {
+    logStream.open(logPath, std::ios::binary | std::ios::app);
+    if (!logStream) {
+        LOG_ERROR("Failed to open metadata log: " + logPath);
+    }
+    return logStream.good();
+}
+
+bool MetadataLog::loadSnapshot(MetadataMap& metadata, bool& legacyFormat) {
+    std::ifstream in(snapshotPath, std::ios::binary);
+    if (!in) return false;
+
+    uint32_t magic = 0;
+    uint16_t version = 0;
+    uint64_t count = 0;
+    in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    if (!in || magic != SNAPSHOT_MAGIC) {
+        in.close();
+        legacyFormat = true;
+        return loadLegacySnapshot(metadata);
+    }
+
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!in || version != FORMAT_VERSION) {
+        LOG_ERROR("Unsupported metadata snapshot version in: " + snapshotPath);
+        return false;
+    }
+
+    metadata.reserve(static_cast<size_t>(count));
+    std::vector<uint8_t> payload;
+    for (uint64_t i = 0; i < count; ++i) {
+        uint32_t header[3];
+        in.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (!in || header[0] != RECORD_MAGIC || header[1] > MAX_RECORD_SIZE) {
+            LOG_ERROR("Metadata snapshot is truncated or corrupt: " + snapshotPath);
+            return false;
+        }
+        payload.resize(header[1]);
+        in.read(reinterpret_cast<char*>(payload.data()), header[1]);
+        if (!in || crc32(payload.data(), payload.size()) != header[2]) {
+            LOG_ERROR("Metadata snapshot checksum mismatch: " + snapshotPath);
+            return false;
+        }
+
+        RecordType type;
+        std::string path;
+        FileMetadata meta;
+        if (decodePayload(payload, type, path, meta) && type == RecordType::PUT) {
+            metadata[path] = std::move(meta);
+        }
+    }
+    return true;
+}
+
+bool MetadataLog::loadLegacySnapshot(MetadataMap& metadata) {
+    std::ifstream ifs(snapshotPath);
+    if (!ifs) return false;
+    std::string path, owner;
+    uint32_t permissions;
+    std::size_t size;
+    int isDir;
+    while (ifs >> path >> owner >> permissions >> size >> isDir) {
+        FileMetadata meta;
+        meta.name = path;
+        meta.owner = owner;
+        meta.permissions = permissions;
+        meta.size = size;
+        meta.isDirectory = (isDir != 0);
+        metadata[path] = meta;
+    }
+    LOG_INFO("Converting legacy metadata file: " + snapshotPath);
+    return true;
+}
+
+bool MetadataLog::replayLog(MetadataMap& metadata) {
+    logRecords = 0;
+    std::ifstream in(logPath, std::ios::binary);
+    if (!in) return false;
+
+    std::vector<uint8_t> payload;
+    std::streamoff validEnd = 0;
+    while (true) {
+        uint32_t header[3];
+        in.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (!in) break;
+        if (header[0] != RECORD_MAGIC || header[1] > MAX_RECORD_SIZE) break;
+
+        payload.resize(header[1]);
+        in.read(reinterpret_cast<char*>(payload.data()), header[1]);
+        if (!in || crc32(payload.data(), payload.size()) != header[2]) break;
+
+        RecordType type;
+        std::string path;
+        FileMetadata meta;
+        if (!decodePayload(payload, type, path, meta)) break;
+
+        if (type == RecordType::PUT) {
+            metadata[path] = std::move(meta);
+        } else {
+            metadata.erase(path);
+        }
+        ++logRecords;
+        validEnd += static_cast<std::streamoff>(RECORD_HEADER_SIZE + header[1]);
+    }
+    in.close();
+
+    // Drop a torn record left by a crash mid-append so new records follow
+    // the last valid one.
+    std::error_code ec;
+    auto fileSize = std::filesystem::file_size(logPath, ec);
+    if (!ec && static_cast<std::streamoff>(fileSize) > validEnd) {
+        LOG_ERROR("Discarding torn tail of metadata log: " + logPath);
+        std::filesystem::resize_file(logPath, static_cast<uintmax_t>(validEnd), ec);
+    }
+    return true;
+}
+
+bool MetadataLog::writeRecord(std::ostream& out, RecordType type, const std::string& path,
+                              const FileMetadata* metadata) {
+    auto payload = encodePayload(type, path, metadata);
+    uint32_t header[3] = {
+        RECORD_MAGIC,
+        static_cast<uint32_t>(payload.size()),
+        crc32(payload.data(), payload.size())
+    };
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+    return out.good();
+}
+
+std::vector<uint8_t> MetadataLog::encodePayload(RecordType type, const std::string& path,
+                                                const FileMetadata* metadata) {
+    std::vector<uint8_t> payload;
+    payload.reserve(64 + path.size() + (metadata ? metadata->layout.inlineData.size() : 0));
+    ByteWriter writer(payload);
+    writer.put(static_cast<uint8_t>(type));
+    writer.putString(path);
+    if (type == RecordType::PUT && metadata) {
+        writer.putString(metadata->name);
+        writer.putString(metadata->owner);
+        writer.putString(metadata->group);
+        writer.put(static_cast<uint32_t>(metadata->permissions));
+        writer.put(static_cast<uint64_t>(metadata->size));
+        writer.put(static_cast<uint8_t>(metadata->isDirectory ? 1 : 0));
+        writer.put(toTicks(metadata->createdAt));
+        writer.put(toTicks(metadata->modifiedAt));
+        // Block store placement; records without it describe host files.
+        // Flags follow the placement, so records without them read as zero.
+        uint8_t flags = metadata->compressed ? FLAG_COMPRESSED : 0;
+        if (!metadata->layout.empty() || flags != 0) {
+            writer.put(static_cast<uint32_t>(metadata->layout.extents.size()));
+            for (const auto& extent : metadata->layout.extents) {
+                writer.put(extent.firstBlock);
+                writer.put(extent.blockCount);
+            }
+            writer.putBlob(metadata->layout.inlineData);
+        }
+        if (flags != 0) {
+            writer.put(flags);
+        }
+    }
+    return payload;
+}
+
+bool MetadataLog::decodePayload(const std::vector<uint8_t>& payload, RecordType& type,
+                                std::string& path, FileMetadata& metadata) {
+    ByteReader reader(payload);
+    uint8_t rawType = 0;
+    if (!reader.get(rawType) || !reader.getString(path)) return false;
+    type = static_cast<RecordType>(rawType);
+
+    if (type == RecordType::ERASE) {
+        return reader.atEnd();
+    }
+    if (type != RecordType::PUT) {
+        return false;
+    }
+
+    uint32_t permissions = 0;
+    uint64_t size = 0;
+    uint8_t isDirectory = 0;
+    int64_t createdAt = 0;
+    int64_t modifiedAt = 0;
+    if (!reader.getString(metadata.name) || !reader.getString(metadata.owner) ||
+        !reader.getString(metadata.group) || !reader.get(permissions) || !reader.get(size) ||
+        !reader.get(isDirectory) || !reader.get(createdAt) || !reader.get(modifiedAt)) {
+        return false;
+    }
+    metadata.permissions = permissions;
+    metadata.size = static_cast<std::size_t>(size);
+    metadata.isDirectory = isDirectory != 0;
+    metadata.createdAt = fromTicks(createdAt);
+    metadata.modifiedAt = fromTicks(modifiedAt);
+    if (reader.atEnd()) {
+        return true;
+    }
+
+    uint32_t extentCount = 0;
+    if (!reader.get(extentCount) || extentCount > payload.size() / sizeof(Extent)) {
+        return false;
+    }
+    metadata.layout.extents.resize(extentCount);
+    for (auto& extent : metadata.layout.extents) {
+        if (!reader.get(extent.firstBlock) || !reader.get(extent.blockCount)) {
+            return false;
+        }
+    }
+    if (!reader.getBlob(metadata.layout.inlineData)) {
+        return false;
+    }
+    if (reader.atEnd()) {
+        return true;
+    }
+    uint8_t flags = 0;
+    if (!reader.get(flags)) {
+        return false;
+    }
+    metadata.compressed = (flags & FLAG_COMPRESSED) != 0;
+    return reader.atEnd();
+}
+
+} // namespace mtfs::fs
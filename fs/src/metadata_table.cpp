@@ -0,0 +1,62 @@
+#include "fs/metadata_table.hpp"
+#include <functional>
+
+namespace mtfs::fs {
+
+MetadataTable::Shard& MetadataTable::shardOf(const std::string& path) {
+    return shards[std::hash<std::string>{}(path) % SHARDS];
+}
+
+const MetadataTable::Shard& MetadataTable::shardOf(const std::string& path) const {
+    return shards[std::hash<std::string>{}(path) % SHARDS];
+}
+
+bool MetadataTable::find(const std::string& path, FileMetadata& metadata) const {
+    return inspect(path, [&](const FileMetadata& entry) { metadata = entry; });
+}
+
+bool MetadataTable::contains(const std::string& path) const {
+    const Shard& shard = shardOf(path);
+    std::shared_lock<std::shared_mutex> lock(shard.lock);
+    return shard.entries.count(path) != 0;
+}
+
+void MetadataTable::put(const std::string& path, const FileMetadata& metadata) {
+    Shard& shard = shardOf(path);
+    std::unique_lock<std::shared_mutex> lock(shard.lock);
+    shard.entries[path] = metadata;
+}
+
+bool MetadataTable::erase(const std::string& path) {
+    Shard& shard = shardOf(path);
+    std::unique_lock<std::shared_mutex> lock(shard.lock);
+    return shard.entries.erase(path) != 0;
+}
+
+MetadataTable::MetadataMap MetadataTable::snapshot() const {
+    MetadataMap all;
+    all.reserve(size());
+    forEach([&](const std::string& path, const FileMetadata& metadata) { all.emplace(path, metadata); });
+    return all;
+}
+
+void MetadataTable::assign(const MetadataMap& metadata) {
+    for (auto& shard : shards) {
+        std::unique_lock<std::shared_mutex> lock(shard.lock);
+        shard.entries.clear();
+    }
+    for (const auto& [path, entry] : metadata) {
+        put(path, entry);
+    }
+}
+
+size_t MetadataTable::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard.lock);
+        total += shard.entries.size();
+    }
+    return total;
+}
+
+} // namespace mtfs::fs
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include "fs/file_index.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace mtfs::fs {
+
+// Platform file attributes to a FileStamp. FileStamp::of and the directory
+// walker both go through here, so a stamp taken either way compares equal.
+#ifdef _WIN32
+// FILETIME counts 100ns intervals since 1601
+inline int64_t fileTimeToNs(const FILETIME& time) {
+    uint64_t ticks = (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    return (static_cast<int64_t>(ticks) - 116444736000000000LL) * 100;
+}
+
+// A file ID would need a handle and is left at 0
+inline FileStamp stampFromAttributes(DWORD sizeHigh, DWORD sizeLow, const FILETIME& lastWrite) {
+    FileStamp stamp;
+    stamp.size = (static_cast<uint64_t>(sizeHigh) << 32) | sizeLow;
+    stamp.modifiedNs = fileTimeToNs(lastWrite);
+    stamp.fileId = 0;
+    return stamp;
+}
+
+// Mode bits as _stat reports them: write unless read-only, execute for directories
+inline uint32_t permissionsFromAttributes(DWORD attributes) {
+    uint32_t permissions = (attributes & FILE_ATTRIBUTE_READONLY) ? 0444 : 0666;
+    return (attributes & FILE_ATTRIBUTE_DIRECTORY) ? permissions | 0111 : permissions;
+}
+#else
+inline int64_t changeTimeNs(const struct stat& info) {
+#ifdef __APPLE__
+    return static_cast<int64_t>(info.st_ctimespec.tv_sec) * 1000000000LL + info.st_ctimespec.tv_nsec;
+#else
+    return static_cast<int64_t>(info.st_ctim.tv_sec) * 1000000000LL + info.st_ctim.tv_nsec;
+#endif
+}
+
+inline FileStamp stampFromStat(const struct stat& info) {
+    FileStamp stamp;
+    stamp.size = static_cast<uint64_t>(info.st_size);
+#ifdef __APPLE__
+    stamp.modifiedNs = static_cast<int64_t>(info.st_mtimespec.tv_sec) * 1000000000LL + info.st_mtimespec.tv_nsec;
+#else
+    stamp.modifiedNs = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000LL + info.st_mtim.tv_nsec;
+#endif
+    stamp.fileId = static_cast<uint64_t>(info.st_ino) ^ (static_cast<uint64_t>(info.st_dev) << 48);
+    return stamp;
+}
+#endif
+
+} // namespace mtfs::fs
@@ -0,0 +1,83 @@
+#include "fs/path_locks.hpp"
+#include <functional>
+#include <utility>
+
+namespace mtfs::fs {
+
+PathLockTable::Guard::Guard(Guard&& other) noexcept
+    : table(std::exchange(other.table, nullptr)),
+      exclusive(std::exchange(other.exclusive, 0)),
+      shared(std::exchange(other.shared, 0)) {}
+
+PathLockTable::Guard& PathLockTable::Guard::operator=(Guard&& other) noexcept {
+    if (this != &other) {
+        release();
+        table = std::exchange(other.table, nullptr);
+        exclusive = std::exchange(other.exclusive, 0);
+        shared = std::exchange(other.shared, 0);
+    }
+    return *this;
+}
+
+void PathLockTable::Guard::acquire(PathLockTable& owner, size_t stripe, Mode mode) {
+    table = &owner;
+    std::shared_mutex& lock = owner.stripes[stripe].lock;
+    if (mode == Mode::Exclusive) {
+        lock.lock();
+        exclusive |= uint64_t{1} << stripe;
+    } else {
+        lock.lock_shared();
+        shared |= uint64_t{1} << stripe;
+    }
+}
+
+void PathLockTable::Guard::release() {
+    // Reverse order of acquisition, which was ascending stripe order
+    for (size_t stripe = STRIPES; (exclusive | shared) != 0 && stripe-- > 0;) {
+        uint64_t bit = uint64_t{1} << stripe;
+        if (exclusive & bit) {
+            table->stripes[stripe].lock.unlock();
+        } else if (shared & bit) {
+            table->stripes[stripe].lock.unlock_shared();
+        }
+        exclusive &= ~bit;
+        shared &= ~bit;
+    }
+}
+
+size_t PathLockTable::stripeOf(const std::string& path) {
+    return std::hash<std::string>{}(path) % STRIPES;
+}
+
+PathLockTable::Guard PathLockTable::lock(const std::string& path, Mode mode) {
+    Guard guard;
+    guard.acquire(*this, stripeOf(path), mode);
+    return guard;
+}
+
+PathLockTable::Guard PathLockTable::lock(const std::string& first, Mode firstMode,
+                                         const std::string& second, Mode secondMode) {
+    return lock({{first, firstMode}, {second, secondMode}});
+}
+
+PathLockTable::Guard PathLockTable::lock(const std::vector<std::pair<std::string, Mode>>& paths) {
+    uint64_t exclusive = 0;
+    uint64_t wanted = 0;
+    for (const auto& [path, mode] : paths) {
+        uint64_t bit = uint64_t{1} << stripeOf(path);
+        wanted |= bit;
+        if (mode == Mode::Exclusive) {
+            exclusive |= bit;
+        }
+    }
+    Guard guard;
+    for (size_t stripe = 0; stripe < STRIPES; ++stripe) {
+        uint64_t bit = uint64_t{1} << stripe;
+        if (wanted & bit) {
+            guard.acquire(*this, stripe, (exclusive & bit) ? Mode::Exclusive : Mode::Shared);
+        }
+    }
+    return guard;
+}
+
+} // namespace mtfs::fs
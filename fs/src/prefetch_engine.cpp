@@ -0,0 +1,186 @@
+#include "fs/prefetch_engine.hpp"
+#include "common/logger.hpp"
+#include "threading/thread_pool.hpp"
+#include <algorithm>
+
+namespace mtfs::fs {
+
+namespace {
+
+constexpr auto BUDGET_WINDOW = std::chrono::seconds(1);
+
+std::string directoryOf(const std::string& path) {
+    size_t separator = path.find_last_of('/');
+    return separator == std::string::npos ? std::string() : path.substr(0, separator);
+}
+
+std::string nameOf(const std::string& path) {
+    return path.substr(path.find_last_of('/') + 1);
+}
+
+} // namespace
+
+PrefetchEngine::PrefetchEngine(Loader loader, Lister lister, const PrefetchOptions& options,
+                               threading::ThreadPool* pool)
+    : loader(std::move(loader)),
+      lister(std::move(lister)),
+      options(options),
+      pool(pool ? pool : &threading::GlobalThreadPool::getInstance()),
+      windowStart(std::chrono::steady_clock::now()) {}
+
+PrefetchEngine::~PrefetchEngine() {
+    drain();
+}
+
+void PrefetchEngine::recordAccess(const std::string& path) {
+    Work work;
+    {
+        std::lock_guard<std::mutex> lock(learnMutex);
+        for (const auto& previous : recent) {
+            if (previous != path) {
+                learnFollower(previous, path);
+            }
+        }
+        recent.push_back(path);
+        if (recent.size() > HISTORY) {
+            recent.pop_front();
+        }
+
+        if (auto it = followers.find(path); it != followers.end()) {
+            for (const auto& follower : it->second) {
+                if (follower.count >= options.coAccessThreshold) {
+                    work.paths.push_back(follower.path);
+                }
+            }
+        }
+
+        if (streams.size() >= MAX_TRACKED) {
+            streams.clear();
+        }
+        // Refill the read-ahead window once the scan has used half of it
+        Stream& stream = streams[directoryOf(path)];
+        std::string name = nameOf(path);
+        if (!stream.lastName.empty() && name > stream.lastName) {
+            stream.run++;
+            stream.ahead = stream.ahead > 0 ? stream.ahead - 1 : 0;
+        } else if (name != stream.lastName) {
+            stream.run = 0;
+            stream.ahead = 0;
+        }
+        stream.lastName = name;
+        if (stream.run > 0 && options.readAhead > 0 && stream.ahead <= options.readAhead / 2) {
+            work.scan = true;
+            work.scanDirectory = directoryOf(path);
+            work.scanAfter = name;
+            stream.ahead = options.readAhead;
+        }
+    }
+    if (work.scan || !work.paths.empty()) {
+        schedule(std::move(work));
+    }
+}
+
+// The counts of `previous`'s followers; a new one replaces the least seen
+void PrefetchEngine::learnFollower(const std::string& previous, const std::string& path) {
+    if (followers.size() >= MAX_TRACKED && followers.find(previous) == followers.end()) {
+        followers.clear();
+    }
+    auto& list = followers[previous];
+    for (auto& follower : list) {
+        if (follower.path == path) {
+            follower.count++;
+            return;
+        }
+    }
+    if (list.size() < MAX_FOLLOWERS) {
+        list.push_back({path, 1});
+        return;
+    }
+    auto weakest = std::min_element(list.begin(), list.end(),
+                                    [](const Follower& a, const Follower& b) { return a.count < b.count; });
+    *weakest = {path, 1};
+}
+
+void PrefetchEngine::schedule(Work work) {
+    {
+        std::lock_guard<std::mutex> lock(flightMutex);
+        if (inFlight >= options.maxInFlight) {
+            throttled += work.paths.size() + (work.scan ? options.readAhead : 0);
+            return;
+        }
+        inFlight++;
+    }
+    // Speculative, so it yields to interactive and normal work
+    threading::TaskOptions background{threading::TaskPriority::BACKGROUND};
+    pool->enqueue_detached(background, [this, work = std::move(work)] {
+        try {
+            run(work);
+        } catch (const std::exception& e) {
+            LOG_DEBUG(std::string("Prefetch failed: ") + e.what());
+        }
+        std::lock_guard<std::mutex> lock(flightMutex);
+        if (--inFlight == 0) {
+            idle.notify_all();
+        }
+    });
+}
+
+void PrefetchEngine::run(const Work& work) {
+    std::vector<std::string> paths = work.paths;
+    if (work.scan) {
+        std::vector<std::string> names = lister(work.scanDirectory);
+        std::sort(names.begin(), names.end());
+        auto next = std::upper_bound(names.begin(), names.end(), work.scanAfter);
+        std::string prefix = work.scanDirectory.empty() ? std::string() : work.scanDirectory + "/";
+        for (size_t i = 0; i < options.readAhead && next != names.end(); ++i, ++next) {
+            paths.push_back(prefix + *next);
+        }
+    }
+    for (const auto& path : paths) {
+        if (!withinBudget()) {
+            throttled++;
+            continue;
+        }
+        scheduled++;
+        size_t bytes = 0;
+        try {
+            bytes = loader(path);
+        } catch (const std::exception& e) {
+            LOG_DEBUG("Prefetch skipped " + path + ": " + e.what());
+        }
+        if (bytes > 0) {
+            loaded++;
+            charge(bytes);
+        }
+    }
+}
+
+bool PrefetchEngine::withinBudget() {
+    std::lock_guard<std::mutex> lock(flightMutex);
+    auto now = std::chrono::steady_clock::now();
+    if (now - windowStart >= BUDGET_WINDOW) {
+        windowStart = now;
+        windowBytes = 0;
+    }
+    return windowBytes < options.bytesPerSecond;
+}
+
+void PrefetchEngine::charge(uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(flightMutex);
+    windowBytes += bytes;
+}
+
+void PrefetchEngine::drain() {
+    std::unique_lock<std::mutex> lock(flightMutex);
+    idle.wait(lock, [this] { return inFlight == 0; });
+}
+
+PrefetchEngine::Stats PrefetchEngine::getStats() const {
+    Stats stats;
+    stats.scheduled = scheduled.load();
+    stats.loaded = loaded.load();
+    stats.throttled = throttled.load();
+    return stats;
+}
+
+} // namespace mtfs::fs
@@ -0,0 +1,151 @@
+#include "fs/restore_plan.hpp"
+#include "common/logger.hpp"
+#include "threading/thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <set>
+
+namespace mtfs::fs {
+
+using namespace mtfs::common;
+namespace stdfs = std::filesystem;
+
+double RestoreResult::throughput() const {
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    return seconds > 0 ? static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds : 0.0;
+}
+
+RestorePlan::RestorePlan(const ChunkStore& store, std::vector<ManifestEntry> entries,
+                         const std::string& targetDirectory)
+    : store(store), entries(std::move(entries)), targetDirectory(targetDirectory) {
+    // Ties keep manifest order, so a plan is the same every time
+    std::stable_sort(this->entries.begin(), this->entries.end(),
+                     [](const ManifestEntry& a, const ManifestEntry& b) { return a.size > b.size; });
+    for (const auto& entry : this->entries) {
+        bytes += entry.size;
+    }
+}
+
+RestoreResult RestorePlan::run(threading::ThreadPool& pool, const threading::TaskOptions& options,
+                               const FileCallback& onFile) const {
+    auto startTime = std::chrono::steady_clock::now();
+    RestoreResult result;
+
+    // Every directory once, before any file is written; a failure here shows
+    // up as the files under it failing to open
+    std::set<stdfs::path> directories;
+    directories.insert(targetDirectory);
+    for (const auto& entry : entries) {
+        directories.insert((stdfs::path(targetDirectory) / entry.path).parent_path());
+    }
+    for (const auto& directory : directories) {
+        std::error_code error;
+        stdfs::create_directories(directory, error);
+    }
+
+    // One driver per worker takes the next file in plan order. A file waits
+    // on its chunk tasks, and a waiting worker helps with queued tasks, so
+    // queuing a task per file would nest files on the waiting worker's stack.
+    std::mutex resultMutex;
+    std::atomic<size_t> nextFile{0};
+    auto drive = [this, &pool, &options, &onFile, &result, &resultMutex, &nextFile]() {
+        for (size_t i; (i = nextFile++) < entries.size();) {
+            const ManifestEntry& entry = entries[i];
+            size_t chunks = 0;
+            bool restored = true;
+            try {
+                chunks = restoreFile(entry, pool, options);
+            } catch (const std::exception& e) {
+                LOG_ERROR("Failed to restore file from backup: " + entry.path + ": " + e.what());
+                restored = false;
+                std::error_code error;
+                stdfs::remove(stdfs::path(targetDirectory) / entry.path, error);
+            }
+            {
+                std::lock_guard<std::mutex> lock(resultMutex);
+                if (restored) {
+                    result.files++;
+                    result.bytes += entry.size;
+                    result.chunks += chunks;
+                } else {
+                    result.failed++;
+                    result.failures.push_back(entry.path);
+                }
+            }
+            if (onFile) {
+                onFile(entry, restored);
+            }
+        }
+    };
+    std::vector<std::future<void>> drivers;
+    size_t driverCount = std::min(entries.size(), pool.getThreadCount());
+    for (size_t d = 0; d < driverCount; ++d) {
+        drivers.push_back(pool.enqueue(options, drive));
+    }
+    for (auto& driver : drivers) {
+        pool.waitFor(driver);
+        driver.get();
+    }
+
+    result.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                          startTime);
+    return result;
+}
+
+size_t RestorePlan::restoreFile(const ManifestEntry& entry, threading::ThreadPool& pool,
+                                const threading::TaskOptions& options) const {
+    std::string targetPath = (stdfs::path(targetDirectory) / entry.path).string();
+    std::ofstream out(targetPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw FSException("Cannot create restored file: " + targetPath);
+    }
+
+    uint64_t restored = 0;
+    std::deque<std::future<std::string>> inFlight;
+    auto writeOldest = [&] {
+        auto future = std::move(inFlight.front());
+        inFlight.pop_front();
+        pool.waitFor(future);
+        std::string data = future.get();
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        restored += data.size();
+    };
+
+    try {
+        if (entry.chunks.size() == 1) {
+            // Nothing to overlap with
+            std::string data = store.get(entry.chunks.front());
+            out.write(data.data(), static_cast<std::streamsize>(data.size()));
+            restored += data.size();
+        } else {
+            for (const auto& id : entry.chunks) {
+                inFlight.push_back(pool.enqueue(options, [this, id]() { return store.get(id); }));
+                if (inFlight.size() >= MAX_CHUNKS_IN_FLIGHT) {
+                    writeOldest();
+                }
+            }
+            while (!inFlight.empty()) {
+                writeOldest();
+            }
+        }
+    } catch (...) {
+        // Chunks still decoding must not outlive the plan
+        for (auto& future : inFlight) {
+            pool.waitFor(future);
+        }
+        throw;
+    }
+
+    out.close();
+    if (!out || restored != entry.size) {
+        throw FSException("Failed to restore file: " + entry.path);
+    }
+    return entry.chunks.size();
+}
+
+} // namespace mtfs::fs
@@ -0,0 +1,236 @@
+#include "fs/write_back_buffer.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace mtfs::fs {
+
+WriteBackBuffer::WriteBackBuffer(Flusher flusher, const WriteBackOptions& options)
+    : flusher(std::move(flusher)), options(options) {}
+
+WriteBackBuffer::~WriteBackBuffer() {
+    stop();
+}
+
+bool WriteBackBuffer::add(const std::string& path, uint64_t offset, const void* data, size_t size) {
+    if (size == 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!worker.joinable() && !stopping) {
+        worker = std::thread([this]() { run(); });
+    }
+    auto [entry, inserted] = files.try_emplace(path);
+    File& file = entry->second;
+    if (inserted) {
+        file.firstWrite = std::chrono::steady_clock::now();
+    }
+    uint64_t before = file.bytes;
+    place(file, offset, data, size);
+
+    pendingBytes += file.bytes - before;
+    stats.writes++;
+    stats.bytesWritten += size;
+    bool overBudget = pendingBytes > options.maxTotalBytes;
+    if (inserted || overBudget) {
+        wakeup.notify_one();  // The flusher may be asleep with no file to wait for
+    }
+    return overBudget || file.bytes > options.maxFileBytes;
+}
+
+void WriteBackBuffer::place(File& file, uint64_t offset, const void* data, size_t size) {
+    // Extend the extent that reaches the write, or start one
+    Extents& extents = file.extents;
+    uint64_t end = offset + size;
+    auto it = extents.upper_bound(offset);
+    if (it != extents.begin() && std::prev(it)->first + std::prev(it)->second.size() >= offset) {
+        --it;
+    } else {
+        it = extents.emplace_hint(it, offset, std::string());
+    }
+    uint64_t start = it->first;
+    std::string& bytes = it->second;
+    file.bytes -= bytes.size();
+    if (start + bytes.size() < end) {
+        bytes.resize(end - start);
+    }
+    std::memcpy(&bytes[offset - start], data, size);
+
+    // Later extents it now overlaps or touches keep only their bytes past it
+    for (auto next = std::next(it); next != extents.end() && next->first <= start + bytes.size();) {
+        uint64_t reach = start + bytes.size();
+        if (next->first + next->second.size() > reach) {
+            bytes.append(next->second, reach - next->first, std::string::npos);
+        }
+        file.bytes -= next->second.size();
+        next = extents.erase(next);
+    }
+    file.bytes += bytes.size();
+}
+
+WriteBackBuffer::Extents WriteBackBuffer::take(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto entry = files.find(path);
+    if (entry == files.end()) {
+        return {};
+    }
+    Extents extents = std::move(entry->second.extents);
+    pendingBytes -= entry->second.bytes;
+    stats.flushes++;
+    stats.extentsFlushed += extents.size();
+    stats.bytesFlushed += entry->second.bytes;
+    files.erase(entry);
+    return extents;
+}
+
+void WriteBackBuffer::restore(const std::string& path, Extents extents) {
+    if (extents.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    File restored;
+    restored.firstWrite = std::chrono::steady_clock::now();
+    for (const auto& [offset, bytes] : extents) {
+        place(restored, offset, bytes.data(), bytes.size());
+    }
+    uint64_t before = 0;
+    if (auto entry = files.find(path); entry != files.end()) {
+        before = entry->second.bytes;
+        restored.firstWrite = entry->second.firstWrite;
+        for (const auto& [offset, bytes] : entry->second.extents) {
+            place(restored, offset, bytes.data(), bytes.size());
+        }
+    }
+    pendingBytes += restored.bytes - before;
+    files[path] = std::move(restored);
+    wakeup.notify_one();
+}
+
+bool WriteBackBuffer::contains(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return files.count(path) > 0;
+}
+
+std::vector<std::string> WriteBackBuffer::dirtyPaths() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::string> paths;
+    paths.reserve(files.size());
+    for (const auto& [path, file] : files) {
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+uint64_t WriteBackBuffer::end(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto entry = files.find(path);
+    if (entry == files.end()) {
+        return 0;
+    }
+    const auto& last = *entry->second.extents.rbegin();
+    return last.first + last.second.size();
+}
+
+size_t WriteBackBuffer::overlay(const std::string& path, uint64_t offset, char* buffer, size_t size,
+                                size_t valid) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto entry = files.find(path);
+    if (entry == files.end()) {
+        return valid;
+    }
+    const Extents& extents = entry->second.extents;
+    uint64_t last = extents.rbegin()->first + extents.rbegin()->second.size();
+    size_t result = valid;
+    if (last > offset) {
+        result = std::max(valid, static_cast<size_t>(std::min<uint64_t>(size, last - offset)));
+    }
+    if (result > valid) {
+        std::memset(buffer + valid, 0, result - valid);
+    }
+
+    uint64_t readEnd = offset + size;
+    auto it = extents.upper_bound(offset);
+    if (it != extents.begin()) {
+        --it;
+    }
+    for (; it != extents.end() && it->first < readEnd; ++it) {
+        uint64_t from = std::max(offset, it->first);
+        uint64_t to = std::min(readEnd, it->first + it->second.size());
+        if (from < to) {
+            std::memcpy(buffer + (from - offset), it->second.data() + (from - it->first), to - from);
+        }
+    }
+    return result;
+}
+
+void WriteBackBuffer::overlay(const std::string& path, std::string& contents) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto entry = files.find(path);
+    if (entry == files.end()) {
+        return;
+    }
+    const Extents& extents = entry->second.extents;
+    uint64_t last = extents.rbegin()->first + extents.rbegin()->second.size();
+    if (contents.size() < last) {
+        contents.resize(static_cast<size_t>(last), '\0');
+    }
+    for (const auto& [offset, bytes] : extents) {
+        contents.replace(static_cast<size_t>(offset), bytes.size(), bytes);
+    }
+}
+
+void WriteBackBuffer::stop() {
+    std::thread stopped;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        stopped = std::move(worker);
+    }
+    wakeup.notify_all();
+    if (stopped.joinable()) {
+        stopped.join();
+    }
+}
+
+WriteBackBuffer::Stats WriteBackBuffer::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats current = stats;
+    current.dirtyFiles = files.size();
+    current.pendingBytes = pendingBytes;
+    return current;
+}
+
+// Sleeps until the oldest file is due, then hands every due file to the
+// flusher with the lock released, since flushing takes the file's path lock
+// and writers hold that lock while they add
+void WriteBackBuffer::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        auto now = std::chrono::steady_clock::now();
+        bool overBudget = pendingBytes > options.maxTotalBytes;
+        auto nextDue = std::chrono::steady_clock::time_point::max();
+        std::vector<std::string> due;
+        for (const auto& [path, file] : files) {
+            auto deadline = file.firstWrite + options.maxAge;
+            if (overBudget || deadline <= now) {
+                due.push_back(path);
+            } else {
+                nextDue = std::min(nextDue, deadline);
+            }
+        }
+        if (due.empty()) {
+            if (nextDue == std::chrono::steady_clock::time_point::max()) {
+                wakeup.wait(lock);
+            } else {
+                wakeup.wait_until(lock, nextDue);
+            }
+            continue;
+        }
+        lock.unlock();
+        for (const auto& path : due) {
+            flusher(path);
+        }
+        lock.lock();
+    }
+}
+
+} // namespace mtfs::fs
@@ -5,6 +5,9 @@
 #include <memory>
 #include <chrono>
 #include <string>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 #include "common/error.hpp"
 #include "storage/block_manager.hpp"
 
@@ -25,22 +28,44 @@ struct JournalEntry {
     std::chrono::system_clock::time_point timestamp;
     std::vector<storage::BlockId> blocks;
     std::vector<uint8_t> metadata;
-    
+
     JournalEntry() : timestamp(std::chrono::system_clock::now()) {}
 };
 
+// Write-ahead journal.
+//
+// Without a BlockManager the journal is kept in memory only. With one, it
+// owns the last JOURNAL_BLOCKS blocks of the device: two alternating header
+// blocks recording the checkpoint, followed by a ring of checksummed records.
+// A new journal is only formatted over free blocks; creating one throws
+// JournalException when any of them is in use or the device is too small.
+// logEntry() returns once its record is durable. Concurrent writers share a
+// single BlockManager::sync() per group commit: the first waiter becomes the
+// leader, optionally lingers for the commit window, then flushes everything
+// queued so far while the others wait for it.
+//
+// The ring holds every record since the checkpoint and never overwrites one.
+// When a new record would not fit, logEntry() and commitTransaction() throw
+// JournalException without logging anything (a transaction stays open), and
+// checkpoint() frees the space.
 class Journal {
 public:
+    using ReplayHandler = std::function<void(const JournalEntry&)>;
+
+    static constexpr size_t JOURNAL_BLOCKS = 64;       // 2 header blocks + record ring
+    static constexpr size_t GROUP_COMMIT_BYTES = 64 * 1024;  // Leader stops lingering past this
+
     // Factory method for future extensibility
     static std::shared_ptr<Journal> create(std::shared_ptr<storage::BlockManager> blockManager = nullptr);
 
     // Core journal operations
     void initialize();
     void logOperation(const std::string& operation);
-    void recover();
+    void recover();                               // Reload entries since the checkpoint
+    void recover(const ReplayHandler& replay);    // Stream entries since the checkpoint
     void clear();
-    
-    // Transaction support (basic implementation)
+
+    // Transaction support: entries are held back until commit and written as one batch
     void beginTransaction();
     void commitTransaction();
     void rollbackTransaction();
@@ -48,21 +73,81 @@ public:
     // Entry management
     void logEntry(const JournalEntry& entry);
     std::vector<JournalEntry> getEntries(uint64_t fromSequence, uint64_t toSequence) const;
-    
+
     // Status and management
     bool needsRecovery() const;
-    void checkpoint();
+    void checkpoint();  // Entries up to the last durable one no longer need replay
     size_t size() const;
     uint64_t getLastSequenceNumber() const;
 
+    // Group commit tuning
+    void setCommitWindow(std::chrono::microseconds window);
+    std::chrono::microseconds getCommitWindow() const;
+    uint64_t getSyncCount() const;
+
     Journal() = default;
     ~Journal() = default;
 
 private:
+    static constexpr uint32_t HEADER_MAGIC = 0x484A544D;  // "MTJH"
+    static constexpr uint32_t RECORD_MAGIC = 0x524A544D;  // "MTJR"
+    static constexpr uint16_t FORMAT_VERSION = 1;
+    static constexpr size_t HEADER_BLOCKS = 2;
+    static constexpr size_t RECORD_HEADER_SIZE = 3 * sizeof(uint32_t);
+
+    struct BlockCursor;
+
+    // In-memory mode, and entries held by an open transaction
     std::vector<JournalEntry> entries;
+    std::vector<JournalEntry> transactionEntries;
     uint64_t currentSequence{0};
     bool inTransaction{false};
     std::shared_ptr<storage::BlockManager> blockManager;
+
+    // Persistent state
+    mutable std::mutex journalMutex;
+    mutable std::condition_variable commitDone;
+    std::condition_variable batchReady;
+    std::chrono::microseconds commitWindow{0};
+    std::vector<uint8_t> pendingBuffer;   // Encoded records not yet written
+    uint64_t pendingLastSequence{0};
+    size_t pendingRecords{0};
+    uint64_t durableSequence{0};
+    bool flushInProgress{false};
+    bool writeFailed{false};
+    bool recoveryPending{false};
+    size_t logRecords{0};                 // Records since the checkpoint
+    uint64_t loggedBytes{0};              // Ring bytes they take, pending records included
+    uint64_t syncCount{0};
+
+    // Leader-owned layout state
+    int firstBlock{0};
+    uint64_t generation{0};
+    uint64_t headerCounter{0};
+    uint64_t checkpointPosition{0};
+    uint64_t checkpointSequence{0};
+    uint64_t writePosition{0};
+    std::vector<char> tailBlock;
+
+    bool persistent() const { return blockManager != nullptr; }
+    size_t ringBytes() const;
+    int ringBlock(uint64_t position) const;
+
+    void openPersistent();
+    bool loadHeader();
+    void writeHeader();
+    uint64_t scanLog(uint64_t& endPosition, const ReplayHandler& visit) const;
+    bool readBytes(BlockCursor& cursor, uint64_t position, void* out, size_t length) const;
+    bool writeBytes(const std::vector<uint8_t>& data);
+
+    uint64_t appendLocked(std::unique_lock<std::mutex>& lock, std::vector<JournalEntry>& batch);
+    void waitDurable(std::unique_lock<std::mutex>& lock, uint64_t sequence);
+    void becomeLeader(std::unique_lock<std::mutex>& lock);
+    void resignLeader();
+    void flushPendingLocked(std::unique_lock<std::mutex>& lock);
+
+    void encodeRecord(const JournalEntry& entry, std::vector<uint8_t>& out) const;
+    static bool decodeEntry(const std::vector<uint8_t>& payload, JournalEntry& entry);
 };
 
-} // namespace mtfs::journal 
\ No newline at end of file
+} // namespace mtfs::journal
@@ -1,10 +1,50 @@
 #include "journal/journal.hpp"
 #include "common/logger.hpp"
+#include "common/checksum.hpp"
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 
 namespace mtfs::journal {
 
+using namespace mtfs::common;
+using storage::BlockManager;
+
+namespace {
+
+template<typename T>
+void appendValue(std::vector<uint8_t>& out, T value) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template<typename T>
+bool readValue(const std::vector<uint8_t>& in, size_t& offset, T& value) {
+    if (offset + sizeof(T) > in.size()) return false;
+    std::memcpy(&value, in.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+// Header block layout; the checksum covers every field before it
+struct HeaderFields {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint64_t generation;
+    uint64_t counter;
+    uint64_t checkpointPosition;
+    uint64_t checkpointSequence;
+};
+
+} // namespace
+
+// Single-block read cache used while walking the record ring
+struct Journal::BlockCursor {
+    int blockId{-1};
+    std::vector<char> data;
+};
+
 std::shared_ptr<Journal> Journal::create(std::shared_ptr<storage::BlockManager> blockManager) {
     auto journal = std::make_shared<Journal>();
     journal->blockManager = blockManager;
@@ -13,85 +53,591 @@ std::shared_ptr<Journal> Journal::create(std::shared_ptr<storage::BlockManager>
 }
 
 void Journal::initialize() {
-    LOG_INFO("Journal initialized");
+    std::lock_guard<std::mutex> lock(journalMutex);
     currentSequence = 0;
     inTransaction = false;
     entries.clear();
+    transactionEntries.clear();
+    pendingBuffer.clear();
+    pendingRecords = 0;
+    writeFailed = false;
+
+    if (persistent()) {
+        openPersistent();
+        LOG_INFO("Journal initialized (" + std::to_string(logRecords) +
+                 " entries since last checkpoint, last sequence " + std::to_string(currentSequence) + ")");
+    } else {
+        LOG_INFO("Journal initialized");
+    }
 }
 
 void Journal::logOperation(const std::string& operation) {
     LOG_INFO("Operation logged: " + operation);
-    
+
     JournalEntry entry;
-    entry.sequenceNumber = ++currentSequence;
     entry.type = JournalEntryType::UPDATE_METADATA;
     entry.metadata.assign(operation.begin(), operation.end());
-    
-    entries.push_back(entry);
+    logEntry(entry);
 }
 
 void Journal::logEntry(const JournalEntry& entry) {
-    JournalEntry newEntry = entry;
-    newEntry.sequenceNumber = ++currentSequence;
-    newEntry.timestamp = std::chrono::system_clock::now();
-    entries.push_back(newEntry);
+    std::unique_lock<std::mutex> lock(journalMutex);
+    if (inTransaction) {
+        transactionEntries.push_back(entry);
+        return;
+    }
+
+    std::vector<JournalEntry> batch{entry};
+    uint64_t sequence = appendLocked(lock, batch);
+    if (persistent()) {
+        waitDurable(lock, sequence);
+    }
 }
 
 std::vector<JournalEntry> Journal::getEntries(uint64_t fromSequence, uint64_t toSequence) const {
     std::vector<JournalEntry> result;
-    for (const auto& entry : entries) {
+    std::unique_lock<std::mutex> lock(journalMutex);
+    if (!persistent()) {
+        for (const auto& entry : entries) {
+            if (entry.sequenceNumber >= fromSequence && entry.sequenceNumber <= toSequence) {
+                result.push_back(entry);
+            }
+        }
+        return result;
+    }
+
+    // Holding the lock with no flush in progress keeps the ring stable
+    commitDone.wait(lock, [this] { return !flushInProgress; });
+    uint64_t endPosition = 0;
+    scanLog(endPosition, [&](const JournalEntry& entry) {
         if (entry.sequenceNumber >= fromSequence && entry.sequenceNumber <= toSequence) {
             result.push_back(entry);
         }
-    }
+    });
     return result;
 }
 
 void Journal::beginTransaction() {
+    std::lock_guard<std::mutex> lock(journalMutex);
     inTransaction = true;
     LOG_INFO("Transaction began");
 }
 
 void Journal::commitTransaction() {
-    if (inTransaction) {
-        inTransaction = false;
-        LOG_INFO("Transaction committed");
+    std::unique_lock<std::mutex> lock(journalMutex);
+    if (!inTransaction) return;
+    inTransaction = false;
+
+    if (!transactionEntries.empty()) {
+        std::vector<JournalEntry> batch;
+        batch.swap(transactionEntries);
+        uint64_t sequence = 0;
+        try {
+            sequence = appendLocked(lock, batch);
+        } catch (...) {
+            // Nothing was logged; the transaction stays open to commit again
+            batch.swap(transactionEntries);
+            inTransaction = true;
+            throw;
+        }
+        if (persistent()) {
+            waitDurable(lock, sequence);
+        }
     }
+    LOG_INFO("Transaction committed");
 }
 
 void Journal::rollbackTransaction() {
+    std::lock_guard<std::mutex> lock(journalMutex);
     if (inTransaction) {
         inTransaction = false;
+        transactionEntries.clear();
         LOG_INFO("Transaction rolled back");
     }
 }
 
 bool Journal::needsRecovery() const {
-    return !entries.empty() && inTransaction;
+    std::lock_guard<std::mutex> lock(journalMutex);
+    return recoveryPending || (!entries.empty() && inTransaction);
 }
 
 void Journal::recover() {
-    LOG_INFO("Journal recovery completed");
+    recover(nullptr);
+}
+
+void Journal::recover(const ReplayHandler& replay) {
+    std::unique_lock<std::mutex> lock(journalMutex);
     inTransaction = false;
+    transactionEntries.clear();
+
+    size_t replayed = 0;
+    if (!persistent()) {
+        for (const auto& entry : entries) {
+            if (replay) replay(entry);
+            ++replayed;
+        }
+    } else {
+        // Stream records straight from the ring; leadership keeps other
+        // flushes out while the handler runs without the lock held.
+        becomeLeader(lock);
+        lock.unlock();
+        try {
+            uint64_t endPosition = 0;
+            scanLog(endPosition, [&](const JournalEntry& entry) {
+                if (replay) replay(entry);
+                ++replayed;
+            });
+        } catch (...) {
+            lock.lock();
+            resignLeader();
+            throw;
+        }
+        lock.lock();
+        recoveryPending = false;
+        resignLeader();
+    }
+    LOG_INFO("Journal recovery completed: " + std::to_string(replayed) + " entries replayed");
 }
 
 void Journal::checkpoint() {
-    LOG_INFO("Journal checkpoint completed");
+    std::unique_lock<std::mutex> lock(journalMutex);
+    if (!persistent()) {
+        entries.clear();
+        LOG_INFO("Journal checkpoint completed");
+        return;
+    }
+
+    becomeLeader(lock);
+    try {
+        flushPendingLocked(lock);
+        checkpointPosition = writePosition;
+        checkpointSequence = durableSequence;
+        writeHeader();
+        if (!blockManager->sync()) {
+            throw JournalException("Failed to sync checkpoint");
+        }
+        logRecords = 0;
+        loggedBytes = pendingBuffer.size();  // Queued while the flush ran
+        recoveryPending = false;
+    } catch (...) {
+        resignLeader();
+        throw;
+    }
+    resignLeader();
+    LOG_INFO("Journal checkpoint completed at sequence " + std::to_string(checkpointSequence));
 }
 
 void Journal::clear() {
-    LOG_INFO("Journal cleared");
+    std::unique_lock<std::mutex> lock(journalMutex);
     entries.clear();
-    currentSequence = 0;
+    transactionEntries.clear();
     inTransaction = false;
+
+    if (persistent()) {
+        becomeLeader(lock);
+        try {
+            // Let writers already queued complete before their records are
+            // discarded, including ones that queued while a flush ran: left
+            // queued, they would be written under the old generation, where
+            // the scan stops, after being reported durable
+            while (!pendingBuffer.empty()) {
+                flushPendingLocked(lock);
+            }
+            ++generation;
+            currentSequence = 0;
+            durableSequence = 0;
+            pendingLastSequence = 0;
+            checkpointPosition = writePosition;
+            checkpointSequence = 0;
+            logRecords = 0;
+            loggedBytes = pendingBuffer.size();
+            recoveryPending = false;
+            writeHeader();
+            blockManager->sync();
+        } catch (...) {
+            resignLeader();
+            throw;
+        }
+        resignLeader();
+    } else {
+        currentSequence = 0;
+    }
+    LOG_INFO("Journal cleared");
 }
 
 size_t Journal::size() const {
-    return entries.size();
+    std::lock_guard<std::mutex> lock(journalMutex);
+    return persistent() ? logRecords + pendingRecords : entries.size();
 }
 
 uint64_t Journal::getLastSequenceNumber() const {
+    std::lock_guard<std::mutex> lock(journalMutex);
     return currentSequence;
 }
 
-} // namespace mtfs::journal 
\ No newline at end of file
+void Journal::setCommitWindow(std::chrono::microseconds window) {
+    std::lock_guard<std::mutex> lock(journalMutex);
+    commitWindow = window;
+}
+
+std::chrono::microseconds Journal::getCommitWindow() const {
+    std::lock_guard<std::mutex> lock(journalMutex);
+    return commitWindow;
+}
+
+uint64_t Journal::getSyncCount() const {
+    std::lock_guard<std::mutex> lock(journalMutex);
+    return syncCount;
+}
+
+// Group commit
+
+uint64_t Journal::appendLocked(std::unique_lock<std::mutex>& lock, std::vector<JournalEntry>& batch) {
+    if (persistent()) {
+        // Back-pressure: never queue more than half the ring ahead of a flush
+        commitDone.wait(lock, [this] { return pendingBuffer.size() < ringBytes() / 2 || writeFailed; });
+        if (writeFailed) {
+            throw JournalException("Journal is unavailable after a failed write");
+        }
+    }
+
+    if (persistent()) {
+        // Records since the checkpoint are never overwritten, so a batch that
+        // does not fit in what the ring has left is refused whole
+        std::vector<uint8_t> encoded;
+        uint64_t sequence = currentSequence;
+        for (auto& entry : batch) {
+            entry.sequenceNumber = ++sequence;
+            entry.timestamp = std::chrono::system_clock::now();
+            encodeRecord(entry, encoded);
+        }
+        if (loggedBytes + encoded.size() + BlockManager::BLOCK_SIZE > ringBytes()) {
+            throw JournalException("Journal full; checkpoint() to free space");
+        }
+        pendingBuffer.insert(pendingBuffer.end(), encoded.begin(), encoded.end());
+        pendingRecords += batch.size();
+        loggedBytes += encoded.size();
+        currentSequence = sequence;
+    } else {
+        for (auto& entry : batch) {
+            entry.sequenceNumber = ++currentSequence;
+            entry.timestamp = std::chrono::system_clock::now();
+            entries.push_back(std::move(entry));
+        }
+    }
+    pendingLastSequence = currentSequence;
+
+    if (pendingBuffer.size() >= GROUP_COMMIT_BYTES) {
+        batchReady.notify_one();
+    }
+    return currentSequence;
+}
+
+void Journal::waitDurable(std::unique_lock<std::mutex>& lock, uint64_t sequence) {
+    const uint64_t startGeneration = generation;
+    while (durableSequence < sequence && generation == startGeneration) {
+        if (writeFailed) {
+            throw JournalException("Failed to commit journal entry " + std::to_string(sequence));
+        }
+        if (flushInProgress) {
+            commitDone.wait(lock);
+            continue;
+        }
+
+        becomeLeader(lock);
+        try {
+            if (commitWindow.count() > 0 && pendingBuffer.size() < GROUP_COMMIT_BYTES) {
+                batchReady.wait_for(lock, commitWindow,
+                                    [this] { return pendingBuffer.size() >= GROUP_COMMIT_BYTES; });
+            }
+            flushPendingLocked(lock);
+        } catch (...) {
+            resignLeader();
+            throw;
+        }
+        resignLeader();
+    }
+}
+
+void Journal::becomeLeader(std::unique_lock<std::mutex>& lock) {
+    commitDone.wait(lock, [this] { return !flushInProgress; });
+    flushInProgress = true;
+}
+
+void Journal::resignLeader() {
+    flushInProgress = false;
+    commitDone.notify_all();
+}
+
+void Journal::flushPendingLocked(std::unique_lock<std::mutex>& lock) {
+    if (pendingBuffer.empty()) return;
+
+    std::vector<uint8_t> batch;
+    batch.swap(pendingBuffer);
+    const uint64_t lastSequence = pendingLastSequence;
+    const size_t records = pendingRecords;
+    pendingRecords = 0;
+
+    // The leader owns the ring layout, so the I/O runs without the lock and
+    // new writers keep queueing behind this batch.
+    lock.unlock();
+    try {
+        // appendLocked only queues what fits, so this would be a bug
+        if (writePosition + batch.size() + BlockManager::BLOCK_SIZE - checkpointPosition > ringBytes()) {
+            throw JournalException("Journal records would overwrite the checkpoint");
+        }
+        if (!writeBytes(batch)) {
+            throw JournalException("Failed to write journal records");
+        }
+        if (!blockManager->sync()) {
+            throw JournalException("Failed to sync journal");
+        }
+    } catch (...) {
+        lock.lock();
+        writeFailed = true;
+        throw;
+    }
+    lock.lock();
+
+    durableSequence = lastSequence;
+    ++syncCount;
+    logRecords += records;
+}
+
+// On-disk layout
+
+size_t Journal::ringBytes() const {
+    return (JOURNAL_BLOCKS - HEADER_BLOCKS) * BlockManager::BLOCK_SIZE;
+}
+
+int Journal::ringBlock(uint64_t position) const {
+    const uint64_t ringBlocks = JOURNAL_BLOCKS - HEADER_BLOCKS;
+    return firstBlock + static_cast<int>(HEADER_BLOCKS + (position / BlockManager::BLOCK_SIZE) % ringBlocks);
+}
+
+void Journal::openPersistent() {
+    if (blockManager->getFormattedBlocks() < JOURNAL_BLOCKS) {
+        throw JournalException("Block store of " + std::to_string(blockManager->getFormattedBlocks()) +
+                               " blocks is too small for the journal");
+    }
+    firstBlock = static_cast<int>(blockManager->getFormattedBlocks() - JOURNAL_BLOCKS);
+    tailBlock.assign(BlockManager::BLOCK_SIZE, 0);
+
+    if (!loadHeader()) {
+        // A new journal takes only free blocks; one holding someone else's
+        // data is never formatted over
+        for (size_t i = 0; i < JOURNAL_BLOCKS; ++i) {
+            int blockId = firstBlock + static_cast<int>(i);
+            if (!blockManager->isBlockFree(blockId)) {
+                throw JournalException("Journal block " + std::to_string(blockId) + " is already in use");
+            }
+        }
+        for (size_t i = 0; i < JOURNAL_BLOCKS; ++i) {
+            int blockId = firstBlock + static_cast<int>(i);
+            if (!blockManager->reserveBlock(blockId)) {
+                throw JournalException("Failed to reserve journal block " + std::to_string(blockId));
+            }
+        }
+        generation = static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+        headerCounter = 0;
+        checkpointPosition = 0;
+        checkpointSequence = 0;
+        writeHeader();
+        if (!blockManager->sync()) {
+            throw JournalException("Failed to sync new journal header");
+        }
+        LOG_INFO("Formatted journal at block " + std::to_string(firstBlock));
+    }
+
+    uint64_t endPosition = 0;
+    uint64_t lastSequence = scanLog(endPosition, nullptr);
+    writePosition = endPosition;
+    currentSequence = lastSequence;
+    durableSequence = lastSequence;
+    pendingLastSequence = lastSequence;
+    logRecords = static_cast<size_t>(lastSequence - checkpointSequence);
+    loggedBytes = writePosition - checkpointPosition;
+    recoveryPending = logRecords > 0;
+
+    // Resume appending inside the partially filled tail block
+    size_t tailOffset = writePosition % BlockManager::BLOCK_SIZE;
+    if (tailOffset != 0) {
+        if (!blockManager->readBlock(ringBlock(writePosition), tailBlock)) {
+            throw JournalException("Failed to read journal tail block");
+        }
+        std::fill(tailBlock.begin() + tailOffset, tailBlock.end(), 0);
+    }
+}
+
+bool Journal::loadHeader() {
+    bool found = false;
+    for (size_t slot = 0; slot < HEADER_BLOCKS; ++slot) {
+        int blockId = firstBlock + static_cast<int>(slot);
+        std::vector<char> block;
+        if (blockManager->isBlockFree(blockId) || !blockManager->readBlock(blockId, block)) continue;
+
+        HeaderFields fields;
+        uint32_t storedCrc = 0;
+        std::memcpy(&fields, block.data(), sizeof(fields));
+        std::memcpy(&storedCrc, block.data() + sizeof(fields), sizeof(storedCrc));
+        if (fields.magic != HEADER_MAGIC || fields.version != FORMAT_VERSION ||
+            crc32(block.data(), sizeof(fields)) != storedCrc) {
+            continue;
+        }
+        if (!found || fields.counter > headerCounter) {
+            generation = fields.generation;
+            headerCounter = fields.counter;
+            checkpointPosition = fields.checkpointPosition;
+            checkpointSequence = fields.checkpointSequence;
+            found = true;
+        }
+    }
+    return found;
+}
+
+void Journal::writeHeader() {
+    ++headerCounter;
+    HeaderFields fields{};
+    fields.magic = HEADER_MAGIC;
+    fields.version = FORMAT_VERSION;
+    fields.generation = generation;
+    fields.counter = headerCounter;
+    fields.checkpointPosition = checkpointPosition;
+    fields.checkpointSequence = checkpointSequence;
+
+    std::vector<char> block(BlockManager::BLOCK_SIZE, 0);
+    std::memcpy(block.data(), &fields, sizeof(fields));
+    uint32_t crc = crc32(block.data(), sizeof(fields));
+    std::memcpy(block.data() + sizeof(fields), &crc, sizeof(crc));
+
+    // Alternate slots so a torn header write leaves the previous one intact
+    int blockId = firstBlock + static_cast<int>(headerCounter % HEADER_BLOCKS);
+    if (!blockManager->writeBlock(blockId, block)) {
+        throw JournalException("Failed to write journal header");
+    }
+}
+
+uint64_t Journal::scanLog(uint64_t& endPosition, const ReplayHandler& visit) const {
+    BlockCursor cursor;
+    std::vector<uint8_t> payload;
+    uint64_t position = checkpointPosition;
+    uint64_t expected = checkpointSequence + 1;
+
+    // Stop at the first record that is torn, from another generation, or
+    // left over from an earlier pass around the ring.
+    while (position - checkpointPosition + RECORD_HEADER_SIZE <= ringBytes()) {
+        uint32_t header[3];
+        if (!readBytes(cursor, position, header, sizeof(header))) break;
+        if (header[0] != RECORD_MAGIC ||
+            position - checkpointPosition + RECORD_HEADER_SIZE + header[1] > ringBytes()) {
+            break;
+        }
+
+        payload.resize(header[1]);
+        if (!readBytes(cursor, position + RECORD_HEADER_SIZE, payload.data(), payload.size())) break;
+        uint32_t crc = crc32(&generation, sizeof(generation));
+        if (crc32(payload.data(), payload.size(), crc) != header[2]) break;
+
+        JournalEntry entry;
+        if (!decodeEntry(payload, entry) || entry.sequenceNumber != expected) break;
+
+        if (visit) visit(entry);
+        position += RECORD_HEADER_SIZE + header[1];
+        ++expected;
+    }
+
+    endPosition = position;
+    return expected - 1;
+}
+
+bool Journal::readBytes(BlockCursor& cursor, uint64_t position, void* out, size_t length) const {
+    auto* dest = static_cast<char*>(out);
+    while (length > 0) {
+        int blockId = ringBlock(position);
+        if (cursor.blockId != blockId) {
+            if (!blockManager->readBlock(blockId, cursor.data)) return false;
+            cursor.blockId = blockId;
+        }
+        size_t offset = position % BlockManager::BLOCK_SIZE;
+        size_t count = std::min(length, BlockManager::BLOCK_SIZE - offset);
+        std::memcpy(dest, cursor.data.data() + offset, count);
+        dest += count;
+        position += count;
+        length -= count;
+    }
+    return true;
+}
+
+bool Journal::writeBytes(const std::vector<uint8_t>& data) {
+    size_t offset = 0;
+    while (offset < data.size()) {
+        size_t blockOffset = writePosition % BlockManager::BLOCK_SIZE;
+        size_t count = std::min(data.size() - offset, BlockManager::BLOCK_SIZE - blockOffset);
+        std::memcpy(tailBlock.data() + blockOffset, data.data() + offset, count);
+
+        if (!blockManager->writeBlock(ringBlock(writePosition), tailBlock)) {
+            return false;
+        }
+        offset += count;
+        writePosition += count;
+        if (writePosition % BlockManager::BLOCK_SIZE == 0) {
+            std::fill(tailBlock.begin(), tailBlock.end(), 0);
+        }
+    }
+    return true;
+}
+
+// Record layout: [magic][payload length][crc(generation + payload)][payload]
+void Journal::encodeRecord(const JournalEntry& entry, std::vector<uint8_t>& out) const {
+    std::vector<uint8_t> payload;
+    payload.reserve(32 + entry.blocks.size() * sizeof(storage::BlockId) + entry.metadata.size());
+    appendValue(payload, entry.sequenceNumber);
+    appendValue(payload, static_cast<uint8_t>(entry.type));
+    appendValue(payload, static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             entry.timestamp.time_since_epoch()).count()));
+    appendValue(payload, static_cast<uint32_t>(entry.blocks.size()));
+    for (storage::BlockId block : entry.blocks) {
+        appendValue(payload, static_cast<int32_t>(block));
+    }
+    appendValue(payload, static_cast<uint32_t>(entry.metadata.size()));
+    payload.insert(payload.end(), entry.metadata.begin(), entry.metadata.end());
+
+    uint32_t crc = crc32(&generation, sizeof(generation));
+    appendValue(out, RECORD_MAGIC);
+    appendValue(out, static_cast<uint32_t>(payload.size()));
+    appendValue(out, crc32(payload.data(), payload.size(), crc));
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+bool Journal::decodeEntry(const std::vector<uint8_t>& payload, JournalEntry& entry) {
+    size_t offset = 0;
+    uint8_t type = 0;
+    int64_t timestamp = 0;
+    uint32_t blockCount = 0;
+    uint32_t metadataSize = 0;
+    if (!readValue(payload, offset, entry.sequenceNumber) || !readValue(payload, offset, type) ||
+        !readValue(payload, offset, timestamp) || !readValue(payload, offset, blockCount)) {
+        return false;
+    }
+    if (type > static_cast<uint8_t>(JournalEntryType::UPDATE_METADATA) ||
+        blockCount > (payload.size() - offset) / sizeof(int32_t)) {
+        return false;
+    }
+
+    entry.type = static_cast<JournalEntryType>(type);
+    entry.timestamp = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(timestamp)));
+    entry.blocks.resize(blockCount);
+    for (auto& block : entry.blocks) {
+        int32_t value = 0;
+        readValue(payload, offset, value);
+        block = value;
+    }
+    if (!readValue(payload, offset, metadataSize) || offset + metadataSize != payload.size()) {
+        return false;
+    }
+    entry.metadata.assign(payload.begin() + offset, payload.end());
+    return true;
+}
+
+} // namespace mtfs::journal
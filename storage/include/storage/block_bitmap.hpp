@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mtfs::storage {
+
+// Block allocation bitmap with a summary tree for O(log N) free-space search.
+//
+// Bit i is set while block i is in use. Above the bitmap, each summary level
+// keeps one bit per word of the level below, set while that word still has
+// free space, so finding the next free block from any position looks at one
+// word per level instead of scanning. Padding bits past size() stay set, so
+// they are never handed out.
+class BlockBitmap {
+public:
+    static constexpr size_t WORD_BITS = 64;
+    static constexpr size_t NOT_FOUND = SIZE_MAX;
+
+    explicit BlockBitmap(size_t blocks = 0);
+
+    size_t size() const { return blocks; }
+    size_t freeCount() const { return freeBlocks; }
+
+    bool test(size_t index) const;
+    void assign(size_t first, size_t count, bool used);
+
+    // Grow to `newBlocks`; the added blocks start free
+    void resize(size_t newBlocks);
+
+    // First free block at or after `from`, wrapping around; NOT_FOUND when full
+    size_t findFree(size_t from) const;
+
+    // Start of `count` consecutive free blocks, first fit from `from`, wrapping around
+    size_t findFreeRun(size_t count, size_t from) const;
+
+    // First free block at or after `from` without wrapping; NOT_FOUND if none
+    size_t findFreeFrom(size_t from) const;
+
+    // Number of consecutive free blocks starting at `from`, stopping at `limit`
+    size_t freeRunLength(size_t from, size_t limit) const { return nextUsed(from, limit) - from; }
+
+    // Raw words for persistence; load() rebuilds the summaries
+    const std::vector<uint64_t>& words() const { return bits; }
+    void load(std::vector<uint64_t> words, size_t blocks);
+
+    static size_t wordsFor(size_t blocks) { return (blocks + WORD_BITS - 1) / WORD_BITS; }
+
+private:
+    size_t nextSet(size_t level, size_t index) const;
+    size_t nextUsed(size_t from, size_t limit) const;
+    void refreshSummary(size_t wordIndex);
+    void rebuildSummaries();
+    void setPadding();
+
+    size_t blocks{0};
+    size_t freeBlocks{0};
+    std::vector<uint64_t> bits;
+    std::vector<std::vector<uint64_t>> summaries;  // summaries[0] covers bits; the top level is one word
+};
+
+} // namespace mtfs::storage
@@ -2,50 +2,138 @@
 
 #include <string>
 #include <vector>
-#include <fstream>
 #include <memory>
+#include <future>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <array>
 #include <windows.h>
 #include "common/error.hpp"
+#include "common/metrics.hpp"
+#include "storage/block_bitmap.hpp"
 
 namespace mtfs::storage {
 
 using BlockId = int;  // Type alias for block identifiers
 
+class NativeFile;
+class AsyncIO;
+
+// Growable store of fixed-size blocks in a single file. Block data moves
+// through positional I/O, and the allocation bitmap is split into block
+// groups of GROUP_BLOCKS, each behind its own latch with an atomic free
+// counter, so operations on different groups run concurrently. A
+// reader-writer layout lock is held shared by every operation and taken
+// exclusively only to grow or format the store.
+//
+// File layout: a HEADER_BYTES superblock, then the blocks, then the
+// allocation bitmap. When allocation runs out of space the store doubles.
+// The bitmap is rewritten past the new end before the superblock is pointed
+// at it, so a crash mid-growth leaves the old layout intact.
 class BlockManager {
 public:
-    static constexpr size_t BLOCK_SIZE = 4096;  // 4KB blocks
-    static constexpr size_t MAX_BLOCKS = 1024;  // Initial maximum blocks
-    static constexpr size_t BITMAP_BYTES = (MAX_BLOCKS + 7) / 8;  // Size of bitmap in bytes
+    static constexpr size_t BLOCK_SIZE = 4096;           // 4KB blocks
+    static constexpr size_t INITIAL_BLOCKS = 1024;       // Capacity of a new store
+    static constexpr size_t MAX_BLOCKS = size_t(1) << 26; // Growth limit (256GB)
+    static constexpr size_t HEADER_BYTES = 128;          // Superblock ahead of block 0
 
-    explicit BlockManager(const std::string& storagePath);
+    explicit BlockManager(const std::string& storagePath, size_t initialBlocks = INITIAL_BLOCKS);
     ~BlockManager();
 
     // Block operations
     bool writeBlock(int blockId, const std::vector<char>& data);
     bool readBlock(int blockId, std::vector<char>& data);
+
+    // Batch operations: runs of consecutive block IDs move in one vectored
+    // call. All IDs are checked first; an invalid one fails the whole batch.
+    bool writeBlocks(const std::vector<BlockId>& blockIds, const std::vector<std::vector<char>>& data);
+    bool readBlocks(const std::vector<BlockId>& blockIds, std::vector<std::vector<char>>& data);
+
+    // Asynchronous block I/O completing through futures. A failed write
+    // yields false and a failed read an empty block.
+    std::future<bool> writeBlockAsync(BlockId blockId, std::vector<char> data);
+    std::future<std::vector<char>> readBlockAsync(BlockId blockId);
+    const char* getAsyncBackendName();  // "io_uring", "iocp" or "thread"
     int allocateBlock();  // Returns new block ID or -1 on failure
     bool freeBlock(int blockId);
+
+    // Contiguous runs: the first block of `count` consecutive blocks, or -1
+    BlockId allocateExtent(size_t count);
+    bool freeExtent(BlockId firstBlock, size_t count);
+    bool reserveBlock(int blockId);  // Claim a specific block; false if already in use
     void formatStorage();
 
+    // Flush buffered writes and force them to stable storage
+    bool sync();
+
     // Utility methods
-    size_t getTotalBlocks() const { return MAX_BLOCKS; }
-    size_t getFreeBlocks();  // Removed const as it modifies critical section
+    size_t getTotalBlocks() const { return totalBlocks.load(std::memory_order_acquire); }
+    // Capacity the store was created with; fixed regions such as the journal
+    // sit at the end of it and do not move when the store grows
+    size_t getFormattedBlocks() const { return formattedBlocks; }
+    size_t getFreeBlocks() const { return freeBlocks.load(std::memory_order_acquire); }
     bool isBlockFree(int blockId);  // Removed const as it needs to lock
 
+    // Latency of the synchronous block calls; a batch counts as one call
+    const common::LatencyHistogram& getReadLatency() const { return readLatency; }
+    const common::LatencyHistogram& getWriteLatency() const { return writeLatency; }
+    void resetLatency() { readLatency.reset(); writeLatency.reset(); }
+
 private:
+    // Longest run sent as a single vectored call
+    static constexpr size_t MAX_RUN_BLOCKS = 256;
+    // Allocation hints: each thread resumes after its own last allocation
+    static constexpr size_t HINT_SLOTS = 64;
+    // Blocks per group; a multiple of the bitmap word so groups own whole words
+    static constexpr size_t GROUP_BLOCKS = 256;
+    static_assert(GROUP_BLOCKS % BlockBitmap::WORD_BITS == 0, "Groups must own whole bitmap words");
+
+    // One slice of the bitmap. The latch guards `bitmap`; `freeBlocks` is
+    // also read without it to skip full groups.
+    struct BlockGroup {
+        BlockGroup(size_t firstBlock, BlockBitmap bitmap);
+        ~BlockGroup();
+        BlockGroup(const BlockGroup&) = delete;
+        BlockGroup& operator=(const BlockGroup&) = delete;
+
+        CRITICAL_SECTION latch;
+        const size_t firstBlock;
+        BlockBitmap bitmap;  // Bit set = block in use
+        std::atomic<size_t> freeBlocks;
+    };
+
     std::string storagePath;
-    std::fstream storageFile;
-    std::vector<uint8_t> blockBitmap;  // 1 = used, 0 = free
-    CRITICAL_SECTION cs;  // Windows critical section for thread safety
+    std::unique_ptr<NativeFile> storageFile;
+    std::shared_mutex layoutLock;  // Shared for block operations, exclusive to grow or format
+    std::vector<std::unique_ptr<BlockGroup>> groups;
+    std::atomic<size_t> totalBlocks{0};
+    std::atomic<size_t> freeBlocks{0};  // Sum of the group counters
+    size_t formattedBlocks{0};
+    uint64_t bitmapOffset{0};
+    std::array<std::atomic<size_t>, HINT_SLOTS> allocationHints{};
+    std::unique_ptr<AsyncIO> asyncIO;  // Started on first async request
+    std::once_flag asyncInit;
+    common::LatencyHistogram readLatency;
+    common::LatencyHistogram writeLatency;
 
     // Internal helper methods
-    bool initializeStorage();
-    void loadBitmap();
-    void saveBitmap();
+    bool initializeStorage(size_t initialBlocks);
+    void createLayout(size_t blocks);
+    bool loadLayout();
+    void installBitmap(const std::vector<uint64_t>& words, size_t blocks);
+    std::vector<uint64_t> collectBitmap() const;
+    void writeHeader(uint64_t blocks, uint64_t bitmapAt);
+    void saveGroupRange(const BlockGroup& group, size_t first, size_t count);
+    void markRange(size_t firstBlock, size_t count, bool used);
+    size_t findExtentExclusive(size_t count, size_t from) const;
+    bool growExclusive(size_t neededBlocks);
+    BlockGroup& groupOf(size_t blockId) const { return *groups[blockId / GROUP_BLOCKS]; }
+    std::atomic<size_t>& allocationHint();
     bool validateBlockId(int blockId) const;
-    size_t getBlockOffset(int blockId) const;
-    bool setBit(size_t index, bool value);
-    bool getBit(size_t index);
+    uint64_t getBlockOffset(int blockId) const;
+    bool checkBlocks(const std::vector<BlockId>& blockIds);
+    AsyncIO& asyncBackend();
 };
 
 } // namespace mtfs::storage 
\ No newline at end of file
@@ -0,0 +1,396 @@
+#include "async_io.hpp"
+#include "native_file.hpp"
+#include "common/logger.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define MTFS_HAVE_IO_URING 1
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace mtfs::storage {
+
+using namespace mtfs::common;
+
+namespace {
+
+// Counts requests in flight so shutdown can wait for the last completion
+class InFlightCounter {
+public:
+    explicit InFlightCounter(size_t limit = SIZE_MAX) : limit(limit) {}
+
+    void acquire() {
+        std::unique_lock<std::mutex> lock(mutex);
+        available.wait(lock, [this]() { return count < limit; });
+        ++count;
+    }
+
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex);
+        --count;
+        available.notify_all();
+    }
+
+    void waitIdle() {
+        std::unique_lock<std::mutex> lock(mutex);
+        available.wait(lock, [this]() { return count == 0; });
+    }
+
+private:
+    size_t limit;
+    size_t count{0};
+    std::mutex mutex;
+    std::condition_variable available;
+};
+
+// Portable fallback: one worker thread doing positional I/O in submission order
+class ThreadedIO : public AsyncIO {
+public:
+    explicit ThreadedIO(const std::string& path)
+        : file(NativeFile::open(path, false)), worker([this]() { run(); }) {}
+
+    ~ThreadedIO() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        ready.notify_one();
+        worker.join();
+    }
+
+    void read(void* buffer, size_t size, uint64_t offset, Completion done) override {
+        enqueue({false, static_cast<char*>(buffer), size, offset, std::move(done)});
+    }
+
+    void write(const void* buffer, size_t size, uint64_t offset, Completion done) override {
+        enqueue({true, const_cast<char*>(static_cast<const char*>(buffer)), size, offset, std::move(done)});
+    }
+
+    const char* name() const override { return "thread"; }
+
+private:
+    struct Job {
+        bool write;
+        char* buffer;
+        size_t size;
+        uint64_t offset;
+        Completion done;
+    };
+
+    void enqueue(Job job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(std::move(job));
+        }
+        ready.notify_one();
+    }
+
+    void run() {
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ready.wait(lock, [this]() { return stopping || !jobs.empty(); });
+                if (jobs.empty()) return;  // Stopping with nothing left to do
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            try {
+                size_t transferred = job.write ? file->writeAt(job.buffer, job.size, job.offset)
+                                               : file->readAt(job.buffer, job.size, job.offset);
+                job.done(true, transferred);
+            } catch (const std::exception& e) {
+                LOG_ERROR(std::string("Async block I/O failed: ") + e.what());
+                job.done(false, 0);
+            }
+        }
+    }
+
+    std::unique_ptr<NativeFile> file;
+    std::deque<Job> jobs;
+    std::mutex mutex;
+    std::condition_variable ready;
+    bool stopping{false};
+    std::thread worker;  // Last, so it starts after the members it uses
+};
+
+#ifdef _WIN32
+// I/O completion port over a handle of its own opened for overlapped I/O
+class IocpIO : public AsyncIO {
+public:
+    static std::unique_ptr<IocpIO> open(const std::string& path) {
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                                  FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return nullptr;
+        HANDLE port = CreateIoCompletionPort(file, nullptr, 0, 1);
+        if (!port) {
+            CloseHandle(file);
+            return nullptr;
+        }
+        return std::unique_ptr<IocpIO>(new IocpIO(file, port));
+    }
+
+    ~IocpIO() override {
+        inFlight.waitIdle();
+        PostQueuedCompletionStatus(port, 0, SHUTDOWN_KEY, nullptr);
+        worker.join();
+        CloseHandle(port);
+        CloseHandle(file);
+    }
+
+    void read(void* buffer, size_t size, uint64_t offset, Completion done) override {
+        submit(false, buffer, size, offset, std::move(done));
+    }
+
+    void write(const void* buffer, size_t size, uint64_t offset, Completion done) override {
+        submit(true, const_cast<void*>(buffer), size, offset, std::move(done));
+    }
+
+    const char* name() const override { return "iocp"; }
+
+private:
+    static constexpr ULONG_PTR SHUTDOWN_KEY = 1;
+
+    // OVERLAPPED comes first so a completion packet maps back to its request
+    struct Request {
+        OVERLAPPED overlapped;
+        Completion done;
+    };
+
+    IocpIO(HANDLE file, HANDLE port) : file(file), port(port), worker([this]() { run(); }) {}
+
+    void submit(bool isWrite, void* buffer, size_t size, uint64_t offset, Completion done) {
+        auto* request = new Request{};
+        request->overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFFull);
+        request->overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        request->done = std::move(done);
+        inFlight.acquire();
+
+        DWORD length = static_cast<DWORD>(size);
+        BOOL ok = isWrite ? WriteFile(file, buffer, length, nullptr, &request->overlapped)
+                          : ReadFile(file, buffer, length, nullptr, &request->overlapped);
+        if (!ok) {
+            DWORD error = GetLastError();
+            if (error != ERROR_IO_PENDING) {
+                // Failed before queueing, so no completion packet will arrive
+                finish(request, error == ERROR_HANDLE_EOF, 0);
+            }
+        }
+    }
+
+    void run() {
+        for (;;) {
+            DWORD transferred = 0;
+            ULONG_PTR key = 0;
+            OVERLAPPED* overlapped = nullptr;
+            BOOL ok = GetQueuedCompletionStatus(port, &transferred, &key, &overlapped, INFINITE);
+            if (!overlapped) {
+                if (key == SHUTDOWN_KEY) return;
+                continue;
+            }
+            auto* request = reinterpret_cast<Request*>(overlapped);
+            finish(request, ok || GetLastError() == ERROR_HANDLE_EOF, transferred);
+        }
+    }
+
+    void finish(Request* request, bool ok, size_t transferred) {
+        request->done(ok, transferred);
+        delete request;
+        inFlight.release();
+    }
+
+    HANDLE file;
+    HANDLE port;
+    InFlightCounter inFlight;
+    std::thread worker;
+};
+#endif
+
+#ifdef MTFS_HAVE_IO_URING
+// io_uring driven through the raw system calls, so liburing is not required.
+// Submissions are serialized by a mutex; one reaper thread drains completions.
+class UringIO : public AsyncIO {
+public:
+    static constexpr unsigned QUEUE_DEPTH = 64;
+
+    // nullptr when the kernel lacks io_uring or the plain READ/WRITE opcodes
+    static std::unique_ptr<UringIO> open(const std::string& path) {
+        io_uring_params params{};
+        int ring = static_cast<int>(syscall(__NR_io_uring_setup, QUEUE_DEPTH, &params));
+        if (ring < 0) return nullptr;
+        // IORING_OP_READ/WRITE arrived in 5.6 together with this feature bit
+        if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+            ::close(ring);
+            return nullptr;
+        }
+        int fd = ::open(path.c_str(), O_RDWR);
+        if (fd < 0) {
+            ::close(ring);
+            return nullptr;
+        }
+        std::unique_ptr<UringIO> io(new UringIO(ring, fd));
+        if (!io->mapRings(params)) return nullptr;
+        io->reaper = std::thread([raw = io.get()]() { raw->run(); });
+        return io;
+    }
+
+    ~UringIO() override {
+        if (reaper.joinable()) {
+            inFlight.waitIdle();
+            submit(IORING_OP_NOP, nullptr, 0, 0, nullptr);  // Wakes the reaper to exit
+            reaper.join();
+        }
+        if (sqes) munmap(sqes, sqeBytes);
+        if (cqRing && cqRing != sqRing) munmap(cqRing, cqBytes);
+        if (sqRing) munmap(sqRing, sqBytes);
+        ::close(fileFd);
+        ::close(ringFd);
+    }
+
+    void read(void* buffer, size_t size, uint64_t offset, Completion done) override {
+        submit(IORING_OP_READ, buffer, size, offset, new Completion(std::move(done)));
+    }
+
+    void write(const void* buffer, size_t size, uint64_t offset, Completion done) override {
+        submit(IORING_OP_WRITE, const_cast<void*>(buffer), size, offset, new Completion(std::move(done)));
+    }
+
+    const char* name() const override { return "io_uring"; }
+
+private:
+    UringIO(int ring, int fd) : ringFd(ring), fileFd(fd), inFlight(QUEUE_DEPTH) {}
+
+    bool mapRings(const io_uring_params& params) {
+        sqBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) sqBytes = cqBytes = std::max(sqBytes, cqBytes);
+
+        sqRing = mmapRing(sqBytes, IORING_OFF_SQ_RING);
+        cqRing = single ? sqRing : mmapRing(cqBytes, IORING_OFF_CQ_RING);
+        sqeBytes = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(mmapRing(sqeBytes, IORING_OFF_SQES));
+        if (!sqRing || !cqRing || !sqes) return false;
+
+        char* sq = static_cast<char*>(sqRing);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        char* cq = static_cast<char*>(cqRing);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    void* mmapRing(size_t bytes, off_t offset) {
+        void* ring = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, offset);
+        return ring == MAP_FAILED ? nullptr : ring;
+    }
+
+    // A null completion marks the shutdown NOP
+    void submit(uint8_t opcode, void* buffer, size_t size, uint64_t offset, Completion* done) {
+        if (done) inFlight.acquire();  // Keeps the CQ from overflowing
+        std::lock_guard<std::mutex> lock(submitMutex);
+        unsigned tail = *sqTail;
+        unsigned index = tail & sqMask;
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = opcode;
+        sqe->fd = fileFd;
+        sqe->addr = reinterpret_cast<uint64_t>(buffer);
+        sqe->len = static_cast<uint32_t>(size);
+        sqe->off = offset;
+        sqe->user_data = reinterpret_cast<uint64_t>(done);
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+
+        while (syscall(__NR_io_uring_enter, ringFd, 1, 0, 0, nullptr, 0) < 0) {
+            if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                // Rejected before the kernel consumed the entry: take it back
+                LOG_ERROR("io_uring_enter failed: " + std::string(std::strerror(errno)));
+                __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+                if (done) {
+                    (*done)(false, 0);
+                    delete done;
+                    inFlight.release();
+                }
+                return;
+            }
+        }
+    }
+
+    void run() {
+        for (;;) {
+            unsigned head = *cqHead;
+            unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+            if (head == tail) {
+                syscall(__NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+                continue;
+            }
+            // Pairs with the unlock in submit(), ordering each request's setup
+            // before its completion; the kernel's own barriers do not count in
+            // the C++ memory model
+            { std::lock_guard<std::mutex> lock(submitMutex); }
+            for (; head != tail; ++head) {
+                const io_uring_cqe& cqe = cqes[head & cqMask];
+                auto* done = reinterpret_cast<Completion*>(cqe.user_data);
+                int result = cqe.res;
+                __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+                if (!done) return;  // Shutdown NOP; nothing else is in flight
+                (*done)(result >= 0, result >= 0 ? static_cast<size_t>(result) : 0);
+                delete done;
+                inFlight.release();
+            }
+        }
+    }
+
+    int ringFd;
+    int fileFd;
+    void* sqRing{nullptr};
+    void* cqRing{nullptr};
+    io_uring_sqe* sqes{nullptr};
+    size_t sqBytes{0};
+    size_t cqBytes{0};
+    size_t sqeBytes{0};
+    unsigned* sqTail{nullptr};
+    unsigned sqMask{0};
+    unsigned* sqArray{nullptr};
+    unsigned* cqHead{nullptr};
+    unsigned* cqTail{nullptr};
+    unsigned cqMask{0};
+    io_uring_cqe* cqes{nullptr};
+    std::mutex submitMutex;
+    InFlightCounter inFlight;
+    std::thread reaper;
+};
+#endif
+
+} // namespace
+
+std::unique_ptr<AsyncIO> AsyncIO::create(const std::string& path) {
+#ifdef _WIN32
+    if (auto io = IocpIO::open(path)) return io;
+#elif defined(MTFS_HAVE_IO_URING)
+    if (auto io = UringIO::open(path)) return io;
+#endif
+    LOG_INFO("Native async I/O unavailable, using a worker thread for: " + path);
+    return std::make_unique<ThreadedIO>(path);
+}
+
+} // namespace mtfs::storage
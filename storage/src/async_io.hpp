@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+namespace mtfs::storage {
+
+// Asynchronous positional file I/O. Requests are handed to the kernel
+// (io_uring on Linux, an I/O completion port on Windows) and completed on a
+// backend thread; platforms without either fall back to a worker thread.
+// Buffers must stay valid until the completion runs. Destroying the backend
+// waits for requests still in flight.
+class AsyncIO {
+public:
+    // Runs once per request: whether it succeeded and how many bytes moved
+    using Completion = std::function<void(bool ok, size_t transferred)>;
+
+    // Best backend available for `path` on this platform and kernel
+    static std::unique_ptr<AsyncIO> create(const std::string& path);
+
+    virtual ~AsyncIO() = default;
+
+    virtual void read(void* buffer, size_t size, uint64_t offset, Completion done) = 0;
+    virtual void write(const void* buffer, size_t size, uint64_t offset, Completion done) = 0;
+    virtual const char* name() const = 0;
+};
+
+} // namespace mtfs::storage
@@ -0,0 +1,218 @@
+#include "storage/block_bitmap.hpp"
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace mtfs::storage {
+
+namespace {
+
+constexpr uint64_t ALL_USED = ~0ull;
+
+unsigned countTrailingZeros(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+}
+
+unsigned popCount(uint64_t value) {
+#ifdef _MSC_VER
+    return static_cast<unsigned>(__popcnt64(value));
+#else
+    return static_cast<unsigned>(__builtin_popcountll(value));
+#endif
+}
+
+// Bits [from, from + count) of one word, with from + count <= 64
+uint64_t rangeMask(size_t from, size_t count) {
+    uint64_t mask = count >= BlockBitmap::WORD_BITS ? ALL_USED : ((1ull << count) - 1);
+    return mask << from;
+}
+
+} // namespace
+
+BlockBitmap::BlockBitmap(size_t blocks) {
+    resize(blocks);
+}
+
+bool BlockBitmap::test(size_t index) const {
+    return (bits[index / WORD_BITS] >> (index % WORD_BITS)) & 1u;
+}
+
+void BlockBitmap::assign(size_t first, size_t count, bool used) {
+    size_t end = first + count;
+    while (first < end) {
+        size_t word = first / WORD_BITS;
+        size_t offset = first % WORD_BITS;
+        size_t span = std::min(end - first, WORD_BITS - offset);
+        uint64_t mask = rangeMask(offset, span);
+        uint64_t before = bits[word];
+        bits[word] = used ? (before | mask) : (before & ~mask);
+        size_t changed = popCount(before ^ bits[word]);
+        freeBlocks = used ? freeBlocks - changed : freeBlocks + changed;
+        refreshSummary(word);
+        first += span;
+    }
+}
+
+void BlockBitmap::resize(size_t newBlocks) {
+    if (newBlocks < blocks) {
+        return;  // Shrinking is not supported
+    }
+    // Old padding becomes real, free blocks
+    if (blocks % WORD_BITS != 0) {
+        bits.back() &= ~rangeMask(blocks % WORD_BITS, WORD_BITS - blocks % WORD_BITS);
+    }
+    bits.resize(wordsFor(newBlocks), 0);
+    freeBlocks += newBlocks - blocks;
+    blocks = newBlocks;
+    setPadding();
+    rebuildSummaries();
+}
+
+size_t BlockBitmap::findFree(size_t from) const {
+    if (freeBlocks == 0) {
+        return NOT_FOUND;
+    }
+    if (from >= blocks) {
+        from = 0;
+    }
+    size_t found = findFreeFrom(from);
+    return found != NOT_FOUND ? found : findFreeFrom(0);
+}
+
+size_t BlockBitmap::findFreeRun(size_t count, size_t from) const {
+    if (count == 0 || count > freeBlocks) {
+        return NOT_FOUND;
+    }
+    if (from >= blocks) {
+        from = 0;
+    }
+    for (size_t start : {from, size_t(0)}) {
+        size_t position = findFreeFrom(start);
+        while (position != NOT_FOUND && position + count <= blocks) {
+            size_t end = nextUsed(position, position + count);
+            if (end == position + count) {
+                return position;
+            }
+            position = findFreeFrom(end);
+        }
+        if (from == 0) {
+            break;
+        }
+    }
+    return NOT_FOUND;
+}
+
+void BlockBitmap::load(std::vector<uint64_t> words, size_t newBlocks) {
+    words.resize(wordsFor(newBlocks), 0);
+    bits = std::move(words);
+    blocks = newBlocks;
+    setPadding();
+    size_t used = 0;
+    for (uint64_t word : bits) {
+        used += popCount(word);
+    }
+    freeBlocks = bits.size() * WORD_BITS - used;
+    rebuildSummaries();
+}
+
+size_t BlockBitmap::findFreeFrom(size_t from) const {
+    if (from >= blocks) {
+        return NOT_FOUND;
+    }
+    size_t word = from / WORD_BITS;
+    uint64_t available = ~bits[word] & (ALL_USED << (from % WORD_BITS));
+    if (available == 0) {
+        word = nextSet(0, word + 1);
+        if (word == NOT_FOUND) {
+            return NOT_FOUND;
+        }
+        available = ~bits[word];
+    }
+    return word * WORD_BITS + countTrailingZeros(available);
+}
+
+// First position >= index whose bit is set in summaries[level], climbing
+// the tree past runs of empty summary words
+size_t BlockBitmap::nextSet(size_t level, size_t index) const {
+    if (level >= summaries.size()) {
+        return NOT_FOUND;
+    }
+    const auto& summary = summaries[level];
+    size_t word = index / WORD_BITS;
+    if (word >= summary.size()) {
+        return NOT_FOUND;
+    }
+    uint64_t candidates = summary[word] & (ALL_USED << (index % WORD_BITS));
+    if (candidates == 0) {
+        word = nextSet(level + 1, word + 1);
+        if (word == NOT_FOUND) {
+            return NOT_FOUND;
+        }
+        candidates = summary[word];
+    }
+    return word * WORD_BITS + countTrailingZeros(candidates);
+}
+
+// First used block in [from, limit), or limit
+size_t BlockBitmap::nextUsed(size_t from, size_t limit) const {
+    while (from < limit) {
+        size_t word = from / WORD_BITS;
+        uint64_t used = bits[word] & (ALL_USED << (from % WORD_BITS));
+        if (used != 0) {
+            return std::min(limit, word * WORD_BITS + countTrailingZeros(used));
+        }
+        from = (word + 1) * WORD_BITS;
+    }
+    return limit;
+}
+
+// Propagate a change of bits[wordIndex] up the tree, stopping once a level is unchanged
+void BlockBitmap::refreshSummary(size_t wordIndex) {
+    size_t child = wordIndex;
+    for (size_t level = 0; level < summaries.size(); ++level) {
+        bool active = level == 0 ? bits[child] != ALL_USED : summaries[level - 1][child] != 0;
+        uint64_t& word = summaries[level][child / WORD_BITS];
+        uint64_t mask = 1ull << (child % WORD_BITS);
+        uint64_t updated = active ? (word | mask) : (word & ~mask);
+        if (updated == word) {
+            return;
+        }
+        word = updated;
+        child /= WORD_BITS;
+    }
+}
+
+void BlockBitmap::rebuildSummaries() {
+    summaries.clear();
+    size_t entries = bits.size();
+    while (entries > 0) {
+        std::vector<uint64_t> level(wordsFor(entries), 0);
+        for (size_t i = 0; i < entries; ++i) {
+            bool active = summaries.empty() ? bits[i] != ALL_USED : summaries.back()[i] != 0;
+            if (active) {
+                level[i / WORD_BITS] |= 1ull << (i % WORD_BITS);
+            }
+        }
+        summaries.push_back(std::move(level));
+        if (summaries.back().size() == 1) {
+            break;
+        }
+        entries = summaries.back().size();
+    }
+}
+
+void BlockBitmap::setPadding() {
+    if (blocks % WORD_BITS != 0) {
+        bits.back() |= rangeMask(blocks % WORD_BITS, WORD_BITS - blocks % WORD_BITS);
+    }
+}
+
+} // namespace mtfs::storage
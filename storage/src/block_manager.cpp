@@ -1,222 +1,768 @@
 #include "storage/block_manager.hpp"
+#include "native_file.hpp"
+#include "async_io.hpp"
 #include "common/logger.hpp"
+#include "common/checksum.hpp"
 #include <algorithm>
+#include <cstddef>
 #include <cstring>
+#include <functional>
+#include <numeric>
+#include <thread>
 
 namespace mtfs::storage {
 
 using namespace mtfs::common;
 
-BlockManager::BlockManager(const std::string& storagePath) 
-    : storagePath(storagePath), blockBitmap(BITMAP_BYTES, 0) {
-    InitializeCriticalSection(&cs);
-    if (!initializeStorage()) {
+namespace {
+
+// Source for zero-padding short blocks inside a vectored write
+char* zeroPadding() {
+    static const char zeros[BlockManager::BLOCK_SIZE] = {};
+    return const_cast<char*>(zeros);  // Only ever read from
+}
+
+// Order a batch by block ID and hand each run of consecutive IDs, at most
+// `maxRun` long, to fn(indices, count) as indices into the batch
+template<typename Fn>
+void forEachRun(const std::vector<BlockId>& blockIds, size_t maxRun, Fn fn) {
+    std::vector<size_t> order(blockIds.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return blockIds[a] < blockIds[b]; });
+    size_t begin = 0;
+    while (begin < order.size()) {
+        size_t end = begin + 1;
+        while (end < order.size() && end - begin < maxRun &&
+               blockIds[order[end]] == blockIds[order[end - 1]] + 1) {
+            ++end;
+        }
+        fn(&order[begin], end - begin);
+        begin = end;
+    }
+}
+
+// A block whose bytes past `transferred` lie beyond the end of the file reads as zero
+void zeroTail(std::vector<char>& block, size_t transferred) {
+    if (transferred < block.size()) {
+        std::fill(block.begin() + transferred, block.end(), 0);
+    }
+}
+
+// Superblock at offset 0. Files written before it existed start with a
+// 128-byte bitmap for a fixed 1024 blocks instead; the header takes over the
+// same bytes so block offsets are unchanged.
+constexpr char STORE_MAGIC[8] = {'M', 'T', 'F', 'S', 'B', 'L', 'K', '2'};
+constexpr uint32_t STORE_VERSION = 1;
+constexpr size_t LEGACY_BLOCKS = 1024;
+
+struct StoreHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t blockSize;
+    uint64_t totalBlocks;
+    uint64_t formattedBlocks;
+    uint64_t bitmapOffset;
+    uint32_t crc;  // Over every field above
+};
+static_assert(sizeof(StoreHeader) <= BlockManager::HEADER_BYTES, "Store header outgrew its region");
+
+uint32_t headerChecksum(const StoreHeader& header) {
+    return crc32(&header, offsetof(StoreHeader, crc));
+}
+
+struct PendingWrite {
+    std::promise<bool> promise;
+    std::vector<char> data;
+};
+
+struct PendingRead {
+    std::promise<std::vector<char>> promise;
+    std::vector<char> data;
+};
+
+} // namespace
+
+BlockManager::BlockGroup::BlockGroup(size_t firstBlock, BlockBitmap bitmap)
+    : firstBlock(firstBlock), bitmap(std::move(bitmap)), freeBlocks(this->bitmap.freeCount()) {
+    InitializeCriticalSection(&latch);
+}
+
+BlockManager::BlockGroup::~BlockGroup() {
+    DeleteCriticalSection(&latch);
+}
+
+BlockManager::BlockManager(const std::string& storagePath, size_t initialBlocks)
+    : storagePath(storagePath) {
+    if (!initializeStorage(initialBlocks)) {
         throw std::runtime_error("Failed to initialize storage");
     }
-    loadBitmap();
-    LOG_INFO("Block manager initialized at: " + storagePath);
+    LOG_INFO("Block manager initialized at: " + storagePath + " (" +
+             std::to_string(getTotalBlocks()) + " blocks)");
 }
 
 BlockManager::~BlockManager() {
-    EnterCriticalSection(&cs);
-    saveBitmap();
-    storageFile.close();
-    LeaveCriticalSection(&cs);
-    DeleteCriticalSection(&cs);
+    asyncIO.reset();  // Waits for requests still in flight
+    std::unique_lock<std::shared_mutex> layout(layoutLock);
+    storageFile.reset();  // Every bitmap change is already on disk
 }
 
 bool BlockManager::writeBlock(int blockId, const std::vector<char>& data) {
-    EnterCriticalSection(&cs);
+    common::LatencyTimer timer(writeLatency);
     try {
         if (!validateBlockId(blockId) || isBlockFree(blockId)) {
-            LeaveCriticalSection(&cs);
             LOG_ERROR("Invalid block ID or block is free: " + std::to_string(blockId));
             return false;
         }
 
         if (data.size() > BLOCK_SIZE) {
-            LeaveCriticalSection(&cs);
             LOG_ERROR("Data size exceeds block size");
             return false;
         }
 
-        std::vector<char> blockData(BLOCK_SIZE, 0);
-        std::copy(data.begin(), data.end(), blockData.begin());
-
-        size_t offset = getBlockOffset(blockId);
-        storageFile.seekp(offset);
-        storageFile.write(blockData.data(), BLOCK_SIZE);
-        storageFile.flush();
+        // Short data is zero-padded within the same call
+        IoSegment segments[] = {
+            {const_cast<char*>(data.data()), data.size()},
+            {zeroPadding(), BLOCK_SIZE - data.size()}
+        };
+        storageFile->writeVectorAt(segments, data.size() < BLOCK_SIZE ? 2 : 1, getBlockOffset(blockId));
 
         LOG_DEBUG("Written block: " + std::to_string(blockId));
-        LeaveCriticalSection(&cs);
         return true;
     } catch (const std::exception& e) {
         LOG_ERROR("Failed to write block: " + std::string(e.what()));
-        LeaveCriticalSection(&cs);
         return false;
     }
 }
 
 bool BlockManager::readBlock(int blockId, std::vector<char>& data) {
-    EnterCriticalSection(&cs);
+    common::LatencyTimer timer(readLatency);
     try {
         if (!validateBlockId(blockId) || isBlockFree(blockId)) {
-            LeaveCriticalSection(&cs);
             LOG_ERROR("Invalid block ID or block is free: " + std::to_string(blockId));
             return false;
         }
 
         data.resize(BLOCK_SIZE);
-        size_t offset = getBlockOffset(blockId);
-        storageFile.seekg(offset);
-        storageFile.read(data.data(), BLOCK_SIZE);
+        zeroTail(data, storageFile->readAt(data.data(), BLOCK_SIZE, getBlockOffset(blockId)));
 
         LOG_DEBUG("Read block: " + std::to_string(blockId));
-        LeaveCriticalSection(&cs);
         return true;
     } catch (const std::exception& e) {
         LOG_ERROR("Failed to read block: " + std::string(e.what()));
-        LeaveCriticalSection(&cs);
         return false;
     }
 }
 
+bool BlockManager::writeBlocks(const std::vector<BlockId>& blockIds, const std::vector<std::vector<char>>& data) {
+    common::LatencyTimer timer(writeLatency);
+    try {
+        if (blockIds.size() != data.size()) {
+            LOG_ERROR("Block batch has " + std::to_string(blockIds.size()) + " IDs but " +
+                      std::to_string(data.size()) + " buffers");
+            return false;
+        }
+        if (!checkBlocks(blockIds)) {
+            return false;
+        }
+        for (const auto& block : data) {
+            if (block.size() > BLOCK_SIZE) {
+                LOG_ERROR("Data size exceeds block size");
+                return false;
+            }
+        }
+
+        std::vector<IoSegment> segments;
+        forEachRun(blockIds, MAX_RUN_BLOCKS, [&](const size_t* indices, size_t count) {
+            segments.clear();
+            for (size_t i = 0; i < count; ++i) {
+                const auto& block = data[indices[i]];
+                segments.push_back({const_cast<char*>(block.data()), block.size()});
+                if (block.size() < BLOCK_SIZE) {
+                    segments.push_back({zeroPadding(), BLOCK_SIZE - block.size()});
+                }
+            }
+            storageFile->writeVectorAt(segments.data(), segments.size(), getBlockOffset(blockIds[indices[0]]));
+        });
+
+        LOG_DEBUG("Written " + std::to_string(blockIds.size()) + " blocks");
+        return true;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to write blocks: " + std::string(e.what()));
+        return false;
+    }
+}
+
+bool BlockManager::readBlocks(const std::vector<BlockId>& blockIds, std::vector<std::vector<char>>& data) {
+    common::LatencyTimer timer(readLatency);
+    try {
+        if (!checkBlocks(blockIds)) {
+            return false;
+        }
+
+        data.resize(blockIds.size());
+        std::vector<IoSegment> segments;
+        forEachRun(blockIds, MAX_RUN_BLOCKS, [&](const size_t* indices, size_t count) {
+            segments.clear();
+            for (size_t i = 0; i < count; ++i) {
+                auto& block = data[indices[i]];
+                block.resize(BLOCK_SIZE);
+                segments.push_back({block.data(), BLOCK_SIZE});
+            }
+            size_t transferred = storageFile->readVectorAt(segments.data(), segments.size(),
+                                                           getBlockOffset(blockIds[indices[0]]));
+            for (size_t i = 0; i < count; ++i) {
+                size_t start = i * BLOCK_SIZE;
+                zeroTail(data[indices[i]], transferred > start ? transferred - start : 0);
+            }
+        });
+
+        LOG_DEBUG("Read " + std::to_string(blockIds.size()) + " blocks");
+        return true;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to read blocks: " + std::string(e.what()));
+        return false;
+    }
+}
+
+std::future<bool> BlockManager::writeBlockAsync(BlockId blockId, std::vector<char> data) {
+    auto pending = std::make_shared<PendingWrite>();
+    auto future = pending->promise.get_future();
+    try {
+        if (!validateBlockId(blockId) || isBlockFree(blockId)) {
+            LOG_ERROR("Invalid block ID or block is free: " + std::to_string(blockId));
+            pending->promise.set_value(false);
+            return future;
+        }
+        if (data.size() > BLOCK_SIZE) {
+            LOG_ERROR("Data size exceeds block size");
+            pending->promise.set_value(false);
+            return future;
+        }
+
+        pending->data = std::move(data);
+        pending->data.resize(BLOCK_SIZE, 0);
+        asyncBackend().write(pending->data.data(), BLOCK_SIZE, getBlockOffset(blockId),
+                             [pending](bool ok, size_t transferred) {
+            pending->promise.set_value(ok && transferred == BLOCK_SIZE);
+        });
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to submit block write: " + std::string(e.what()));
+        pending->promise.set_value(false);
+    }
+    return future;
+}
+
+std::future<std::vector<char>> BlockManager::readBlockAsync(BlockId blockId) {
+    auto pending = std::make_shared<PendingRead>();
+    auto future = pending->promise.get_future();
+    try {
+        if (!validateBlockId(blockId) || isBlockFree(blockId)) {
+            LOG_ERROR("Invalid block ID or block is free: " + std::to_string(blockId));
+            pending->promise.set_value({});
+            return future;
+        }
+
+        pending->data.resize(BLOCK_SIZE);
+        asyncBackend().read(pending->data.data(), BLOCK_SIZE, getBlockOffset(blockId),
+                            [pending](bool ok, size_t transferred) {
+            if (!ok) {
+                pending->promise.set_value({});
+                return;
+            }
+            zeroTail(pending->data, transferred);
+            pending->promise.set_value(std::move(pending->data));
+        });
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to submit block read: " + std::string(e.what()));
+        pending->promise.set_value({});
+    }
+    return future;
+}
+
+const char* BlockManager::getAsyncBackendName() {
+    return asyncBackend().name();
+}
+
 int BlockManager::allocateBlock() {
-    EnterCriticalSection(&cs);
-    for (size_t i = 0; i < MAX_BLOCKS; ++i) {
-        if (!getBit(i)) {
-            setBit(i, true);
-            saveBitmap();
-            LOG_DEBUG("Allocated block: " + std::to_string(i));
-            LeaveCriticalSection(&cs);
-            return static_cast<int>(i);
+    for (;;) {
+        size_t observedTotal;
+        {
+            std::shared_lock<std::shared_mutex> layout(layoutLock);
+            auto& hint = allocationHint();
+            observedTotal = totalBlocks.load(std::memory_order_relaxed);
+            size_t start = hint.load(std::memory_order_relaxed);
+            if (start >= observedTotal) {
+                start = 0;
+            }
+
+            // Start in this thread's group and move on past full ones
+            size_t firstGroup = start / GROUP_BLOCKS;
+            for (size_t i = 0; i < groups.size() && freeBlocks.load(std::memory_order_acquire) > 0; ++i) {
+                BlockGroup& group = *groups[(firstGroup + i) % groups.size()];
+                if (group.freeBlocks.load(std::memory_order_acquire) == 0) {
+                    continue;
+                }
+                EnterCriticalSection(&group.latch);
+                size_t local = group.bitmap.findFree(i == 0 ? start - group.firstBlock : 0);
+                if (local != BlockBitmap::NOT_FOUND) {
+                    markRange(group.firstBlock + local, 1, true);
+                    LeaveCriticalSection(&group.latch);
+                    size_t blockId = group.firstBlock + local;
+                    hint.store(blockId + 1, std::memory_order_relaxed);
+                    LOG_DEBUG("Allocated block: " + std::to_string(blockId));
+                    return static_cast<int>(blockId);
+                }
+                LeaveCriticalSection(&group.latch);
+            }
+        }
+
+        // Full: grow, unless another thread already did while we waited
+        std::unique_lock<std::shared_mutex> layout(layoutLock);
+        if (totalBlocks.load(std::memory_order_relaxed) == observedTotal &&
+            !growExclusive(observedTotal + 1)) {
+            LOG_ERROR("No free blocks available");
+            return -1;
         }
     }
-    LOG_ERROR("No free blocks available");
-    LeaveCriticalSection(&cs);
-    return -1;
 }
 
 bool BlockManager::freeBlock(int blockId) {
-    EnterCriticalSection(&cs);
-    if (!validateBlockId(blockId) || isBlockFree(blockId)) {
-        LeaveCriticalSection(&cs);
+    std::shared_lock<std::shared_mutex> layout(layoutLock);
+    if (!validateBlockId(blockId)) {
         LOG_ERROR("Invalid block ID or block already free: " + std::to_string(blockId));
         return false;
     }
 
-    setBit(blockId, false);
-    saveBitmap();
+    BlockGroup& group = groupOf(blockId);
+    EnterCriticalSection(&group.latch);
+    if (!group.bitmap.test(blockId - group.firstBlock)) {
+        LeaveCriticalSection(&group.latch);
+        LOG_ERROR("Invalid block ID or block already free: " + std::to_string(blockId));
+        return false;
+    }
+    markRange(blockId, 1, false);
+    LeaveCriticalSection(&group.latch);
     LOG_DEBUG("Freed block: " + std::to_string(blockId));
-    LeaveCriticalSection(&cs);
     return true;
 }
 
-void BlockManager::formatStorage() {
-    EnterCriticalSection(&cs);
-    // Clear bitmap
-    std::fill(blockBitmap.begin(), blockBitmap.end(), 0);
-    
-    // Reset storage file
-    storageFile.close();
-    storageFile.open(storagePath, std::ios::out | std::ios::binary | std::ios::trunc);
-    
-    // Write empty blocks
-    std::vector<char> emptyBlock(BLOCK_SIZE, 0);
-    for (size_t i = 0; i < MAX_BLOCKS; ++i) {
-        storageFile.write(emptyBlock.data(), BLOCK_SIZE);
-    }
-    storageFile.flush();
-    
-    // Reopen in read/write mode
-    storageFile.close();
-    storageFile.open(storagePath, std::ios::in | std::ios::out | std::ios::binary);
-    
-    saveBitmap();
-    LOG_INFO("Storage formatted");
-    LeaveCriticalSection(&cs);
+BlockId BlockManager::allocateExtent(size_t count) {
+    if (count == 0 || count > MAX_BLOCKS) {
+        LOG_ERROR("Invalid extent length: " + std::to_string(count));
+        return -1;
+    }
+
+    auto& hint = allocationHint();
+    if (count <= GROUP_BLOCKS) {
+        // Extents that fit in a group are found under that group's latch alone
+        std::shared_lock<std::shared_mutex> layout(layoutLock);
+        size_t start = hint.load(std::memory_order_relaxed);
+        if (start >= totalBlocks.load(std::memory_order_relaxed)) {
+            start = 0;
+        }
+        size_t firstGroup = start / GROUP_BLOCKS;
+        for (size_t i = 0; i < groups.size(); ++i) {
+            BlockGroup& group = *groups[(firstGroup + i) % groups.size()];
+            if (group.freeBlocks.load(std::memory_order_acquire) < count) {
+                continue;
+            }
+            EnterCriticalSection(&group.latch);
+            size_t local = group.bitmap.findFreeRun(count, i == 0 ? start - group.firstBlock : 0);
+            if (local != BlockBitmap::NOT_FOUND) {
+                markRange(group.firstBlock + local, count, true);
+                LeaveCriticalSection(&group.latch);
+                size_t first = group.firstBlock + local;
+                hint.store(first + count, std::memory_order_relaxed);
+                LOG_DEBUG("Allocated extent: " + std::to_string(first) + "+" + std::to_string(count));
+                return static_cast<BlockId>(first);
+            }
+            LeaveCriticalSection(&group.latch);
+        }
+    }
+
+    // Runs crossing group boundaries are searched with the layout held exclusively
+    std::unique_lock<std::shared_mutex> layout(layoutLock);
+    size_t first = findExtentExclusive(count, hint.load(std::memory_order_relaxed));
+    if (first == BlockBitmap::NOT_FOUND) {
+        // Free blocks at the old end join the new space, so search from there
+        size_t previousTotal = totalBlocks.load(std::memory_order_relaxed);
+        if (!growExclusive(previousTotal + count)) {
+            LOG_ERROR("No free extent of " + std::to_string(count) + " blocks available");
+            return -1;
+        }
+        first = findExtentExclusive(count, previousTotal > count ? previousTotal - count : 0);
+        if (first == BlockBitmap::NOT_FOUND) {
+            LOG_ERROR("No free extent of " + std::to_string(count) + " blocks available");
+            return -1;
+        }
+    }
+
+    markRange(first, count, true);
+    hint.store(first + count, std::memory_order_relaxed);
+    LOG_DEBUG("Allocated extent: " + std::to_string(first) + "+" + std::to_string(count));
+    return static_cast<BlockId>(first);
+}
+
+bool BlockManager::freeExtent(BlockId firstBlock, size_t count) {
+    std::shared_lock<std::shared_mutex> layout(layoutLock);
+    if (count == 0 || !validateBlockId(firstBlock) ||
+        count > getTotalBlocks() - static_cast<size_t>(firstBlock)) {
+        LOG_ERROR("Invalid extent: " + std::to_string(firstBlock) + "+" + std::to_string(count));
+        return false;
+    }
+
+    // Latch every group the extent touches, in ascending order
+    size_t firstGroup = firstBlock / GROUP_BLOCKS;
+    size_t lastGroup = (firstBlock + count - 1) / GROUP_BLOCKS;
+    for (size_t g = firstGroup; g <= lastGroup; ++g) {
+        EnterCriticalSection(&groups[g]->latch);
+    }
+    auto release = [&]() {
+        for (size_t g = firstGroup; g <= lastGroup; ++g) {
+            LeaveCriticalSection(&groups[g]->latch);
+        }
+    };
+
+    for (size_t i = 0; i < count; ++i) {
+        size_t blockId = firstBlock + i;
+        const BlockGroup& group = groupOf(blockId);
+        if (!group.bitmap.test(blockId - group.firstBlock)) {
+            release();
+            LOG_ERROR("Extent contains free block: " + std::to_string(blockId));
+            return false;
+        }
+    }
+
+    markRange(firstBlock, count, false);
+    release();
+    LOG_DEBUG("Freed extent: " + std::to_string(firstBlock) + "+" + std::to_string(count));
+    return true;
 }
 
-size_t BlockManager::getFreeBlocks() {
-    EnterCriticalSection(&cs);
-    size_t count = 0;
-    for (size_t i = 0; i < MAX_BLOCKS; ++i) {
-        if (!getBit(i)) ++count;
+bool BlockManager::reserveBlock(int blockId) {
+    std::shared_lock<std::shared_mutex> layout(layoutLock);
+    if (!validateBlockId(blockId)) {
+        return false;
+    }
+
+    BlockGroup& group = groupOf(blockId);
+    EnterCriticalSection(&group.latch);
+    if (group.bitmap.test(blockId - group.firstBlock)) {
+        LeaveCriticalSection(&group.latch);
+        return false;
     }
-    LeaveCriticalSection(&cs);
-    return count;
+    markRange(blockId, 1, true);
+    LeaveCriticalSection(&group.latch);
+    LOG_DEBUG("Reserved block: " + std::to_string(blockId));
+    return true;
+}
+
+bool BlockManager::sync() {
+    bool result = storageFile->sync();
+    if (!result) {
+        LOG_ERROR("Failed to sync storage: " + storagePath);
+    }
+    return result;
+}
+
+void BlockManager::formatStorage() {
+    std::unique_lock<std::shared_mutex> layout(layoutLock);
+    // Back to the formatted capacity with every block zeroed
+    try {
+        createLayout(formattedBlocks);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to reset storage: " + std::string(e.what()));
+    }
+    for (auto& hint : allocationHints) {
+        hint.store(0, std::memory_order_relaxed);
+    }
+    LOG_INFO("Storage formatted");
 }
 
 bool BlockManager::isBlockFree(int blockId) {
+    std::shared_lock<std::shared_mutex> layout(layoutLock);
     if (!validateBlockId(blockId)) return true;
-    EnterCriticalSection(&cs);
-    bool result = !getBit(blockId);
-    LeaveCriticalSection(&cs);
+    BlockGroup& group = groupOf(blockId);
+    EnterCriticalSection(&group.latch);
+    bool result = !group.bitmap.test(blockId - group.firstBlock);
+    LeaveCriticalSection(&group.latch);
     return result;
 }
 
 // Private helper methods
-bool BlockManager::initializeStorage() {
-    storageFile.open(storagePath, std::ios::in | std::ios::out | std::ios::binary);
-    if (!storageFile) {
-        // Create new storage file
-        storageFile.clear();
-        storageFile.open(storagePath, std::ios::out | std::ios::binary);
-        if (!storageFile) return false;
-        
-        // Initialize with empty blocks
-        std::vector<char> emptyBlock(BLOCK_SIZE, 0);
-        for (size_t i = 0; i < MAX_BLOCKS; ++i) {
-            storageFile.write(emptyBlock.data(), BLOCK_SIZE);
-        }
-        storageFile.close();
-        
-        // Reopen in read/write mode
-        storageFile.open(storagePath, std::ios::in | std::ios::out | std::ios::binary);
-        return storageFile.good();
+bool BlockManager::initializeStorage(size_t initialBlocks) {
+    try {
+        storageFile = NativeFile::open(storagePath, true);
+        if (storageFile->size() == 0) {
+            if (initialBlocks == 0 || initialBlocks > MAX_BLOCKS) {
+                LOG_ERROR("Invalid initial block count: " + std::to_string(initialBlocks));
+                return false;
+            }
+            createLayout(initialBlocks);
+            return true;
+        }
+        return loadLayout();
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to open storage: " + std::string(e.what()));
+        return false;
+    }
+}
+
+// Caller holds the layout exclusively or has sole access
+void BlockManager::createLayout(size_t blocks) {
+    BlockBitmap bitmap(blocks);
+    formattedBlocks = blocks;
+    bitmapOffset = getBlockOffset(static_cast<BlockId>(blocks));
+
+    // Truncating and re-extending the file zeroes every block
+    const auto& words = bitmap.words();
+    storageFile->resize(0);
+    storageFile->resize(bitmapOffset + words.size() * sizeof(uint64_t));
+    storageFile->writeAt(words.data(), words.size() * sizeof(uint64_t), bitmapOffset);
+    writeHeader(blocks, bitmapOffset);
+    installBitmap(words, blocks);
+}
+
+bool BlockManager::loadLayout() {
+    StoreHeader header{};
+    storageFile->readAt(&header, sizeof(header), 0);
+
+    if (std::memcmp(header.magic, STORE_MAGIC, sizeof(STORE_MAGIC)) != 0) {
+        // Legacy store: 1024 blocks, bitmap bytes at offset 0, bit i of byte j for block 8j + i
+        std::vector<uint8_t> legacy(LEGACY_BLOCKS / 8, 0);
+        storageFile->readAt(legacy.data(), legacy.size(), 0);
+        std::vector<uint64_t> words(BlockBitmap::wordsFor(LEGACY_BLOCKS), 0);
+        for (size_t i = 0; i < legacy.size(); ++i) {
+            words[i / 8] |= static_cast<uint64_t>(legacy[i]) << (8 * (i % 8));
+        }
+        formattedBlocks = LEGACY_BLOCKS;
+        bitmapOffset = getBlockOffset(static_cast<BlockId>(LEGACY_BLOCKS));
+
+        // The old bitmap stays valid until the header replaces it
+        storageFile->writeAt(words.data(), words.size() * sizeof(uint64_t), bitmapOffset);
+        storageFile->sync();
+        writeHeader(LEGACY_BLOCKS, bitmapOffset);
+        storageFile->sync();
+        installBitmap(words, LEGACY_BLOCKS);
+        LOG_INFO("Migrated legacy block store: " + storagePath);
+        return true;
     }
+
+    if (header.crc != headerChecksum(header) || header.version != STORE_VERSION ||
+        header.blockSize != BLOCK_SIZE || header.totalBlocks == 0 ||
+        header.totalBlocks > MAX_BLOCKS || header.formattedBlocks > header.totalBlocks) {
+        LOG_ERROR("Corrupt block store header: " + storagePath);
+        return false;
+    }
+
+    std::vector<uint64_t> words(BlockBitmap::wordsFor(header.totalBlocks), 0);
+    storageFile->readAt(words.data(), words.size() * sizeof(uint64_t), header.bitmapOffset);
+    formattedBlocks = header.formattedBlocks;
+    bitmapOffset = header.bitmapOffset;
+    installBitmap(words, header.totalBlocks);
     return true;
 }
 
-void BlockManager::loadBitmap() {
-    EnterCriticalSection(&cs);
-    storageFile.seekg(0);
-    storageFile.read(reinterpret_cast<char*>(blockBitmap.data()), BITMAP_BYTES);
-    LeaveCriticalSection(&cs);
+// Replace every group with slices of `words`. Caller holds the layout exclusively.
+void BlockManager::installBitmap(const std::vector<uint64_t>& words, size_t blocks) {
+    constexpr size_t groupWords = GROUP_BLOCKS / BlockBitmap::WORD_BITS;
+    groups.clear();
+    size_t available = 0;
+    for (size_t first = 0; first < blocks; first += GROUP_BLOCKS) {
+        size_t firstWord = first / BlockBitmap::WORD_BITS;
+        size_t lastWord = std::min(words.size(), firstWord + groupWords);
+        BlockBitmap bitmap;
+        bitmap.load(std::vector<uint64_t>(words.begin() + firstWord, words.begin() + lastWord),
+                    std::min(GROUP_BLOCKS, blocks - first));
+        available += bitmap.freeCount();
+        groups.push_back(std::make_unique<BlockGroup>(first, std::move(bitmap)));
+    }
+    freeBlocks.store(available, std::memory_order_release);
+    totalBlocks.store(blocks, std::memory_order_release);
 }
 
-void BlockManager::saveBitmap() {
-    storageFile.seekp(0);
-    storageFile.write(reinterpret_cast<const char*>(blockBitmap.data()), BITMAP_BYTES);
-    storageFile.flush();
+// Every group's words end to end, as stored on disk
+std::vector<uint64_t> BlockManager::collectBitmap() const {
+    std::vector<uint64_t> words;
+    for (const auto& group : groups) {
+        const auto& groupWords = group->bitmap.words();
+        words.insert(words.end(), groupWords.begin(), groupWords.end());
+    }
+    return words;
 }
 
-bool BlockManager::validateBlockId(int blockId) const {
-    return blockId >= 0 && static_cast<size_t>(blockId) < MAX_BLOCKS;
+void BlockManager::writeHeader(uint64_t blocks, uint64_t bitmapAt) {
+    char region[HEADER_BYTES] = {};
+    StoreHeader header{};
+    std::memcpy(header.magic, STORE_MAGIC, sizeof(STORE_MAGIC));
+    header.version = STORE_VERSION;
+    header.blockSize = BLOCK_SIZE;
+    header.totalBlocks = blocks;
+    header.formattedBlocks = formattedBlocks;
+    header.bitmapOffset = bitmapAt;
+    header.crc = headerChecksum(header);
+    std::memcpy(region, &header, sizeof(header));
+    storageFile->writeAt(region, HEADER_BYTES, 0);
+}
+
+// Write back the words of one group covering [first, first + count), group-relative
+void BlockManager::saveGroupRange(const BlockGroup& group, size_t first, size_t count) {
+    try {
+        const auto& words = group.bitmap.words();
+        size_t firstWord = first / BlockBitmap::WORD_BITS;
+        size_t lastWord = (first + count - 1) / BlockBitmap::WORD_BITS;
+        uint64_t offset = bitmapOffset + (group.firstBlock / BlockBitmap::WORD_BITS + firstWord) * sizeof(uint64_t);
+        storageFile->writeAt(&words[firstWord], (lastWord - firstWord + 1) * sizeof(uint64_t), offset);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to save block bitmap: " + std::string(e.what()));
+    }
+}
+
+// Set or clear [firstBlock, firstBlock + count), keep the counters in step
+// and persist the touched words. Caller holds the latch of every group in
+// the range, or the layout exclusively.
+void BlockManager::markRange(size_t firstBlock, size_t count, bool used) {
+    size_t end = firstBlock + count;
+    while (firstBlock < end) {
+        BlockGroup& group = groupOf(firstBlock);
+        size_t local = firstBlock - group.firstBlock;
+        size_t span = std::min(end - firstBlock, group.bitmap.size() - local);
+        group.bitmap.assign(local, span, used);
+        if (used) {
+            group.freeBlocks.fetch_sub(span, std::memory_order_release);
+            freeBlocks.fetch_sub(span, std::memory_order_release);
+        } else {
+            group.freeBlocks.fetch_add(span, std::memory_order_release);
+            freeBlocks.fetch_add(span, std::memory_order_release);
+        }
+        saveGroupRange(group, local, span);
+        firstBlock += span;
+    }
+}
+
+// First fit for `count` free blocks anywhere, crossing group boundaries,
+// from `from` and then from the start. Caller holds the layout exclusively.
+size_t BlockManager::findExtentExclusive(size_t count, size_t from) const {
+    size_t total = totalBlocks.load(std::memory_order_relaxed);
+    if (count > freeBlocks.load(std::memory_order_relaxed)) {
+        return BlockBitmap::NOT_FOUND;
+    }
+    for (size_t start : {from < total ? from : 0, size_t(0)}) {
+        size_t position = start;
+        while (position + count <= total) {
+            const BlockGroup& group = groupOf(position);
+            size_t local = group.freeBlocks.load(std::memory_order_relaxed) == 0
+                ? BlockBitmap::NOT_FOUND
+                : group.bitmap.findFreeFrom(position - group.firstBlock);
+            if (local == BlockBitmap::NOT_FOUND) {
+                position = group.firstBlock + group.bitmap.size();
+                continue;
+            }
+            position = group.firstBlock + local;
+            if (position + count > total) {
+                break;
+            }
+
+            // Extend the run through following groups until it is long enough or hits a used block
+            size_t end = position;
+            while (end < position + count) {
+                const BlockGroup& current = groupOf(end);
+                size_t limit = std::min(position + count, current.firstBlock + current.bitmap.size());
+                end += current.bitmap.freeRunLength(end - current.firstBlock, limit - current.firstBlock);
+                if (end < limit) {
+                    break;
+                }
+            }
+            if (end >= position + count) {
+                return position;
+            }
+            position = end + 1;  // `end` is in use
+        }
+        if (start == 0) {
+            break;
+        }
+    }
+    return BlockBitmap::NOT_FOUND;
+}
+
+// Double the store (or more, to reach neededBlocks). The bitmap is written
+// past the new end and synced before the header points at it; the old
+// bitmap's bytes become part of the new, free blocks and are zeroed last.
+// Caller holds the layout exclusively.
+bool BlockManager::growExclusive(size_t neededBlocks) {
+    size_t current = totalBlocks.load(std::memory_order_relaxed);
+    size_t target = std::min(MAX_BLOCKS, std::max(neededBlocks, current * 2));
+    if (neededBlocks > MAX_BLOCKS || target <= current) {
+        return false;
+    }
+
+    BlockBitmap grown;
+    grown.load(collectBitmap(), current);
+    grown.resize(target);
+    try {
+        uint64_t oldBitmapOffset = bitmapOffset;
+        size_t oldBitmapBytes = BlockBitmap::wordsFor(current) * sizeof(uint64_t);
+        uint64_t newBitmapOffset = getBlockOffset(static_cast<BlockId>(target));
+
+        const auto& words = grown.words();
+        storageFile->resize(newBitmapOffset + words.size() * sizeof(uint64_t));
+        storageFile->writeAt(words.data(), words.size() * sizeof(uint64_t), newBitmapOffset);
+        storageFile->sync();
+
+        writeHeader(target, newBitmapOffset);
+        storageFile->sync();
+        bitmapOffset = newBitmapOffset;
+
+        std::vector<char> zeros(oldBitmapBytes, 0);
+        storageFile->writeAt(zeros.data(), zeros.size(), oldBitmapOffset);
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to grow storage: " + std::string(e.what()));
+        return false;
+    }
+
+    installBitmap(grown.words(), target);
+    LOG_INFO("Block store grown to " + std::to_string(target) + " blocks");
+    return true;
 }
 
-size_t BlockManager::getBlockOffset(int blockId) const {
-    return static_cast<size_t>(blockId) * BLOCK_SIZE + BITMAP_BYTES;
+std::atomic<size_t>& BlockManager::allocationHint() {
+    size_t slot = std::hash<std::thread::id>{}(std::this_thread::get_id()) % HINT_SLOTS;
+    return allocationHints[slot];
 }
 
-bool BlockManager::setBit(size_t index, bool value) {
-    if (index >= MAX_BLOCKS) return false;
-    size_t byteIndex = index / 8;
-    size_t bitIndex = index % 8;
-    if (value) {
-        blockBitmap[byteIndex] |= (1 << bitIndex);
-    } else {
-        blockBitmap[byteIndex] &= ~(1 << bitIndex);
+bool BlockManager::checkBlocks(const std::vector<BlockId>& blockIds) {
+    std::shared_lock<std::shared_mutex> layout(layoutLock);
+    for (BlockId blockId : blockIds) {
+        bool used = false;
+        if (validateBlockId(blockId)) {
+            BlockGroup& group = groupOf(blockId);
+            EnterCriticalSection(&group.latch);
+            used = group.bitmap.test(blockId - group.firstBlock);
+            LeaveCriticalSection(&group.latch);
+        }
+        if (!used) {
+            LOG_ERROR("Invalid block ID or block is free: " + std::to_string(blockId));
+            return false;
+        }
     }
     return true;
 }
 
-bool BlockManager::getBit(size_t index) {
-    if (index >= MAX_BLOCKS) return false;
-    size_t byteIndex = index / 8;
-    size_t bitIndex = index % 8;
-    return (blockBitmap[byteIndex] & (1 << bitIndex)) != 0;
+AsyncIO& BlockManager::asyncBackend() {
+    std::call_once(asyncInit, [this]() {
+        asyncIO = AsyncIO::create(storagePath);
+        LOG_INFO(std::string("Async block I/O backend: ") + asyncIO->name());
+    });
+    return *asyncIO;
+}
+
+bool BlockManager::validateBlockId(int blockId) const {
+    return blockId >= 0 && static_cast<size_t>(blockId) < getTotalBlocks();
+}
+
+uint64_t BlockManager::getBlockOffset(int blockId) const {
+    return static_cast<uint64_t>(blockId) * BLOCK_SIZE + HEADER_BYTES;
 }
 
-} // namespace mtfs::storage 
\ No newline at end of file
+} // namespace mtfs::storage 
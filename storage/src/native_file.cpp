@@ -0,0 +1,235 @@
+#include "native_file.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <climits>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace mtfs::storage {
+
+using namespace mtfs::common;
+
+namespace {
+
+#ifdef _WIN32
+// The handle is opened for overlapped I/O so the kernel does not serialize
+// concurrent requests on it; synchronous calls wait on a per-thread event.
+HANDLE threadEvent() {
+    thread_local struct EventHolder {
+        HANDLE event = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        ~EventHolder() { CloseHandle(event); }
+    } holder;
+    return holder.event;
+}
+
+// Returns false on error; end of file is a successful zero-byte transfer
+bool transferAt(HANDLE handle, bool write, void* buffer, DWORD size, uint64_t offset, DWORD& transferred) {
+    OVERLAPPED overlapped{};
+    overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFFull);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    overlapped.hEvent = threadEvent();
+    transferred = 0;
+    BOOL ok = write ? WriteFile(handle, buffer, size, nullptr, &overlapped)
+                    : ReadFile(handle, buffer, size, nullptr, &overlapped);
+    if (!ok) {
+        DWORD error = GetLastError();
+        if (error == ERROR_HANDLE_EOF) return true;
+        if (error != ERROR_IO_PENDING) return false;
+    }
+    if (!GetOverlappedResult(handle, &overlapped, &transferred, TRUE)) {
+        return GetLastError() == ERROR_HANDLE_EOF;
+    }
+    return true;
+}
+
+constexpr size_t MAX_TRANSFER = 1u << 30;  // Largest single ReadFile/WriteFile
+#else
+// Run preadv/pwritev until every segment is done or the file ends,
+// resuming from the middle of a segment after a partial transfer.
+size_t transferVector(int fd, bool write, const IoSegment* segments, size_t count, uint64_t offset) {
+    std::vector<iovec> iov(count);
+    for (size_t i = 0; i < count; ++i) {
+        iov[i].iov_base = segments[i].data;
+        iov[i].iov_len = segments[i].size;
+    }
+
+    size_t total = 0;
+    size_t first = 0;
+    while (first < count) {
+        int batch = static_cast<int>(std::min<size_t>(count - first, IOV_MAX));
+        ssize_t done = write ? pwritev(fd, &iov[first], batch, static_cast<off_t>(offset + total))
+                             : preadv(fd, &iov[first], batch, static_cast<off_t>(offset + total));
+        if (done < 0) {
+            if (errno == EINTR) continue;
+            throw FSException(std::string(write ? "pwritev" : "preadv") + " failed: " + std::strerror(errno));
+        }
+        if (done == 0) break;  // End of file
+        total += static_cast<size_t>(done);
+        size_t remaining = static_cast<size_t>(done);
+        while (first < count && remaining >= iov[first].iov_len) {
+            remaining -= iov[first].iov_len;
+            ++first;
+        }
+        if (remaining > 0) {
+            iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + remaining;
+            iov[first].iov_len -= remaining;
+        }
+    }
+    return total;
+}
+#endif
+
+} // namespace
+
+std::unique_ptr<NativeFile> NativeFile::open(const std::string& path, bool create) {
+    std::unique_ptr<NativeFile> file(new NativeFile());
+    file->path = path;
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                create ? OPEN_ALWAYS : OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        throw FSException("Failed to open storage file: " + path);
+    }
+    file->handle = handle;
+#else
+    int fd = ::open(path.c_str(), create ? (O_RDWR | O_CREAT) : O_RDWR, 0644);
+    if (fd < 0) {
+        throw FSException("Failed to open storage file: " + path);
+    }
+    file->fd = fd;
+#endif
+    return file;
+}
+
+NativeFile::~NativeFile() {
+#ifdef _WIN32
+    if (handle) CloseHandle(handle);
+#else
+    if (fd >= 0) ::close(fd);
+#endif
+}
+
+size_t NativeFile::readAt(void* buffer, size_t size, uint64_t offset) const {
+#ifdef _WIN32
+    char* out = static_cast<char*>(buffer);
+    size_t total = 0;
+    while (total < size) {
+        DWORD transferred = 0;
+        DWORD chunk = static_cast<DWORD>(std::min(size - total, MAX_TRANSFER));
+        if (!transferAt(handle, false, out + total, chunk, offset + total, transferred)) {
+            throw FSException("Failed to read storage file: " + path);
+        }
+        if (transferred == 0) break;
+        total += transferred;
+    }
+    return total;
+#else
+    IoSegment segment{static_cast<char*>(buffer), size};
+    return transferVector(fd, false, &segment, 1, offset);
+#endif
+}
+
+size_t NativeFile::writeAt(const void* buffer, size_t size, uint64_t offset) {
+#ifdef _WIN32
+    const char* in = static_cast<const char*>(buffer);
+    size_t total = 0;
+    while (total < size) {
+        DWORD transferred = 0;
+        DWORD chunk = static_cast<DWORD>(std::min(size - total, MAX_TRANSFER));
+        if (!transferAt(handle, true, const_cast<char*>(in) + total, chunk, offset + total, transferred) ||
+            transferred == 0) {
+            throw FSException("Failed to write storage file: " + path);
+        }
+        total += transferred;
+    }
+    return total;
+#else
+    // iovec is not const-qualified even for writes
+    IoSegment segment{const_cast<char*>(static_cast<const char*>(buffer)), size};
+    return transferVector(fd, true, &segment, 1, offset);
+#endif
+}
+
+size_t NativeFile::readVectorAt(const IoSegment* segments, size_t count, uint64_t offset) const {
+#ifdef _WIN32
+    // ReadFileScatter needs unbuffered, page-aligned I/O; stage instead
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) total += segments[i].size;
+    thread_local std::vector<char> staging;
+    staging.resize(total);
+    size_t done = readAt(staging.data(), total, offset);
+    size_t position = 0;
+    for (size_t i = 0; i < count && position < done; ++i) {
+        size_t piece = std::min(segments[i].size, done - position);
+        std::memcpy(segments[i].data, staging.data() + position, piece);
+        position += piece;
+    }
+    return done;
+#else
+    return transferVector(fd, false, segments, count, offset);
+#endif
+}
+
+size_t NativeFile::writeVectorAt(const IoSegment* segments, size_t count, uint64_t offset) {
+#ifdef _WIN32
+    thread_local std::vector<char> staging;
+    staging.clear();
+    for (size_t i = 0; i < count; ++i) {
+        staging.insert(staging.end(), segments[i].data, segments[i].data + segments[i].size);
+    }
+    return writeAt(staging.data(), staging.size(), offset);
+#else
+    return transferVector(fd, true, segments, count, offset);
+#endif
+}
+
+uint64_t NativeFile::size() const {
+#ifdef _WIN32
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize)) {
+        throw FSException("Failed to size storage file: " + path);
+    }
+    return static_cast<uint64_t>(fileSize.QuadPart);
+#else
+    struct stat fileStats;
+    if (fstat(fd, &fileStats) != 0) {
+        throw FSException("Failed to size storage file: " + path);
+    }
+    return static_cast<uint64_t>(fileStats.st_size);
+#endif
+}
+
+void NativeFile::resize(uint64_t newSize) {
+#ifdef _WIN32
+    FILE_END_OF_FILE_INFO endOfFile;
+    endOfFile.EndOfFile.QuadPart = static_cast<LONGLONG>(newSize);
+    if (!SetFileInformationByHandle(handle, FileEndOfFileInfo, &endOfFile, sizeof(endOfFile))) {
+        throw FSException("Failed to resize storage file: " + path);
+    }
+#else
+    if (ftruncate(fd, static_cast<off_t>(newSize)) != 0) {
+        throw FSException("Failed to resize storage file: " + path);
+    }
+#endif
+}
+
+bool NativeFile::sync() {
+#ifdef _WIN32
+    return FlushFileBuffers(handle) != 0;
+#else
+    return ::fsync(fd) == 0;
+#endif
+}
+
+} // namespace mtfs::storage
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include "common/error.hpp"
+
+namespace mtfs::storage {
+
+// One contiguous piece of a vectored transfer
+struct IoSegment {
+    char* data;
+    size_t size;
+};
+
+// Native file handle doing positional I/O only, so concurrent callers never
+// contend on a shared cursor. Short reads mean end of file.
+class NativeFile {
+public:
+    // Open read-write, creating the file if `create` is set; throws FSException
+    static std::unique_ptr<NativeFile> open(const std::string& path, bool create);
+    ~NativeFile();
+
+    NativeFile(const NativeFile&) = delete;
+    NativeFile& operator=(const NativeFile&) = delete;
+
+    size_t readAt(void* buffer, size_t size, uint64_t offset) const;
+    size_t writeAt(const void* buffer, size_t size, uint64_t offset);
+
+    // Scatter/gather over consecutive file bytes, one system call per
+    // IOV_MAX segments on POSIX; staged through one buffer on Windows
+    size_t readVectorAt(const IoSegment* segments, size_t count, uint64_t offset) const;
+    size_t writeVectorAt(const IoSegment* segments, size_t count, uint64_t offset);
+
+    uint64_t size() const;
+    void resize(uint64_t newSize);
+    bool sync();
+
+private:
+    NativeFile() = default;
+
+    std::string path;
+#ifdef _WIN32
+    void* handle{nullptr};
+#else
+    int fd{-1};
+#endif
+};
+
+} // namespace mtfs::storage
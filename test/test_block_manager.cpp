@@ -0,0 +1,293 @@
+#include <gtest/gtest.h>
+#include "storage/block_manager.hpp"
+#include "storage/block_bitmap.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mtfs::test {
+
+using mtfs::storage::BlockId;
+using mtfs::storage::BlockBitmap;
+using mtfs::storage::BlockManager;
+
+class BlockManagerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        storagePath = std::filesystem::temp_directory_path() / "mtfs_block_test.dat";
+        std::filesystem::remove(storagePath);
+        blocks = std::make_unique<BlockManager>(storagePath.string());
+    }
+
+    void TearDown() override {
+        blocks.reset();
+        std::filesystem::remove(storagePath);
+    }
+
+    static std::vector<char> pattern(BlockId blockId, size_t size = BlockManager::BLOCK_SIZE) {
+        std::vector<char> data(size);
+        for (size_t i = 0; i < size; ++i) {
+            data[i] = static_cast<char>(blockId * 7 + i);
+        }
+        return data;
+    }
+
+    std::filesystem::path storagePath;
+    std::unique_ptr<BlockManager> blocks;
+};
+
+// Out-of-order batches with gaps and short buffers round-trip through runs
+TEST_F(BlockManagerTest, BatchRoundTrip) {
+    std::vector<BlockId> ids;
+    for (int i = 0; i < 12; ++i) {
+        ids.push_back(blocks->allocateBlock());
+    }
+    std::vector<BlockId> batch = {ids[5], ids[2], ids[3], ids[4], ids[9], ids[11], ids[10]};
+    std::vector<std::vector<char>> data;
+    for (BlockId id : batch) {
+        data.push_back(pattern(id, id == ids[3] ? 100 : BlockManager::BLOCK_SIZE));
+    }
+    ASSERT_TRUE(blocks->writeBlocks(batch, data));
+
+    std::vector<std::vector<char>> readBack;
+    ASSERT_TRUE(blocks->readBlocks(batch, readBack));
+    ASSERT_EQ(readBack.size(), batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        std::vector<char> expected = data[i];
+        expected.resize(BlockManager::BLOCK_SIZE, 0);
+        EXPECT_EQ(readBack[i], expected) << "block " << batch[i];
+    }
+
+    // Single-block reads see the batched writes
+    std::vector<char> single;
+    ASSERT_TRUE(blocks->readBlock(ids[10], single));
+    EXPECT_EQ(single, pattern(ids[10]));
+
+    // The highest block, next to the bitmap, reads as zeros until written
+    BlockId last = static_cast<BlockId>(blocks->getTotalBlocks() - 1);
+    ASSERT_TRUE(blocks->reserveBlock(last));
+    ASSERT_TRUE(blocks->readBlocks({last}, readBack));
+    EXPECT_EQ(readBack[0], std::vector<char>(BlockManager::BLOCK_SIZE, 0));
+}
+
+TEST_F(BlockManagerTest, BatchRejectsUnallocatedBlocks) {
+    BlockId allocated = blocks->allocateBlock();
+    BlockId unallocated = allocated + 1;
+    ASSERT_FALSE(blocks->writeBlocks({allocated, unallocated}, {pattern(1), pattern(2)}));
+    ASSERT_FALSE(blocks->writeBlocks({allocated}, {}));
+
+    // Nothing from the rejected batch was written
+    std::vector<char> data;
+    ASSERT_TRUE(blocks->readBlock(allocated, data));
+    EXPECT_EQ(data, std::vector<char>(BlockManager::BLOCK_SIZE, 0));
+}
+
+// Concurrent async requests complete through futures without a shared cursor
+TEST_F(BlockManagerTest, AsyncReadsAndWrites) {
+    EXPECT_NE(std::string(blocks->getAsyncBackendName()), "");
+
+    std::vector<BlockId> ids;
+    for (int i = 0; i < 64; ++i) {
+        ids.push_back(blocks->allocateBlock());
+    }
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&, t]() {
+            std::vector<std::future<bool>> pending;
+            for (size_t i = t; i < ids.size(); i += 4) {
+                pending.push_back(blocks->writeBlockAsync(ids[i], pattern(ids[i])));
+            }
+            for (auto& result : pending) {
+                EXPECT_TRUE(result.get());
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    std::vector<std::future<std::vector<char>>> reads;
+    for (BlockId id : ids) {
+        reads.push_back(blocks->readBlockAsync(id));
+    }
+    for (size_t i = 0; i < ids.size(); ++i) {
+        EXPECT_EQ(reads[i].get(), pattern(ids[i]));
+    }
+
+    EXPECT_FALSE(blocks->writeBlockAsync(ids.back() + 1, pattern(0)).get());
+    EXPECT_TRUE(blocks->readBlockAsync(-1).get().empty());
+}
+
+TEST(BlockBitmapTest, FindsFreeBlocksAndRuns) {
+    BlockBitmap bitmap(100000);
+    EXPECT_EQ(bitmap.freeCount(), 100000u);
+    bitmap.assign(0, 70000, true);
+    bitmap.assign(70001, 29999, true);
+    EXPECT_EQ(bitmap.freeCount(), 1u);
+    EXPECT_EQ(bitmap.findFree(0), 70000u);
+    EXPECT_EQ(bitmap.findFree(80000), 70000u);  // Wraps around
+    EXPECT_EQ(bitmap.findFreeRun(2, 0), BlockBitmap::NOT_FOUND);
+
+    bitmap.assign(70000, 1, true);
+    EXPECT_EQ(bitmap.findFree(0), BlockBitmap::NOT_FOUND);
+
+    // A run has to skip a gap too short for it
+    bitmap.assign(500, 3, false);
+    bitmap.assign(1000, 200, false);
+    EXPECT_EQ(bitmap.findFreeRun(3, 0), 500u);
+    EXPECT_EQ(bitmap.findFreeRun(4, 0), 1000u);
+    EXPECT_EQ(bitmap.findFreeRun(150, 1100), 1000u);
+
+    // Grown blocks start free, including the old partial word's padding
+    bitmap.resize(100100);
+    EXPECT_EQ(bitmap.findFreeRun(100, 2000), 100000u);
+    EXPECT_EQ(bitmap.freeCount(), 303u);
+
+    BlockBitmap copy;
+    copy.load(bitmap.words(), bitmap.size());
+    EXPECT_EQ(copy.freeCount(), bitmap.freeCount());
+    EXPECT_TRUE(copy.test(70000));
+    EXPECT_FALSE(copy.test(100099));
+}
+
+// Allocation past the initial capacity grows the store and survives reopening
+TEST_F(BlockManagerTest, GrowsAndReopens) {
+    const size_t initial = blocks->getTotalBlocks();
+    std::vector<BlockId> ids;
+    for (size_t i = 0; i < initial + 10; ++i) {
+        ids.push_back(blocks->allocateBlock());
+        ASSERT_GE(ids.back(), 0);
+    }
+    EXPECT_EQ(blocks->getTotalBlocks(), initial * 2);
+    EXPECT_EQ(blocks->getFormattedBlocks(), initial);
+    EXPECT_EQ(blocks->getFreeBlocks(), initial - 10);
+
+    BlockId extent = blocks->allocateExtent(3 * initial);
+    ASSERT_GE(extent, 0);
+    EXPECT_GE(blocks->getTotalBlocks(), static_cast<size_t>(extent) + 3 * initial);
+    for (size_t i = 0; i < 3 * initial; ++i) {
+        EXPECT_FALSE(blocks->isBlockFree(extent + static_cast<BlockId>(i)));
+    }
+    BlockId high = ids.back();
+    ASSERT_TRUE(blocks->writeBlock(high, pattern(high)));
+    ASSERT_TRUE(blocks->freeBlock(ids[5]));
+    const size_t total = blocks->getTotalBlocks();
+    const size_t freeBlocks = blocks->getFreeBlocks();
+
+    blocks = std::make_unique<BlockManager>(storagePath.string());
+    EXPECT_EQ(blocks->getTotalBlocks(), total);
+    EXPECT_EQ(blocks->getFormattedBlocks(), initial);
+    EXPECT_EQ(blocks->getFreeBlocks(), freeBlocks);
+    EXPECT_TRUE(blocks->isBlockFree(ids[5]));
+    EXPECT_FALSE(blocks->isBlockFree(extent));
+    std::vector<char> data;
+    ASSERT_TRUE(blocks->readBlock(high, data));
+    EXPECT_EQ(data, pattern(high));
+
+    ASSERT_TRUE(blocks->freeExtent(extent, 3 * initial));
+    EXPECT_FALSE(blocks->freeExtent(extent, 1));  // Already free
+    EXPECT_EQ(blocks->getFreeBlocks(), freeBlocks + 3 * initial);
+}
+
+// A free run that starts within `count` blocks of the end of the last group
+// is not searched past the store; the store grows and the run continues into it
+TEST_F(BlockManagerTest, ExtentSearchStopsAtStoreEnd) {
+    const size_t initial = blocks->getTotalBlocks();
+    for (size_t count : {size_t(8), size_t(264)}) {  // Within a group of 256, and across groups
+        auto path = std::filesystem::temp_directory_path() / "mtfs_block_end_test.dat";
+        std::filesystem::remove(path);
+        {
+            BlockManager store(path.string());
+            ASSERT_EQ(store.allocateExtent(initial - 3), 0);
+            // Enough free blocks for the extent, but only as single gaps
+            for (BlockId id = 0; id < 600; id += 2) {
+                ASSERT_TRUE(store.freeBlock(id));
+            }
+            BlockId extent = store.allocateExtent(count);
+            ASSERT_EQ(extent, static_cast<BlockId>(initial - 3));
+            EXPECT_GE(store.getTotalBlocks(), initial - 3 + count);
+            for (size_t i = 0; i < count; ++i) {
+                EXPECT_FALSE(store.isBlockFree(extent + static_cast<BlockId>(i)));
+            }
+        }
+        std::filesystem::remove(path);
+    }
+}
+
+// Threads allocating, growing and freeing at once never share a block
+TEST_F(BlockManagerTest, ConcurrentAllocationAcrossGroups) {
+    const size_t initial = blocks->getTotalBlocks();
+    constexpr int threads = 8;
+    const size_t perThread = initial / 2;
+    std::vector<std::vector<BlockId>> owned(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (size_t i = 0; i < perThread; ++i) {
+                BlockId id = (i % 8 == 7) ? blocks->allocateExtent(3) : blocks->allocateBlock();
+                ASSERT_GE(id, 0);
+                owned[t].push_back(id);
+                if (i % 8 == 7) {
+                    owned[t].push_back(id + 1);
+                    owned[t].push_back(id + 2);
+                }
+                if (i % 5 == 4) {
+                    ASSERT_TRUE(blocks->freeBlock(owned[t].front()));
+                    owned[t].erase(owned[t].begin());
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    std::vector<BlockId> all;
+    for (const auto& ids : owned) {
+        all.insert(all.end(), ids.begin(), ids.end());
+    }
+    std::sort(all.begin(), all.end());
+    EXPECT_EQ(std::adjacent_find(all.begin(), all.end()), all.end());
+    EXPECT_GT(blocks->getTotalBlocks(), initial);
+    EXPECT_EQ(blocks->getFreeBlocks(), blocks->getTotalBlocks() - all.size());
+    for (BlockId id : all) {
+        EXPECT_FALSE(blocks->isBlockFree(id));
+    }
+}
+
+// Stores written before the superblock keep their allocations and data
+TEST_F(BlockManagerTest, MigratesLegacyStore) {
+    blocks.reset();
+    {
+        std::ofstream legacy(storagePath, std::ios::binary | std::ios::trunc);
+        std::vector<char> bitmapBytes(BlockManager::HEADER_BYTES, 0);
+        bitmapBytes[0] = 0x05;    // Blocks 0 and 2
+        bitmapBytes[127] = static_cast<char>(0x80);  // Block 1023
+        legacy.write(bitmapBytes.data(), bitmapBytes.size());
+        std::vector<char> blockData(1024 * BlockManager::BLOCK_SIZE, 0);
+        std::vector<char> block2 = pattern(2);
+        std::copy(block2.begin(), block2.end(), blockData.begin() + 2 * BlockManager::BLOCK_SIZE);
+        legacy.write(blockData.data(), blockData.size());
+    }
+
+    for (int reopen = 0; reopen < 2; ++reopen) {
+        blocks = std::make_unique<BlockManager>(storagePath.string());
+        EXPECT_EQ(blocks->getTotalBlocks(), 1024u);
+        EXPECT_EQ(blocks->getFreeBlocks(), 1021u);
+        EXPECT_FALSE(blocks->isBlockFree(0));
+        EXPECT_TRUE(blocks->isBlockFree(1));
+        EXPECT_FALSE(blocks->isBlockFree(1023));
+        std::vector<char> data;
+        ASSERT_TRUE(blocks->readBlock(2, data));
+        EXPECT_EQ(data, pattern(2));
+    }
+}
+
+} // namespace mtfs::test
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
+#include <list>
+#include <random>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 #include "cache/enhanced_cache.hpp"
 
@@ -50,3 +53,285 @@ TEST(EnhancedCacheTest, Statistics) {
     EXPECT_EQ(stats.hits, 1);
     EXPECT_EQ(stats.misses, 1);
 }
+
+class ByteBudgetTest : public ::testing::TestWithParam<CachePolicy> {};
+
+TEST_P(ByteBudgetTest, EvictsUntilBudgetFits) {
+    // Weigh only the value so the arithmetic below is exact
+    Weigher<int, std::string> weigher = [](const int&, const std::string& value) { return value.size(); };
+    CacheManager<int, std::string> cache(100, GetParam(), CapacityMode::BYTES, weigher);
+    
+    for (int i = 0; i < 10; ++i) {
+        cache.put(i, std::string(10, 'a'));
+    }
+    auto stats = cache.getStatistics();
+    EXPECT_EQ(stats.currentSize, 10u);
+    EXPECT_EQ(stats.residentBytes, 100u);
+    
+    // One large entry has to push out several small ones
+    cache.put(100, std::string(45, 'b'));
+    stats = cache.getStatistics();
+    EXPECT_TRUE(cache.contains(100));
+    EXPECT_LE(stats.residentBytes, 100u);
+    EXPECT_EQ(stats.currentSize, 6u);
+    EXPECT_EQ(stats.evictions, 5u);
+    
+    // Growing an entry in place also evicts others, never the entry itself
+    cache.put(100, std::string(80, 'c'));
+    stats = cache.getStatistics();
+    EXPECT_EQ(cache.get(100), std::string(80, 'c'));
+    EXPECT_EQ(stats.residentBytes, 100u);
+    EXPECT_EQ(stats.currentSize, 3u);
+}
+
+TEST_P(ByteBudgetTest, RejectsEntriesLargerThanBudget) {
+    Weigher<int, std::string> weigher = [](const int&, const std::string& value) { return value.size(); };
+    CacheManager<int, std::string> cache(64, GetParam(), CapacityMode::BYTES, weigher);
+    
+    cache.put(1, std::string(32, 'a'));
+    cache.put(2, std::string(200, 'b'));
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(2));
+    
+    // Replacing a cached value with an oversized one drops the stale copy
+    cache.put(1, std::string(65, 'c'));
+    EXPECT_FALSE(cache.contains(1));
+    EXPECT_EQ(cache.getStatistics().residentBytes, 0u);
+}
+
+TEST_P(ByteBudgetTest, PinnedEntriesSurviveEviction) {
+    Weigher<int, std::string> weigher = [](const int&, const std::string& value) { return value.size(); };
+    CacheManager<int, std::string> cache(30, GetParam(), CapacityMode::BYTES, weigher);
+    
+    cache.put(1, std::string(10, 'a'));
+    cache.put(2, std::string(10, 'b'));
+    cache.pin(1);
+    cache.pin(2);
+    cache.put(3, std::string(10, 'c'));
+    cache.put(4, std::string(10, 'd'));
+    
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_TRUE(cache.contains(2));
+    EXPECT_TRUE(cache.contains(4));
+    EXPECT_EQ(cache.getStatistics().residentBytes, 30u);
+    
+    // With everything pinned there is nothing to evict; the insert still succeeds
+    cache.pin(4);
+    cache.put(5, std::string(10, 'e'));
+    EXPECT_TRUE(cache.contains(5));
+    EXPECT_EQ(cache.getStatistics().residentBytes, 40u);
+    
+    cache.remove(5);
+    cache.clear();
+    EXPECT_EQ(cache.getStatistics().residentBytes, 0u);
+}
+
+TEST_P(ByteBudgetTest, PrefetchOnlyFillsFreeRoom) {
+    Weigher<int, std::string> weigher = [](const int&, const std::string& value) { return value.size(); };
+    CacheManager<int, std::string> cache(30, GetParam(), CapacityMode::BYTES, weigher);
+    
+    cache.put(1, std::string(10, 'a'));
+    EXPECT_TRUE(cache.prefetchIfRoom(2, std::string(10, 'b')));
+    EXPECT_FALSE(cache.prefetchIfRoom(2, std::string(5, 'x')));   // Already resident
+    EXPECT_FALSE(cache.prefetchIfRoom(3, std::string(15, 'c')));  // Would need an eviction
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(3));
+    EXPECT_EQ(cache.getStatistics().evictions, 0u);
+    
+    // Only the first use of a prefetched entry counts as a prefetch hit
+    EXPECT_EQ(cache.get(2), std::string(10, 'b'));
+    cache.get(2);
+    EXPECT_TRUE(cache.prefetchIfRoom(4, std::string(10, 'd')));
+    auto stats = cache.getStatistics();
+    EXPECT_EQ(stats.prefetchedItems, 2u);
+    EXPECT_EQ(stats.prefetchHits, 1u);
+    EXPECT_DOUBLE_EQ(stats.prefetchHitRate, 50.0);
+    
+    // A write makes it ordinary data, no longer a pending prefetch
+    cache.put(4, std::string(10, 'e'));
+    cache.get(4);
+    EXPECT_EQ(cache.getStatistics().prefetchHits, 1u);
+}
+
+INSTANTIATE_TEST_SUITE_P(AllPolicies, ByteBudgetTest,
+                         ::testing::Values(CachePolicy::LRU, CachePolicy::LFU,
+                                           CachePolicy::FIFO, CachePolicy::LIFO,
+                                           CachePolicy::ARC));
+
+TEST(EnhancedCacheTest, EntryModeTracksResidentBytes) {
+    CacheManager<std::string, std::string> cache(2);
+    cache.put("a", std::string(1000, 'x'));
+    
+    auto stats = cache.getStatistics();
+    EXPECT_EQ(stats.currentSize, 1u);
+    EXPECT_GE(stats.residentBytes, 1000u);
+    EXPECT_EQ(cache.getCapacityMode(), CapacityMode::ENTRIES);
+    
+    cache.setCapacityMode(CapacityMode::BYTES, 4096);
+    EXPECT_EQ(cache.getCapacityMode(), CapacityMode::BYTES);
+    EXPECT_EQ(cache.getStatistics().currentSize, 0u);
+}
+
+TEST(ARCCacheTest, WorkingSetSurvivesScan) {
+    const int capacity = 100;
+    CacheManager<int, int> arc(capacity, CachePolicy::ARC);
+    CacheManager<int, int> lru(capacity, CachePolicy::LRU);
+    
+    // Cache-aside access: a miss loads the value, a hit just reads it
+    auto access = [](CacheManager<int, int>& cache, int key) {
+        if (cache.contains(key)) {
+            cache.get(key);
+        } else {
+            cache.put(key, key);
+        }
+    };
+    
+    // Establish a hot working set that is read repeatedly
+    for (int round = 0; round < 3; ++round) {
+        for (int key = 0; key < 50; ++key) {
+            access(arc, key);
+            access(lru, key);
+        }
+    }
+    
+    // A one-pass sweep over many cold keys, like a nightly backup
+    for (int key = 1000; key < 1500; ++key) {
+        access(arc, key);
+        access(lru, key);
+    }
+    
+    int arcHot = 0;
+    int lruHot = 0;
+    for (int key = 0; key < 50; ++key) {
+        arcHot += arc.contains(key) ? 1 : 0;
+        lruHot += lru.contains(key) ? 1 : 0;
+    }
+    EXPECT_EQ(arcHot, 50);
+    EXPECT_EQ(lruHot, 0);
+    EXPECT_LE(arc.getStatistics().currentSize, static_cast<size_t>(capacity));
+}
+
+TEST(ARCCacheTest, GhostHitsAdaptRecencyTarget) {
+    ARCCache<int, int> cache(4);
+    
+    // Keys 0 and 1 are used twice (T2); 2 and 3 only once (T1)
+    for (int key = 0; key < 4; ++key) {
+        cache.put(key, key);
+    }
+    cache.get(0);
+    cache.get(1);
+    
+    // New keys displace the once-used ones into the B1 ghost list
+    for (int key = 4; key < 7; ++key) {
+        cache.put(key, key);
+    }
+    EXPECT_EQ(cache.recencyTarget(), 0u);
+    EXPECT_TRUE(cache.contains(0));
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(3));
+    
+    // Re-requesting a recently evicted key grows T1's target and lands in T2
+    cache.put(3, 3);
+    EXPECT_GT(cache.recencyTarget(), 0u);
+    EXPECT_TRUE(cache.contains(3));
+    EXPECT_EQ(cache.size(), 4u);
+    
+    cache.remove(0);
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.recencyTarget(), 0u);
+}
+
+TEST(LFUCacheTest, EvictsLeastFrequentThenLeastRecent) {
+    LFUCache<std::string, int> cache(3);
+    cache.put("hot", 1);
+    cache.put("warm", 2);
+    cache.put("cold", 3);
+    cache.get("hot");
+    cache.get("hot");
+    cache.get("warm");
+    
+    // "cold" is the only entry still at frequency one
+    cache.put("new", 4);
+    EXPECT_FALSE(cache.contains("cold"));
+    EXPECT_TRUE(cache.contains("new"));
+    
+    // Among equal frequencies the least recently used goes first
+    cache.get("new");  // Now at frequency two alongside "warm", but more recent
+    cache.put("next", 5);
+    EXPECT_FALSE(cache.contains("warm"));
+    EXPECT_TRUE(cache.contains("new"));
+    
+    // Pinned entries are skipped even at the lowest frequency
+    cache.pin("next");
+    cache.put("last", 6);
+    EXPECT_TRUE(cache.contains("next"));
+    EXPECT_FALSE(cache.contains("new"));
+    EXPECT_TRUE(cache.contains("hot"));
+    EXPECT_EQ(cache.size(), 3u);
+    EXPECT_EQ(cache.getStatistics().pinnedItems, 1u);
+    
+    cache.remove("next");
+    EXPECT_EQ(cache.getStatistics().pinnedItems, 0u);
+}
+
+TEST(FIFOCacheTest, ReinsertedKeyQueuesAgain) {
+    FIFOCache<std::string, int> cache(2);
+    cache.put("a", 1);
+    cache.put("b", 2);
+    cache.remove("a");
+    cache.put("a", 3);
+    
+    // "b" is now the oldest, whatever position "a" had before
+    cache.put("c", 4);
+    EXPECT_FALSE(cache.contains("b"));
+    EXPECT_TRUE(cache.contains("a"));
+    EXPECT_TRUE(cache.contains("c"));
+}
+
+// Few distinct hashes, so probe runs are long and erasing shifts them back
+struct CollidingHash {
+    size_t operator()(int key) const { return static_cast<size_t>(key % 7); }
+};
+
+TEST(SlotArenaTest, MatchesReferenceUnderChurn) {
+    using Arena = SlotArena<int, int, CollidingHash>;
+    Arena arena;
+    std::unordered_map<int, int> reference;
+    std::list<int> order;  // Front to back
+    std::mt19937 rng(7);
+    size_t peakFootprint = 0;
+    
+    for (int step = 0; step < 20000; ++step) {
+        int key = static_cast<int>(rng() % 300);
+        auto index = arena.find(key);
+        ASSERT_EQ(index != Arena::NIL, reference.count(key) == 1);
+        if (index == Arena::NIL) {
+            bool atFront = rng() % 2 == 0;
+            arena.insert(key, step, atFront);
+            reference[key] = step;
+            atFront ? order.push_front(key) : order.push_back(key);
+        } else if (rng() % 3 == 0) {
+            arena.moveToFront(index);
+            order.remove(key);
+            order.push_front(key);
+        } else {
+            EXPECT_EQ(arena[index].value, reference[key]);
+            arena.erase(index);
+            reference.erase(key);
+            order.remove(key);
+        }
+        if (step == 10000) {
+            peakFootprint = arena.footprint();
+        }
+    }
+    
+    ASSERT_EQ(arena.size(), reference.size());
+    std::vector<int> walked;
+    for (auto index = arena.front(); index != Arena::NIL; index = arena[index].next) {
+        walked.push_back(arena[index].key);
+    }
+    EXPECT_EQ(walked, std::vector<int>(order.begin(), order.end()));
+    // Freed slots are reused rather than the array growing with every insert
+    EXPECT_LE(arena.footprint(), peakFootprint * 2);
+}
@@ -1,10 +1,23 @@
 #include <gtest/gtest.h>
 #include "fs/filesystem.hpp"
+#include "fs/metadata_log.hpp"
+#include "fs/backup_manager.hpp"
+#include "fs/copy_engine.hpp"
+#include "fs/restore_plan.hpp"
+#include "fs/directory_walker.hpp"
+#include "fs/file_index.hpp"
+#include "fs/glob_matcher.hpp"
 #include "common/error.hpp"
+#include "threading/thread_pool.hpp"
+#include "threading/parallel_backup.hpp"
+#include "threading/co_file_ops.hpp"
 #include <filesystem>
 #include <memory>
 #include <thread>
+#include <atomic>
 #include <chrono>
+#include <fstream>
+#include <algorithm>
 
 namespace mtfs::test {
 
@@ -183,4 +196,1102 @@ TEST_F(FileSystemTest, ConcurrentOperations) {
     ASSERT_GT(successCount, 0);
 }
 
-} // namespace mtfs::test 
\ No newline at end of file
+// Test metadata log replay, compaction and torn-tail recovery
+TEST_F(FileSystemTest, MetadataLogPersistence) {
+    const std::string basePath = (testRootPath / "meta").string();
+    mtfs::fs::MetadataLog::MetadataMap metadata;
+
+    {
+        mtfs::fs::MetadataLog log(basePath);
+        log.load(metadata);
+
+        mtfs::fs::FileMetadata meta;
+        meta.name = "a.txt";
+        meta.owner = "alice";
+        meta.size = 42;
+        ASSERT_TRUE(log.appendPut("a.txt", meta));
+        meta.name = "b.txt";
+        ASSERT_TRUE(log.appendPut("b.txt", meta));
+        ASSERT_TRUE(log.appendErase("b.txt"));
+        ASSERT_EQ(log.getLogRecordCount(), 3u);
+    }
+
+    // Simulate a crash in the middle of an append
+    {
+        std::ofstream torn(basePath + ".log", std::ios::binary | std::ios::app);
+        torn << "MTML garbage";
+    }
+
+    {
+        mtfs::fs::MetadataLog log(basePath);
+        log.load(metadata);
+        ASSERT_EQ(metadata.size(), 1u);
+        ASSERT_EQ(metadata["a.txt"].owner, "alice");
+        ASSERT_EQ(metadata["a.txt"].size, 42u);
+        ASSERT_EQ(log.getLogRecordCount(), 3u);
+
+        ASSERT_TRUE(log.compact(metadata));
+        ASSERT_EQ(log.getLogRecordCount(), 0u);
+        ASSERT_EQ(std::filesystem::file_size(basePath + ".log"), 0u);
+    }
+
+    mtfs::fs::MetadataLog log(basePath);
+    log.load(metadata);
+    ASSERT_EQ(metadata.size(), 1u);
+    ASSERT_EQ(metadata["a.txt"].owner, "alice");
+}
+
+// Strings too long for a record's 16-bit length are refused rather than
+// written with a wrapped one, and such paths never enter the table
+TEST_F(FileSystemTest, MetadataLogRejectsOverlongStrings) {
+    const std::string basePath = (testRootPath / "meta").string();
+    const std::string overlong(mtfs::fs::MetadataLog::MAX_STRING_LENGTH + 1, 'p');
+    mtfs::fs::MetadataLog::MetadataMap metadata;
+    {
+        mtfs::fs::MetadataLog log(basePath);
+        log.load(metadata);
+        mtfs::fs::FileMetadata meta;
+        meta.name = "a.txt";
+        ASSERT_TRUE(log.appendPut("a.txt", meta));
+        ASSERT_THROW(log.appendPut(overlong, meta), mtfs::common::FSException);
+        meta.owner = overlong;
+        ASSERT_THROW(log.appendPut("b.txt", meta), mtfs::common::FSException);
+        ASSERT_THROW(log.appendErase(overlong), mtfs::common::FSException);
+    }
+    mtfs::fs::MetadataLog log(basePath);
+    log.load(metadata);
+    ASSERT_EQ(metadata.size(), 1u);
+    ASSERT_EQ(metadata.count("a.txt"), 1u);
+
+    mtfs::fs::FileSystemOptions options;
+    options.storageMode = mtfs::fs::StorageMode::BlockStore;
+    auto packed = mtfs::fs::FileSystem::create((testRootPath / "packed").string(), options);
+    ASSERT_THROW(packed->createFile(overlong), mtfs::common::FSException);
+    ASSERT_THROW(packed->createDirectory(overlong), mtfs::common::FSException);
+    ASSERT_FALSE(packed->exists(overlong));
+}
+
+// Cache hits hand out the cached buffer itself rather than a copy
+TEST_F(FileSystemTest, SharedReadsReuseCachedBuffer) {
+    const std::string testFile = "shared.txt";
+    const std::string testData(4096, 's');
+    ASSERT_TRUE(fs->createFile(testFile));
+    ASSERT_TRUE(fs->writeFile(testFile, testData));
+
+    auto first = fs->readFileShared(testFile);
+    auto second = fs->readFileShared(testFile);
+    ASSERT_EQ(*first, testData);
+    ASSERT_EQ(first.get(), second.get());
+    ASSERT_EQ(fs->readFile(testFile), testData);
+
+    // A copy writes the source buffer into the destination's cache entry
+    ASSERT_TRUE(fs->copyFile(testFile, "shared_copy.txt"));
+    ASSERT_EQ(fs->readFileShared("shared_copy.txt").get(), first.get());
+
+    // Byte budgets charge the buffer contents, not just the pointer
+    fs->setCacheByteBudget(1 << 20);
+    fs->readFileShared(testFile);
+    ASSERT_GE(fs->getCacheStatistics().residentBytes, testData.size());
+}
+
+// read() serves files above the threshold from a cached mapping
+TEST_F(FileSystemTest, MappedReads) {
+    const std::string testFile = "mapped.bin";
+    std::string testData(64 * 1024, '\0');
+    for (size_t i = 0; i < testData.size(); ++i) {
+        testData[i] = static_cast<char>(i * 31);
+    }
+    ASSERT_TRUE(fs->createFile(testFile));
+    ASSERT_EQ(fs->write(testFile, testData.data(), testData.size(), 0), testData.size());
+    fs->sync();  // Mappings cover what is on disk; later writes are buffered over them
+
+    fs->setMmapThreshold(4096);
+    char chunk[256];
+    ASSERT_EQ(fs->read(testFile, chunk, sizeof(chunk), 1000), sizeof(chunk));
+    ASSERT_EQ(std::string(chunk, sizeof(chunk)), testData.substr(1000, sizeof(chunk)));
+    ASSERT_EQ(fs->getOpenMappingCount(), 1u);
+
+    // Short read at the tail, nothing past the end
+    ASSERT_EQ(fs->read(testFile, chunk, sizeof(chunk), testData.size() - 10), 10u);
+    ASSERT_EQ(fs->read(testFile, chunk, sizeof(chunk), testData.size() + 10), 0u);
+
+    // In-place writes are visible through the mapping; growing the file remaps it
+    ASSERT_EQ(fs->write(testFile, "XY", 2, 1000), 2u);
+    ASSERT_EQ(fs->read(testFile, chunk, 2, 1000), 2u);
+    ASSERT_EQ(std::string(chunk, 2), "XY");
+    ASSERT_EQ(fs->write(testFile, "tail", 4, testData.size()), 4u);
+    ASSERT_EQ(fs->read(testFile, chunk, sizeof(chunk), testData.size()), 4u);
+    ASSERT_EQ(std::string(chunk, 4), "tail");
+
+    // Rewriting or deleting the file drops its mapping
+    ASSERT_TRUE(fs->writeFile(testFile, "small"));
+    ASSERT_EQ(fs->getOpenMappingCount(), 0u);
+    ASSERT_EQ(fs->read(testFile, chunk, sizeof(chunk), 0), 5u);
+    ASSERT_EQ(fs->getOpenMappingCount(), 0u);
+    ASSERT_TRUE(fs->deleteFile(testFile));
+    ASSERT_THROW(fs->read(testFile, chunk, sizeof(chunk), 0), mtfs::common::FileNotFoundException);
+}
+
+// Repeated offset I/O reuses one open handle until the file is moved or deleted
+TEST_F(FileSystemTest, FileHandleReuse) {
+    const std::string testFile = "handles.bin";
+    ASSERT_TRUE(fs->createFile(testFile));
+    fs->resetStats();
+
+    for (size_t i = 0; i < 100; ++i) {
+        char byte = static_cast<char>('a' + i % 26);
+        ASSERT_EQ(fs->write(testFile, &byte, 1, i), 1u);
+    }
+    char readBack[100];
+    ASSERT_EQ(fs->read(testFile, readBack, sizeof(readBack), 0), sizeof(readBack));
+    ASSERT_EQ(readBack[27], 'b');
+    ASSERT_EQ(fs->readFile(testFile).size(), 100u);
+
+    auto stats = fs->getStats();
+    ASSERT_EQ(stats.openHandles, 1u);
+    ASSERT_EQ(stats.handleCacheMisses, 0u);
+    ASSERT_GE(stats.handleCacheHits, 101u);
+
+    // Rewriting through the handle truncates to the new contents
+    ASSERT_TRUE(fs->writeFile(testFile, "short"));
+    ASSERT_EQ(std::filesystem::file_size(testRootPath / testFile), 5u);
+
+    ASSERT_TRUE(fs->renameFile(testFile, "renamed.bin"));
+    ASSERT_FALSE(fs->exists(testFile));
+    ASSERT_THROW(fs->read(testFile, readBack, 1, 0), mtfs::common::FileNotFoundException);
+    ASSERT_EQ(fs->read("renamed.bin", readBack, sizeof(readBack), 0), 5u);
+    ASSERT_EQ(fs->getStats().openHandles, 1u);
+}
+
+// Independent files proceed in parallel; whole-file writes of one file never
+// interleave with each other or with its readers
+TEST_F(FileSystemTest, ParallelFilesSerializedWrites) {
+    mtfs::fs::FileSystemOptions options;
+    options.storageMode = mtfs::fs::StorageMode::BlockStore;
+    auto packed = mtfs::fs::FileSystem::create((testRootPath / "packed").string(), options);
+
+    for (auto* target : {fs.get(), packed.get()}) {
+        ASSERT_TRUE(target->createFile("shared.txt"));
+        ASSERT_TRUE(target->writeFile("shared.txt", std::string(8192, 'a')));
+        std::atomic<int> failures{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([target, t, &failures] {
+                std::string own = "own" + std::to_string(t) + ".txt";
+                target->createFile(own);
+                for (int i = 0; i < 50; ++i) {
+                    std::string data = own + ":" + std::to_string(i);
+                    target->writeFile(own, data);
+                    if (target->readFile(own) != data) {
+                        failures++;
+                    }
+                    target->writeFile("shared.txt", std::string(8192, static_cast<char>('a' + t)));
+                    std::string shared = target->readFile("shared.txt");
+                    if (shared.size() != 8192 || shared.find_first_not_of(shared[0]) != std::string::npos) {
+                        failures++;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        ASSERT_EQ(failures.load(), 0);
+        ASSERT_EQ(target->getStats().totalWrites, 401u);
+        ASSERT_EQ(target->getStats().totalReads, 400u);
+        for (int t = 0; t < 4; ++t) {
+            ASSERT_EQ(target->readFile("own" + std::to_string(t) + ".txt"), "own" + std::to_string(t) + ".txt:49");
+        }
+    }
+}
+
+TEST_F(FileSystemTest, LatencyReportCountsOperations) {
+    mtfs::fs::FileSystemOptions options;
+    options.storageMode = mtfs::fs::StorageMode::BlockStore;
+    auto packed = mtfs::fs::FileSystem::create((testRootPath / "packed").string(), options);
+
+    ASSERT_TRUE(packed->createFile("timed.txt"));
+    ASSERT_TRUE(packed->writeFile("timed.txt", std::string(10000, 'x')));
+    ASSERT_EQ(packed->readFile("timed.txt").size(), 10000u);
+    ASSERT_EQ(packed->readFile("timed.txt").size(), 10000u);
+
+    auto report = packed->getLatencyReport();
+    EXPECT_EQ(report.write.count(), packed->getStats().totalWrites);
+    EXPECT_EQ(report.read.count(), 2u);
+    EXPECT_EQ(report.cacheHit.count() + report.cacheMiss.count(), 2u);
+    EXPECT_GT(report.blockWrite.count(), 0u);
+    EXPECT_GE(report.read.percentile(99.9), report.read.percentile(50));
+
+    packed->resetStats();
+    report = packed->getLatencyReport();
+    EXPECT_EQ(report.read.count(), 0u);
+    EXPECT_EQ(report.write.count(), 0u);
+    EXPECT_EQ(report.blockWrite.count(), 0u);
+    EXPECT_EQ(packed->getStats().totalReads, 0u);
+}
+
+// Block store mode packs files into one container with inline small files
+TEST_F(FileSystemTest, BlockStoreMode) {
+    const auto packedRoot = testRootPath / "packed";
+    mtfs::fs::FileSystemOptions options;
+    options.storageMode = mtfs::fs::StorageMode::BlockStore;
+    options.inlineThreshold = 512;
+    auto packed = mtfs::fs::FileSystem::create(packedRoot.string(), options);
+
+    ASSERT_TRUE(packed->createDirectory("objects"));
+    std::string large(3 * mtfs::fs::ExtentStore::BLOCK_SIZE + 123, '\0');
+    for (size_t i = 0; i < large.size(); ++i) {
+        large[i] = static_cast<char>(i * 13);
+    }
+    for (int i = 0; i < 50; ++i) {
+        std::string name = "objects/obj" + std::to_string(i);
+        ASSERT_TRUE(packed->createFile(name));
+        ASSERT_TRUE(packed->writeFile(name, i == 0 ? large : "tiny object " + std::to_string(i)));
+    }
+    ASSERT_EQ(packed->listDirectory("objects").size(), 50u);
+    ASSERT_EQ(packed->getMetadata("objects/obj0").size, large.size());
+    ASSERT_FALSE(std::filesystem::exists(packedRoot / "objects"));  // No host file per object
+
+    // Offset writes cross block boundaries and promote inline files to extents
+    ASSERT_EQ(packed->write("objects/obj0", "XYZ", 3, mtfs::fs::ExtentStore::BLOCK_SIZE - 1), 3u);
+    large.replace(mtfs::fs::ExtentStore::BLOCK_SIZE - 1, 3, "XYZ");
+    ASSERT_EQ(packed->readFile("objects/obj0"), large);
+    ASSERT_EQ(packed->write("objects/obj1", "end", 3, 2000), 3u);
+    std::string grown = "tiny object 1";
+    grown.resize(2000, '\0');
+    grown += "end";
+    ASSERT_EQ(packed->readFile("objects/obj1"), grown);
+    char chunk[8];
+    ASSERT_EQ(packed->read("objects/obj1", chunk, sizeof(chunk), 1999), 4u);
+    ASSERT_EQ(std::string(chunk, 4), std::string("\0end", 4));
+
+    ASSERT_TRUE(packed->deleteFile("objects/obj2"));
+    ASSERT_THROW(packed->readFile("objects/obj2"), mtfs::common::FileNotFoundException);
+    ASSERT_THROW(packed->createDirectory("objects/obj3"), mtfs::common::FSException);
+    ASSERT_THROW(packed->createFile("objects"), mtfs::common::FSException);
+    ASSERT_THROW(packed->createFile("missing/obj"), mtfs::common::FileNotFoundException);
+
+    // Everything survives a remount
+    packed.reset();
+    packed = mtfs::fs::FileSystem::create(packedRoot.string(), options);
+    ASSERT_EQ(packed->listDirectory("objects").size(), 49u);
+    ASSERT_EQ(packed->readFile("objects/obj0"), large);
+    ASSERT_EQ(packed->readFile("objects/obj1"), grown);
+    ASSERT_EQ(packed->readFile("objects/obj49"), "tiny object 49");
+}
+
+// LZ compression round-trips host files and rejects corrupt streams
+TEST_F(FileSystemTest, CompressionRoundTrip) {
+    const std::string testFile = "compress.txt";
+    std::string testData;
+    for (int i = 0; testData.size() < 600 * 1024; ++i) {
+        testData += "line " + std::to_string(i % 97) + " of a fairly repetitive log file\n";
+    }
+    ASSERT_TRUE(fs->createFile(testFile));
+    ASSERT_TRUE(fs->writeFile(testFile, testData));
+
+    ASSERT_TRUE(fs->compressFile(testFile));
+    ASSERT_LT(std::filesystem::file_size(testRootPath / testFile), testData.size() / 4);
+    ASSERT_TRUE(fs->decompressFile(testFile));
+    fs->clearCache();
+    ASSERT_EQ(fs->readFile(testFile), testData);
+
+    // Short, incompressible and empty inputs survive the in-memory API too
+    for (std::string sample : {std::string(), std::string("abc"), std::string(70000, 'z')}) {
+        ASSERT_EQ(mtfs::fs::FileCompression::decompress(mtfs::fs::FileCompression::compress(sample)), sample);
+    }
+    auto corrupt = mtfs::fs::FileCompression::compress(testData);
+    corrupt.resize(corrupt.size() / 2);
+    ASSERT_THROW(mtfs::fs::FileCompression::decompress(corrupt), std::runtime_error);
+}
+
+TEST_F(FileSystemTest, CompressedRandomAccess) {
+    using mtfs::fs::FileCompression;
+    const std::string testFile = "chunked.log";
+    std::string testData;
+    uint32_t seed = 12345;
+    while (testData.size() < 5 * FileCompression::STREAM_BLOCK_SIZE / 2) {
+        seed = seed * 1103515245u + 12345u;
+        testData += "record " + std::to_string(seed % 5000) + " status=ok\n";
+    }
+    ASSERT_TRUE(fs->createFile(testFile));
+    ASSERT_TRUE(fs->writeFile(testFile, testData));
+    ASSERT_TRUE(fs->compressFile(testFile));
+    ASSERT_TRUE(fs->getMetadata(testFile).compressed);
+    ASSERT_THROW(fs->compressFile(testFile), mtfs::common::FSException);
+
+    // Ranges inside one chunk, across a chunk boundary and at the end
+    auto expectRange = [&](size_t offset, size_t size) {
+        std::string buffer(size, '\0');
+        size_t count = fs->read(testFile, &buffer[0], size, offset);
+        ASSERT_EQ(buffer.substr(0, count), testData.substr(offset, size));
+    };
+    expectRange(0, 100);
+    expectRange(FileCompression::STREAM_BLOCK_SIZE - 50, 100);
+    expectRange(testData.size() - 10, 100);
+    char byte;
+    ASSERT_EQ(fs->read(testFile, &byte, 1, testData.size()), 0u);
+    ASSERT_THROW(fs->write(testFile, "x", 1, 0), mtfs::common::FSException);
+
+    // The flag survives a remount
+    fs.reset();
+    fs = mtfs::fs::FileSystem::create(testRootPath.string());
+    expectRange(2 * FileCompression::STREAM_BLOCK_SIZE + 7, 4096);
+
+    // Chunks compressed on a pool decode to the same bytes
+    mtfs::threading::ThreadPool pool(4);
+    std::string plainPath = (testRootPath / "plain.bin").string();
+    std::string packedPath = (testRootPath / "packed.bin").string();
+    std::ofstream(plainPath, std::ios::binary) << testData;
+    ASSERT_TRUE(FileCompression::compressFile(plainPath, packedPath, &pool));
+    auto packed = mtfs::fs::CompressedFile::open(packedPath);
+    ASSERT_EQ(packed->size(), testData.size());
+    ASSERT_EQ(packed->getChunkCount(), 3u);
+    std::string all(testData.size(), '\0');
+    ASSERT_EQ(packed->read(&all[0], all.size(), 0), testData.size());
+    ASSERT_EQ(all, testData);
+
+    ASSERT_TRUE(fs->decompressFile(testFile));
+    ASSERT_FALSE(fs->getMetadata(testFile).compressed);
+    expectRange(1000, 1000);
+}
+
+// Whichever primitive the platform allows, copies are exact and replace
+// longer destinations, and FileSystem::copyFile goes through the engine
+TEST_F(FileSystemTest, CopyEngineCopiesWholeFiles) {
+    using mtfs::fs::CopyEngine;
+    std::string bulk(3 * 1024 * 1024 + 123, '\0');
+    for (size_t i = 0; i < bulk.size(); ++i) {
+        bulk[i] = static_cast<char>(i * 31 + (i >> 12));
+    }
+    auto source = testRootPath / "bulk.bin";
+    auto target = testRootPath / "bulk.copy";
+    std::ofstream(source, std::ios::binary) << bulk;
+    std::ofstream(target, std::ios::binary) << std::string(bulk.size() * 2, 'x');
+
+    auto copied = CopyEngine::copy(source.string(), target.string());
+    ASSERT_EQ(copied.bytes, bulk.size());
+    std::ifstream in(target, std::ios::binary);
+    ASSERT_EQ(std::string(std::istreambuf_iterator<char>(in), {}), bulk);
+
+    std::ofstream(testRootPath / "empty.bin");
+    ASSERT_EQ(CopyEngine::copy((testRootPath / "empty.bin").string(), (testRootPath / "empty.copy").string()).bytes,
+              0u);
+    ASSERT_THROW(CopyEngine::copy((testRootPath / "missing").string(), target.string()), mtfs::common::FSException);
+
+    ASSERT_TRUE(fs->createFile("original.txt"));
+    ASSERT_TRUE(fs->writeFile("original.txt", bulk));
+    ASSERT_TRUE(fs->createFile("duplicate.txt"));
+    ASSERT_TRUE(fs->writeFile("duplicate.txt", "stale cached contents"));
+    ASSERT_TRUE(fs->copyFile("original.txt", "duplicate.txt"));
+    ASSERT_EQ(fs->readFile("duplicate.txt"), bulk);
+    ASSERT_EQ(fs->getMetadata("duplicate.txt").size, bulk.size());
+}
+
+TEST_F(FileSystemTest, DeduplicatedBackups) {
+    using mtfs::fs::BackupManager;
+    auto sourceDir = testRootPath / "source";
+    auto backupDir = testRootPath / "backups";
+    std::filesystem::create_directories(sourceDir / "nested");
+
+    std::string bulk;
+    uint64_t seed = 42;
+    while (bulk.size() < 1024 * 1024) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        bulk.push_back(static_cast<char>(seed >> 56));
+    }
+    std::ofstream(sourceDir / "bulk.bin", std::ios::binary) << bulk;
+    std::ofstream(sourceDir / "nested" / "note.txt") << "unchanged";
+    std::ofstream(sourceDir / "empty.txt");
+
+    BackupManager backups(backupDir.string());
+    ASSERT_TRUE(backups.createBackup("monday", sourceDir.string()));
+    auto monday = backups.getBackupInfo("monday");
+
+    // An insertion near the front only disturbs the chunks around it
+    bulk.insert(1000, "inserted bytes");
+    std::ofstream(sourceDir / "bulk.bin", std::ios::binary) << bulk;
+    ASSERT_TRUE(backups.createBackup("tuesday", sourceDir.string()));
+    auto tuesday = backups.getBackupInfo("tuesday");
+    ASSERT_EQ(monday.storedSize, monday.totalSize);
+    ASSERT_LT(tuesday.storedSize, tuesday.totalSize / 8);
+    ASSERT_GT(backups.getBackupStats().bytesDeduplicated, 0u);
+    ASSERT_GT(backups.getBackupStats().backupThroughput(), 0.0);
+
+    // Deleting the older backup keeps the chunks the newer one still needs
+    ASSERT_TRUE(backups.deleteBackup("monday"));
+    ASSERT_TRUE(backups.verifyBackup("tuesday"));
+    auto restoreDir = testRootPath / "restored";
+    ASSERT_TRUE(backups.restoreBackup("tuesday", restoreDir.string()));
+    std::ifstream restored(restoreDir / "bulk.bin", std::ios::binary);
+    ASSERT_EQ(std::string(std::istreambuf_iterator<char>(restored), {}), bulk);
+    ASSERT_TRUE(std::filesystem::exists(restoreDir / "nested" / "note.txt"));
+    ASSERT_EQ(std::filesystem::file_size(restoreDir / "empty.txt"), 0u);
+}
+
+TEST_F(FileSystemTest, IncrementalBackups) {
+    using mtfs::fs::BackupManager;
+    auto sourceDir = testRootPath / "source";
+    auto backupDir = testRootPath / "backups";
+    std::filesystem::create_directories(sourceDir);
+    std::ofstream(sourceDir / "same.txt") << "never changes";
+    std::ofstream(sourceDir / "touched.txt") << "same bytes";
+    std::ofstream(sourceDir / "edited.txt") << "old contents";
+
+    BackupManager backups(backupDir.string());
+    ASSERT_TRUE(backups.createBackup("full", sourceDir.string()));
+    ASSERT_TRUE(backups.getChangedFiles(sourceDir.string(), "full").empty());
+
+    // A new mtime alone is settled by the content hash; an edit of the same
+    // size is not
+    auto later = std::filesystem::last_write_time(sourceDir / "same.txt") + std::chrono::seconds(5);
+    std::filesystem::last_write_time(sourceDir / "touched.txt", later);
+    std::ofstream(sourceDir / "edited.txt") << "new contents";
+    std::filesystem::last_write_time(sourceDir / "edited.txt", later);
+    std::ofstream(sourceDir / "added.txt") << "fresh";
+    auto changed = backups.getChangedFiles(sourceDir.string(), "full");
+    std::sort(changed.begin(), changed.end());
+    ASSERT_EQ(changed, (std::vector<std::string>{"added.txt", "edited.txt"}));
+
+    // Only files whose stamp moved are read again
+    ASSERT_TRUE(backups.createIncrementalBackup("incremental", "full", sourceDir.string()));
+    auto info = backups.getBackupInfo("incremental");
+    ASSERT_TRUE(info.isIncremental);
+    ASSERT_EQ(info.parentBackup, "full");
+    ASSERT_EQ(info.totalFiles, 4u);
+    ASSERT_EQ(info.includedFiles.size(), 3u);
+    ASSERT_TRUE(backups.getChangedFiles(sourceDir.string(), "incremental").empty());
+
+    // The incremental manifest is complete, so it restores without its parent
+    ASSERT_TRUE(backups.deleteBackup("full"));
+    auto restoreDir = testRootPath / "restored";
+    ASSERT_TRUE(backups.restoreBackup("incremental", restoreDir.string()));
+    std::ifstream same(restoreDir / "same.txt");
+    ASSERT_EQ(std::string(std::istreambuf_iterator<char>(same), {}), "never changes");
+    std::ifstream edited(restoreDir / "edited.txt");
+    ASSERT_EQ(std::string(std::istreambuf_iterator<char>(edited), {}), "new contents");
+}
+
+TEST_F(FileSystemTest, ParallelBackupCompressesChunks) {
+    // ParallelBackupManager works under ./backups
+    auto previousDir = std::filesystem::current_path();
+    std::filesystem::current_path(testRootPath);
+    std::filesystem::create_directories("source");
+    std::string text;
+    for (int i = 0; text.size() < 512 * 1024; ++i) {
+        text += "line " + std::to_string(i % 100) + " of a compressible file\n";
+    }
+    std::ofstream("source/text.txt", std::ios::binary) << text;
+
+    mtfs::threading::ParallelBackupManager backups(2);
+    bool created = backups.createParallelBackup("nightly", {"source"}).get();
+    auto manifest = mtfs::fs::ChunkStore::loadManifest("backups/nightly/.mtfs_manifest");
+    auto stats = backups.getStats();
+    std::filesystem::current_path(previousDir);
+
+    ASSERT_TRUE(created);
+    ASSERT_EQ(manifest.size(), 1u);
+    ASSERT_GT(stats.totalCompressionSaved, text.size() / 2);
+    mtfs::fs::ChunkStore store((testRootPath / "backups" / ".chunks").string());
+    auto restored = testRootPath / "restored.txt";
+    store.restoreFile(manifest[0], restored.string());
+    std::ifstream in(restored, std::ios::binary);
+    ASSERT_EQ(std::string(std::istreambuf_iterator<char>(in), {}), text);
+}
+
+// A file that cannot be read is left out of the manifest and the index, so
+// a restore does not recreate it empty and the next backup reads it again
+TEST_F(FileSystemTest, ParallelBackupLeavesOutUnreadableFiles) {
+    auto previousDir = std::filesystem::current_path();
+    std::filesystem::current_path(testRootPath);
+    std::filesystem::create_directories("source");
+    std::ofstream("source/kept.txt") << "kept";
+    std::ofstream("source/vanished.txt") << "gone before it is read";
+
+    // The first progress report comes after the scan and before any file is read
+    std::atomic<bool> removed{false};
+    mtfs::threading::ParallelBackupManager backups(2);
+    bool created = backups.createParallelBackup("nightly", {"source"}, [&](const auto&) {
+        if (!removed.exchange(true)) {
+            std::filesystem::remove("source/vanished.txt");
+        }
+    }).get();
+    auto manifest = mtfs::fs::ChunkStore::loadManifest("backups/nightly/.mtfs_manifest");
+    mtfs::fs::FileIndex index;
+    bool indexLoaded = index.load("backups/nightly/.mtfs_index");
+    std::filesystem::current_path(previousDir);
+
+    ASSERT_FALSE(created);
+    ASSERT_EQ(manifest.size(), 1u);
+    ASSERT_EQ(manifest[0].path, "kept.txt");
+    ASSERT_TRUE(indexLoaded);
+    ASSERT_EQ(index.size(), 1u);
+    ASSERT_NE(index.find("kept.txt"), nullptr);
+    ASSERT_EQ(index.find("vanished.txt"), nullptr);
+}
+
+TEST_F(FileSystemTest, ParallelRestoreVerifiesInline) {
+    auto previousDir = std::filesystem::current_path();
+    std::filesystem::current_path(testRootPath);
+    std::filesystem::create_directories("source/a/b");
+    std::string bulk;
+    for (uint32_t seed = 7; bulk.size() < 3 * 1024 * 1024;) {
+        seed = seed * 1103515245 + 12345;
+        bulk += static_cast<char>(seed >> 16);
+    }
+    std::ofstream("source/bulk.bin", std::ios::binary) << bulk;
+    std::ofstream("source/a/small.txt") << "small";
+    std::ofstream("source/a/b/deep.txt") << "deep";
+
+    mtfs::threading::ParallelBackupManager backups(4);
+    bool created = backups.createParallelBackup("nightly", {"source"}).get();
+    mtfs::fs::ChunkStore store("backups/.chunks");
+    mtfs::fs::RestorePlan plan(store, mtfs::fs::ChunkStore::loadManifest("backups/nightly/.mtfs_manifest"),
+                               "restored");
+    bool restored = backups.restoreParallelBackup("nightly", "restored").get();
+    auto stats = backups.getStats();
+
+    // A corrupt chunk fails its file instead of leaving bad bytes behind
+    for (const auto& entry : std::filesystem::recursive_directory_iterator("backups/.chunks")) {
+        if (entry.is_regular_file()) {
+            std::ofstream(entry.path(), std::ios::binary | std::ios::in) << "garbage";
+        }
+    }
+    bool corrupt = backups.restoreParallelBackup("nightly", "corrupt").get();
+    std::filesystem::current_path(previousDir);
+
+    ASSERT_TRUE(created);
+    ASSERT_EQ(plan.files().front().path, "bulk.bin");  // Largest first
+    ASSERT_EQ(plan.totalBytes(), bulk.size() + 9);
+    ASSERT_TRUE(restored);
+    std::ifstream in(testRootPath / "restored" / "bulk.bin", std::ios::binary);
+    ASSERT_EQ(std::string(std::istreambuf_iterator<char>(in), {}), bulk);
+    std::ifstream deep(testRootPath / "restored" / "a" / "b" / "deep.txt");
+    ASSERT_EQ(std::string(std::istreambuf_iterator<char>(deep), {}), "deep");
+    ASSERT_EQ(stats.totalBackupsRestored, 1u);
+    ASSERT_EQ(stats.totalBytesRestored, bulk.size() + 9);
+
+    ASSERT_FALSE(corrupt);
+    ASSERT_FALSE(std::filesystem::exists(testRootPath / "corrupt" / "bulk.bin"));
+}
+
+// Thousands of multi-chunk files back up and restore on a small shared pool,
+// where every task is BACKGROUND
+TEST_F(FileSystemTest, ParallelBackupOfThousandsOfFilesOnSharedPool) {
+    auto previousDir = std::filesystem::current_path();
+    std::filesystem::current_path(testRootPath);
+    const int files = 2000;
+    auto contents = [](int i) {
+        std::string data(8 * 1024 + (i % 5) * 4 * 1024, '\0');
+        uint32_t seed = static_cast<uint32_t>(i) * 2654435761u + 1;
+        for (char& c : data) {
+            seed = seed * 1103515245 + 12345;
+            c = static_cast<char>(seed >> 16);
+        }
+        return data;
+    };
+    for (int i = 0; i < files; ++i) {
+        auto dir = std::filesystem::path("source") / ("dir" + std::to_string(i % 20));
+        std::filesystem::create_directories(dir);
+        std::ofstream(dir / ("file" + std::to_string(i) + ".bin"), std::ios::binary) << contents(i);
+    }
+
+    bool created = false;
+    bool restored = false;
+    mtfs::threading::ParallelBackupManager::BackupStats stats;
+    {
+        mtfs::threading::ThreadPool pool(3, mtfs::threading::SchedulingMode::SHARED_QUEUE);
+        mtfs::threading::ParallelBackupManager backups(pool);
+        created = backups.createParallelBackup("bulk", {"source"}).get();
+        restored = backups.restoreParallelBackup("bulk", "restored").get();
+        stats = backups.getStats();
+    }
+    std::filesystem::current_path(previousDir);
+
+    ASSERT_TRUE(created);
+    ASSERT_TRUE(restored);
+    ASSERT_EQ(stats.totalFilesBackedUp, static_cast<size_t>(files));
+    for (int i = 0; i < files; i += 7) {
+        auto path = testRootPath / "restored" / ("dir" + std::to_string(i % 20)) /
+                    ("file" + std::to_string(i) + ".bin");
+        std::ifstream in(path, std::ios::binary);
+        ASSERT_EQ(std::string(std::istreambuf_iterator<char>(in), {}), contents(i)) << path;
+    }
+}
+
+// Offset writes are buffered and coalesced: reads, the cache and metadata
+// see them at once, the disk only after sync()
+TEST_F(FileSystemTest, WriteBackCoalescesOffsetWrites) {
+    mtfs::fs::FileSystemOptions options;
+    options.writeBack.maxAge = std::chrono::hours(1);
+    auto root = testRootPath / "buffered";
+    auto buffered = mtfs::fs::FileSystem::create(root.string(), options);
+    ASSERT_TRUE(buffered->createFile("log.bin"));
+    ASSERT_TRUE(buffered->writeFile("log.bin", std::string(4096, 'a')));
+    ASSERT_EQ(buffered->readFile("log.bin").size(), 4096u);  // Cached
+
+    std::string expected(4096, 'a');
+    for (size_t i = 0; i < 1000; ++i) {
+        ASSERT_EQ(buffered->write("log.bin", "wxyz", 4, 100 + i * 4), 4u);
+    }
+    expected.replace(100, 4000, std::string(1000 * 4, ' '));
+    for (size_t i = 0; i < 1000; ++i) {
+        expected.replace(100 + i * 4, 4, "wxyz");
+    }
+    std::string overlap(100, 'o');
+    buffered->write("log.bin", overlap.data(), overlap.size(), 50);
+    expected.replace(50, 100, overlap);
+    buffered->write("log.bin", "tail", 4, 8000);
+    expected.resize(8000, '\0');
+    expected += "tail";
+
+    ASSERT_EQ(buffered->readFile("log.bin"), expected);
+    ASSERT_EQ(buffered->getMetadata("log.bin").size, expected.size());
+    std::vector<char> window(16);
+    ASSERT_EQ(buffered->read("log.bin", window.data(), window.size(), 7996), 8u);
+    ASSERT_EQ(std::string(window.data(), 8), std::string(4, '\0') + "tail");
+    ASSERT_EQ(std::filesystem::file_size(root / "log.bin"), 4096u);
+
+    auto pending = buffered->getWriteBackStats();
+    ASSERT_EQ(pending.writes, 1002u);
+    ASSERT_EQ(pending.dirtyFiles, 1u);
+    buffered->sync();
+    auto flushed = buffered->getWriteBackStats();
+    ASSERT_EQ(flushed.extentsFlushed, 2u);
+    ASSERT_EQ(flushed.pendingBytes, 0u);
+    std::ifstream disk(root / "log.bin", std::ios::binary);
+    ASSERT_EQ(std::string(std::istreambuf_iterator<char>(disk), {}), expected);
+
+    // Whole-file writes replace whatever is still buffered
+    buffered->write("log.bin", "zz", 2, 0);
+    ASSERT_TRUE(buffered->writeFile("log.bin", "fresh"));
+    buffered->sync();
+    ASSERT_EQ(buffered->readFile("log.bin"), "fresh");
+}
+
+// The size limit flushes from the write that passes it, the age limit from
+// the background flusher
+TEST_F(FileSystemTest, WriteBackFlushesAtLimits) {
+    mtfs::fs::FileSystemOptions options;
+    options.writeBack.maxFileBytes = 1024;
+    options.writeBack.maxAge = std::chrono::milliseconds(20);
+    auto root = testRootPath / "limited";
+    auto buffered = mtfs::fs::FileSystem::create(root.string(), options);
+    ASSERT_TRUE(buffered->createFile("big.bin"));
+    ASSERT_TRUE(buffered->createFile("small.bin"));
+
+    std::string block(2048, 'b');
+    buffered->write("big.bin", block.data(), block.size(), 0);
+    ASSERT_EQ(std::filesystem::file_size(root / "big.bin"), block.size());
+
+    buffered->write("small.bin", "s", 1, 0);
+    for (int i = 0; i < 200 && buffered->getWriteBackStats().dirtyFiles > 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(std::filesystem::file_size(root / "small.bin"), 1u);
+}
+
+// A flush that fails keeps the bytes it could not write and reports the
+// failure once, to sync() or to the file's next read or write
+TEST_F(FileSystemTest, WriteBackKeepsBytesItFailsToWrite) {
+    mtfs::fs::FileSystemOptions options;
+    options.writeBack.maxAge = std::chrono::milliseconds(200);
+    auto root = testRootPath / "failing";
+    auto buffered = mtfs::fs::FileSystem::create(root.string(), options);
+    ASSERT_TRUE(buffered->createFile("log.bin"));
+
+    // Past the largest file the host allows, so only that extent fails
+    const size_t far = size_t{1} << 50;
+    buffered->write("log.bin", "head", 4, 0);
+    buffered->write("log.bin", "tail", 4, far);
+    ASSERT_THROW(buffered->sync(), mtfs::common::FSException);
+    ASSERT_EQ(std::filesystem::file_size(root / "log.bin"), 4u);
+    auto pending = buffered->getWriteBackStats();
+    EXPECT_EQ(pending.dirtyFiles, 1u);
+    EXPECT_EQ(pending.pendingBytes, 4u);
+    char readBack[4];
+    ASSERT_EQ(buffered->read("log.bin", readBack, sizeof(readBack), far), 4u);
+    ASSERT_EQ(std::string(readBack, 4), "tail");
+
+    // The background flusher fails too; the next read reports it, once
+    bool reported = false;
+    for (int i = 0; i < 300 && !reported; ++i) {
+        try {
+            buffered->read("log.bin", readBack, sizeof(readBack), far);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        } catch (const mtfs::common::FSException&) {
+            reported = true;
+        }
+    }
+    ASSERT_TRUE(reported);
+    ASSERT_EQ(buffered->read("log.bin", readBack, sizeof(readBack), far), 4u);
+    ASSERT_EQ(std::string(readBack, 4), "tail");
+
+    // Replacing the file drops the failed bytes and the failure with them
+    ASSERT_TRUE(buffered->writeFile("log.bin", "fresh"));
+    buffered->sync();
+    ASSERT_EQ(buffered->readFile("log.bin"), "fresh");
+}
+
+// Coroutine file operations complete as one batch through whenAll
+TEST_F(FileSystemTest, CoroutineFileOperations) {
+    mtfs::threading::ThreadPool pool(2);
+    mtfs::threading::CoFileOperations ops(fs.get(), pool);
+    using mtfs::threading::blockingWait;
+
+    std::vector<std::pair<std::string, std::string>> files;
+    std::vector<std::string> paths;
+    for (int i = 0; i < 50; ++i) {
+        paths.push_back("co_" + std::to_string(i) + ".txt");
+        files.emplace_back(paths.back(), "content " + std::to_string(i));
+    }
+    auto written = blockingWait(ops.writeAll(files));
+    ASSERT_EQ(std::count(written.begin(), written.end(), true), 50);
+
+    auto contents = blockingWait(ops.readAll(paths));
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_EQ(contents[i], "content " + std::to_string(i));
+    }
+
+    auto copied = blockingWait(ops.copyAll({{"co_0.txt", "co_copy.txt"}, {"missing.txt", "nowhere.txt"}}));
+    ASSERT_EQ(copied, (std::vector<bool>{true, false}));
+    ASSERT_EQ(blockingWait(ops.read("co_copy.txt")), "content 0");
+    ASSERT_ANY_THROW(blockingWait(ops.read("missing.txt")));
+    ASSERT_EQ(ops.inFlight(), 0u);
+}
+
+// Files come with their size from the listing, nested directories are
+// descended in parallel, and findFiles searches the whole subtree
+TEST_F(FileSystemTest, RecursiveFindFilesUsesDirectoryWalker) {
+    for (const std::string directory : {"a", "a/b", "a/b/c", "d"}) {
+        ASSERT_TRUE(fs->createDirectory(directory));
+    }
+    const std::vector<std::string> files = {"top.txt", "a/one.txt", "a/b/two.log", "a/b/c/three.txt", "d/four.txt"};
+    for (const auto& file : files) {
+        ASSERT_TRUE(fs->createFile(file));
+        ASSERT_TRUE(fs->writeFile(file, file));
+    }
+
+    threading::ThreadPool pool(2);
+    std::vector<mtfs::fs::DirectoryEntry> entries = mtfs::fs::DirectoryWalker(&pool).collect(testRootPath.string());
+    std::vector<std::string> walked;
+    for (const auto& entry : entries) {
+        if (!entry.isDirectory && entry.name().find(".mtfs") != 0) {
+            walked.push_back(entry.path);
+            EXPECT_EQ(entry.stamp.size, entry.path.size()) << entry.path;
+        }
+    }
+    std::vector<std::string> expected = files;
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(walked, expected);
+
+    mtfs::fs::WalkOptions shallow;
+    shallow.recursive = false;
+    shallow.includeDirectories = true;
+    size_t visited = mtfs::fs::DirectoryWalker(&pool).walk(
+        (testRootPath / "a").string(), [](const mtfs::fs::DirectoryEntry&) {}, shallow);
+    EXPECT_EQ(visited, 2u);
+    EXPECT_THROW(mtfs::fs::DirectoryWalker(&pool).collect((testRootPath / "missing").string()),
+                 mtfs::common::FSException);
+
+    EXPECT_EQ(fs->findFiles("*.txt"),
+              (std::vector<std::string>{"a/b/c/three.txt", "a/one.txt", "d/four.txt", "top.txt"}));
+    EXPECT_EQ(fs->findFiles("t*", "a"), (std::vector<std::string>{"a/b/c/three.txt", "a/b/two.log"}));
+}
+
+TEST_F(FileSystemTest, DirectoryIndexAnswersFromMemory) {
+    std::filesystem::path indexedRoot = testRootPath / "indexed";
+    std::filesystem::create_directories(indexedRoot / "docs");
+    std::ofstream(indexedRoot / "docs" / "existing.txt") << "before mount";
+
+    mtfs::fs::FileSystemOptions options;
+    options.directoryIndex = true;
+    auto indexed = mtfs::fs::FileSystem::create(indexedRoot.string(), options);
+    EXPECT_TRUE(indexed->exists("docs/existing.txt"));
+    EXPECT_EQ(indexed->getFileInfo("docs/existing.txt").size, std::string("before mount").size());
+
+    ASSERT_TRUE(indexed->createDirectory("docs/sub"));
+    ASSERT_TRUE(indexed->createFile("docs/b.txt"));
+    ASSERT_TRUE(indexed->createFile("docs/a.txt"));
+    ASSERT_TRUE(indexed->writeFile("docs/a.txt", "twelve bytes"));
+    EXPECT_EQ(indexed->listDirectory("docs"),
+              (std::vector<std::string>{"a.txt", "b.txt", "existing.txt", "sub"}));
+    EXPECT_TRUE(indexed->listDirectory("docs/sub").empty());
+    EXPECT_EQ(indexed->getFileInfo("docs/a.txt").size, 12u);
+    EXPECT_TRUE(indexed->getFileInfo("docs/sub").isDirectory);
+
+    // Made behind the FileSystem's back: found on a miss, listed after rescan
+    std::ofstream(indexedRoot / "docs" / "outside.txt") << "x";
+    EXPECT_EQ(indexed->listDirectory("docs").size(), 4u);
+    EXPECT_TRUE(indexed->exists("docs/outside.txt"));
+    std::filesystem::create_directories(indexedRoot / "late");
+    EXPECT_EQ(indexed->listDirectory("docs").size(), 5u);
+    indexed->rescan();
+    EXPECT_TRUE(indexed->exists("late"));
+
+    ASSERT_TRUE(indexed->deleteFile("docs/b.txt"));
+    EXPECT_FALSE(indexed->exists("docs/b.txt"));
+    EXPECT_EQ(indexed->listDirectory("docs"),
+              (std::vector<std::string>{"a.txt", "existing.txt", "outside.txt", "sub"}));
+    EXPECT_FALSE(indexed->exists("docs/never.txt"));
+}
+
+TEST_F(FileSystemTest, BatchOperationsCommitOnce) {
+    for (auto mode : {mtfs::fs::StorageMode::HostFiles, mtfs::fs::StorageMode::BlockStore}) {
+        std::filesystem::path root = testRootPath / (mode == mtfs::fs::StorageMode::HostFiles ? "host" : "packed");
+        mtfs::fs::FileSystemOptions options;
+        options.storageMode = mode;
+        {
+            auto batched = mtfs::fs::FileSystem::create(root.string(), options);
+            ASSERT_TRUE(batched->createDirectory("in"));
+            ASSERT_TRUE(batched->createDirectory("out"));
+            std::vector<std::pair<std::string, std::string>> files;
+            for (int i = 0; i < 20; ++i) {
+                files.emplace_back((i % 2 ? "in/" : "out/") + std::to_string(i) + ".txt", std::to_string(i * i));
+            }
+            files.emplace_back("missing/x.txt", "no parent");
+            files.emplace_back("in/1.txt", "rewritten");
+
+            std::vector<bool> written = batched->writeBatch(files);
+            ASSERT_EQ(written.size(), files.size());
+            EXPECT_FALSE(written[20]);
+            EXPECT_EQ(std::count(written.begin(), written.end(), true), 21);
+            EXPECT_EQ(batched->readFile("in/1.txt"), "rewritten");
+            EXPECT_EQ(batched->readFile("out/4.txt"), "16");
+
+            std::vector<bool> copied = batched->copyBatch({{"in/3.txt", "out/copy3.txt"},
+                                                           {"out/4.txt", "in/copy3.txt"},
+                                                           {"absent.txt", "out/absent.txt"}});
+            EXPECT_EQ(copied, (std::vector<bool>{true, true, false}));
+            EXPECT_EQ(batched->readFile("in/copy3.txt"), "16");
+            EXPECT_EQ(batched->readFile("out/copy3.txt"), "9");
+
+            std::vector<bool> deleted = batched->deleteBatch({"out/0.txt", "out/2.txt", "absent.txt"});
+            EXPECT_EQ(deleted, (std::vector<bool>{true, true, false}));
+            EXPECT_FALSE(batched->exists("out/0.txt"));
+        }
+
+        // Every change was committed to the metadata log
+        auto reopened = mtfs::fs::FileSystem::create(root.string(), options);
+        EXPECT_EQ(reopened->getFileInfo("in/1.txt").size, std::string("rewritten").size());
+        EXPECT_EQ(reopened->readFile("in/copy3.txt"), "16");
+        EXPECT_FALSE(reopened->exists("out/2.txt"));
+        EXPECT_EQ(reopened->listDirectory("out").size(), 9u);
+    }
+}
+
+// A batch whose metadata commit fails leaves the old contents readable: the
+// log still names their blocks, so the batch must not have freed them for
+// its own later items to take
+TEST_F(FileSystemTest, FailedBatchCommitKeepsOldContents) {
+    const auto root = testRootPath / "packed";
+    const size_t size = 4 * mtfs::fs::ExtentStore::BLOCK_SIZE;
+    mtfs::fs::FileSystemOptions options;
+    options.storageMode = mtfs::fs::StorageMode::BlockStore;
+    options.initialBlocks = 8;  // Full once both files are written
+    {
+        auto packed = mtfs::fs::FileSystem::create(root.string(), options);
+        ASSERT_TRUE(packed->createFile("a.bin"));
+        ASSERT_TRUE(packed->writeFile("a.bin", std::string(size, 'a')));
+        ASSERT_TRUE(packed->createFile("b.bin"));
+        ASSERT_TRUE(packed->writeFile("b.bin", std::string(size, 'b')));
+        packed->unmount();  // Everything in the snapshot, the log empty
+    }
+
+    // A directory in the log's place makes every append fail
+    const auto logPath = root / ".mtfs_metadata.log";
+    std::filesystem::remove(logPath);
+    std::filesystem::create_directory(logPath);
+    {
+        auto packed = mtfs::fs::FileSystem::create(root.string(), options);
+        std::vector<bool> written = packed->writeBatch({{"a.bin", std::string(size, 'A')},
+                                                        {"b.bin", std::string(size, 'B')},
+                                                        {"c.bin", std::string(size, 'C')}});
+        EXPECT_EQ(written, (std::vector<bool>{true, true, true}));
+        packed->sync();
+    }
+    std::filesystem::remove(logPath);
+
+    auto reopened = mtfs::fs::FileSystem::create(root.string(), options);
+    EXPECT_EQ(reopened->readFile("a.bin"), std::string(size, 'a'));
+    EXPECT_EQ(reopened->readFile("b.bin"), std::string(size, 'b'));
+    EXPECT_FALSE(reopened->exists("c.bin"));
+}
+
+TEST_F(FileSystemTest, PrefetcherLearnsScansAndCoAccess) {
+    mtfs::fs::FileSystemOptions options;
+    options.prefetch.enabled = true;
+    auto prefetching = mtfs::fs::FileSystem::create((testRootPath / "prefetching").string(), options);
+    ASSERT_TRUE(prefetching->createDirectory("scan"));
+    ASSERT_TRUE(prefetching->createDirectory("other"));
+    for (int i = 0; i < 8; ++i) {
+        std::string path = "scan/f" + std::to_string(i);
+        ASSERT_TRUE(prefetching->createFile(path));
+        ASSERT_TRUE(prefetching->writeFile(path, "contents of " + path));
+    }
+    for (const std::string path : {"other/x", "other/y"}) {
+        ASSERT_TRUE(prefetching->createFile(path));
+        ASSERT_TRUE(prefetching->writeFile(path, path));
+    }
+
+    // Two ascending reads start a scan; the next files are loaded meanwhile
+    prefetching->clearCache();
+    prefetching->resetCacheStatistics();
+    prefetching->readFile("scan/f0");
+    prefetching->readFile("scan/f1");
+    prefetching->drainPrefetch();
+    EXPECT_EQ(prefetching->getCacheStatistics().prefetchedItems, options.prefetch.readAhead);
+    EXPECT_EQ(prefetching->readFile("scan/f2"), "contents of scan/f2");
+    auto stats = prefetching->getCacheStatistics();
+    EXPECT_EQ(stats.prefetchHits, 1u);
+    EXPECT_EQ(stats.misses, 2u);
+
+    // y keeps following x, so in the end reading x alone loads y
+    for (int round = 0; round < 3; ++round) {
+        prefetching->clearCache();
+        prefetching->readFile("other/y");
+        prefetching->readFile("other/x");
+        prefetching->readFile("other/y");
+    }
+    prefetching->clearCache();
+    prefetching->resetCacheStatistics();
+    prefetching->readFile("other/x");
+    prefetching->drainPrefetch();
+    EXPECT_EQ(prefetching->readFile("other/y"), "other/y");
+    EXPECT_EQ(prefetching->getCacheStatistics().prefetchHits, 1u);
+    EXPECT_GT(prefetching->getPrefetchStats().loaded, options.prefetch.readAhead);
+}
+
+TEST_F(FileSystemTest, WarmRestartReloadsHottestFirst) {
+    mtfs::fs::FileSystemOptions options;
+    options.warmRestart.enabled = true;
+    std::string root = (testRootPath / "warm").string();
+    auto warm = mtfs::fs::FileSystem::create(root, options);
+    for (const std::string path : {"hot", "lukewarm", "cold", "gone"}) {
+        ASSERT_TRUE(warm->createFile(path));
+        ASSERT_TRUE(warm->writeFile(path, "contents of " + path));
+    }
+    warm->clearCache();
+    for (int i = 0; i < 3; ++i) {
+        warm->readFile("hot");
+    }
+    warm->readFile("lukewarm");
+    warm->readFile("lukewarm");
+    warm->readFile("gone");
+    warm->unmount();
+
+    auto saved = mtfs::fs::CacheWarmer::load(root + "/.mtfs_cache_keys");
+    ASSERT_EQ(saved.size(), 3u);
+    EXPECT_EQ(saved[0].path, "hot");
+    EXPECT_EQ(saved[0].accessCount, 2u);
+    EXPECT_EQ(saved[1].path, "lukewarm");
+    ASSERT_TRUE(warm->deleteFile("gone"));
+    warm.reset();
+
+    warm = mtfs::fs::FileSystem::create(root, options);
+    warm->mount();
+    warm->waitForWarmup();
+    auto stats = warm->getWarmupStats();
+    EXPECT_EQ(stats.planned, 3u);
+    EXPECT_EQ(stats.loaded, 2u);  // "gone" was deleted since
+    EXPECT_FALSE(stats.running);
+
+    warm->resetCacheStatistics();
+    EXPECT_EQ(warm->readFile("hot"), "contents of hot");
+    EXPECT_EQ(warm->readFile("lukewarm"), "contents of lukewarm");
+    EXPECT_EQ(warm->getCacheStatistics().hits, 2u);
+    EXPECT_EQ(warm->readFile("cold"), "contents of cold");
+    EXPECT_EQ(warm->getCacheStatistics().misses, 1u);
+
+    // A paced reload is abandoned, not finished, when the file system goes away
+    options.warmRestart.bytesPerSecond = 1;
+    for (int i = 0; i < 40; ++i) {
+        std::string path = "many" + std::to_string(i);
+        ASSERT_TRUE(warm->createFile(path));
+        ASSERT_TRUE(warm->writeFile(path, path));
+    }
+    warm->unmount();
+    warm = mtfs::fs::FileSystem::create(root, options);
+    warm->mount();
+    EXPECT_GT(warm->getWarmupStats().planned, 16u);
+    warm.reset();
+}
+
+// Files deleted or written while their warm-up batch is still loading are
+// never cached with their old contents
+TEST_F(FileSystemTest, WarmRestartRacesWithChanges) {
+    mtfs::fs::FileSystemOptions options;
+    options.warmRestart.enabled = true;
+    std::string root = (testRootPath / "warm").string();
+    {
+        auto warm = mtfs::fs::FileSystem::create(root, options);
+        // The two hottest files load first; the large ones keep their batch
+        // loading well after that
+        for (const std::string path : {"deleted", "written"}) {
+            ASSERT_TRUE(warm->createFile(path));
+            ASSERT_TRUE(warm->writeFile(path, "old"));
+            for (int i = 0; i < 5; ++i) {
+                warm->readFile(path);
+            }
+        }
+        for (int i = 0; i < 14; ++i) {
+            std::string path = "large" + std::to_string(i);
+            ASSERT_TRUE(warm->createFile(path));
+            ASSERT_TRUE(warm->writeFile(path, std::string(8 << 20, 'l')));
+            warm->readFile(path);
+        }
+        warm->unmount();
+    }
+
+    auto warm = mtfs::fs::FileSystem::create(root, options);
+    warm->mount();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    ASSERT_TRUE(warm->deleteFile("deleted"));
+    ASSERT_EQ(warm->write("written", "new", 3, 0), 3u);
+    warm->waitForWarmup();
+
+    EXPECT_THROW(warm->readFile("deleted"), mtfs::common::FileNotFoundException);
+    EXPECT_EQ(warm->readFile("written"), "new");
+}
+
+TEST(GlobMatcherTest, WildcardsClassesAndBraces) {
+    using mtfs::fs::GlobMatcher;
+    GlobMatcher star("*.txt");
+    EXPECT_TRUE(star.matches("notes.txt"));
+    EXPECT_TRUE(star.matches(".txt"));
+    EXPECT_FALSE(star.matches("notes.txt.bak"));
+
+    GlobMatcher middle("a*b*c");
+    EXPECT_TRUE(middle.matches("abc"));
+    EXPECT_TRUE(middle.matches("axxbyybzc"));
+    EXPECT_FALSE(middle.matches("acb"));
+    EXPECT_FALSE(middle.matches("abcx"));
+
+    GlobMatcher single("file?.log");
+    EXPECT_TRUE(single.matches("file1.log"));
+    EXPECT_FALSE(single.matches("file.log"));
+
+    GlobMatcher classes("[a-c]x[!0-9]");
+    EXPECT_TRUE(classes.matches("bxz"));
+    EXPECT_FALSE(classes.matches("dxz"));
+    EXPECT_FALSE(classes.matches("ax5"));
+    EXPECT_TRUE(GlobMatcher("[]]").matches("]"));
+
+    GlobMatcher braces("*.{cpp,h{pp,xx}}");
+    EXPECT_TRUE(braces.matches("main.cpp"));
+    EXPECT_TRUE(braces.matches("main.hpp"));
+    EXPECT_TRUE(braces.matches("main.hxx"));
+    EXPECT_FALSE(braces.matches("main.h"));
+    EXPECT_TRUE(GlobMatcher("{a}").matches("{a}"));
+
+    // Without wildcards a pattern matches names containing it, as findFiles always has
+    GlobMatcher plain("report");
+    EXPECT_TRUE(plain.matches("monthly_report.txt"));
+    EXPECT_FALSE(plain.matches("summary.txt"));
+    EXPECT_TRUE(GlobMatcher("a[b").matches("xa[by"));
+    EXPECT_TRUE(GlobMatcher("*").matches(""));
+
+    EXPECT_THROW(GlobMatcher("{a,b}{a,b}{a,b}{a,b}{a,b}{a,b}{a,b}{a,b}{a,b}{a,b}{a,b}"), mtfs::common::FSException);
+}
+
+} // namespace mtfs::test
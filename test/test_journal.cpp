@@ -0,0 +1,268 @@
+#include <gtest/gtest.h>
+#include "journal/journal.hpp"
+#include "storage/block_manager.hpp"
+#include <filesystem>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <string>
+
+namespace mtfs::test {
+
+class JournalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        storagePath = std::filesystem::temp_directory_path() / "mtfs_journal_test.dat";
+        std::filesystem::remove(storagePath);
+        open();
+    }
+
+    void TearDown() override {
+        journal.reset();
+        blockManager.reset();
+        std::filesystem::remove(storagePath);
+    }
+
+    // Simulate a restart by dropping every in-memory structure
+    void reopen() {
+        journal.reset();
+        blockManager.reset();
+        open();
+    }
+
+    void open() {
+        blockManager = std::make_shared<mtfs::storage::BlockManager>(storagePath.string());
+        journal = mtfs::journal::Journal::create(blockManager);
+    }
+
+    static mtfs::journal::JournalEntry makeEntry(const std::string& text) {
+        mtfs::journal::JournalEntry entry;
+        entry.type = mtfs::journal::JournalEntryType::WRITE_DATA;
+        entry.blocks = {1, 2, 3};
+        entry.metadata.assign(text.begin(), text.end());
+        return entry;
+    }
+
+    std::filesystem::path storagePath;
+    std::shared_ptr<mtfs::storage::BlockManager> blockManager;
+    std::shared_ptr<mtfs::journal::Journal> journal;
+};
+
+// Entries survive a restart and replay in order
+TEST_F(JournalTest, RecoverAfterReopen) {
+    for (int i = 0; i < 10; ++i) {
+        journal->logEntry(makeEntry("op" + std::to_string(i)));
+    }
+    ASSERT_FALSE(journal->needsRecovery());
+
+    reopen();
+    ASSERT_TRUE(journal->needsRecovery());
+    ASSERT_EQ(journal->getLastSequenceNumber(), 10u);
+
+    std::vector<mtfs::journal::JournalEntry> replayed;
+    journal->recover([&](const mtfs::journal::JournalEntry& entry) { replayed.push_back(entry); });
+    ASSERT_EQ(replayed.size(), 10u);
+    for (size_t i = 0; i < replayed.size(); ++i) {
+        ASSERT_EQ(replayed[i].sequenceNumber, i + 1);
+        ASSERT_EQ(std::string(replayed[i].metadata.begin(), replayed[i].metadata.end()), "op" + std::to_string(i));
+        ASSERT_EQ(replayed[i].blocks.size(), 3u);
+    }
+    ASSERT_FALSE(journal->needsRecovery());
+}
+
+// Only entries after the checkpoint are replayed
+TEST_F(JournalTest, CheckpointLimitsReplay) {
+    for (int i = 0; i < 5; ++i) {
+        journal->logOperation("before");
+    }
+    journal->checkpoint();
+    for (int i = 0; i < 3; ++i) {
+        journal->logOperation("after");
+    }
+
+    reopen();
+    auto entries = journal->getEntries(0, 100);
+    ASSERT_EQ(entries.size(), 3u);
+    ASSERT_EQ(entries.front().sequenceNumber, 6u);
+    ASSERT_EQ(entries.back().sequenceNumber, 8u);
+
+    // New entries continue the sequence after the recovered tail
+    journal->logOperation("next");
+    ASSERT_EQ(journal->getLastSequenceNumber(), 9u);
+}
+
+// A full ring refuses new records rather than dropping ones that still need
+// replay; checkpoints free the space and the ring wraps around
+TEST_F(JournalTest, FullRingNeverDropsUncheckpointedRecords) {
+    const std::string payload(500, 'x');
+    uint64_t logged = 0;
+    while (true) {
+        try {
+            journal->logOperation(payload);
+        } catch (const mtfs::common::JournalException&) {
+            break;
+        }
+        ++logged;
+        ASSERT_LT(logged, 2000u);
+    }
+    ASSERT_GT(logged, 0u);
+    ASSERT_EQ(journal->getLastSequenceNumber(), logged);
+
+    reopen();
+    uint64_t expected = 0;
+    journal->recover([&](const mtfs::journal::JournalEntry& entry) {
+        ASSERT_EQ(entry.sequenceNumber, ++expected);
+    });
+    ASSERT_EQ(expected, logged);
+
+    // Checkpointing whenever it fills lets the ring go round several times
+    uint64_t checkpointed = 0;
+    for (int i = 0; i < 2000; ++i) {
+        try {
+            journal->logOperation(payload);
+        } catch (const mtfs::common::JournalException&) {
+            journal->checkpoint();
+            checkpointed = journal->getLastSequenceNumber();
+            journal->logOperation(payload);
+        }
+    }
+    const uint64_t last = logged + 2000;
+    ASSERT_GT(checkpointed, logged);
+
+    reopen();
+    ASSERT_EQ(journal->getLastSequenceNumber(), last);
+    expected = checkpointed;
+    journal->recover([&](const mtfs::journal::JournalEntry& entry) {
+        ASSERT_EQ(entry.sequenceNumber, ++expected);
+    });
+    ASSERT_EQ(expected, last);
+}
+
+// A transaction that does not fit stays open and commits after a checkpoint
+TEST_F(JournalTest, FullRingKeepsTransactionOpen) {
+    const std::string payload(500, 'x');
+    for (int i = 0; i < 300; ++i) {
+        journal->logOperation(payload);
+    }
+    journal->beginTransaction();
+    for (int i = 0; i < 200; ++i) {
+        journal->logOperation(payload);
+    }
+    ASSERT_THROW(journal->commitTransaction(), mtfs::common::JournalException);
+    ASSERT_EQ(journal->getLastSequenceNumber(), 300u);
+
+    journal->checkpoint();
+    journal->commitTransaction();
+    ASSERT_EQ(journal->getLastSequenceNumber(), 500u);
+
+    reopen();
+    auto entries = journal->getEntries(0, 1000);
+    ASSERT_EQ(entries.size(), 200u);
+    ASSERT_EQ(entries.front().sequenceNumber, 301u);
+}
+
+// A new journal never formats over blocks someone else holds, and a store
+// too small for it is refused
+TEST_F(JournalTest, RefusesBlocksInUse) {
+    journal.reset();
+    blockManager.reset();
+    std::filesystem::remove(storagePath);
+    blockManager = std::make_shared<mtfs::storage::BlockManager>(storagePath.string());
+    int taken = static_cast<int>(blockManager->getFormattedBlocks()) - 10;
+    ASSERT_TRUE(blockManager->reserveBlock(taken));
+    std::vector<char> data(mtfs::storage::BlockManager::BLOCK_SIZE, 'd');
+    ASSERT_TRUE(blockManager->writeBlock(taken, data));
+
+    ASSERT_THROW(mtfs::journal::Journal::create(blockManager), mtfs::common::JournalException);
+    std::vector<char> readBack;
+    ASSERT_TRUE(blockManager->readBlock(taken, readBack));
+    ASSERT_EQ(readBack, data);
+    ASSERT_TRUE(blockManager->isBlockFree(taken - 1));  // Nothing was reserved
+
+    auto smallPath = std::filesystem::temp_directory_path() / "mtfs_journal_small.dat";
+    std::filesystem::remove(smallPath);
+    {
+        auto small = std::make_shared<mtfs::storage::BlockManager>(smallPath.string(), 16);
+        ASSERT_THROW(mtfs::journal::Journal::create(small), mtfs::common::JournalException);
+    }
+    std::filesystem::remove(smallPath);
+}
+
+// Records queued while clear() flushes are written before the generation
+// changes, so they never hide the records logged after it from a replay
+TEST_F(JournalTest, ClearDuringConcurrentLogging) {
+    for (int round = 0; round < 20; ++round) {
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> writers;
+        for (int t = 0; t < 4; ++t) {
+            writers.emplace_back([&]() {
+                try {
+                    while (!stop) {
+                        journal->logOperation("busy");
+                    }
+                } catch (const mtfs::common::JournalException&) {
+                    // Ring full; enough records are queued already
+                }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        journal->clear();
+        stop = true;
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        journal->logOperation("marker");
+        uint64_t last = journal->getLastSequenceNumber();
+
+        reopen();
+        auto entries = journal->getEntries(0, UINT64_MAX);
+        ASSERT_EQ(entries.size(), last) << "round " << round;
+        ASSERT_EQ(std::string(entries.back().metadata.begin(), entries.back().metadata.end()), "marker");
+        journal->checkpoint();
+    }
+}
+
+// Concurrent writers share syncs
+TEST_F(JournalTest, GroupCommitBatchesSyncs) {
+    journal->setCommitWindow(std::chrono::microseconds(1000));
+    const int numThreads = 8;
+    const int perThread = 25;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < perThread; ++i) {
+                journal->logEntry(makeEntry("t" + std::to_string(t)));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(journal->size(), static_cast<size_t>(numThreads * perThread));
+    ASSERT_LT(journal->getSyncCount(), static_cast<uint64_t>(numThreads * perThread));
+
+    reopen();
+    ASSERT_EQ(journal->getEntries(0, 1000).size(), static_cast<size_t>(numThreads * perThread));
+}
+
+// Rolled back entries are never written
+TEST_F(JournalTest, TransactionRollback) {
+    journal->beginTransaction();
+    journal->logOperation("discarded");
+    journal->rollbackTransaction();
+    ASSERT_EQ(journal->size(), 0u);
+
+    journal->beginTransaction();
+    journal->logOperation("kept1");
+    journal->logOperation("kept2");
+    journal->commitTransaction();
+    ASSERT_EQ(journal->size(), 2u);
+
+    reopen();
+    ASSERT_EQ(journal->getEntries(0, 100).size(), 2u);
+}
+
+} // namespace mtfs::test
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/logger.hpp"
+
+TEST(LoggerTest, FlushWritesEveryMessageInOrderPerThread) {
+    testing::internal::CaptureStdout();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            // More than the ring holds, so producers also wait for the writer
+            for (int i = 0; i < 2000; ++i) {
+                LOG_INFO("logger-test " + std::to_string(t) + " " + std::to_string(i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    mtfs::common::flush_logs();
+    std::string output = testing::internal::GetCapturedStdout();
+
+    std::vector<int> next(4, 0);
+    size_t lines = 0;
+    std::istringstream stream(output);
+    std::string line;
+    while (std::getline(stream, line)) {
+        auto at = line.find("[INFO] logger-test ");
+        if (at == std::string::npos) {
+            continue;
+        }
+        int thread = 0;
+        int index = 0;
+        std::istringstream(line.substr(at + 19)) >> thread >> index;
+        ASSERT_EQ(index, next[thread]) << line;
+        next[thread]++;
+        lines++;
+    }
+    EXPECT_EQ(lines, 8000u);
+}
+
+TEST(LoggerTest, DisabledLevelsDoNotEvaluateTheMessage) {
+    int built = 0;
+    auto message = [&built] {
+        built++;
+        return std::string("message");
+    };
+    LOG_DEBUG(message());
+    mtfs::common::flush_logs();
+    EXPECT_EQ(built, MTFS_LOG_LEVEL <= MTFS_LOG_LEVEL_DEBUG ? 1 : 0);
+}
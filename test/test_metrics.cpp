@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "common/metrics.hpp"
+
+using namespace mtfs::common;
+
+TEST(MetricsTest, ShardedCounterSumsAllThreads) {
+    ShardedCounter counter;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&counter] {
+            for (int i = 0; i < 1000; ++i) {
+                counter.add();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(counter.load(), 8000u);
+    counter.reset();
+    EXPECT_EQ(counter.load(), 0u);
+}
+
+TEST(MetricsTest, BucketsCoverValuesWithoutGaps) {
+    for (size_t bucket = 0; bucket + 1 < LatencyHistogram::BUCKETS; ++bucket) {
+        uint64_t lower = LatencyHistogram::bucketLowerBound(bucket);
+        uint64_t next = lower + LatencyHistogram::bucketWidth(bucket);
+        ASSERT_EQ(LatencyHistogram::bucketOf(lower), bucket);
+        ASSERT_EQ(LatencyHistogram::bucketOf(next - 1), bucket);
+        ASSERT_EQ(LatencyHistogram::bucketLowerBound(bucket + 1), next);
+    }
+    EXPECT_EQ(LatencyHistogram::bucketOf(~uint64_t(0)), LatencyHistogram::BUCKETS - 1);
+}
+
+TEST(MetricsTest, PercentilesWithinBucketPrecision) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.snapshot().percentile(50), 0u);
+
+    // 1us .. 1ms in 1us steps
+    for (uint64_t value = 1000; value <= 1000000; value += 1000) {
+        histogram.record(value);
+    }
+    auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count(), 1000u);
+    EXPECT_EQ(snapshot.max(), 1000000u);
+    EXPECT_NEAR(snapshot.mean(), 500500.0, 1.0);
+    for (double percent : {50.0, 90.0, 99.0, 99.9}) {
+        double expected = percent * 10000.0;
+        double reported = static_cast<double>(snapshot.percentile(percent));
+        EXPECT_GE(reported, expected) << "p" << percent;
+        EXPECT_LE(reported, expected * (1.0 + 1.0 / 32)) << "p" << percent;
+    }
+    EXPECT_EQ(snapshot.percentile(100), 1000000u);
+}
+
+TEST(MetricsTest, ThreadsMergeIntoOneSnapshot) {
+    LatencyHistogram histogram;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&histogram, t] {
+            for (int i = 0; i < 500; ++i) {
+                histogram.record(std::chrono::microseconds(t + 1));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count(), 2000u);
+    EXPECT_EQ(snapshot.max(), 4000u);
+    uint64_t bucketed = 0;
+    for (const auto& bucket : snapshot.buckets()) {
+        bucketed += bucket.second;
+    }
+    EXPECT_EQ(bucketed, 2000u);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.snapshot().count(), 0u);
+}
@@ -0,0 +1,310 @@
+#include <gtest/gtest.h>
+#include "threading/thread_pool.hpp"
+#include "threading/co_task.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mtfs::test {
+
+using mtfs::threading::CoTask;
+using mtfs::threading::SchedulingMode;
+using mtfs::threading::TaskOptions;
+using mtfs::threading::TaskPriority;
+using mtfs::threading::ThreadPool;
+
+class ThreadPoolTest : public ::testing::TestWithParam<SchedulingMode> {};
+
+// Results come back through the futures
+TEST_P(ThreadPoolTest, EnqueueReturnsResults) {
+    ThreadPool pool(4, GetParam());
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 1000; ++i) {
+        futures.push_back(pool.enqueue([](int x) { return x * 2; }, i));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(futures[i].get(), i * 2);
+    }
+}
+
+// Tasks that wait on their own nested submissions must not starve a small pool
+TEST_P(ThreadPoolTest, NestedSubmissionDoesNotDeadlock) {
+    ThreadPool pool(2, GetParam());
+    std::vector<std::future<int>> outer;
+    for (int i = 0; i < 8; ++i) {
+        outer.push_back(pool.enqueue([&pool]() {
+            std::vector<std::future<int>> inner;
+            for (int j = 0; j < 16; ++j) {
+                inner.push_back(pool.enqueue([j]() { return j; }));
+            }
+            int sum = 0;
+            for (auto& future : inner) {
+                pool.waitFor(future);
+                sum += future.get();
+            }
+            return sum;
+        }));
+    }
+    for (auto& future : outer) {
+        ASSERT_EQ(future.get(), 120);
+    }
+}
+
+// Thousands of queued tasks that each wait on a nested one do not nest one
+// stack frame per queued task, in the normal lane or the background lane
+TEST_P(ThreadPoolTest, NestedWaitsStayShallow) {
+    ThreadPool pool(4, GetParam());
+    for (TaskPriority priority : {TaskPriority::NORMAL, TaskPriority::BACKGROUND}) {
+        const TaskOptions options{priority};
+        static thread_local size_t depth = 0;
+        std::atomic<size_t> peak{0};
+        std::vector<std::future<int>> outer;
+        for (int i = 0; i < 20000; ++i) {
+            outer.push_back(pool.enqueue(options, [&pool, &options, &peak, i]() {
+                size_t now = ++depth;
+                size_t seen = peak.load();
+                while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+                }
+                auto inner = pool.enqueue(options, [i]() { return i; });
+                pool.waitFor(inner);
+                --depth;
+                return inner.get();
+            }));
+        }
+        for (int i = 0; i < 20000; ++i) {
+            ASSERT_EQ(outer[i].get(), i);
+        }
+        EXPECT_LE(peak.load(), ThreadPool::MAX_HELP_DEPTH + 1);
+    }
+}
+
+// waitForAll covers detached tasks, including ones spawned by other tasks
+TEST_P(ThreadPoolTest, WaitForAllCoversDetachedTasks) {
+    ThreadPool pool(4, GetParam());
+    std::atomic<int> counter{0};
+    for (int i = 0; i < 100; ++i) {
+        pool.enqueue_detached([&pool, &counter]() {
+            counter++;
+            pool.enqueue_detached([&counter]() { counter++; });
+        });
+    }
+    pool.waitForAll();
+    ASSERT_EQ(counter.load(), 200);
+    ASSERT_FALSE(pool.isBusy());
+}
+
+// Shrinking and growing keep the pool usable
+TEST_P(ThreadPoolTest, ResizeKeepsPoolUsable) {
+    ThreadPool pool(8, GetParam());
+    pool.resize(2);
+    ASSERT_EQ(pool.getThreadCount(), 2u);
+    ASSERT_EQ(pool.enqueue([]() { return 7; }).get(), 7);
+
+    pool.resize(6);
+    ASSERT_EQ(pool.getThreadCount(), 6u);
+    ASSERT_EQ(pool.enqueue([]() { return 9; }).get(), 9);
+}
+
+// Move-only results and arguments work, and exceptions reach the future
+TEST_P(ThreadPoolTest, MoveOnlyValuesAndExceptions) {
+    ThreadPool pool(2, GetParam());
+    auto owned = pool.enqueue([](std::unique_ptr<int>& value) { return std::move(value); },
+                              std::make_unique<int>(42));
+    ASSERT_EQ(*owned.get(), 42);
+
+    auto failing = pool.enqueue([]() -> int { throw std::runtime_error("boom"); });
+    ASSERT_THROW(failing.get(), std::runtime_error);
+}
+
+// Ties up one of the pool's two workers until released, so the order the
+// other one claims queued tasks in is observable
+class OccupiedWorker {
+public:
+    explicit OccupiedWorker(ThreadPool& pool) {
+        done = pool.enqueue([gate = release.get_future().share()]() { gate.wait(); });
+        while (pool.getActiveThreads() == 0) {
+            std::this_thread::yield();
+        }
+    }
+    ~OccupiedWorker() {
+        release.set_value();
+        done.wait();
+    }
+
+private:
+    std::promise<void> release;
+    std::future<void> done;
+};
+
+// Interactive tasks are claimed before normal and background ones queued earlier
+TEST_P(ThreadPoolTest, InteractiveLaneRunsFirst) {
+    ThreadPool pool(2, GetParam());
+    std::mutex orderMutex;
+    std::vector<std::string> order;
+    auto record = [&](const std::string& name) {
+        std::lock_guard<std::mutex> lock(orderMutex);
+        order.push_back(name);
+    };
+    {
+        OccupiedWorker occupied(pool);
+        pool.pause();
+        pool.enqueue_detached(TaskOptions{TaskPriority::BACKGROUND}, record, "background");
+        pool.enqueue_detached(record, "normal");
+        pool.enqueue_detached(TaskOptions{TaskPriority::INTERACTIVE}, record, "interactive");
+        pool.resume();
+        while (pool.getQueueSize() > 0) {
+            std::this_thread::yield();
+        }
+    }
+    pool.waitForAll();
+    ASSERT_EQ(order, (std::vector<std::string>{"interactive", "normal", "background"}));
+}
+
+// Within a lane dated tasks run earliest deadline first, ahead of undated
+// ones, and a nearly due task overtakes higher lanes
+TEST_P(ThreadPoolTest, DeadlinesOrderDequeue) {
+    ThreadPool pool(2, GetParam());
+    auto now = std::chrono::steady_clock::now();
+    std::mutex orderMutex;
+    std::vector<std::string> order;
+    auto record = [&](const std::string& name) {
+        std::lock_guard<std::mutex> lock(orderMutex);
+        order.push_back(name);
+    };
+    {
+        OccupiedWorker occupied(pool);
+        pool.pause();
+        pool.enqueue_detached(record, "undated");
+        pool.enqueue_detached(TaskOptions{TaskPriority::NORMAL, now + std::chrono::hours(2)}, record, "later");
+        pool.enqueue_detached(TaskOptions{TaskPriority::NORMAL, now + std::chrono::hours(1)}, record, "sooner");
+        pool.enqueue_detached(TaskOptions{TaskPriority::INTERACTIVE}, record, "interactive");
+        pool.enqueue_detached(TaskOptions{TaskPriority::BACKGROUND, now}, record, "overdue");
+        pool.resume();
+        while (pool.getQueueSize() > 0) {
+            std::this_thread::yield();
+        }
+    }
+    pool.waitForAll();
+    ASSERT_EQ(order, (std::vector<std::string>{"overdue", "interactive", "sooner", "later", "undated"}));
+}
+
+// No more threads run background tasks at once than the limit, other work
+// still gets through meanwhile, and background tasks waiting on nested
+// background work do not deadlock
+TEST_P(ThreadPoolTest, BackgroundLimitCapsConcurrency) {
+    ThreadPool pool(4, GetParam());
+    pool.setBackgroundLimit(1);
+    ASSERT_EQ(pool.getBackgroundLimit(), 1u);
+    const TaskOptions background{TaskPriority::BACKGROUND};
+
+    // A thread waiting in waitFor may run further tasks on its own stack, so
+    // threads are counted rather than tasks
+    std::atomic<int> running{0};
+    std::atomic<int> peak{0};
+    static thread_local int depth = 0;
+    std::vector<std::future<int>> bulk;
+    for (int i = 0; i < 4; ++i) {
+        bulk.push_back(pool.enqueue(background, [&, i]() {
+            if (depth++ == 0) {
+                int now = ++running;
+                peak = std::max(peak.load(), now);
+            }
+            std::vector<std::future<int>> parts;
+            for (int j = 0; j < 4; ++j) {
+                parts.push_back(pool.enqueue(background, [j]() { return j; }));
+            }
+            int sum = 0;
+            for (auto& part : parts) {
+                pool.waitFor(part);
+                sum += part.get();
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            if (--depth == 0) {
+                --running;
+            }
+            return sum + i;
+        }));
+    }
+    ASSERT_EQ(pool.enqueue([]() { return 1; }).get(), 1);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_EQ(bulk[i].get(), 6 + i);
+    }
+    ASSERT_EQ(peak.load(), 1);
+    pool.waitForAll();
+    ASSERT_EQ(pool.getRunningBackground(), 0u);
+
+    pool.setBackgroundLimit(0);
+    ASSERT_EQ(pool.getBackgroundLimit(), 2u);
+}
+
+namespace {
+
+CoTask<int> doubledOn(ThreadPool& pool, int x) {
+    co_await mtfs::threading::resumeOn(pool);
+    if (x < 0) {
+        throw std::invalid_argument("negative");
+    }
+    co_return x * 2;
+}
+
+CoTask<int> chain(ThreadPool& pool, int x) {
+    int once = co_await doubledOn(pool, x);
+    int twice = co_await doubledOn(pool, once);
+    co_return twice + 1;
+}
+
+} // namespace
+
+// Awaited coroutines hand back values and exceptions through the chain
+TEST_P(ThreadPoolTest, CoroutineChainPropagatesResults) {
+    ThreadPool pool(2, GetParam());
+    ASSERT_EQ(mtfs::threading::blockingWait(chain(pool, 5)), 21);
+    ASSERT_THROW(mtfs::threading::blockingWait(chain(pool, -1)), std::invalid_argument);
+}
+
+// Far more coroutines than workers are in flight at once, since a suspended
+// coroutine holds no thread
+TEST_P(ThreadPoolTest, WhenAllRunsThousandsOfCoroutines) {
+    ThreadPool pool(2, GetParam());
+    std::vector<CoTask<int>> tasks;
+    for (int i = 0; i < 5000; ++i) {
+        tasks.push_back(chain(pool, i));
+    }
+    auto results = mtfs::threading::blockingWait(mtfs::threading::whenAll(std::move(tasks)));
+    ASSERT_EQ(results.size(), 5000u);
+    for (int i = 0; i < 5000; ++i) {
+        ASSERT_EQ(results[i], i * 4 + 1);
+    }
+
+    std::vector<CoTask<int>> failing;
+    failing.push_back(chain(pool, 1));
+    failing.push_back(chain(pool, -1));
+    ASSERT_THROW(mtfs::threading::blockingWait(mtfs::threading::whenAll(std::move(failing))),
+                 std::invalid_argument);
+}
+
+// Small callables are stored inline; large ones still run correctly
+TEST(TaskTest, InlineAndHeapStorage) {
+    int calls = 0;
+    mtfs::threading::Task small([&calls]() { ++calls; });
+    std::array<char, 512> payload{};
+    payload[0] = 1;
+    mtfs::threading::Task large([&calls, payload]() { calls += payload[0]; });
+
+    mtfs::threading::Task moved(std::move(large));
+    ASSERT_FALSE(static_cast<bool>(large));
+    small();
+    moved();
+    ASSERT_EQ(calls, 2);
+}
+
+INSTANTIATE_TEST_SUITE_P(SchedulingModes, ThreadPoolTest,
+                         ::testing::Values(SchedulingMode::SHARED_QUEUE, SchedulingMode::WORK_STEALING));
+
+} // namespace mtfs::test
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+#include "threading/co_task.hpp"
+
+namespace mtfs::fs {
+    class FileSystem;
+}
+
+namespace mtfs::threading {
+
+// Coroutine counterparts of AsyncFileOperations. Each operation moves onto
+// the pool with resumeOn and makes the FileSystem call there, and batches
+// complete through whenAll, so nothing waits on a future: operations in
+// flight are suspended frames rather than blocked threads, and thousands of
+// them share the pool's workers. Reads are INTERACTIVE and backups
+// BACKGROUND. Like AsyncFileOperations, reads rethrow failures while the
+// other operations report them as false.
+class CoFileOperations {
+public:
+    CoFileOperations(mtfs::fs::FileSystem* fs, ThreadPool& pool);
+
+    CoTask<std::string> read(std::string path);
+    CoTask<bool> write(std::string path, std::string content);
+    CoTask<bool> copy(std::string source, std::string destination);
+    CoTask<bool> backup(std::string backupName);
+
+    // Every item at once; results in input order
+    CoTask<std::vector<std::string>> readAll(std::vector<std::string> paths);
+    CoTask<std::vector<bool>> writeAll(std::vector<std::pair<std::string, std::string>> files);
+    CoTask<std::vector<bool>> copyAll(std::vector<std::pair<std::string, std::string>> operations);
+
+    size_t inFlight() const { return started.load() - finished.load(); }  // Started, not yet finished
+
+private:
+    // Counts an operation in flight for the lifetime of its frame
+    class Flight {
+    public:
+        explicit Flight(CoFileOperations& owner) : owner(owner) { owner.started++; }
+        ~Flight() { owner.finished++; }
+
+    private:
+        CoFileOperations& owner;
+    };
+
+    mtfs::fs::FileSystem* filesystem;
+    ThreadPool& pool;
+    std::atomic<size_t> started{0};
+    std::atomic<size_t> finished{0};
+};
+
+} // namespace mtfs::threading
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "threading/thread_pool.hpp"
+
+namespace mtfs::threading {
+
+template<typename T = void>
+class CoTask;
+
+namespace detail {
+
+// Hands control to whoever awaited the task once it finishes
+struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+    template<typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        std::coroutine_handle<> continuation = handle.promise().continuation;
+        return continuation ? continuation : std::noop_coroutine();
+    }
+    void await_resume() const noexcept {}
+};
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { exception = std::current_exception(); }
+};
+
+template<typename T>
+struct CoPromise : PromiseBase {
+    std::optional<T> value;
+
+    CoTask<T> get_return_object() noexcept;
+    template<typename U>
+    void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+    T take();
+};
+
+template<>
+struct CoPromise<void> : PromiseBase {
+    CoTask<void> get_return_object() noexcept;
+    void return_void() const noexcept {}
+    void take();
+};
+
+// Eager, self-destroying coroutine for starting work nobody awaits
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+} // namespace detail
+
+// Lazily started coroutine producing a T. Awaiting it starts it on the
+// awaiting thread, and its end resumes the awaiter directly (symmetric
+// transfer), so long chains neither block threads nor grow the stack. A
+// coroutine moves to a pool with `co_await resumeOn(pool)`. Awaited at most
+// once; coroutine parameters should be taken by value, since the frame
+// outlives the caller's arguments.
+template<typename T>
+class [[nodiscard]] CoTask {
+public:
+    using promise_type = detail::CoPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    CoTask() noexcept = default;
+    explicit CoTask(Handle handle) noexcept : handle(handle) {}
+    CoTask(CoTask&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    CoTask& operator=(CoTask&& other) noexcept;
+    CoTask(const CoTask&) = delete;
+    CoTask& operator=(const CoTask&) = delete;
+    ~CoTask();
+
+    bool valid() const noexcept { return static_cast<bool>(handle); }
+    bool done() const noexcept { return handle && handle.done(); }
+
+    // Runs the task and yields its result, rethrowing what it threw
+    auto operator co_await() noexcept;
+
+    // Runs the task to completion without taking its result
+    auto whenReady() noexcept;
+
+    // Result of a finished task; rethrows what it threw
+    T result();
+
+private:
+    Handle handle;
+};
+
+// Suspends the awaiting coroutine and resumes it as a task on `pool`, in
+// the lane `options` choose
+class ResumeOn {
+public:
+    ResumeOn(ThreadPool& pool, const TaskOptions& options) : pool(pool), options(options) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+        pool.enqueue_detached(options, [handle]() { handle.resume(); });
+    }
+    void await_resume() const noexcept {}
+
+private:
+    ThreadPool& pool;
+    TaskOptions options;
+};
+
+inline ResumeOn resumeOn(ThreadPool& pool, const TaskOptions& options = TaskOptions()) {
+    return ResumeOn(pool, options);
+}
+
+// Results of whenAll: a vector in input order, or nothing for CoTask<void>
+template<typename T>
+using WhenAllResult = std::conditional_t<std::is_void_v<T>, void, std::vector<T>>;
+
+// Starts every task at once and completes when the last one does. Tasks
+// that begin with resumeOn run in parallel on their pool. If any task
+// threw, the first such exception in input order is rethrown once all have
+// finished.
+template<typename T>
+CoTask<WhenAllResult<T>> whenAll(std::vector<CoTask<T>> tasks);
+
+// Runs a task from code that is not a coroutine and blocks until it
+// finishes. Not for use on a pool worker whose pool the task needs.
+template<typename T>
+T blockingWait(CoTask<T> task);
+
+} // namespace mtfs::threading
+
+// Template implementation
+#include "co_task.tpp"
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <future>
+#include <memory>
+#include <stdexcept>
+
+namespace mtfs::threading {
+
+namespace detail {
+
+template<typename T>
+CoTask<T> CoPromise<T>::get_return_object() noexcept {
+    return CoTask<T>(std::coroutine_handle<CoPromise<T>>::from_promise(*this));
+}
+
+template<typename T>
+T CoPromise<T>::take() {
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+    return std::move(*value);
+}
+
+inline CoTask<void> CoPromise<void>::get_return_object() noexcept {
+    return CoTask<void>(std::coroutine_handle<CoPromise<void>>::from_promise(*this));
+}
+
+inline void CoPromise<void>::take() {
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+// Starts the task and has it resume the awaiter when it finishes
+template<typename Promise>
+struct StartAwaiter {
+    std::coroutine_handle<Promise> handle;
+
+    bool await_ready() const noexcept { return !handle || handle.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+};
+
+// Counts the tasks of a whenAll down; the whenAll itself holds one count
+// until it has started them all
+struct WhenAllLatch {
+    explicit WhenAllLatch(size_t tasks) : remaining(tasks + 1) {}
+
+    bool arrive() noexcept { return remaining.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+    std::atomic<size_t> remaining;
+    std::coroutine_handle<> awaiting;
+};
+
+template<typename T>
+Detached arriveWhenReady(CoTask<T>& task, WhenAllLatch& latch) {
+    co_await task.whenReady();
+    if (latch.arrive()) {
+        latch.awaiting.resume();
+    }
+}
+
+template<typename T>
+struct WhenAllAwaiter {
+    std::vector<CoTask<T>>& tasks;
+    WhenAllLatch latch;
+
+    bool await_ready() const noexcept { return tasks.empty(); }
+    bool await_suspend(std::coroutine_handle<> awaiting) {
+        latch.awaiting = awaiting;
+        for (auto& task : tasks) {
+            arriveWhenReady(task, latch);
+        }
+        return !latch.arrive();
+    }
+    void await_resume() const noexcept {}
+};
+
+// The promise is owned by the frame, so it outlives set_value even when the
+// waiter wakes and returns at once
+template<typename T>
+Detached signalWhenReady(CoTask<T>& task, std::shared_ptr<std::promise<void>> finished) {
+    co_await task.whenReady();
+    finished->set_value();
+}
+
+} // namespace detail
+
+template<typename T>
+CoTask<T>& CoTask<T>::operator=(CoTask&& other) noexcept {
+    if (this != &other) {
+        if (handle) {
+            handle.destroy();
+        }
+        handle = std::exchange(other.handle, {});
+    }
+    return *this;
+}
+
+template<typename T>
+CoTask<T>::~CoTask() {
+    if (handle) {
+        handle.destroy();
+    }
+}
+
+template<typename T>
+auto CoTask<T>::operator co_await() noexcept {
+    struct Awaiter : detail::StartAwaiter<promise_type> {
+        CoTask& task;
+        Awaiter(CoTask& task) : detail::StartAwaiter<promise_type>{task.handle}, task(task) {}
+        T await_resume() { return task.result(); }
+    };
+    return Awaiter(*this);
+}
+
+template<typename T>
+auto CoTask<T>::whenReady() noexcept {
+    struct Awaiter : detail::StartAwaiter<promise_type> {
+        void await_resume() const noexcept {}
+    };
+    return Awaiter{{handle}};
+}
+
+template<typename T>
+T CoTask<T>::result() {
+    if (!handle || !handle.done()) {
+        throw std::logic_error("CoTask has not finished");
+    }
+    return handle.promise().take();
+}
+
+template<typename T>
+CoTask<WhenAllResult<T>> whenAll(std::vector<CoTask<T>> tasks) {
+    co_await detail::WhenAllAwaiter<T>{tasks, detail::WhenAllLatch(tasks.size())};
+    if constexpr (std::is_void_v<T>) {
+        for (auto& task : tasks) {
+            task.result();
+        }
+    } else {
+        std::vector<T> results;
+        results.reserve(tasks.size());
+        for (auto& task : tasks) {
+            results.push_back(task.result());
+        }
+        co_return results;
+    }
+}
+
+template<typename T>
+T blockingWait(CoTask<T> task) {
+    auto finished = std::make_shared<std::promise<void>>();
+    std::future<void> ready = finished->get_future();
+    detail::signalWhenReady(task, std::move(finished));
+    ready.wait();
+    return task.result();
+}
+
+} // namespace mtfs::threading
@@ -6,7 +6,9 @@
 #include <atomic>
 #include <shared_mutex>
 #include "cache/enhanced_cache.hpp"
+#include "common/metrics.hpp"
 #include "threading/thread_pool.hpp"
+#include "threading/read_buffer.hpp"
 
 namespace mtfs::threading {
 
@@ -32,13 +34,18 @@ public:
     std::future<std::vector<Value>> getBatchAsync(const std::vector<Key>& keys);
     std::future<void> removeBatchAsync(const std::vector<Key>& keys);
     
-    // Synchronous operations (thread-safe)
+    // Synchronous operations (thread-safe). A hit in get() takes only shared
+    // locks; its recency update is buffered and applied in batches.
     void put(const Key& key, const Value& value);
     Value get(const Key& key);
     bool contains(const Key& key) const;
     void remove(const Key& key);
     void clear();
     
+    // Apply all buffered hits, e.g. before reading exact statistics
+    void drainReadBuffers();
+    mtfs::cache::CacheStatistics getStatistics();
+    
     // Cache management
     void setPolicy(mtfs::cache::CachePolicy policy);
     mtfs::cache::CachePolicy getPolicy() const;
@@ -60,14 +67,14 @@ public:
     void stopBackgroundOptimization();
     void schedulePeriodicCleanup(std::chrono::seconds interval);
     
-    // Performance monitoring
+    // Performance monitoring. A snapshot of the per-thread async operation
+    // counters and latency histogram; times are in milliseconds.
     struct ConcurrentStats {
-        std::atomic<size_t> concurrentReads{0};
-        std::atomic<size_t> concurrentWrites{0};
-        std::atomic<size_t> totalAsyncOperations{0};
-        std::atomic<size_t> completedAsyncOperations{0};
-        std::atomic<size_t> failedAsyncOperations{0};
-        std::atomic<double> averageResponseTime{0.0};
+        size_t totalAsyncOperations{0};
+        size_t completedAsyncOperations{0};
+        size_t failedAsyncOperations{0};
+        double averageResponseTime{0.0};
+        double p99ResponseTime{0.0};
         
         double getCompletionRate() const {
             return totalAsyncOperations > 0 ? 
@@ -95,6 +102,7 @@ private:
     struct CacheShard {
         std::unique_ptr<mtfs::cache::CacheManager<Key, Value>> cache;
         mutable std::shared_mutex mutex;
+        ReadBuffer<Key> reads;  // Hits not yet applied to the policy
         
         CacheShard(size_t capacity, mtfs::cache::CachePolicy policy)
             : cache(std::make_unique<mtfs::cache::CacheManager<Key, Value>>(capacity, policy)) {}
@@ -111,19 +119,22 @@ private:
     std::unique_ptr<std::thread> cleanupThread;
     
     // Statistics
-    mutable ConcurrentStats concurrentStats;
+    mtfs::common::ShardedCounter completedAsyncOperations;
+    mtfs::common::ShardedCounter failedAsyncOperations;
+    mtfs::common::LatencyHistogram asyncLatency;
     
     // Hash function for sharding
     size_t getShardIndex(const Key& key) const;
     CacheShard& getShard(const Key& key);
     const CacheShard& getShard(const Key& key) const;
+    void drainReads(CacheShard& shard);
     
     // Background operations
     void backgroundOptimizationLoop();
     void periodicCleanupLoop(std::chrono::seconds interval);
     
     // Statistics tracking
-    void trackAsyncOperation(bool success, std::chrono::milliseconds duration);
+    void trackAsyncOperation(bool success, std::chrono::nanoseconds duration);
     
     // Batch operation helpers
     template<typename Operation>
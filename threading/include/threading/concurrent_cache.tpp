@@ -10,17 +10,14 @@ ConcurrentCacheManager<Key, Value>::ConcurrentCacheManager(
     size_t capacity, 
     mtfs::cache::CachePolicy policy,
     size_t numShards)
-    : numShards(numShards), threadPool(GlobalThreadPool::getInstance()) {
-    
-    // Ensure at least 1 shard
-    numShards = std::max(size_t(1), numShards);
+    : numShards(std::max(size_t(1), numShards)), threadPool(GlobalThreadPool::getInstance()) {
     
     // Distribute capacity among shards
-    size_t capacityPerShard = std::max(size_t(1), capacity / numShards);
+    size_t capacityPerShard = std::max(size_t(1), capacity / this->numShards);
     
     // Create shards
-    shards.reserve(numShards);
-    for (size_t i = 0; i < numShards; ++i) {
+    shards.reserve(this->numShards);
+    for (size_t i = 0; i < this->numShards; ++i) {
         shards.push_back(std::make_unique<CacheShard>(capacityPerShard, policy));
     }
 }
@@ -52,15 +49,9 @@ std::future<void> ConcurrentCacheManager<Key, Value>::putAsync(const Key& key, c
             std::unique_lock<std::shared_mutex> lock(shard.mutex);
             shard.cache->put(key, value);
             
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now() - start
-            );
-            trackAsyncOperation(true, duration);
+            trackAsyncOperation(true, std::chrono::steady_clock::now() - start);
         } catch (...) {
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now() - start
-            );
-            trackAsyncOperation(false, duration);
+            trackAsyncOperation(false, std::chrono::steady_clock::now() - start);
             throw;
         }
     });
@@ -71,20 +62,12 @@ std::future<Value> ConcurrentCacheManager<Key, Value>::getAsync(const Key& key)
     return threadPool.enqueue([this, key]() -> Value {
         auto start = std::chrono::steady_clock::now();
         try {
-            auto& shard = getShard(key);
-            std::shared_lock<std::shared_mutex> lock(shard.mutex);
-            auto result = shard.cache->get(key);
+            auto result = get(key);
             
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now() - start
-            );
-            trackAsyncOperation(true, duration);
+            trackAsyncOperation(true, std::chrono::steady_clock::now() - start);
             return result;
         } catch (...) {
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now() - start
-            );
-            trackAsyncOperation(false, duration);
+            trackAsyncOperation(false, std::chrono::steady_clock::now() - start);
             throw;
         }
     });
@@ -99,11 +82,56 @@ void ConcurrentCacheManager<Key, Value>::put(const Key& key, const Value& value)
 
 template<typename Key, typename Value>
 Value ConcurrentCacheManager<Key, Value>::get(const Key& key) {
+    // The policy caches synchronize themselves, so reads skip the shard lock
+    // that serializes writers
     auto& shard = getShard(key);
-    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    
+    // Hit: read under shared locks and leave the promotion to a later drain
+    if (auto value = shard.cache->peek(key)) {
+        if (shard.reads.record(key)) {
+            drainReads(shard);
+        }
+        return std::move(*value);
+    }
+    
+    // Miss: go through the policy so it is counted (and thrown)
     return shard.cache->get(key);
 }
 
+template<typename Key, typename Value>
+void ConcurrentCacheManager<Key, Value>::drainReads(CacheShard& shard) {
+    // Only one reader drains a shard at a time; the others just carry on
+    shard.reads.tryDrain([&shard](const Key* keys, size_t count) { shard.cache->touch(keys, count); });
+}
+
+template<typename Key, typename Value>
+void ConcurrentCacheManager<Key, Value>::drainReadBuffers() {
+    for (auto& shard : shards) {
+        drainReads(*shard);
+    }
+}
+
+template<typename Key, typename Value>
+mtfs::cache::CacheStatistics ConcurrentCacheManager<Key, Value>::getStatistics() {
+    drainReadBuffers();
+    
+    mtfs::cache::CacheStatistics total;
+    for (auto& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard->mutex);
+        auto stats = shard->cache->getStatistics();
+        total.hits += stats.hits;
+        total.misses += stats.misses;
+        total.evictions += stats.evictions;
+        total.pinnedItems += stats.pinnedItems;
+        total.prefetchedItems += stats.prefetchedItems;
+        total.prefetchHits += stats.prefetchHits;
+        total.currentSize += stats.currentSize;
+        total.residentBytes += stats.residentBytes;
+    }
+    total.updateHitRate();
+    return total;
+}
+
 template<typename Key, typename Value>
 bool ConcurrentCacheManager<Key, Value>::contains(const Key& key) const {
     auto& shard = getShard(key);
@@ -140,26 +168,27 @@ std::future<void> ConcurrentCacheManager<Key, Value>::putBatchAsync(
 template<typename Key, typename Value>
 typename ConcurrentCacheManager<Key, Value>::ConcurrentStats 
 ConcurrentCacheManager<Key, Value>::getConcurrentStats() const {
-    return concurrentStats;
+    ConcurrentStats stats;
+    auto latency = asyncLatency.snapshot();
+    stats.completedAsyncOperations = completedAsyncOperations.load();
+    stats.failedAsyncOperations = failedAsyncOperations.load();
+    stats.totalAsyncOperations = stats.completedAsyncOperations + stats.failedAsyncOperations;
+    stats.averageResponseTime = latency.mean() / 1e6;
+    stats.p99ResponseTime = latency.percentile(99) / 1e6;
+    return stats;
 }
 
 template<typename Key, typename Value>
 void ConcurrentCacheManager<Key, Value>::resetConcurrentStats() {
-    concurrentStats = ConcurrentStats{};
+    completedAsyncOperations.reset();
+    failedAsyncOperations.reset();
+    asyncLatency.reset();
 }
 
 template<typename Key, typename Value>
-void ConcurrentCacheManager<Key, Value>::trackAsyncOperation(bool success, std::chrono::milliseconds duration) {
-    concurrentStats.totalAsyncOperations++;
-    if (success) {
-        concurrentStats.completedAsyncOperations++;
-    } else {
-        concurrentStats.failedAsyncOperations++;
-    }
-    
-    // Update average response time
-    double newAvg = (concurrentStats.averageResponseTime.load() + duration.count()) / 2.0;
-    concurrentStats.averageResponseTime = newAvg;
+void ConcurrentCacheManager<Key, Value>::trackAsyncOperation(bool success, std::chrono::nanoseconds duration) {
+    (success ? completedAsyncOperations : failedAsyncOperations).add();
+    asyncLatency.record(duration);
 }
 
 } // namespace mtfs::threading
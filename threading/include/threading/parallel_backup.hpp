@@ -8,12 +8,22 @@
 #include <mutex>
 #include <functional>
 #include "threading/thread_pool.hpp"
+#include "fs/chunk_store.hpp"
+#include "fs/file_index.hpp"
+#include "fs/directory_walker.hpp"
 
 namespace mtfs::threading {
 
+// Files are chunked in parallel into a content-addressed store shared by
+// every backup (backups/.chunks); each backup directory keeps a manifest
+// and the FileIndex that lets an incremental backup skip unchanged files.
 class ParallelBackupManager {
 public:
     explicit ParallelBackupManager(size_t numThreads = std::thread::hardware_concurrency());
+    // Runs on a pool shared with other work. Its tasks are BACKGROUND, so
+    // they yield to interactive ones and stay within the pool's background
+    // limit. The pool must outlive the manager.
+    explicit ParallelBackupManager(ThreadPool& sharedPool);
     ~ParallelBackupManager() = default;
 
     // Parallel backup operations
@@ -31,6 +41,8 @@ public:
         std::atomic<size_t> totalBytes{0};
         std::atomic<size_t> filesCompressed{0};
         std::atomic<size_t> compressionSaved{0};
+        std::atomic<size_t> bytesDeduplicated{0};  // Already in the chunk store
+        std::atomic<size_t> filesSkipped{0};       // Unchanged since the base backup
         std::atomic<bool> isComplete{false};
         std::atomic<bool> hasErrors{false};
         std::chrono::steady_clock::time_point startTime;
@@ -57,6 +69,8 @@ public:
         ProgressCallback callback = nullptr
     );
     
+    // Streams the backup's files out of the chunk store largest first,
+    // verifying each chunk as it is decoded (see fs::RestorePlan)
     std::future<bool> restoreParallelBackup(
         const std::string& backupName,
         const std::string& targetPath,
@@ -96,34 +110,53 @@ public:
         size_t totalFilesBackedUp{0};
         size_t totalBytesBackedUp{0};
         size_t totalCompressionSaved{0};
+        size_t totalBytesDeduplicated{0};
+        size_t totalBytesRestored{0};
         std::chrono::milliseconds totalBackupTime{0};
         std::chrono::milliseconds totalRestoreTime{0};
         double averageCompressionRatio{0.0};
+
+        // Source MiB read per second of backup time
+        double backupThroughput() const {
+            double seconds = std::chrono::duration<double>(totalBackupTime).count();
+            return seconds > 0 ? static_cast<double>(totalBytesBackedUp) / (1024.0 * 1024.0) / seconds : 0.0;
+        }
+        double restoreThroughput() const {
+            double seconds = std::chrono::duration<double>(totalRestoreTime).count();
+            return seconds > 0 ? static_cast<double>(totalBytesRestored) / (1024.0 * 1024.0) / seconds : 0.0;
+        }
     };
     
     BackupStats getStats() const;
     void resetStats();
     
     // Pool management
-    void setThreadCount(size_t numThreads);
+    void setThreadCount(size_t numThreads);  // Own pool only; a shared pool is left alone
     size_t getThreadCount() const;
     bool isBusy() const;
 
 private:
-    std::unique_ptr<ThreadPool> backupThreadPool;
+    std::unique_ptr<ThreadPool> ownedPool;  // Null when running on a shared pool
+    ThreadPool* backupThreadPool;
+    TaskOptions taskOptions;
+    std::unique_ptr<fs::ChunkStore> chunkStore;  // Created by the first backup
+    std::once_flag chunkStoreOnce;
+    fs::ChunkStore& getChunkStore();
     
     // Statistics
     mutable std::mutex statsMutex;
     mutable BackupStats stats;
     
-    // Internal backup operations
-    bool backupFile(const std::string& sourcePath, const std::string& backupPath, bool compress);
-    bool restoreFile(const std::string& backupPath, const std::string& targetPath);
+    // Internal backup operations; baseBackup is empty for a full backup
+    bool runBackup(const std::string& backupName, const std::string& baseBackup,
+                   const std::vector<std::string>& sourcePaths, ProgressCallback callback);
+    static constexpr size_t MAX_CHUNKS_IN_FLIGHT = 16;
+    bool backupFile(const std::string& sourcePath, const std::string& relativePath, bool compress, bool verify,
+                    fs::ManifestEntry& entry, fs::ChunkingStats& chunking);
     bool verifyFile(const std::string& backupPath, const std::string& originalPath);
     
-    // Directory scanning
-    std::vector<std::string> scanDirectory(const std::string& path, bool recursive = true);
-    size_t calculateDirectorySize(const std::string& path);
+    // Directory scanning; files only, sorted, paths relative to `path`
+    std::vector<fs::DirectoryEntry> scanDirectory(const std::string& path, bool recursive = true);
     
     // Utility functions
     void updateStats(const BackupStats& increment);
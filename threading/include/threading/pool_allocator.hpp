@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace mtfs::threading {
+
+namespace detail {
+
+// Size-classed free lists for the small, short-lived allocations made on
+// every task submission (task nodes, promise shared state). Each thread keeps
+// a bounded local cache and exchanges fixed-size batches with a global list,
+// so steady-state submission does not reach the system allocator even when
+// blocks are freed on a different thread than the one that allocated them.
+void* allocateBlock(std::size_t bytes);
+void deallocateBlock(void* block, std::size_t bytes) noexcept;
+
+constexpr std::size_t MAX_POOLED_BLOCK = 512;
+
+} // namespace detail
+
+// Stateless allocator over the block pool, suitable for
+// std::promise(std::allocator_arg, ...) and std::allocate_shared.
+template<typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if constexpr (alignof(T) > alignof(std::max_align_t)) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        } else {
+            return static_cast<T*>(detail::allocateBlock(n * sizeof(T)));
+        }
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        if constexpr (alignof(T) > alignof(std::max_align_t)) {
+            ::operator delete(p, std::align_val_t(alignof(T)));
+        } else {
+            detail::deallocateBlock(p, n * sizeof(T));
+        }
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const PoolAllocator<U>&) const noexcept { return false; }
+};
+
+} // namespace mtfs::threading
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace mtfs::threading {
+
+// Lossy buffer of cache hits waiting to be applied to the eviction policy.
+//
+// Readers record the key of a hit in a slot picked from a per-thread probe
+// sequence, so recording never blocks and threads rarely share a slot. A slot
+// that is busy is skipped and a full slot is overwritten: losing a few
+// recency updates only makes the policy approximate, never incorrect. When a
+// reader finds its slot already full it asks the caller to drain, and one
+// thread at a time hands the buffered keys to the policy in one batch.
+template<typename Key, size_t Slots = 64>
+class ReadBuffer {
+    static_assert((Slots & (Slots - 1)) == 0, "Slots must be a power of two");
+
+public:
+    ReadBuffer() = default;
+
+    ReadBuffer(const ReadBuffer&) = delete;
+    ReadBuffer& operator=(const ReadBuffer&) = delete;
+
+    // Returns true when the buffer is filling up and should be drained
+    bool record(const Key& key);
+
+    // Hand the buffered keys to apply(const Key*, size_t) as one batch;
+    // returns false if another thread is already draining
+    template<typename Apply>
+    bool tryDrain(Apply&& apply);
+
+    size_t droppedRecords() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<bool> busy{false};
+        bool full{false};  // Guarded by busy
+        Key key;
+    };
+
+    std::array<Slot, Slots> slots;
+    std::atomic<bool> draining{false};
+    std::array<Key, Slots> batch;  // Owned by the draining thread
+    std::atomic<size_t> dropped{0};
+};
+
+} // namespace mtfs::threading
+
+// Template implementation
+#include "read_buffer.tpp"
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+
+namespace mtfs::threading {
+
+namespace detail {
+
+// Per-thread slot probe, seeded from the thread id so threads start apart
+inline size_t nextReadProbe() {
+    thread_local size_t probe = std::hash<std::thread::id>()(std::this_thread::get_id()) * 0x9E3779B97F4A7C15ull;
+    return probe++;
+}
+
+} // namespace detail
+
+template<typename Key, size_t Slots>
+bool ReadBuffer<Key, Slots>::record(const Key& key) {
+    Slot& slot = slots[detail::nextReadProbe() & (Slots - 1)];
+    if (slot.busy.exchange(true, std::memory_order_acquire)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    bool wasFull = slot.full;
+    slot.key = key;
+    slot.full = true;
+    slot.busy.store(false, std::memory_order_release);
+
+    if (wasFull) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    return wasFull;
+}
+
+template<typename Key, size_t Slots>
+template<typename Apply>
+bool ReadBuffer<Key, Slots>::tryDrain(Apply&& apply) {
+    if (draining.exchange(true, std::memory_order_acquire)) {
+        return false;
+    }
+
+    // Swapping keys out keeps every slot's storage allocated for the next record
+    size_t count = 0;
+    for (auto& slot : slots) {
+        if (slot.busy.exchange(true, std::memory_order_acquire)) {
+            continue;  // A reader is writing it; catch it next time
+        }
+        if (slot.full) {
+            using std::swap;
+            swap(batch[count++], slot.key);
+            slot.full = false;
+        }
+        slot.busy.store(false, std::memory_order_release);
+    }
+    if (count > 0) {
+        apply(batch.data(), count);
+    }
+
+    draining.store(false, std::memory_order_release);
+    return true;
+}
+
+} // namespace mtfs::threading
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace mtfs::threading {
+
+// Move-only, type-erased `void()` callable with small-buffer optimization.
+//
+// Callables up to INLINE_SIZE bytes that are nothrow-movable are stored in
+// place, so wrapping a typical enqueue lambda (a promise plus a few captures)
+// does not allocate. Larger callables fall back to the heap. Unlike
+// std::function, move-only captures such as std::promise are accepted.
+class Task {
+public:
+    static constexpr std::size_t INLINE_SIZE = 96;
+
+    Task() noexcept = default;
+
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+    Task(F&& f);
+
+    Task(Task&& other) noexcept;
+    Task& operator=(Task&& other) noexcept;
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() { reset(); }
+
+    void operator()() { operations->invoke(storage); }
+    explicit operator bool() const noexcept { return operations != nullptr; }
+    void reset() noexcept;
+
+private:
+    struct Operations {
+        void (*invoke)(void* storage);
+        void (*relocate)(void* destination, void* source);  // Move, then destroy source
+        void (*destroy)(void* storage);
+    };
+
+    template<typename F>
+    static constexpr bool storedInline =
+        sizeof(F) <= INLINE_SIZE && alignof(F) <= alignof(std::max_align_t) &&
+        std::is_nothrow_move_constructible_v<F>;
+
+    template<typename F>
+    static const Operations* inlineOperations();
+    template<typename F>
+    static const Operations* heapOperations();
+
+    alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+    const Operations* operations{nullptr};
+};
+
+} // namespace mtfs::threading
+
+// Template implementation
+#include "task.tpp"
@@ -0,0 +1,69 @@
+#pragma once
+
+namespace mtfs::threading {
+
+template<typename F, typename>
+Task::Task(F&& f) {
+    using Callable = std::decay_t<F>;
+    if constexpr (storedInline<Callable>) {
+        ::new (static_cast<void*>(storage)) Callable(std::forward<F>(f));
+        operations = inlineOperations<Callable>();
+    } else {
+        ::new (static_cast<void*>(storage)) Callable*(new Callable(std::forward<F>(f)));
+        operations = heapOperations<Callable>();
+    }
+}
+
+inline Task::Task(Task&& other) noexcept : operations(other.operations) {
+    if (operations) {
+        operations->relocate(storage, other.storage);
+        other.operations = nullptr;
+    }
+}
+
+inline Task& Task::operator=(Task&& other) noexcept {
+    if (this != &other) {
+        reset();
+        operations = other.operations;
+        if (operations) {
+            operations->relocate(storage, other.storage);
+            other.operations = nullptr;
+        }
+    }
+    return *this;
+}
+
+inline void Task::reset() noexcept {
+    if (operations) {
+        operations->destroy(storage);
+        operations = nullptr;
+    }
+}
+
+template<typename F>
+const Task::Operations* Task::inlineOperations() {
+    static constexpr Operations ops{
+        [](void* storage) { (*static_cast<F*>(storage))(); },
+        [](void* destination, void* source) {
+            F* from = static_cast<F*>(source);
+            ::new (destination) F(std::move(*from));
+            from->~F();
+        },
+        [](void* storage) { static_cast<F*>(storage)->~F(); }
+    };
+    return &ops;
+}
+
+template<typename F>
+const Task::Operations* Task::heapOperations() {
+    static constexpr Operations ops{
+        [](void* storage) { (**static_cast<F**>(storage))(); },
+        [](void* destination, void* source) {
+            ::new (destination) F*(*static_cast<F**>(source));
+        },
+        [](void* storage) { delete *static_cast<F**>(storage); }
+    };
+    return &ops;
+}
+
+} // namespace mtfs::threading
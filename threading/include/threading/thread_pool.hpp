@@ -1,6 +1,8 @@
 #pragma once
 
+#include <array>
 #include <vector>
+#include <deque>
 #include <queue>
 #include <memory>
 #include <thread>
@@ -11,53 +13,165 @@
 #include <stdexcept>
 #include <atomic>
 #include <chrono>
+#include <tuple>
+#include <type_traits>
+#include "threading/work_stealing_deque.hpp"
+#include "threading/task.hpp"
+#include "threading/pool_allocator.hpp"
 
 namespace mtfs::threading {
 
+// How tasks are distributed between workers
+enum class SchedulingMode {
+    SHARED_QUEUE,   // Every task goes through one mutex-protected queue
+    WORK_STEALING   // Per-worker lock-free deques; idle workers steal
+};
+
+// Scheduling class of a task. Workers take queued work lane by lane, so
+// interactive tasks never wait behind queued normal or background ones.
+enum class TaskPriority {
+    INTERACTIVE,  // Latency-sensitive foreground work
+    NORMAL,
+    BACKGROUND    // Bulk work; at most getBackgroundLimit() run at once
+};
+
+constexpr size_t PRIORITY_LANES = 3;
+
+struct TaskOptions {
+    TaskPriority priority{TaskPriority::NORMAL};
+    // When the task should have started; the default means none. Within a
+    // lane, tasks with a deadline run earliest deadline first and ahead of
+    // those without one. A task whose deadline is less than DEADLINE_SLACK
+    // away runs ahead of every lane.
+    std::chrono::steady_clock::time_point deadline{};
+
+    static constexpr std::chrono::milliseconds DEADLINE_SLACK{2};
+
+    bool hasDeadline() const { return deadline != std::chrono::steady_clock::time_point(); }
+};
+
+// Result of a task submitted with enqueue(f, args...); like std::bind, the
+// stored callable and arguments are invoked as lvalues.
+template<class F, class... Args>
+using task_result_t = std::invoke_result_t<std::decay_t<F>&, std::decay_t<Args>&...>;
+
 class ThreadPool {
 public:
-    explicit ThreadPool(size_t numThreads = std::thread::hardware_concurrency());
+    explicit ThreadPool(size_t numThreads = std::thread::hardware_concurrency(),
+                        SchedulingMode mode = SchedulingMode::SHARED_QUEUE);
     ~ThreadPool();
 
-    // Submit a task and get a future for the result
+    // Submit a task and get a future for the result. Without options the
+    // task is NORMAL with no deadline.
+    template<class F, class... Args>
+    auto enqueue(F&& f, Args&&... args) -> std::future<task_result_t<F, Args...>>;
     template<class F, class... Args>
-    auto enqueue(F&& f, Args&&... args) 
-        -> std::future<typename std::result_of<F(Args...)>::type>;
+    auto enqueue(const TaskOptions& options, F&& f, Args&&... args) -> std::future<task_result_t<F, Args...>>;
 
     // Submit a task without return value (fire and forget)
-    template<class F, class... Args>
+    template<class F, class... Args, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, TaskOptions>>>
     void enqueue_detached(F&& f, Args&&... args);
+    template<class F, class... Args>
+    void enqueue_detached(const TaskOptions& options, F&& f, Args&&... args);
+
+    // Block until `future` is ready. Called from one of this pool's workers,
+    // it runs other queued tasks meanwhile, so tasks that wait on nested
+    // submissions cannot starve the pool. It takes the newest queued task
+    // first, usually the one waited on, since an older one is likely another
+    // waiter that would nest a further frame on this stack. Past
+    // MAX_HELP_DEPTH nested waits it blocks instead and leaves the queue to
+    // the other workers.
+    template<typename T>
+    void waitFor(const std::future<T>& future);
+    static constexpr size_t MAX_HELP_DEPTH = 32;
 
     // Get pool statistics
     size_t getThreadCount() const { return workers.size(); }
+    SchedulingMode getSchedulingMode() const { return mode; }
+    bool isWorkerThread() const { return currentPool == this; }
     size_t getQueueSize() const;
+    size_t getQueueSize(TaskPriority priority) const;  // Queued in that lane
     size_t getActiveThreads() const { return activeThreads.load(); }
+    size_t getRunningBackground() const { return runningBackground.load(); }
     bool isBusy() const;
 
+    // Most BACKGROUND tasks running at once, so bulk I/O leaves workers free
+    // for interactive work. 0 restores the default, half the workers
+    // (at least one). A background task waiting in waitFor() may run the
+    // background tasks it waits on without taking another slot.
+    void setBackgroundLimit(size_t maxRunning);
+    size_t getBackgroundLimit() const { return backgroundLimit.load(); }
+
     // Pool management
     void pause();
     void resume();
     void waitForAll();
-    void resize(size_t newSize);
+    void resize(size_t newSize);  // Drains queued work; must not be called from a worker
 
 private:
+    struct WorkerQueue {
+        WorkStealingDeque<Task*> deque;
+    };
+
     // Worker threads
     std::vector<std::thread> workers;
-    
-    // Task queue
-    std::queue<std::function<void()>> tasks;
-    
+    SchedulingMode mode;
+
+    struct DatedTask {
+        std::chrono::steady_clock::time_point deadline;
+        uint64_t sequence;  // Submission order among equal deadlines
+        Task* task;
+        bool operator>(const DatedTask& other) const {
+            return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+        }
+    };
+
+    struct Lane {
+        std::deque<Task*> fifo;
+        std::priority_queue<DatedTask, std::vector<DatedTask>, std::greater<DatedTask>> dated;
+        size_t size() const { return fifo.size() + dated.size(); }
+    };
+
+    // Shared lanes, guarded by queueMutex. In work-stealing mode a worker's
+    // own NORMAL submissions without a deadline go to its deque instead.
+    std::array<Lane, PRIORITY_LANES> lanes;
+    uint64_t datedSequence{0};
+    std::vector<std::unique_ptr<WorkerQueue>> workerQueues;
+
     // Synchronization
-    std::mutex queueMutex;
+    mutable std::mutex queueMutex;
     std::condition_variable condition;
     std::condition_variable finished;
-    
+
     // State management
     std::atomic<bool> stop{false};
+    std::atomic<bool> draining{false};
     std::atomic<bool> paused{false};
     std::atomic<size_t> activeThreads{0};
-    
-    void workerThread();
+    std::atomic<size_t> pendingTasks{0};   // Queued anywhere, not yet claimed
+    std::atomic<size_t> sharedTasks{0};    // Queued in `lanes`
+    std::atomic<size_t> urgentTasks{0};    // Interactive or dated, checked before a worker's own deque
+    std::atomic<size_t> idleWorkers{0};
+    std::atomic<size_t> runningBackground{0};
+    std::atomic<size_t> backgroundLimit{1};
+    bool backgroundLimitSet{false};
+
+    // Set on worker threads so nested submissions stay local
+    static thread_local ThreadPool* currentPool;
+    static thread_local size_t currentWorker;
+    static thread_local bool holdsBackgroundSlot;  // Running a BACKGROUND task
+    static thread_local size_t helpDepth;          // waitFor calls running tasks on this stack
+
+    void submit(Task task, const TaskOptions& options);
+    void startWorkers(size_t count);
+    void stopWorkers();
+    void workerThread(size_t index);
+    bool mayRunBackground() const;
+    bool hasRunnableTask() const;
+    Task* takeShared(bool& background, bool newest = false);
+    Task* findTask(size_t index, bool& background, bool newest = false);
+    bool runPendingTask();
+    void runTask(Task* task, bool background);
 };
 
 // Async file operation types
@@ -89,7 +203,8 @@ struct AsyncResult {
 class GlobalThreadPool {
 public:
     static ThreadPool& getInstance();
-    static void initialize(size_t numThreads = std::thread::hardware_concurrency());
+    static void initialize(size_t numThreads = std::thread::hardware_concurrency(),
+                           SchedulingMode mode = SchedulingMode::WORK_STEALING);
     static void shutdown();
 
 private:
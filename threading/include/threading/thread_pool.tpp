@@ -3,47 +3,62 @@
 namespace mtfs::threading {
 
 template<class F, class... Args>
-auto ThreadPool::enqueue(F&& f, Args&&... args) 
-    -> std::future<typename std::result_of<F(Args...)>::type> {
-    
-    using return_type = typename std::result_of<F(Args...)>::type;
-
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...)
-    );
-
-    std::future<return_type> res = task->get_future();
-    
-    {
-        std::unique_lock<std::mutex> lock(queueMutex);
-
-        // Don't allow enqueueing after stopping the pool
-        if(stop) {
-            throw std::runtime_error("enqueue on stopped ThreadPool");
-        }
+auto ThreadPool::enqueue(F&& f, Args&&... args) -> std::future<task_result_t<F, Args...>> {
+    return enqueue(TaskOptions(), std::forward<F>(f), std::forward<Args>(args)...);
+}
 
-        tasks.emplace([task](){ (*task)(); });
-    }
-    
-    condition.notify_one();
+template<class F, class... Args>
+auto ThreadPool::enqueue(const TaskOptions& options, F&& f, Args&&... args)
+    -> std::future<task_result_t<F, Args...>> {
+    using return_type = task_result_t<F, Args...>;
+
+    // The shared state and result slot come from the block pool, and the
+    // closure fits in Task's inline buffer, so submission does not hit malloc.
+    std::promise<return_type> promise(std::allocator_arg, PoolAllocator<return_type>());
+    std::future<return_type> res = promise.get_future();
+
+    submit(Task([promise = std::move(promise), fn = std::forward<F>(f),
+                 bound = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+        try {
+            if constexpr (std::is_void_v<return_type>) {
+                std::apply(fn, bound);
+                promise.set_value();
+            } else {
+                promise.set_value(std::apply(fn, bound));
+            }
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+    }), options);
     return res;
 }
 
-template<class F, class... Args>
+template<class F, class... Args, typename>
 void ThreadPool::enqueue_detached(F&& f, Args&&... args) {
-    auto task = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
-    
-    {
-        std::unique_lock<std::mutex> lock(queueMutex);
+    enqueue_detached(TaskOptions(), std::forward<F>(f), std::forward<Args>(args)...);
+}
 
-        if(stop) {
-            throw std::runtime_error("enqueue on stopped ThreadPool");
-        }
+template<class F, class... Args>
+void ThreadPool::enqueue_detached(const TaskOptions& options, F&& f, Args&&... args) {
+    submit(Task([fn = std::forward<F>(f), bound = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+        std::apply(fn, bound);
+    }), options);
+}
 
-        tasks.emplace([task](){ task(); });
+template<typename T>
+void ThreadPool::waitFor(const std::future<T>& future) {
+    if (currentPool != this || helpDepth >= MAX_HELP_DEPTH) {
+        future.wait();
+        return;
+    }
+
+    helpDepth++;
+    while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        if (!runPendingTask()) {
+            future.wait_for(std::chrono::microseconds(50));
+        }
     }
-    
-    condition.notify_one();
+    helpDepth--;
 }
 
 } // namespace mtfs::threading
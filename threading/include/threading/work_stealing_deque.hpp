@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace mtfs::threading {
+
+// Chase-Lev work-stealing deque (Le, Pop, Cohen, Zappa Nardelli, PPoPP'13).
+//
+// The owning worker pushes and pops at the bottom without locking; other
+// workers steal from the top with a single CAS. T must be trivially copyable
+// (the pool stores task pointers). Retired buffers are kept until the deque
+// is destroyed because a concurrent thief may still be reading them.
+template<typename T>
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(size_t initialCapacity = 256);
+    ~WorkStealingDeque() = default;
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner thread only
+    void push(T item);
+    bool pop(T& item);
+
+    // Any thread
+    bool steal(T& item);
+    bool empty() const;
+    size_t size() const;
+
+private:
+    struct Buffer {
+        explicit Buffer(int64_t capacity)
+            : capacity(capacity), mask(capacity - 1), slots(new std::atomic<T>[capacity]) {}
+
+        T get(int64_t index) const { return slots[index & mask].load(std::memory_order_relaxed); }
+        void put(int64_t index, T item) { slots[index & mask].store(item, std::memory_order_relaxed); }
+
+        int64_t capacity;
+        int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+    Buffer* grow(Buffer* buffer, int64_t bottom, int64_t top);
+
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    alignas(64) std::atomic<Buffer*> buffer;
+    std::vector<std::unique_ptr<Buffer>> buffers;  // Owner only; current buffer is last
+};
+
+} // namespace mtfs::threading
+
+// Template implementation
+#include "work_stealing_deque.tpp"
@@ -0,0 +1,95 @@
+#pragma once
+
+namespace mtfs::threading {
+
+template<typename T>
+WorkStealingDeque<T>::WorkStealingDeque(size_t initialCapacity) {
+    // Capacity must be a power of two for index masking
+    int64_t capacity = 1;
+    while (capacity < static_cast<int64_t>(initialCapacity)) {
+        capacity <<= 1;
+    }
+    buffers.push_back(std::make_unique<Buffer>(capacity));
+    buffer.store(buffers.back().get(), std::memory_order_relaxed);
+}
+
+template<typename T>
+void WorkStealingDeque<T>::push(T item) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    Buffer* current = buffer.load(std::memory_order_relaxed);
+
+    if (b - t > current->capacity - 1) {
+        current = grow(current, b, t);
+    }
+
+    current->put(b, item);
+    bottom.store(b + 1, std::memory_order_release);
+}
+
+template<typename T>
+bool WorkStealingDeque<T>::pop(T& item) {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    Buffer* current = buffer.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        // Deque was empty
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    item = current->get(b);
+    if (t == b) {
+        // Last element: race against thieves for it
+        bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                               std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+template<typename T>
+bool WorkStealingDeque<T>::steal(T& item) {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+
+    if (t >= b) {
+        return false;
+    }
+
+    Buffer* current = buffer.load(std::memory_order_acquire);
+    item = current->get(t);
+    return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                       std::memory_order_relaxed);
+}
+
+template<typename T>
+bool WorkStealingDeque<T>::empty() const {
+    return size() == 0;
+}
+
+template<typename T>
+size_t WorkStealingDeque<T>::size() const {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_relaxed);
+    return b > t ? static_cast<size_t>(b - t) : 0;
+}
+
+template<typename T>
+typename WorkStealingDeque<T>::Buffer* WorkStealingDeque<T>::grow(Buffer* current, int64_t b, int64_t t) {
+    auto larger = std::make_unique<Buffer>(current->capacity * 2);
+    for (int64_t i = t; i < b; ++i) {
+        larger->put(i, current->get(i));
+    }
+    Buffer* result = larger.get();
+    buffers.push_back(std::move(larger));
+    buffer.store(result, std::memory_order_release);
+    return result;
+}
+
+} // namespace mtfs::threading
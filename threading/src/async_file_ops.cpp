@@ -1,15 +1,23 @@
 #include "threading/async_file_ops.hpp"
 #include "fs/filesystem.hpp"
+#include <algorithm>
 #include <chrono>
 
 namespace mtfs::threading {
 
+namespace {
+
+// Reads and listings are what a user is waiting on; they go ahead of bulk work
+const TaskOptions INTERACTIVE{TaskPriority::INTERACTIVE};
+
+} // namespace
+
 AsyncFileOperations::AsyncFileOperations(mtfs::fs::FileSystem* fs, ThreadPool& pool) 
     : filesystem(fs), threadPool(pool) {
 }
 
 std::future<std::vector<std::string>> AsyncFileOperations::listFilesAsync(const std::string& pattern) {
-    return threadPool.enqueue([this, pattern]() -> std::vector<std::string> {
+    return threadPool.enqueue(INTERACTIVE, [this, pattern]() -> std::vector<std::string> {
         auto start = std::chrono::steady_clock::now();
         try {
             auto result = this->filesystem->findFiles(pattern);
@@ -29,7 +37,7 @@ std::future<std::vector<std::string>> AsyncFileOperations::listFilesAsync(const
 }
 
 std::future<std::string> AsyncFileOperations::readFileAsync(const std::string& path) {
-    return threadPool.enqueue([this, path]() -> std::string {
+    return threadPool.enqueue(INTERACTIVE, [this, path]() -> std::string {
         auto start = std::chrono::steady_clock::now();
         try {
             auto result = this->filesystem->readFile(path);
@@ -149,7 +157,7 @@ std::future<bool> AsyncFileOperations::createDirectoryAsync(const std::string& p
 }
 
 std::future<std::vector<std::string>> AsyncFileOperations::listDirectoryAsync(const std::string& path) {
-    return threadPool.enqueue([this, path]() -> std::vector<std::string> {
+    return threadPool.enqueue(INTERACTIVE, [this, path]() -> std::vector<std::string> {
         auto start = std::chrono::steady_clock::now();
         try {
             auto result = this->filesystem->listDirectory(path);
@@ -168,25 +176,30 @@ std::future<std::vector<std::string>> AsyncFileOperations::listDirectoryAsync(co
     });
 }
 
+// One FileSystem batch per call, so the whole set shares a single
+// metadata commit instead of paying for one per file
 std::future<std::vector<bool>> AsyncFileOperations::batchCopyAsync(
     const std::vector<std::pair<std::string, std::string>>& operations) {
     
     return threadPool.enqueue([this, operations]() -> std::vector<bool> {
-        std::vector<std::future<bool>> futures;
-        
-        for (const auto& op : operations) {
-            futures.push_back(copyFileAsync(op.first, op.second));
-        }
-        
-        std::vector<bool> results;
-        for (auto& future : futures) {
-            try {
-                results.push_back(future.get());
-            } catch (...) {
-                results.push_back(false);
-            }
-        }
-        
+        auto start = std::chrono::steady_clock::now();
+        std::vector<bool> results = this->filesystem->copyBatch(operations);
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start
+        );
+        updateStats(std::find(results.begin(), results.end(), false) == results.end(), duration);
+        return results;
+    });
+}
+
+std::future<std::vector<bool>> AsyncFileOperations::batchDeleteAsync(const std::vector<std::string>& paths) {
+    return threadPool.enqueue([this, paths]() -> std::vector<bool> {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<bool> results = this->filesystem->deleteBatch(paths);
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start
+        );
+        updateStats(std::find(results.begin(), results.end(), false) == results.end(), duration);
         return results;
     });
 }
@@ -212,6 +225,7 @@ std::future<bool> AsyncFileOperations::batchCopyWithProgressAsync(
         bool allSuccess = true;
         for (auto& future : futures) {
             try {
+                threadPool.waitFor(future);
                 bool success = future.get();
                 if (success) {
                     progress.completedOperations++;
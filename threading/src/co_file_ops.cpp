@@ -0,0 +1,81 @@
+#include "threading/co_file_ops.hpp"
+#include "fs/filesystem.hpp"
+
+namespace mtfs::threading {
+
+namespace {
+
+const TaskOptions INTERACTIVE{TaskPriority::INTERACTIVE};
+const TaskOptions BACKGROUND{TaskPriority::BACKGROUND};
+
+} // namespace
+
+CoFileOperations::CoFileOperations(mtfs::fs::FileSystem* fs, ThreadPool& pool) : filesystem(fs), pool(pool) {}
+
+CoTask<std::string> CoFileOperations::read(std::string path) {
+    Flight flight(*this);
+    co_await resumeOn(pool, INTERACTIVE);
+    co_return filesystem->readFile(path);
+}
+
+CoTask<bool> CoFileOperations::write(std::string path, std::string content) {
+    Flight flight(*this);
+    co_await resumeOn(pool);
+    try {
+        if (!filesystem->exists(path)) {
+            filesystem->createFile(path);
+        }
+        co_return filesystem->writeFile(path, content);
+    } catch (...) {
+        co_return false;
+    }
+}
+
+CoTask<bool> CoFileOperations::copy(std::string source, std::string destination) {
+    Flight flight(*this);
+    co_await resumeOn(pool);
+    try {
+        co_return filesystem->copyFile(source, destination);
+    } catch (...) {
+        co_return false;
+    }
+}
+
+CoTask<bool> CoFileOperations::backup(std::string backupName) {
+    Flight flight(*this);
+    co_await resumeOn(pool, BACKGROUND);
+    try {
+        co_return filesystem->createBackup(backupName);
+    } catch (...) {
+        co_return false;
+    }
+}
+
+CoTask<std::vector<std::string>> CoFileOperations::readAll(std::vector<std::string> paths) {
+    std::vector<CoTask<std::string>> reads;
+    reads.reserve(paths.size());
+    for (auto& path : paths) {
+        reads.push_back(read(std::move(path)));
+    }
+    co_return co_await whenAll(std::move(reads));
+}
+
+CoTask<std::vector<bool>> CoFileOperations::writeAll(std::vector<std::pair<std::string, std::string>> files) {
+    std::vector<CoTask<bool>> writes;
+    writes.reserve(files.size());
+    for (auto& [path, content] : files) {
+        writes.push_back(write(std::move(path), std::move(content)));
+    }
+    co_return co_await whenAll(std::move(writes));
+}
+
+CoTask<std::vector<bool>> CoFileOperations::copyAll(std::vector<std::pair<std::string, std::string>> operations) {
+    std::vector<CoTask<bool>> copies;
+    copies.reserve(operations.size());
+    for (auto& [source, destination] : operations) {
+        copies.push_back(copy(std::move(source), std::move(destination)));
+    }
+    co_return co_await whenAll(std::move(copies));
+}
+
+} // namespace mtfs::threading
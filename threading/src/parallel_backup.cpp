@@ -1,12 +1,27 @@
 #include "threading/parallel_backup.hpp"
+#include "fs/compression.hpp"
+#include "fs/restore_plan.hpp"
+#include "common/checksum.hpp"
 #include <filesystem>
 #include <algorithm>
 #include <fstream>
+#include <deque>
+#include <unordered_map>
 
 namespace mtfs::threading {
 
 ParallelBackupManager::ParallelBackupManager(size_t numThreads) 
-    : backupThreadPool(std::make_unique<ThreadPool>(numThreads)) {
+    : ownedPool(std::make_unique<ThreadPool>(numThreads, SchedulingMode::WORK_STEALING)),
+      backupThreadPool(ownedPool.get()) {
+}
+
+ParallelBackupManager::ParallelBackupManager(ThreadPool& sharedPool)
+    : backupThreadPool(&sharedPool), taskOptions{TaskPriority::BACKGROUND} {
+}
+
+fs::ChunkStore& ParallelBackupManager::getChunkStore() {
+    std::call_once(chunkStoreOnce, [this] { chunkStore = std::make_unique<fs::ChunkStore>("backups/.chunks"); });
+    return *chunkStore;
 }
 
 std::future<bool> ParallelBackupManager::createParallelBackup(
@@ -14,107 +29,236 @@ std::future<bool> ParallelBackupManager::createParallelBackup(
     const std::vector<std::string>& sourcePaths,
     ProgressCallback callback) {
     
-    return backupThreadPool->enqueue([this, backupName, sourcePaths, callback]() -> bool {
+    return backupThreadPool->enqueue(taskOptions, [this, backupName, sourcePaths, callback]() -> bool {
+        return runBackup(backupName, "", sourcePaths, callback);
+    });
+}
+
+std::future<bool> ParallelBackupManager::restoreParallelBackup(
+    const std::string& backupName,
+    const std::string& targetPath,
+    ProgressCallback callback) {
+
+    return backupThreadPool->enqueue(taskOptions, [this, backupName, targetPath, callback]() -> bool {
         BackupProgress progress;
         progress.startTime = std::chrono::steady_clock::now();
-        
-        // Calculate total work
-        for (const auto& path : sourcePaths) {
-            auto files = scanDirectory(path);
-            progress.totalFiles += files.size();
-            progress.totalBytes += calculateDirectorySize(path);
-        }
-        
-        if (callback) {
-            callback(progress);
+
+        std::string manifestPath = "backups/" + backupName + "/.mtfs_manifest";
+        if (!std::filesystem::exists(manifestPath)) {
+            return false;
         }
-        
-        // Create backup directory
-        std::string backupDir = "backups/" + backupName;
-        std::filesystem::create_directories(backupDir);
-        
-        // Process files in parallel
-        std::vector<std::future<bool>> futures;
-        
-        for (const auto& sourcePath : sourcePaths) {
-            auto files = scanDirectory(sourcePath);
-            
-            for (const auto& file : files) {
-                std::string relativePath = std::filesystem::relative(file, sourcePath).string();
-                std::string backupPath = backupDir + "/" + relativePath;
-                
-                futures.push_back(backupThreadPool->enqueue([this, file, backupPath, &progress, callback]() -> bool {
-                    bool success = backupFile(file, backupPath, true);
-                    
-                    progress.filesProcessed++;
-                    try {
-                        auto fileSize = std::filesystem::file_size(file);
-                        progress.bytesProcessed += fileSize;
-                        
-                        if (success && std::filesystem::exists(backupPath)) {
-                            auto backupSize = std::filesystem::file_size(backupPath);
-                            if (backupSize < fileSize) {
-                                progress.filesCompressed++;
-                                progress.compressionSaved += (fileSize - backupSize);
-                            }
-                        }
-                    } catch (...) {
-                        // File size calculation failed, continue
-                    }
-                    
-                    if (!success) {
-                        progress.hasErrors = true;
-                    }
-                    
-                    if (callback) {
-                        callback(progress);
-                    }
-                    
-                    return success;
-                }));
+
+        fs::RestoreResult restored;
+        try {
+            fs::RestorePlan plan(getChunkStore(), fs::ChunkStore::loadManifest(manifestPath), targetPath);
+            progress.totalFiles = plan.files().size();
+            progress.totalBytes = plan.totalBytes();
+            if (callback) {
+                callback(progress);
             }
-        }
-        
-        // Wait for all backup operations to complete
-        bool allSuccess = true;
-        for (auto& future : futures) {
-            try {
-                if (!future.get()) {
-                    allSuccess = false;
+
+            restored = plan.run(*backupThreadPool, taskOptions,
+                                [&progress, callback](const fs::ManifestEntry& entry, bool success) {
+                progress.filesProcessed++;
+                if (success) {
+                    progress.bytesProcessed += entry.size;
+                } else {
+                    progress.hasErrors = true;
                 }
-            } catch (...) {
-                allSuccess = false;
-                progress.hasErrors = true;
-            }
+                if (callback) {
+                    callback(progress);
+                }
+            });
+        } catch (const std::exception&) {
+            progress.hasErrors = true;
         }
-        
+
         progress.isComplete = true;
         if (callback) {
             callback(progress);
         }
-        
-        // Update statistics
+
         BackupStats increment;
-        increment.totalBackupsCreated = 1;
-        increment.totalFilesBackedUp = progress.filesProcessed;
-        increment.totalBytesBackedUp = progress.bytesProcessed;
-        increment.totalCompressionSaved = progress.compressionSaved;
-        increment.totalBackupTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        increment.totalBackupsRestored = 1;
+        increment.totalBytesRestored = static_cast<size_t>(restored.bytes);
+        increment.totalRestoreTime = std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::steady_clock::now() - progress.startTime
         );
-        increment.averageCompressionRatio = progress.getCompressionRatio();
-        
         updateStats(increment);
-        
-        return allSuccess && !progress.hasErrors;
+
+        return !progress.hasErrors;
+    });
+}
+
+std::future<bool> ParallelBackupManager::createIncrementalBackup(
+    const std::string& backupName,
+    const std::string& baseBackup,
+    const std::vector<std::string>& sourcePaths,
+    ProgressCallback callback) {
+
+    return backupThreadPool->enqueue(taskOptions, [this, backupName, baseBackup, sourcePaths, callback]() -> bool {
+        return runBackup(backupName, baseBackup, sourcePaths, callback);
     });
 }
 
+bool ParallelBackupManager::runBackup(const std::string& backupName, const std::string& baseBackup,
+                                      const std::vector<std::string>& sourcePaths, ProgressCallback callback) {
+    BackupProgress progress;
+    progress.startTime = std::chrono::steady_clock::now();
+    
+    // One listing per source gives the work, its totals and every file's
+    // stamp, taken before the file is read so a write during the backup
+    // shows up next time
+    struct WorkItem {
+        std::string file;
+        std::string relativePath;
+        fs::FileStamp stamp;
+    };
+    std::vector<WorkItem> work;
+    for (const auto& sourcePath : sourcePaths) {
+        for (auto& entry : scanDirectory(sourcePath)) {
+            progress.totalBytes += entry.stamp.size;
+            work.push_back({sourcePath + "/" + entry.path, std::move(entry.path), entry.stamp});
+        }
+    }
+    progress.totalFiles = work.size();
+    
+    if (callback) {
+        callback(progress);
+    }
+    
+    // Create backup directory
+    std::string backupDir = "backups/" + backupName;
+    std::filesystem::create_directories(backupDir);
+
+    // Files whose stamp matches the base backup's index are taken from its
+    // manifest unread; the new manifest stays complete on its own
+    fs::FileIndex baseIndex;
+    std::unordered_map<std::string, fs::ManifestEntry> baseFiles;
+    if (!baseBackup.empty()) {
+        std::string baseDir = "backups/" + baseBackup;
+        try {
+            if (baseIndex.load(baseDir + "/.mtfs_index")) {
+                for (auto& entry : fs::ChunkStore::loadManifest(baseDir + "/.mtfs_manifest")) {
+                    std::string path = entry.path;
+                    baseFiles.emplace(std::move(path), std::move(entry));
+                }
+            }
+        } catch (...) {
+            // An unreadable base only costs rereading every file
+            baseFiles.clear();
+        }
+    }
+    
+    // Each file fills its own manifest slot
+    std::vector<fs::ManifestEntry> manifest(work.size());
+    std::vector<fs::FileIndexEntry> indexed(work.size());
+    auto backupOne = [&](size_t i) -> bool {
+        bool success = true;
+        indexed[i].stamp = work[i].stamp;
+        const fs::FileIndexEntry* previous = baseIndex.find(work[i].relativePath);
+        auto baseFile = baseFiles.find(work[i].relativePath);
+        fs::ChunkingStats chunking;
+        if (previous && previous->stamp == indexed[i].stamp && baseFile != baseFiles.end()) {
+            manifest[i] = baseFile->second;
+            indexed[i] = *previous;
+            progress.filesSkipped++;
+        } else {
+            BackupTask task;
+            success = backupFile(work[i].file, work[i].relativePath, task.compress, task.verify, manifest[i],
+                                 chunking);
+            indexed[i].contentHash = fs::FileIndex::contentHash(manifest[i].chunks);
+        }
+        
+        progress.filesProcessed++;
+        progress.bytesProcessed += chunking.bytes;
+        progress.bytesDeduplicated += chunking.bytes - chunking.newBytes;
+        progress.compressionSaved += chunking.newBytes - chunking.storedBytes;
+        if (chunking.storedBytes < chunking.newBytes) {
+            progress.filesCompressed++;
+        }
+        
+        if (!success) {
+            progress.hasErrors = true;
+        }
+        
+        if (callback) {
+            callback(progress);
+        }
+        
+        return success;
+    };
+    
+    // A file waits on its chunk tasks, so files are taken from the list by
+    // one driver per worker rather than queued one task each: a waiting
+    // worker helps with queued tasks, and queued files would nest on its stack
+    std::atomic<size_t> nextFile{0};
+    std::atomic<bool> allSuccess{true};
+    std::vector<std::future<void>> drivers;
+    size_t driverCount = std::min(work.size(), backupThreadPool->getThreadCount());
+    for (size_t d = 0; d < driverCount; ++d) {
+        drivers.push_back(backupThreadPool->enqueue(taskOptions, [&]() {
+            for (size_t i; (i = nextFile++) < work.size();) {
+                bool success = false;
+                try {
+                    success = backupOne(i);
+                } catch (...) {
+                    progress.hasErrors = true;
+                }
+                if (!success) {
+                    allSuccess = false;
+                }
+            }
+        }));
+    }
+    for (auto& driver : drivers) {
+        backupThreadPool->waitFor(driver);
+    }
+    
+    // Slots of failed files have no path and are left out
+    fs::FileIndex index;
+    index.reserve(work.size());
+    for (size_t i = 0; i < work.size(); ++i) {
+        if (!manifest[i].path.empty()) {
+            index.put(work[i].relativePath, indexed[i]);
+        }
+    }
+    manifest.erase(std::remove_if(manifest.begin(), manifest.end(),
+                                  [](const fs::ManifestEntry& entry) { return entry.path.empty(); }),
+                   manifest.end());
+    if (!fs::ChunkStore::saveManifest(backupDir + "/.mtfs_manifest", manifest) ||
+        !index.save(backupDir + "/.mtfs_index")) {
+        allSuccess = false;
+        progress.hasErrors = true;
+    }
+    
+    progress.isComplete = true;
+    if (callback) {
+        callback(progress);
+    }
+    
+    // Update statistics
+    BackupStats increment;
+    increment.totalBackupsCreated = 1;
+    increment.totalFilesBackedUp = progress.filesProcessed;
+    increment.totalBytesBackedUp = progress.bytesProcessed;
+    increment.totalCompressionSaved = progress.compressionSaved;
+    increment.totalBytesDeduplicated = progress.bytesDeduplicated;
+    increment.totalBackupTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - progress.startTime
+    );
+    increment.averageCompressionRatio = progress.getCompressionRatio();
+    
+    updateStats(increment);
+    
+    return allSuccess && !progress.hasErrors;
+}
+
 std::future<bool> ParallelBackupManager::verifyBackupIntegrity(
     const std::string& backupName,
     ProgressCallback callback) {
     
-    return backupThreadPool->enqueue([this, backupName, callback]() -> bool {
+    return backupThreadPool->enqueue(taskOptions, [this, backupName, callback]() -> bool {
         BackupProgress progress;
         progress.startTime = std::chrono::steady_clock::now();
         
@@ -132,8 +276,9 @@ std::future<bool> ParallelBackupManager::verifyBackupIntegrity(
         
         std::vector<std::future<bool>> futures;
         
-        for (const auto& file : files) {
-            futures.push_back(backupThreadPool->enqueue([this, file, &progress, callback]() -> bool {
+        for (const auto& entry : files) {
+            std::string file = backupDir + "/" + entry.path;
+            futures.push_back(backupThreadPool->enqueue(taskOptions, [this, file, &progress, callback]() -> bool {
                 // Simple file existence and size check
                 bool isValid = std::filesystem::exists(file) && std::filesystem::file_size(file) > 0;
                 
@@ -153,6 +298,7 @@ std::future<bool> ParallelBackupManager::verifyBackupIntegrity(
         bool allValid = true;
         for (auto& future : futures) {
             try {
+                backupThreadPool->waitFor(future);
                 if (!future.get()) {
                     allValid = false;
                 }
@@ -171,56 +317,107 @@ std::future<bool> ParallelBackupManager::verifyBackupIntegrity(
     });
 }
 
-std::vector<std::string> ParallelBackupManager::scanDirectory(const std::string& path, bool recursive) {
-    std::vector<std::string> files;
-    
+std::vector<fs::DirectoryEntry> ParallelBackupManager::scanDirectory(const std::string& path, bool recursive) {
+    fs::WalkOptions options;
+    options.recursive = recursive;
     try {
-        if (recursive) {
-            for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
-                if (entry.is_regular_file()) {
-                    files.push_back(entry.path().string());
-                }
-            }
-        } else {
-            for (const auto& entry : std::filesystem::directory_iterator(path)) {
-                if (entry.is_regular_file()) {
-                    files.push_back(entry.path().string());
-                }
-            }
-        }
+        return fs::DirectoryWalker(backupThreadPool).collect(path, options);
     } catch (...) {
         // Directory scanning failed
+        return {};
     }
-    
-    return files;
 }
 
-size_t ParallelBackupManager::calculateDirectorySize(const std::string& path) {
-    size_t totalSize = 0;
-    
-    try {
-        for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
-            if (entry.is_regular_file()) {
-                totalSize += std::filesystem::file_size(entry);
-            }
+// Three stages per file: this thread reads and chunks the file, pool workers
+// hash and compress chunks, and this thread writes them to the store in
+// order. At most MAX_CHUNKS_IN_FLIGHT chunks sit between the read and write
+// stages, so memory stays flat however large the file is. With `verify`,
+// each worker decodes its output and checks it against the CRC the read
+// stage took while streaming, instead of rereading the backup afterwards.
+bool ParallelBackupManager::backupFile(const std::string& sourcePath, const std::string& relativePath,
+                                       bool compress, bool verify, fs::ManifestEntry& entry,
+                                       fs::ChunkingStats& chunking) {
+    struct EncodedChunk {
+        fs::ChunkId id;
+        std::vector<char> stored;   // Empty when the store already has the chunk
+        size_t rawSize{0};
+        bool compressed{false};
+    };
+
+    fs::ChunkStore& store = getChunkStore();
+    std::deque<std::future<EncodedChunk>> inFlight;
+    // The slot only gets a path once the file is complete; runBackup leaves
+    // out slots without one
+    entry = fs::ManifestEntry();
+    fs::ManifestEntry built;
+    built.path = relativePath;
+
+    // Write stage
+    auto writeOldest = [&] {
+        auto future = std::move(inFlight.front());
+        inFlight.pop_front();
+        backupThreadPool->waitFor(future);
+        EncodedChunk chunk = future.get();
+        bool written = !chunk.stored.empty() &&
+                       store.putEncoded(chunk.id, chunk.stored.data(), chunk.stored.size(), chunk.rawSize,
+                                        chunk.compressed);
+        built.chunks.push_back(chunk.id);
+        built.size += chunk.rawSize;
+        chunking.chunks++;
+        chunking.bytes += chunk.rawSize;
+        if (written) {
+            chunking.newChunks++;
+            chunking.newBytes += chunk.rawSize;
+            chunking.storedBytes += chunk.stored.size();
         }
-    } catch (...) {
-        // Size calculation failed
-    }
-    
-    return totalSize;
-}
+    };
 
-bool ParallelBackupManager::backupFile(const std::string& sourcePath, const std::string& backupPath, bool compress) {
     try {
-        // Ensure backup directory exists
-        std::filesystem::create_directories(std::filesystem::path(backupPath).parent_path());
-        
-        // Simple file copy for now (compression would be implemented here)
-        std::filesystem::copy_file(sourcePath, backupPath, std::filesystem::copy_options::overwrite_existing);
-        
+        // Read stage
+        fs::ChunkStore::chunkFile(sourcePath, [&](const char* data, size_t size) {
+            auto raw = std::make_shared<std::string>(data, size);
+            uint32_t crc = verify ? common::crc32(data, size) : 0;
+            // Compress stage
+            inFlight.push_back(backupThreadPool->enqueue(taskOptions, [&store, raw, crc, compress, verify]() {
+                EncodedChunk chunk;
+                chunk.id = common::hash128(raw->data(), raw->size());
+                chunk.rawSize = raw->size();
+                if (store.contains(chunk.id)) {
+                    return chunk;
+                }
+                if (compress) {
+                    chunk.stored.resize(fs::FileCompression::lzCompressBound(raw->size()));
+                    size_t size = fs::FileCompression::lzCompress(raw->data(), raw->size(), chunk.stored.data(),
+                                                                  chunk.stored.size());
+                    chunk.compressed = size + sizeof(uint32_t) < raw->size();  // Beats the raw size field
+                    chunk.stored.resize(size);
+                }
+                if (!chunk.compressed) {
+                    chunk.stored.assign(raw->begin(), raw->end());
+                } else if (verify) {
+                    std::string decoded(raw->size(), '\0');
+                    fs::FileCompression::lzDecompress(chunk.stored.data(), chunk.stored.size(), &decoded[0],
+                                                      decoded.size());
+                    if (common::crc32(decoded.data(), decoded.size()) != crc) {
+                        throw common::FSException("Compressed chunk failed verification");
+                    }
+                }
+                return chunk;
+            }));
+            if (inFlight.size() >= MAX_CHUNKS_IN_FLIGHT) {
+                writeOldest();
+            }
+        });
+        while (!inFlight.empty()) {
+            writeOldest();
+        }
+        entry = std::move(built);
         return true;
     } catch (...) {
+        // Let the remaining workers finish before their results are dropped
+        for (auto& future : inFlight) {
+            backupThreadPool->waitFor(future);
+        }
         return false;
     }
 }
@@ -242,6 +439,8 @@ void ParallelBackupManager::updateStats(const BackupStats& increment) {
     stats.totalFilesBackedUp += increment.totalFilesBackedUp;
     stats.totalBytesBackedUp += increment.totalBytesBackedUp;
     stats.totalCompressionSaved += increment.totalCompressionSaved;
+    stats.totalBytesDeduplicated += increment.totalBytesDeduplicated;
+    stats.totalBytesRestored += increment.totalBytesRestored;
     stats.totalBackupTime += increment.totalBackupTime;
     stats.totalRestoreTime += increment.totalRestoreTime;
     
@@ -256,7 +455,9 @@ bool ParallelBackupManager::isBusy() const {
 }
 
 void ParallelBackupManager::setThreadCount(size_t numThreads) {
-    backupThreadPool->resize(numThreads);
+    if (ownedPool) {
+        ownedPool->resize(numThreads);
+    }
 }
 
 size_t ParallelBackupManager::getThreadCount() const {
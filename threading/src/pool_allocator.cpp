@@ -0,0 +1,143 @@
+#include "threading/pool_allocator.hpp"
+#include <array>
+#include <mutex>
+#include <vector>
+
+namespace mtfs::threading::detail {
+
+namespace {
+
+constexpr std::size_t SIZE_CLASSES = 5;          // 32, 64, 128, 256, 512 bytes
+constexpr std::size_t MIN_BLOCK_SHIFT = 5;
+constexpr std::size_t BATCH_SIZE = 32;           // Blocks moved per global exchange
+constexpr std::size_t LOCAL_LIMIT = 2 * BATCH_SIZE;
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+struct Batch {
+    FreeBlock* head;
+    std::size_t count;
+};
+
+// Intentionally leaked: thread-local caches may flush into it during exit
+struct GlobalPool {
+    std::array<std::mutex, SIZE_CLASSES> mutexes;
+    std::array<std::vector<Batch>, SIZE_CLASSES> batches;
+};
+
+GlobalPool& globalPool() {
+    static GlobalPool* pool = new GlobalPool();
+    return *pool;
+}
+
+std::size_t sizeClass(std::size_t bytes) {
+    std::size_t index = 0;
+    std::size_t blockSize = std::size_t(1) << MIN_BLOCK_SHIFT;
+    while (blockSize < bytes) {
+        blockSize <<= 1;
+        ++index;
+    }
+    return index;
+}
+
+std::size_t blockSizeFor(std::size_t index) {
+    return std::size_t(1) << (MIN_BLOCK_SHIFT + index);
+}
+
+// Trivially destructible, so still valid while other thread_locals and
+// statics tear down after the cache itself is gone
+thread_local bool localCacheDestroyed = false;
+
+struct LocalCache {
+    std::array<FreeBlock*, SIZE_CLASSES> heads{};
+    std::array<std::size_t, SIZE_CLASSES> counts{};
+
+    ~LocalCache() {
+        localCacheDestroyed = true;
+        for (std::size_t index = 0; index < SIZE_CLASSES; ++index) {
+            if (heads[index]) {
+                pushBatch(index, heads[index], counts[index]);
+            }
+        }
+    }
+
+    static void pushBatch(std::size_t index, FreeBlock* head, std::size_t count) {
+        GlobalPool& pool = globalPool();
+        std::lock_guard<std::mutex> lock(pool.mutexes[index]);
+        pool.batches[index].push_back({head, count});
+    }
+
+    bool refill(std::size_t index) {
+        GlobalPool& pool = globalPool();
+        std::lock_guard<std::mutex> lock(pool.mutexes[index]);
+        if (pool.batches[index].empty()) return false;
+        Batch batch = pool.batches[index].back();
+        pool.batches[index].pop_back();
+        heads[index] = batch.head;
+        counts[index] = batch.count;
+        return true;
+    }
+
+    // Hand the oldest BATCH_SIZE blocks beyond the first back to the pool
+    void spill(std::size_t index) {
+        FreeBlock* keep = heads[index];
+        FreeBlock* cursor = keep;
+        for (std::size_t i = 1; i < counts[index] - BATCH_SIZE; ++i) {
+            cursor = cursor->next;
+        }
+        FreeBlock* spilled = cursor->next;
+        cursor->next = nullptr;
+        counts[index] -= BATCH_SIZE;
+        pushBatch(index, spilled, BATCH_SIZE);
+    }
+};
+
+thread_local LocalCache localCache;
+
+} // namespace
+
+void* allocateBlock(std::size_t bytes) {
+    if (bytes > MAX_POOLED_BLOCK) {
+        return ::operator new(bytes);
+    }
+
+    std::size_t index = sizeClass(bytes);
+    if (localCacheDestroyed) {
+        return ::operator new(blockSizeFor(index));
+    }
+    LocalCache& cache = localCache;
+    if (!cache.heads[index] && !cache.refill(index)) {
+        return ::operator new(blockSizeFor(index));
+    }
+
+    FreeBlock* block = cache.heads[index];
+    cache.heads[index] = block->next;
+    --cache.counts[index];
+    return block;
+}
+
+void deallocateBlock(void* block, std::size_t bytes) noexcept {
+    if (!block) return;
+    // Every pooled block originally came from ::operator new
+    if (bytes > MAX_POOLED_BLOCK || localCacheDestroyed) {
+        ::operator delete(block);
+        return;
+    }
+
+    std::size_t index = sizeClass(bytes);
+    LocalCache& cache = localCache;
+    auto* freeBlock = static_cast<FreeBlock*>(block);
+    freeBlock->next = cache.heads[index];
+    cache.heads[index] = freeBlock;
+    if (++cache.counts[index] > LOCAL_LIMIT) {
+        try {
+            cache.spill(index);
+        } catch (...) {
+            // Keep the block locally if the global list cannot grow
+        }
+    }
+}
+
+} // namespace mtfs::threading::detail
@@ -3,13 +3,29 @@
 
 namespace mtfs::threading {
 
-ThreadPool::ThreadPool(size_t numThreads) {
+namespace {
+
+// Queued tasks live in pooled nodes so the deques can hold plain pointers
+Task* allocateTask(Task&& task) {
+    return ::new (detail::allocateBlock(sizeof(Task))) Task(std::move(task));
+}
+
+void releaseTask(Task* task) noexcept {
+    task->~Task();
+    detail::deallocateBlock(task, sizeof(Task));
+}
+
+} // namespace
+
+thread_local ThreadPool* ThreadPool::currentPool = nullptr;
+thread_local size_t ThreadPool::currentWorker = 0;
+thread_local bool ThreadPool::holdsBackgroundSlot = false;
+thread_local size_t ThreadPool::helpDepth = 0;
+
+ThreadPool::ThreadPool(size_t numThreads, SchedulingMode mode) : mode(mode) {
     // Ensure at least 2 threads
     numThreads = std::max(size_t(2), numThreads);
-    
-    for(size_t i = 0; i < numThreads; ++i) {
-        workers.emplace_back(&ThreadPool::workerThread, this);
-    }
+    startWorkers(numThreads);
 }
 
 ThreadPool::~ThreadPool() {
@@ -28,8 +44,21 @@ ThreadPool::~ThreadPool() {
 }
 
 size_t ThreadPool::getQueueSize() const {
-    std::unique_lock<std::mutex> lock(const_cast<std::mutex&>(queueMutex));
-    return tasks.size();
+    return pendingTasks.load();
+}
+
+size_t ThreadPool::getQueueSize(TaskPriority priority) const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return lanes[static_cast<size_t>(priority)].size();
+}
+
+void ThreadPool::setBackgroundLimit(size_t maxRunning) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        backgroundLimitSet = maxRunning > 0;
+        backgroundLimit = backgroundLimitSet ? maxRunning : std::max<size_t>(1, workers.size() / 2);
+    }
+    condition.notify_all();
 }
 
 bool ThreadPool::isBusy() const {
@@ -41,79 +70,266 @@ void ThreadPool::pause() {
 }
 
 void ThreadPool::resume() {
-    paused = false;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        paused = false;
+    }
     condition.notify_all();
 }
 
 void ThreadPool::waitForAll() {
     std::unique_lock<std::mutex> lock(queueMutex);
     finished.wait(lock, [this]() {
-        return tasks.empty() && activeThreads.load() == 0;
+        return pendingTasks.load() == 0 && activeThreads.load() == 0;
     });
 }
 
 void ThreadPool::resize(size_t newSize) {
+    newSize = std::max(size_t(2), newSize);
     if (newSize == workers.size()) return;
-    
-    if (newSize < workers.size()) {
-        // Shrink pool
-        size_t removeCount = workers.size() - newSize;
-        
-        {
-            std::unique_lock<std::mutex> lock(queueMutex);
-            stop = true;
-        }
-        condition.notify_all();
-        
-        // Join excess threads
-        for (size_t i = 0; i < removeCount; ++i) {
-            if (workers.back().joinable()) {
-                workers.back().join();
-            }
-            workers.pop_back();
+
+    // Per-worker deques are sized to the worker count, so the pool is
+    // drained and restarted rather than adjusted in place.
+    stopWorkers();
+    startWorkers(newSize);
+}
+
+void ThreadPool::startWorkers(size_t count) {
+    if (!backgroundLimitSet) {
+        backgroundLimit = std::max<size_t>(1, count / 2);
+    }
+    workerQueues.clear();
+    if (mode == SchedulingMode::WORK_STEALING) {
+        for (size_t i = 0; i < count; ++i) {
+            workerQueues.push_back(std::make_unique<WorkerQueue>());
         }
-        
-        stop = false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        workers.emplace_back(&ThreadPool::workerThread, this, i);
+    }
+}
+
+void ThreadPool::stopWorkers() {
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        draining = true;
+    }
+    condition.notify_all();
+
+    for (std::thread& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers.clear();
+    draining = false;
+}
+
+void ThreadPool::submit(Task task, const TaskOptions& options) {
+    if (stop) {
+        throw std::runtime_error("enqueue on stopped ThreadPool");
+    }
+
+    // Count the task before publishing it so it can never be claimed while
+    // the counter says the pool is empty.
+    pendingTasks.fetch_add(1);
+    bool plain = options.priority == TaskPriority::NORMAL && !options.hasDeadline();
+    if (plain && mode == SchedulingMode::WORK_STEALING && currentPool == this) {
+        workerQueues[currentWorker]->deque.push(allocateTask(std::move(task)));
     } else {
-        // Grow pool
-        size_t addCount = newSize - workers.size();
-        for (size_t i = 0; i < addCount; ++i) {
-            workers.emplace_back(&ThreadPool::workerThread, this);
+        std::unique_lock<std::mutex> lock(queueMutex);
+        if (stop) {
+            pendingTasks.fetch_sub(1);
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+        }
+        Lane& lane = lanes[static_cast<size_t>(options.priority)];
+        if (options.hasDeadline()) {
+            lane.dated.push({options.deadline, datedSequence++, allocateTask(std::move(task))});
+        } else {
+            lane.fifo.push_back(allocateTask(std::move(task)));
         }
+        if (options.priority == TaskPriority::INTERACTIVE || options.hasDeadline()) {
+            urgentTasks.fetch_add(1);
+        }
+        sharedTasks.fetch_add(1);
+    }
+
+    // Only take the lock to wake someone if a worker is actually asleep
+    if (idleWorkers.load() > 0) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        condition.notify_one();
     }
 }
 
-void ThreadPool::workerThread() {
-    for(;;) {
-        std::function<void()> task;
-
-        {
-            std::unique_lock<std::mutex> lock(queueMutex);
-            
-            condition.wait(lock, [this]() {
-                return stop || (!paused && !tasks.empty());
-            });
-            
-            if(stop && tasks.empty()) {
-                return;
+// Shutting down drains everything, so the background limit no longer applies
+bool ThreadPool::mayRunBackground() const {
+    return stop || draining || holdsBackgroundSlot || runningBackground.load() < backgroundLimit.load();
+}
+
+// Whether a worker could claim something; called with queueMutex held
+bool ThreadPool::hasRunnableTask() const {
+    size_t background = lanes[static_cast<size_t>(TaskPriority::BACKGROUND)].size();
+    return pendingTasks.load() > background || (background > 0 && mayRunBackground());
+}
+
+// Called with queueMutex held. Sets `background` when the task takes one of
+// the background slots, which runTask gives back. `newest` takes the back of
+// a lane's FIFO rather than the front.
+Task* ThreadPool::takeShared(bool& background, bool newest) {
+    const size_t backgroundLane = static_cast<size_t>(TaskPriority::BACKGROUND);
+    bool backgroundAllowed = mayRunBackground();
+    auto claim = [&](size_t lane, Task* task, bool dated) {
+        sharedTasks.fetch_sub(1);
+        if (dated || lane == static_cast<size_t>(TaskPriority::INTERACTIVE)) {
+            urgentTasks.fetch_sub(1);
+        }
+        if (lane == backgroundLane && !holdsBackgroundSlot) {
+            runningBackground.fetch_add(1);
+            background = true;
+        }
+        return task;
+    };
+
+    // Nearly due tasks first, earliest deadline across the lanes
+    if (urgentTasks.load() > 0) {
+        auto due = std::chrono::steady_clock::now() + TaskOptions::DEADLINE_SLACK;
+        size_t earliest = PRIORITY_LANES;
+        for (size_t lane = 0; lane < PRIORITY_LANES; ++lane) {
+            if (lanes[lane].dated.empty() || (lane == backgroundLane && !backgroundAllowed)) {
+                continue;
             }
-            
-            if(!tasks.empty()) {
-                task = std::move(tasks.front());
-                tasks.pop();
-                activeThreads++;
+            const DatedTask& head = lanes[lane].dated.top();
+            if (head.deadline <= due &&
+                (earliest == PRIORITY_LANES || head.deadline < lanes[earliest].dated.top().deadline)) {
+                earliest = lane;
             }
         }
+        if (earliest < PRIORITY_LANES) {
+            Task* task = lanes[earliest].dated.top().task;
+            lanes[earliest].dated.pop();
+            return claim(earliest, task, true);
+        }
+    }
 
-        if(task) {
-            try {
-                task();
-            } catch(...) {
-                // Log error but don't let exceptions kill the thread
+    for (size_t lane = 0; lane < PRIORITY_LANES; ++lane) {
+        if (lane == backgroundLane && !backgroundAllowed) {
+            break;
+        }
+        if (!lanes[lane].dated.empty()) {
+            Task* task = lanes[lane].dated.top().task;
+            lanes[lane].dated.pop();
+            return claim(lane, task, true);
+        }
+        if (!lanes[lane].fifo.empty()) {
+            std::deque<Task*>& fifo = lanes[lane].fifo;
+            Task* task = nullptr;
+            if (newest) {
+                task = fifo.back();
+                fifo.pop_back();
+            } else {
+                task = fifo.front();
+                fifo.pop_front();
             }
-            
-            activeThreads--;
-            finished.notify_all();
+            return claim(lane, task, false);
+        }
+    }
+    return nullptr;
+}
+
+Task* ThreadPool::findTask(size_t index, bool& background, bool newest) {
+    background = false;
+    if (paused && !stop && !draining) {
+        return nullptr;
+    }
+
+    // Interactive and dated work goes ahead of the worker's own deque
+    Task* task = nullptr;
+    if (urgentTasks.load() > 0) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if ((task = takeShared(background, newest))) {
+            return task;
+        }
+    }
+
+    if (!workerQueues.empty() && workerQueues[index]->deque.pop(task)) {
+        return task;
+    }
+
+    if (sharedTasks.load() > 0) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if ((task = takeShared(background, newest))) {
+            return task;
+        }
+    }
+
+    // Steal, starting after ourselves so thieves spread across victims
+    size_t count = workerQueues.size();
+    for (size_t i = 1; i < count; ++i) {
+        if (workerQueues[(index + i) % count]->deque.steal(task)) {
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+bool ThreadPool::runPendingTask() {
+    bool background = false;
+    Task* task = findTask(currentWorker, background, true);
+    if (!task) return false;
+    runTask(task, background);
+    return true;
+}
+
+void ThreadPool::runTask(Task* task, bool background) {
+    activeThreads++;
+    pendingTasks.fetch_sub(1);
+    if (background) {
+        holdsBackgroundSlot = true;
+    }
+
+    try {
+        (*task)();
+    } catch(...) {
+        // Log error but don't let exceptions kill the thread
+    }
+    releaseTask(task);
+
+    if (background) {
+        holdsBackgroundSlot = false;
+        runningBackground.fetch_sub(1);
+        // A queued background task may have been waiting for this slot
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (lanes[static_cast<size_t>(TaskPriority::BACKGROUND)].size() > 0) {
+            condition.notify_one();
+        }
+    }
+
+    if (activeThreads.fetch_sub(1) == 1 && pendingTasks.load() == 0) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        finished.notify_all();
+    }
+}
+
+void ThreadPool::workerThread(size_t index) {
+    currentPool = this;
+    currentWorker = index;
+
+    for(;;) {
+        bool background = false;
+        if (Task* task = findTask(index, background)) {
+            runTask(task, background);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(queueMutex);
+        idleWorkers++;
+        condition.wait(lock, [this]() {
+            return stop || draining || (!paused && hasRunnableTask());
+        });
+        idleWorkers--;
+
+        if((stop || draining) && pendingTasks.load() == 0) {
+            return;
         }
     }
 }
@@ -125,14 +341,15 @@ std::mutex GlobalThreadPool::instanceMutex;
 ThreadPool& GlobalThreadPool::getInstance() {
     std::lock_guard<std::mutex> lock(instanceMutex);
     if (!instance) {
-        instance = std::make_unique<ThreadPool>();
+        instance = std::make_unique<ThreadPool>(std::thread::hardware_concurrency(),
+                                                SchedulingMode::WORK_STEALING);
     }
     return *instance;
 }
 
-void GlobalThreadPool::initialize(size_t numThreads) {
+void GlobalThreadPool::initialize(size_t numThreads, SchedulingMode mode) {
     std::lock_guard<std::mutex> lock(instanceMutex);
-    instance = std::make_unique<ThreadPool>(numThreads);
+    instance = std::make_unique<ThreadPool>(numThreads, mode);
 }
 
 void GlobalThreadPool::shutdown() {